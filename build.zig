@@ -2,6 +2,7 @@ const std = @import("std");
 const Build = std.Build;
 
 const CUBS_USING_ZIG_ALLOCATOR = "CUBS_USING_ZIG_ALLOCATOR";
+const CUBS_INTERPRETER_PROFILE = "CUBS_INTERPRETER_PROFILE";
 
 pub fn build(b: *std.Build) void {
     const target = b.standardTargetOptions(.{});
@@ -17,6 +18,12 @@ pub fn build(b: *std.Build) void {
         cubic_script.addCMacro("CUBS_X86_64", "1");
     }
 
+    // See src/interpreter/profiler.h
+    const profile = b.option(bool, "profile", "Compile in the interpreter profiler") orelse false;
+    if (profile) {
+        cubic_script.addCMacro(CUBS_INTERPRETER_PROFILE, "1");
+    }
+
     const c_flags = [_][]const u8{};
     for (cubic_script_c_sources) |c_file| {
         cubic_script.addCSourceFile(.{ .file = b.path(c_file), .flags = &c_flags });
@@ -45,11 +52,17 @@ pub fn build(b: *std.Build) void {
         lib_unit_tests.addIncludePath(b.path("src"));
         lib_unit_tests.linkLibC();
         lib_unit_tests.defineCMacro(CUBS_USING_ZIG_ALLOCATOR, "1");
+        if (profile) {
+            lib_unit_tests.defineCMacro(CUBS_INTERPRETER_PROFILE, "1");
+        }
 
         const cpp_unit_tests = b.addExecutable(.{ .name = "cpp_unit_tests", .target = target, .optimize = optimize });
         cpp_unit_tests.addIncludePath(b.path("src"));
         cpp_unit_tests.linkLibC();
         cpp_unit_tests.linkLibCpp();
+        if (profile) {
+            cpp_unit_tests.defineCMacro(CUBS_INTERPRETER_PROFILE, "1");
+        }
 
         for (cubic_script_c_sources) |c_file| {
             lib_unit_tests.addCSourceFile(.{ .file = b.path(c_file), .flags = &c_flags });
@@ -78,6 +91,27 @@ pub fn build(b: *std.Build) void {
         test_step.dependOn(&run_cpp_unit_tests.step);
     }
 
+    { //* benchmarks
+        const bench = b.addExecutable(.{ .name = "cubic_script_bench", .target = target, .optimize = optimize });
+        bench.addIncludePath(b.path("src"));
+        bench.linkLibC();
+        if (profile) {
+            bench.defineCMacro(CUBS_INTERPRETER_PROFILE, "1");
+        }
+
+        for (cubic_script_c_sources) |c_file| {
+            bench.addCSourceFile(.{ .file = b.path(c_file), .flags = &c_flags });
+        }
+        for (cubic_script_bench_sources) |c_file| {
+            bench.addCSourceFile(.{ .file = b.path(c_file), .flags = &c_flags });
+        }
+
+        // On running "zig build bench -Doptimize=ReleaseFast" on the command line, it will build and run the benchmarks
+        const run_bench = b.addRunArtifact(bench);
+        const bench_step = b.step("bench", "Run benchmarks");
+        bench_step.dependOn(&run_bench.step);
+    }
+
     { //* executable for debug purposes
         const exe = b.addExecutable(.{
             .name = "CubicScript",
@@ -103,24 +137,31 @@ pub const cubic_script_c_sources = [_][]const u8{
     "src/validate_compilation_target.c",
 
     "src/platform/mem.c",
+    "src/platform/clock.c",
 
     "src/program/program.c",
     "src/program/protected_arena.c",
     "src/program/function_map.c",
     "src/program/type_map.c",
     "src/program/function_call_args.c",
+    "src/program/program_image.c",
 
     "src/interpreter/bytecode.c",
     "src/interpreter/interpreter.c",
     "src/interpreter/function_definition.c",
     "src/interpreter/operations.c",
     "src/interpreter/stack.c",
+    "src/interpreter/profiler.c",
+    "src/interpreter/coroutine.c",
+    "src/interpreter/verifier.c",
+    "src/interpreter/jit.c",
 
     "src/compiler/build_options.c",
     "src/compiler/compiler.c",
     "src/compiler/ast.c",
     "src/compiler/tokenizer.c",
     "src/compiler/stack_variables.c",
+    "src/compiler/optimizer.c",
     "src/compiler/ast_nodes/file_node.c",
     "src/compiler/ast_nodes/function_node.c",
     "src/compiler/ast_nodes/return_node.c",
@@ -149,6 +190,7 @@ pub const cubic_script_c_sources = [_][]const u8{
     "src/primitives/error/error.c",
     "src/primitives/result/result.c",
     "src/primitives/sync_ptr/sync_ptr.c",
+    "src/primitives/sync_map/sync_map.c",
     "src/primitives/reference/reference.c",
     "src/primitives/vector/vector.c",
     "src/primitives/function/function.c",
@@ -159,3 +201,11 @@ pub const cubic_script_cpp_test_sources = [_][]const u8{
     "src/primitives/string/string_tests.cpp",
     "src/primitives/array/array_tests.cpp",
 };
+
+pub const cubic_script_bench_sources = [_][]const u8{
+    "src/bench.c",
+    "src/interpreter/interpreter_bench.c",
+    "src/primitives/map/map_bench.c",
+    "src/util/hash_bench.c",
+    "src/primitives/sync_map/sync_map_bench.c",
+};
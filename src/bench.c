@@ -0,0 +1,27 @@
+#include "bench.h"
+#include "platform/clock.h"
+#include <stdio.h>
+
+uint64_t cubs_bench_now_ns()
+{
+    return _cubs_os_monotonic_ns();
+}
+
+void cubs_bench_report(const char *name, uint64_t operations, uint64_t elapsedNs)
+{
+    const double nsPerOp = operations == 0 ? 0.0 : (double)elapsedNs / (double)operations;
+    fprintf(stdout, "%-48s %12llu ops %10.3f ms %8.3f ns/op\n", 
+        name, (unsigned long long)operations, (double)elapsedNs / 1000000.0, nsPerOp);
+    fflush(stdout);
+}
+
+int main(int argc, char** argv) {
+    (void)argc;
+    (void)argv;
+
+    cubs_bench_interpreter();
+    cubs_bench_map();
+    cubs_bench_hash();
+    cubs_bench_sync_map();
+    return 0;
+}
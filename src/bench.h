@@ -0,0 +1,28 @@
+#pragma once
+
+#include <stdint.h>
+
+/*
+Benchmarks are built as a separate executable from the tests, and are not run as part of them.
+Each benchmark group is a function declared here, and called from `main` in `src/bench.c`.
+Should be built with optimizations enabled for meaningful results.
+*/
+
+/// Monotonic time in nanoseconds. See `_cubs_os_monotonic_ns()`.
+uint64_t cubs_bench_now_ns();
+
+/// Prints the total time, and the time per operation, of a benchmark.
+void cubs_bench_report(const char* name, uint64_t operations, uint64_t elapsedNs);
+
+/// Defined in `src/interpreter/interpreter_bench.c`
+void cubs_bench_interpreter();
+
+
+/// Defined in `src/primitives/map/map_bench.c`
+void cubs_bench_map();
+
+/// Defined in `src/util/hash_bench.c`
+void cubs_bench_hash();
+
+/// Defined in `src/primitives/sync_map/sync_map_bench.c`
+void cubs_bench_sync_map();
\ No newline at end of file
@@ -18,6 +18,11 @@ void cubs_ast_deinit(Ast *self)
     ast_node_deinit(&self->rootNode);
 }
 
+void cubs_ast_optimize(Ast *self)
+{
+    ast_node_optimize(&self->rootNode);
+}
+
 void cubs_ast_codegen(const Ast *self)
 {
     assert(self->rootNode.vtable->compile != NULL);
@@ -27,6 +27,7 @@ typedef void(*AstNodeBuildFunction)(
     struct FunctionBuilder* builder,
     const struct StackVariablesAssignment* stackAssignment
 );
+typedef void(*AstNodeOptimize)(void* self);
 
 typedef struct AstNodeVTable {
     enum AstNodeType nodeType;
@@ -34,6 +35,8 @@ typedef struct AstNodeVTable {
     AstNodeCompile compile;
     AstNodeToString toString;
     AstNodeBuildFunction buildFunction;
+    /// Can be NULL, in which case the node isn't optimized.
+    AstNodeOptimize optimize;
 } AstNodeVTable;
 
 typedef struct AstNode {
@@ -57,6 +60,12 @@ inline static void ast_node_build_function(const AstNode* self, struct FunctionB
     self->vtable->buildFunction(self->ptr, builder, stackAssignments);
 }
 
+inline static void ast_node_optimize(AstNode* self) {
+    if(self->vtable->optimize != NULL) {
+        self->vtable->optimize(self->ptr);
+    }
+}
+
 typedef struct Ast {
     struct CubsProgram* program;
     AstNode rootNode;
@@ -66,6 +75,11 @@ Ast cubs_ast_init(TokenIter iter, struct CubsProgram* program);
 
 void cubs_ast_deinit(Ast* self);
 
+/// Optional. Must be called before `cubs_ast_codegen(...)`. Rewrites the tree, folding constant
+/// expressions, propagating copies and constants, and removing dead code and unused variables.
+/// The generated bytecode behaves the same, including reporting integer overflow at runtime.
+void cubs_ast_optimize(Ast* self);
+
 void cubs_ast_codegen(const Ast* self);
 
 void cubs_ast_print(const Ast* self);
@@ -5,9 +5,17 @@ const c = @cImport({
     @cInclude("program/program_internal.h");
     @cInclude("compiler/tokenizer.h");
     @cInclude("compiler/ast.h");
+    @cInclude("compiler/compiler.h");
+    @cInclude("compiler/build_options.h");
     @cInclude("compiler/ast_nodes/file_node.h");
     @cInclude("compiler/ast_nodes/function_node.h");
     @cInclude("compiler/ast_nodes/return_node.h");
+    @cInclude("compiler/ast_nodes/binary_expression.h");
+    @cInclude("compiler/stack_variables.h");
+    @cInclude("program/function_call_args.h");
+    @cInclude("program/program_runtime_error.h");
+    @cInclude("primitives/context.h");
+    @cInclude("primitives/function/function.h");
 });
 
 const TokenIter = c.TokenIter;
@@ -402,3 +410,170 @@ test "function return binary expression" {
         try expect(false);
     }
 }
+
+test "binary expression only specializes matching operand types" {
+    var variables = c.StackVariablesArray{};
+    defer c.cubs_stack_variables_array_deinit(&variables);
+
+    const names = [_][]const u8{ "intVar", "floatVar", "outVar" };
+    const contexts = [_]*const c.CubsTypeContext{ &c.CUBS_INT_CONTEXT, &c.CUBS_FLOAT_CONTEXT, &c.CUBS_INT_CONTEXT };
+    for (names, contexts) |name, context| {
+        const variable = c.StackVariableInfo{
+            .name = c.cubs_string_init_unchecked(.{ .str = name.ptr, .len = name.len }),
+            .context = context,
+        };
+        try expect(c.cubs_stack_variables_array_push(&variables, variable));
+    }
+
+    const intLit = c.ExprValue{ .tag = c.IntLit, .value = .{ .intLiteral = .{ .literal = 1, .variableIndex = 0 } } };
+    const intVar = c.ExprValue{ .tag = c.Variable, .value = .{ .variableIndex = 0 } };
+    const floatVar = c.ExprValue{ .tag = c.Variable, .value = .{ .variableIndex = 1 } };
+
+    { // 1 + intVar
+        var node = c.cubs_binary_expr_node_init(&variables, 2, c.Add, intLit, intVar);
+        defer c.ast_node_deinit(&node);
+        const binaryExpr: *const c.BinaryExprNode = @ptrCast(@alignCast(node.ptr));
+        try expect(binaryExpr.operandContext == @as(?*const c.CubsTypeContext, &c.CUBS_INT_CONTEXT));
+    }
+    { // 1 + floatVar
+        var node = c.cubs_binary_expr_node_init(&variables, 2, c.Add, intLit, floatVar);
+        defer c.ast_node_deinit(&node);
+        const binaryExpr: *const c.BinaryExprNode = @ptrCast(@alignCast(node.ptr));
+        try expect(binaryExpr.operandContext == null);
+    }
+    { // floatVar + intVar
+        var node = c.cubs_binary_expr_node_init(&variables, 2, c.Add, floatVar, intVar);
+        defer c.ast_node_deinit(&node);
+        const binaryExpr: *const c.BinaryExprNode = @ptrCast(@alignCast(node.ptr));
+        try expect(binaryExpr.operandContext == null);
+    }
+}
+
+const Compiled = struct {
+    bytecodeCount: usize,
+    err: c_int,
+    retValue: i64,
+};
+
+/// Compiles `source`, optionally optimizing it, and calls `testFunc` with `args`.
+fn compileAndRun(source: []const u8, optimize: bool, args: []const i64) !Compiled {
+    const tokenIter = tokenIterInit(source, null);
+    var program = c.cubs_program_init(.{});
+    defer c.cubs_program_deinit(&program);
+
+    var ast = c.cubs_ast_init(tokenIter, &program);
+    defer c.cubs_ast_deinit(&ast);
+
+    if (optimize) {
+        c.cubs_ast_optimize(&ast);
+    }
+    c.cubs_ast_codegen(&ast);
+
+    const func = findFunction(&program, "testFunc") orelse return error.FunctionNotFound;
+    var call = c.cubs_function_start_call(&func);
+    for (args) |arg| {
+        var argValue = arg;
+        c.cubs_function_push_arg(&call, @ptrCast(&argValue), &c.CUBS_INT_CONTEXT);
+    }
+    var retValue: i64 = 0;
+    var retContext: *const c.CubsTypeContext = undefined;
+    const err = c.cubs_function_call(call, .{ .value = &retValue, .context = @ptrCast(&retContext) });
+    return .{ .bytecodeCount = func.func.script.*._bytecodeCount, .err = err, .retValue = retValue };
+}
+
+test "optimizer folds constant expressions" {
+    const source =
+        \\fn testFunc() int { 
+        \\  const testVar: int = 1 + 5;
+        \\  return testVar + 4;
+        \\};
+    ;
+    const unoptimized = try compileAndRun(source, false, &.{});
+    const optimized = try compileAndRun(source, true, &.{});
+    try expect(unoptimized.retValue == 10);
+    try expect(optimized.retValue == 10);
+    // Just loading the result and returning it
+    try expect(optimized.bytecodeCount == 3);
+    try expect(optimized.bytecodeCount < unoptimized.bytecodeCount);
+}
+
+test "optimizer keeps overflowing expressions" {
+    const source =
+        \\fn testFunc() int { 
+        \\  const testVar: int = 9223372036854775807;
+        \\  const unused: int = testVar + 1;
+        \\  return 0;
+        \\};
+    ;
+    const unoptimized = try compileAndRun(source, false, &.{});
+    const optimized = try compileAndRun(source, true, &.{});
+    try expect(unoptimized.err == c.cubsProgramRuntimeErrorAdditionIntegerOverflow);
+    try expect(optimized.err == c.cubsProgramRuntimeErrorAdditionIntegerOverflow);
+}
+
+test "optimizer removes unreachable code" {
+    const source =
+        \\fn testFunc(arg: int) int { 
+        \\  return arg;
+        \\  const testVar: int = 1;
+        \\  return testVar;
+        \\};
+    ;
+    const unoptimized = try compileAndRun(source, false, &.{3});
+    const optimized = try compileAndRun(source, true, &.{3});
+    try expect(unoptimized.retValue == 3);
+    try expect(optimized.retValue == 3);
+    try expect(optimized.bytecodeCount == 1);
+    try expect(optimized.bytecodeCount < unoptimized.bytecodeCount);
+}
+
+test "optimizer propagates copies" {
+    const source =
+        \\fn testFunc(arg: int) int { 
+        \\  const a: int = arg;
+        \\  const b: int = a;
+        \\  return b + a;
+        \\};
+    ;
+    const unoptimized = try compileAndRun(source, false, &.{20});
+    const optimized = try compileAndRun(source, true, &.{20});
+    try expect(unoptimized.retValue == 40);
+    try expect(optimized.retValue == 40);
+    // Only the addition and return remain
+    try expect(optimized.bytecodeCount == 2);
+    try expect(optimized.bytecodeCount < unoptimized.bytecodeCount);
+}
+
+/// Compiles `source` as a module through `cubs_compile(...)`, and returns the bytecode count of `testFunc`.
+fn compileModuleBytecodeCount(source: []const u8, disableOptimizations: bool) !usize {
+    var program = c.cubs_program_init(.{});
+    defer c.cubs_program_deinit(&program);
+
+    var build = c.CubsBuildOptions{ .disableOptimizations = disableOptimizations };
+    defer c.cubs_build_options_deinit(&build);
+    const moduleName = "example";
+    var module = c.CubsModule{
+        .name = c.cubs_string_init_unchecked(.{ .str = moduleName.ptr, .len = moduleName.len }),
+        .rootSource = .{ .str = source.ptr, .len = source.len },
+    };
+    defer c.cubs_module_deinit(&module);
+    c.cubs_build_options_add_module(&build, &module);
+
+    c.cubs_compile(&program, &build);
+
+    const func = findFunction(&program, "testFunc") orelse return error.FunctionNotFound;
+    return func.func.script.*._bytecodeCount;
+}
+
+test "compile optimizes unless disabled" {
+    const source =
+        \\fn testFunc() int { 
+        \\  const testVar: int = 1 + 5;
+        \\  return testVar + 4;
+        \\};
+    ;
+    const optimized = try compileModuleBytecodeCount(source, false);
+    const unoptimized = try compileModuleBytecodeCount(source, true);
+    try expect(optimized == 3);
+    try expect(optimized < unoptimized);
+}
@@ -42,16 +42,28 @@ static void binary_expr_node_build_function(
         rhsSrc = stackAssignment->positions[self->rhs.value.variableIndex];
     }
 
-    const Bytecode addBytecode = operands_make_add_dst(false, self->outputVariableIndex, lhsSrc, rhsSrc);
+    const uint16_t dst = stackAssignment->positions[self->outputVariableIndex];
+    const Bytecode addBytecode = cubs_operands_specialize(
+        operands_make_add_dst(false, dst, lhsSrc, rhsSrc), self->operandContext);
     cubs_function_builder_push_bytecode(builder, addBytecode);
 }
 
+/// Returns NULL if the type of `value` is not known yet.
+static const CubsTypeContext* expr_value_context(const ExprValue* value, const StackVariablesArray* variables) {
+    switch(value->tag) {
+        case IntLit: return &CUBS_INT_CONTEXT;
+        case Variable: return variables->variables[value->value.variableIndex].context;
+        default: return NULL;
+    }
+}
+
 static AstNodeVTable binary_expr_node_vtable = {
     .nodeType = astNodeBinaryExpression,
     .deinit = (AstNodeDeinit)&binary_expr_node_deinit,
     .compile = NULL,
     .toString = NULL,
     .buildFunction = (AstNodeBuildFunction)&binary_expr_node_build_function,
+    .optimize = NULL,
 };
 
 AstNode cubs_binary_expr_node_init(
@@ -95,6 +107,14 @@ AstNode cubs_binary_expr_node_init(
     self->lhs = lhs;
     self->rhs = rhs;
 
+    // Type specialized bytecode reads both operands as the same type, so mixed
+    // operands, such as `1 + someFloat`, must use the generic bytecode.
+    const CubsTypeContext* lhsContext = expr_value_context(&lhs, variables);
+    const CubsTypeContext* rhsContext = expr_value_context(&rhs, variables);
+    if(lhsContext == rhsContext) {
+        self->operandContext = lhsContext;
+    }
+
     const AstNode node = {.ptr = (void*)self, .vtable = &binary_expr_node_vtable};
     return node;
 }
@@ -16,6 +16,9 @@ typedef struct BinaryExprNode {
     BinaryExprOp operation;
     ExprValue lhs;
     ExprValue rhs;
+    /// The type of both `lhs` and `rhs`. Is NULL if either is not resolved, or if they
+    /// are different types, in which case generic, non type specialized, bytecode is generated.
+    const struct CubsTypeContext* operandContext;
 } BinaryExprNode;
 
 /// A binary expression will already have a pre-known destination
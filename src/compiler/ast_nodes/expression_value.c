@@ -42,6 +42,7 @@ static ExprValue parse_expression_value(TokenIter* iter, StackVariablesArray* va
             const bool didFind = cubs_stack_variables_array_find(
                 variables, &value.value.variableIndex, identifier);
             assert(didFind && "Did not find stack variable");     
+            cubs_stack_variables_array_mark_used(variables, value.value.variableIndex);
         } break;
         default: {
             fprintf(stderr, "%d hmm\n", token.tag);
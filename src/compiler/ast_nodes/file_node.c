@@ -23,12 +23,19 @@ static void file_node_compile(const FileNode* self, struct CubsProgram* program)
     }
 }
 
+static void file_node_optimize(FileNode* self) {
+    for(size_t i = 0; i < self->items.len; i++) {
+        ast_node_optimize(&self->items.nodes[i]);
+    }
+}
+
 static AstNodeVTable file_node_vtable = {
     .nodeType = astNodeTypeFile,
     .deinit = (AstNodeDeinit)&file_node_deinit,
     .compile = (AstNodeCompile)&file_node_compile,
     .toString = (AstNodeToString)&file_node_to_string,
     .buildFunction = NULL,
+    .optimize = (AstNodeOptimize)&file_node_optimize,
 };
 
 AstNode cubs_file_node_init(TokenIter *iter)
@@ -1,6 +1,7 @@
 #include "function_node.h"
 #include "return_node.h"
 #include "variable_declaration.h"
+#include "../optimizer.h"
 #include "../../program/program.h"
 #include "../../program/program_internal.h"
 #include "../../platform/mem.h"
@@ -9,7 +10,9 @@
 #include "../../interpreter/interpreter.h"
 #include "../../interpreter/operations.h"
 #include "../../interpreter/function_definition.h"
+#include "../../interpreter/verifier.h"
 #include "../../primitives/string/string.h"
+#include "../../util/panic.h"
 //#include <stdio.h>
 
 static void function_node_deinit(FunctionNode* self) {
@@ -40,7 +43,7 @@ static void function_node_compile(const FunctionNode* self, CubsProgram* program
             case functionReturnToken: {
 
                 switch(self->retInfo.retType.token) {
-                    case INT_LITERAL: {
+                    case INT_KEYWORD: {
                         builder.optReturnType = &CUBS_INT_CONTEXT;
                     } break;
                 }
@@ -74,7 +77,12 @@ static void function_node_compile(const FunctionNode* self, CubsProgram* program
         }
     }
 
-    cubs_function_builder_build(&builder, program);
+    const CubsScriptFunctionPtr* function = cubs_function_builder_build(&builder, program);
+    // Codegen doesn't emit calls yet, so there's nothing to set after building. Verified in every build, as
+    // release builds execute the bytecode without any checks of their own.
+    if(cubs_function_verify(function, NULL) != cubsBytecodeVerifyErrorNone) {
+        cubs_panic("Compiled function failed bytecode verification");
+    }
 
     // cleanup
     cubs_stack_assignment_deinit(&stackAssignment);
@@ -86,6 +94,7 @@ static AstNodeVTable function_node_vtable = {
     .compile = (AstNodeCompile)&function_node_compile,
     .toString = (AstNodeToString)&function_node_to_string,
     .buildFunction = NULL,
+    .optimize = (AstNodeOptimize)&cubs_function_node_optimize,
 };
 
 /// Parses from `'('` to `')'`.
@@ -202,6 +211,8 @@ AstNode cubs_function_node_init(TokenIter *iter)
             if(token == TOKEN_NONE) {
                 break;
             }
+            // Lifetimes of the variables used by the statement extend to it
+            self->variables.currentStatement = self->items.len;
             switch(token) {
                 case RETURN_KEYWORD: 
                 {
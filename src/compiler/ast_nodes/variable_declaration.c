@@ -30,21 +30,26 @@ static void variable_declaration_node_build_function(
             );
             cubs_function_builder_push_bytecode_many(builder, loadImmediateLong, 2);
         } break;
+        case Variable: {
+            const uint16_t src = stackAssignment->positions[self->initialValue.value.variableIndex];
+            cubs_function_builder_push_bytecode(builder, cubs_operands_make_clone(returnSrc, src));
+        } break;
         case Expression: {
             ast_node_build_function(&self->initialValue.value.expression, builder, stackAssignment);
         } break;
         default: {
-            assert(false && "Can only handle variable assignment from int literals");
+            assert(false && "Can only handle variable assignment from int literals, variables, and expressions");
         }
     }
 }
 
 static AstNodeVTable variable_declaration_node_vtable = {
-    .nodeType = astNodeBinaryExpression,
+    .nodeType = astNodeVariableDeclaration,
     .deinit = (AstNodeDeinit)&variable_declaration_node_deinit,
     .compile = NULL,
     .toString = NULL,
     .buildFunction = (AstNodeBuildFunction)&variable_declaration_node_build_function,
+    .optimize = NULL,
 };
 
 AstNode cubs_variable_declaration_node_init(TokenIter *iter, StackVariablesArray *variables)
@@ -23,6 +23,7 @@ void cubs_build_options_add_module(CubsBuildOptions *self, const CubsModule *mod
             cubs_free((void*)self->modules, self->_modulesCapacity * sizeof(CubsModule), _Alignof(CubsModule));
         }
         self->modules = newModules;
+        self->_modulesCapacity = newCapacity;
     }
     self->modules[self->modulesLen] = cubs_module_clone(module);
     self->modulesLen += 1;
@@ -36,4 +37,7 @@ void cubs_build_options_deinit(CubsBuildOptions *self)
     if(self->modules != NULL) {
         cubs_free((void*)self->modules, self->_modulesCapacity * sizeof(CubsModule), _Alignof(CubsModule));
     }
+    self->modules = NULL;
+    self->modulesLen = 0;
+    self->_modulesCapacity = 0;
 }
@@ -21,11 +21,22 @@ typedef struct CubsModule {
     // CubsModuleSourceGraph graph;
 } CubsModule;
 
+/// Script functions with at most this many bytecodes are inlined at immediate call sites by default.
+#define CUBS_DEFAULT_INLINE_THRESHOLD 16
+
 /// Should 0 initialize.
 typedef struct CubsBuildOptions {
     CubsModule* modules;
     size_t modulesLen;
     size_t _modulesCapacity;
+    /// Script functions with at most this many bytecodes are inlined into their callers, where
+    /// the callee is known ahead of time. If 0, uses `CUBS_DEFAULT_INLINE_THRESHOLD`.
+    size_t inlineThreshold;
+    /// Keeps every call as is, such as for stepping through functions when debugging.
+    bool disableInlining;
+    /// Generates bytecode straight from the source, without folding constants or removing dead code.
+    /// See `cubs_ast_optimize(...)`.
+    bool disableOptimizations;
 } CubsBuildOptions;
 
 #ifdef __cplusplus
@@ -2,7 +2,28 @@
 #include "build_options.h"
 #include "../program/program.h"
 #include "../program/program_internal.h"
+#include "tokenizer.h"
+#include "ast.h"
 
 void cubs_compile(CubsProgram *program, const CubsBuildOptions *build)
 {
+    ProgramInner* inner = (ProgramInner*)program->_inner;
+    if(build->disableInlining) {
+        inner->inlineThreshold = 0;
+    } else if(build->inlineThreshold == 0) {
+        inner->inlineThreshold = CUBS_DEFAULT_INLINE_THRESHOLD;
+    } else {
+        inner->inlineThreshold = build->inlineThreshold;
+    }
+
+    for(size_t i = 0; i < build->modulesLen; i++) {
+        const CubsModule* module = &build->modules[i];
+        const TokenIter iter = cubs_token_iter_init(cubs_string_as_slice(&module->name), module->rootSource, NULL);
+        Ast ast = cubs_ast_init(iter, program);
+        if(!build->disableOptimizations) {
+            cubs_ast_optimize(&ast);
+        }
+        cubs_ast_codegen(&ast);
+        cubs_ast_deinit(&ast);
+    }
 }
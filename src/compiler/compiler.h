@@ -3,4 +3,6 @@
 struct CubsProgram;
 struct CubsBuildOptions;
 
+/// Compiles every module in `build` into `program`, optimizing the source of each unless
+/// `build->disableOptimizations` is set.
 void cubs_compile(struct CubsProgram* program, const struct CubsBuildOptions* build);
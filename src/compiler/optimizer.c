@@ -0,0 +1,349 @@
+#include "optimizer.h"
+#include "stack_variables.h"
+#include "ast_nodes/function_node.h"
+#include "ast_nodes/return_node.h"
+#include "ast_nodes/variable_declaration.h"
+#include "ast_nodes/binary_expression.h"
+#include "../platform/mem.h"
+#include "../util/math.h"
+#include "../util/unreachable.h"
+#include <assert.h>
+
+/// Called with a pointer to every variable index within a statement, so that it can be read or rewritten.
+/// `isRead` is true if the variable's value is read, rather than it's slot just being written to.
+typedef void (*VisitVariableIndex)(void* context, size_t* index, bool isRead);
+
+/// `intoDeclaration` is true if `value` is the initial value of a variable declaration, in which
+/// case the slot of a literal is that of the declared variable.
+static void visit_expr_value(ExprValue* value, bool intoDeclaration, VisitVariableIndex visit, void* context) {
+    switch(value->tag) {
+        case Variable: {
+            visit(context, &value->value.variableIndex, true);
+        } break;
+        case IntLit: {
+            if(!intoDeclaration) {
+                visit(context, &value->value.intLiteral.variableIndex, false);
+            }
+        } break;
+        case Expression: {
+            AstNode* node = &value->value.expression;
+            assert(node->vtable->nodeType == astNodeBinaryExpression);
+            BinaryExprNode* binaryExpr = (BinaryExprNode*)node->ptr;
+            visit(context, &binaryExpr->outputVariableIndex, false);
+            visit_expr_value(&binaryExpr->lhs, false, visit, context);
+            visit_expr_value(&binaryExpr->rhs, false, visit, context);
+        } break;
+        default: {
+            assert(false && "Cannot optimize expression values other than literals, variables, and binary expressions");
+        } break;
+    }
+}
+
+static void visit_statement(AstNode* statement, VisitVariableIndex visit, void* context) {
+    switch(statement->vtable->nodeType) {
+        case astNodeTypeReturn: {
+            ReturnNode* returnNode = (ReturnNode*)statement->ptr;
+            if(returnNode->hasReturn) {
+                visit_expr_value(&returnNode->retValue, false, visit, context);
+            }
+        } break;
+        case astNodeVariableDeclaration: {
+            VariableDeclarationNode* declaration = (VariableDeclarationNode*)statement->ptr;
+            visit(context, &declaration->variableNameIndex, false);
+            visit_expr_value(&declaration->initialValue, true, visit, context);
+        } break;
+        default: {
+            unreachable();
+        }
+    }
+}
+
+static void remove_statement(AstNodeArray* statements, uint32_t index) {
+    assert(index < statements->len);
+    ast_node_deinit(&statements->nodes[index]);
+    for(uint32_t i = index + 1; i < statements->len; i++) {
+        statements->nodes[i - 1] = statements->nodes[i];
+    }
+    statements->len -= 1;
+}
+
+static void remove_unreachable(FunctionNode* self) {
+    for(uint32_t i = 0; i < self->items.len; i++) {
+        if(self->items.nodes[i].vtable->nodeType != astNodeTypeReturn) {
+            continue;
+        }
+        while(self->items.len > (i + 1)) {
+            remove_statement(&self->items, self->items.len - 1);
+        }
+        return;
+    }
+}
+
+#pragma region Propagate and fold
+
+typedef struct Propagation {
+    const StackVariablesArray* variables;
+    /// For each variable, if it's uses are replaced with `replacements`.
+    bool* isReplaced;
+    /// Either `Variable` or `IntLit`. Not owned.
+    ExprValue* replacements;
+    /// For each variable, if it's declared `mut`. Arguments are immutable.
+    bool* isMutable;
+} Propagation;
+
+static void substitute(const Propagation* self, ExprValue* value) {
+    switch(value->tag) {
+        case Variable: {
+            const size_t index = value->value.variableIndex;
+            if(self->isReplaced[index]) {
+                *value = self->replacements[index];
+            }
+        } break;
+        case Expression: {
+            BinaryExprNode* binaryExpr = (BinaryExprNode*)value->value.expression.ptr;
+            substitute(self, &binaryExpr->lhs);
+            substitute(self, &binaryExpr->rhs);
+        } break;
+        default: break;
+    }
+}
+
+static void fold(ExprValue* value) {
+    if(value->tag != Expression) {
+        return;
+    }
+
+    BinaryExprNode* binaryExpr = (BinaryExprNode*)value->value.expression.ptr;
+    fold(&binaryExpr->lhs);
+    fold(&binaryExpr->rhs);
+    if(binaryExpr->lhs.tag != IntLit || binaryExpr->rhs.tag != IntLit) {
+        return;
+    }
+
+    assert(binaryExpr->operation == Add);
+    const int64_t lhs = binaryExpr->lhs.value.intLiteral.literal;
+    const int64_t rhs = binaryExpr->rhs.value.intLiteral.literal;
+    if(cubs_math_would_add_overflow(lhs, rhs)) {
+        return;
+    }
+
+    ExprValue folded = {0};
+    folded.tag = IntLit;
+    folded.value.intLiteral.literal = lhs + rhs;
+    // Loaded wherever the expression would've been stored
+    folded.value.intLiteral.variableIndex = binaryExpr->outputVariableIndex;
+    expr_value_deinit(value);
+    *value = folded;
+}
+
+static void propagate_declaration(Propagation* self, VariableDeclarationNode* declaration) {
+    const size_t index = declaration->variableNameIndex;
+    ExprValue* initialValue = &declaration->initialValue;
+    self->isMutable[index] = declaration->isMutable;
+
+    substitute(self, initialValue);
+    fold(initialValue);
+    if(initialValue->tag == IntLit) {
+        // Int literals are loaded directly into the declared variable
+        initialValue->value.intLiteral.variableIndex = index;
+    }
+
+    if(declaration->isMutable) {
+        return;
+    }
+    if(initialValue->tag == IntLit) {
+        self->isReplaced[index] = true;
+        self->replacements[index] = *initialValue;
+    } else if(initialValue->tag == Variable) {
+        const size_t src = initialValue->value.variableIndex;
+        const StackVariableInfo* variables = self->variables->variables;
+        if(!self->isMutable[src] && variables[src].context == variables[index].context) {
+            self->isReplaced[index] = true;
+            self->replacements[index] = *initialValue;
+        }
+    }
+}
+
+static void propagate_and_fold(FunctionNode* self) {
+    const size_t count = self->variables.len;
+    if(count == 0) {
+        return;
+    }
+
+    Propagation propagation = {
+        .variables = &self->variables,
+        .isReplaced = MALLOC_TYPE_ARRAY(bool, count),
+        .replacements = MALLOC_TYPE_ARRAY(ExprValue, count),
+        .isMutable = MALLOC_TYPE_ARRAY(bool, count),
+    };
+    for(size_t i = 0; i < count; i++) {
+        propagation.isReplaced[i] = false;
+        propagation.isMutable[i] = false;
+    }
+
+    for(uint32_t i = 0; i < self->items.len; i++) {
+        AstNode* statement = &self->items.nodes[i];
+        switch(statement->vtable->nodeType) {
+            case astNodeTypeReturn: {
+                ReturnNode* returnNode = (ReturnNode*)statement->ptr;
+                if(returnNode->hasReturn) {
+                    substitute(&propagation, &returnNode->retValue);
+                    fold(&returnNode->retValue);
+                }
+            } break;
+            case astNodeVariableDeclaration: {
+                propagate_declaration(&propagation, (VariableDeclarationNode*)statement->ptr);
+            } break;
+            default: {
+                unreachable();
+            }
+        }
+    }
+
+    FREE_TYPE_ARRAY(bool, propagation.isReplaced, count);
+    FREE_TYPE_ARRAY(ExprValue, propagation.replacements, count);
+    FREE_TYPE_ARRAY(bool, propagation.isMutable, count);
+}
+
+#pragma endregion
+
+#pragma region Dead code
+
+static void count_read(void* context, size_t* index, bool isRead) {
+    if(isRead) {
+        ((size_t*)context)[*index] += 1;
+    }
+}
+
+static void uncount_read(void* context, size_t* index, bool isRead) {
+    if(isRead) {
+        size_t* reads = (size_t*)context;
+        assert(reads[*index] > 0);
+        reads[*index] -= 1;
+    }
+}
+
+/// Removes declarations of variables that are never read. Declarations are visited in reverse,
+/// as removing one may leave variables it read unread, which can only have been declared before it.
+static void remove_dead_declarations(FunctionNode* self) {
+    const size_t count = self->variables.len;
+    if(count == 0) {
+        return;
+    }
+
+    size_t* reads = MALLOC_TYPE_ARRAY(size_t, count);
+    for(size_t i = 0; i < count; i++) {
+        reads[i] = 0;
+    }
+    for(uint32_t i = 0; i < self->items.len; i++) {
+        visit_statement(&self->items.nodes[i], count_read, (void*)reads);
+    }
+
+    uint32_t i = self->items.len;
+    while(i > 0) {
+        i -= 1;
+        AstNode* statement = &self->items.nodes[i];
+        if(statement->vtable->nodeType != astNodeVariableDeclaration) {
+            continue;
+        }
+        const VariableDeclarationNode* declaration = (const VariableDeclarationNode*)statement->ptr;
+        const enum ExprValueType initialTag = declaration->initialValue.tag;
+        // Expressions may error at runtime, so they aren't removed
+        if(reads[declaration->variableNameIndex] > 0 || (initialTag != IntLit && initialTag != Variable)) {
+            continue;
+        }
+        visit_statement(statement, uncount_read, (void*)reads);
+        remove_statement(&self->items, i);
+    }
+
+    FREE_TYPE_ARRAY(size_t, reads, count);
+}
+
+#pragma endregion
+
+#pragma region Variables
+
+static void mark_referenced(void* context, size_t* index, bool isRead) {
+    (void)isRead;
+    ((bool*)context)[*index] = true;
+}
+
+static void remap_index(void* context, size_t* index, bool isRead) {
+    (void)isRead;
+    *index = ((const size_t*)context)[*index];
+}
+
+typedef struct Lifetimes {
+    StackVariablesArray* variables;
+    bool* seen;
+    size_t statement;
+} Lifetimes;
+
+static void extend_lifetime(void* context, size_t* index, bool isRead) {
+    (void)isRead;
+    Lifetimes* self = (Lifetimes*)context;
+    StackVariableInfo* variable = &self->variables->variables[*index];
+    if(!self->seen[*index]) {
+        self->seen[*index] = true;
+        variable->firstUse = self->statement;
+    }
+    variable->lastUse = self->statement;
+}
+
+/// Removes variables that are no longer referenced by any statement, keeping the order of the
+/// rest, and recomputes their lifetimes to match the remaining statements.
+static void remove_unused_variables(FunctionNode* self) {
+    const size_t count = self->variables.len;
+    if(count == 0) {
+        return;
+    }
+
+    bool* referenced = MALLOC_TYPE_ARRAY(bool, count);
+    size_t* newIndices = MALLOC_TYPE_ARRAY(size_t, count);
+    for(size_t i = 0; i < count; i++) {
+        // Arguments are always on the stack
+        referenced[i] = i < self->argCount;
+    }
+    for(uint32_t i = 0; i < self->items.len; i++) {
+        visit_statement(&self->items.nodes[i], mark_referenced, (void*)referenced);
+    }
+
+    size_t newCount = 0;
+    for(size_t i = 0; i < count; i++) {
+        if(referenced[i]) {
+            newIndices[i] = newCount;
+            self->variables.variables[newCount] = self->variables.variables[i];
+            newCount += 1;
+        } else {
+            cubs_stack_variable_info_deinit(&self->variables.variables[i]);
+        }
+    }
+    self->variables.len = newCount;
+    for(uint32_t i = 0; i < self->items.len; i++) {
+        visit_statement(&self->items.nodes[i], remap_index, (void*)newIndices);
+    }
+
+    Lifetimes lifetimes = {.variables = &self->variables, .seen = referenced, .statement = 0};
+    for(size_t i = 0; i < newCount; i++) {
+        lifetimes.seen[i] = i < self->argCount;
+        self->variables.variables[i].firstUse = 0;
+        self->variables.variables[i].lastUse = 0;
+    }
+    for(uint32_t i = 0; i < self->items.len; i++) {
+        lifetimes.statement = i;
+        visit_statement(&self->items.nodes[i], extend_lifetime, (void*)&lifetimes);
+    }
+
+    FREE_TYPE_ARRAY(bool, referenced, count);
+    FREE_TYPE_ARRAY(size_t, newIndices, count);
+}
+
+#pragma endregion
+
+void cubs_function_node_optimize(FunctionNode* self)
+{
+    remove_unreachable(self);
+    propagate_and_fold(self);
+    remove_dead_declarations(self);
+    remove_unused_variables(self);
+}
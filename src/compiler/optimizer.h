@@ -0,0 +1,18 @@
+#pragma once
+
+struct FunctionNode;
+
+/*
+AST level optimizations of a function, done before any bytecode is generated. In order:
+- Statements following a `return` are removed, as they are unreachable.
+- Uses of `const` variables initialized from an int literal, or another immutable variable,
+  are replaced by the literal, or that variable.
+- Binary expressions of two int literals are folded into a single literal, unless they would
+  overflow, in which case they are left to report the overflow at runtime.
+- Declarations of variables that are never read are removed, as long as they are initialized
+  from a literal or variable. Expressions that may overflow are kept.
+- Variables, including temporaries, that are no longer referenced are removed, and the
+  lifetimes of the rest recomputed, so they don't occupy stack slots.
+*/
+
+void cubs_function_node_optimize(struct FunctionNode* self);
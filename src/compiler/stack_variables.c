@@ -1,5 +1,7 @@
 #include "stack_variables.h"
 #include "../platform/mem.h"
+#include "../interpreter/stack.h"
+#include "../util/panic.h"
 #include <assert.h>
 #include <stdio.h>
 
@@ -64,6 +66,8 @@ bool cubs_stack_variables_array_push(StackVariablesArray *self, StackVariableInf
 
     ensure_array_capacity_add_one(self);
     
+    variable.firstUse = self->currentStatement;
+    variable.lastUse = self->currentStatement;
     self->variables[self->len] = variable;
     self->len += 1;
     return true;
@@ -83,6 +87,8 @@ void cubs_stack_variables_array_push_temporary(StackVariablesArray *self, StackV
 
     ensure_array_capacity_add_one(self);
     
+    variable.firstUse = self->currentStatement;
+    variable.lastUse = self->currentStatement;
     self->variables[self->len] = variable;
     self->len += 1;
 }
@@ -100,15 +106,100 @@ bool cubs_stack_variables_array_find(const StackVariablesArray* self, size_t* ou
     return foundVariableNameIndex;
 }
 
+void cubs_stack_variables_array_mark_used(StackVariablesArray *self, size_t index)
+{
+    assert(index < self->len);
+    StackVariableInfo* variable = &self->variables[index];
+    if(variable->lastUse < self->currentStatement) {
+        variable->lastUse = self->currentStatement;
+    }
+}
+
+static size_t slots_for_type(size_t sizeOfType) {
+    if(sizeOfType <= 8) {
+        return 1;
+    }
+    return (sizeOfType + 7) / 8;
+}
+
+/// Whether `lhs` and `rhs` can't share any stack slots. Lifetimes are inclusive, so a variable
+/// last used in the same statement another is first used in won't share with it, as the
+/// statement may read the former after writing the latter.
+static bool variables_interfere(const StackVariableInfo* lhs, const StackVariableInfo* rhs) {
+    if(lhs->context->destructor.func.externC != NULL || rhs->context->destructor.func.externC != NULL) {
+        // The slots hold the object until the frame is unwound, which deinitializes it
+        return true;
+    }
+    return lhs->firstUse <= rhs->lastUse && rhs->firstUse <= lhs->lastUse;
+}
+
+static void assignment_append(StackVariablesAssignment* self, CubsStringSlice name, uint16_t position) {
+    if(self->len == self->capacity) {
+        const size_t newCapacity = self->capacity == 0 ? 2 : self->capacity << 1;
+
+        CubsStringSlice* newNames = (CubsStringSlice*)cubs_malloc(newCapacity * sizeof(CubsStringSlice), _Alignof(CubsStringSlice));
+        uint16_t* newPositions = (uint16_t*)cubs_malloc(newCapacity * sizeof(uint16_t), _Alignof(uint16_t));
+
+        if(self->names != NULL) {
+            assert(self->positions != NULL);
+
+            for(uint32_t i = 0; i < self->len; i++) {
+                newNames[i] = self->names[i];
+                newPositions[i] = self->positions[i];
+            }
+
+            cubs_free((void*)self->names, self->capacity * sizeof(CubsStringSlice), _Alignof(CubsStringSlice));
+            cubs_free((void*)self->positions, self->capacity * sizeof(uint16_t), _Alignof(uint16_t));
+        } else {
+            // Validation
+            assert(self->positions == NULL);
+        }
+
+        self->names = newNames;
+        self->positions = newPositions;
+        self->capacity = newCapacity;
+    }
+
+    self->names[self->len] = name;
+    self->positions[self->len] = position;
+    self->len += 1;
+}
+
 StackVariablesAssignment cubs_stack_assignment_init(const StackVariablesArray *variables)
 {
     StackVariablesAssignment self = {0};
     for(size_t i = 0; i < variables->len; i++) {
         const StackVariableInfo* info = &variables->variables[i];
         assert(info->context != NULL);
-        const CubsStringSlice slice = cubs_string_as_slice(&info->name);
-        const bool success = cubs_stack_assignment_push(&self, slice, info->context->sizeOfType);
-        assert(success);
+        const size_t slots = slots_for_type(info->context->sizeOfType);
+
+        // First fit. Move past any already assigned variable that interferes with this one, and 
+        // occupies any of the candidate slots, until none do.
+        size_t position = 0;
+        bool moved = true;
+        while(moved) {
+            moved = false;
+            for(size_t j = 0; j < i; j++) {
+                const StackVariableInfo* other = &variables->variables[j];
+                if(!variables_interfere(info, other)) {
+                    continue;
+                }
+                const size_t otherPosition = self.positions[j];
+                const size_t otherEnd = otherPosition + slots_for_type(other->context->sizeOfType);
+                if(position < otherEnd && otherPosition < (position + slots)) {
+                    position = otherEnd;
+                    moved = true;
+                }
+            }
+        }
+
+        if((position + slots) > MAX_FRAME_LENGTH) {
+            cubs_panic("Function requires more stack slots than a frame can hold");
+        }
+        assignment_append(&self, cubs_string_as_slice(&info->name), (uint16_t)position);
+        if(self.requiredFrameSize < (position + slots)) {
+            self.requiredFrameSize = position + slots;
+        }
     }
     return self;
 }
@@ -154,47 +245,11 @@ bool cubs_stack_assignment_push(StackVariablesAssignment *self, CubsStringSlice
 
     assert(self->requiredFrameSize < UINT16_MAX);
     const uint16_t position = (uint16_t)self->requiredFrameSize;
-
-    size_t slotsForVariable = 1;
-    if(sizeOfType > 8) {
-        for(size_t i = 1; i < (sizeOfType / 8); i++) {
-            slotsForVariable++; // TODO probably could do this in a one liner
-        }
-    }
     
-    self->requiredFrameSize += slotsForVariable;
+    self->requiredFrameSize += slots_for_type(sizeOfType);
     assert(self->requiredFrameSize <= UINT16_MAX);
 
-    if(self->len == self->capacity) {
-        const size_t newCapacity = self->capacity == 0 ? 2 : self->capacity << 1;
-
-        CubsStringSlice* newNames = (CubsStringSlice*)cubs_malloc(newCapacity * sizeof(CubsStringSlice), _Alignof(CubsStringSlice));
-        uint16_t* newPositions = (uint16_t*)cubs_malloc(newCapacity * sizeof(uint16_t), _Alignof(uint16_t));
-
-        if(self->names != NULL) {
-            assert(self->positions != NULL);
-
-            for(uint32_t i = 0; i < self->len; i++) {
-                newNames[i] = self->names[i];
-                newPositions[i] = self->positions[i];
-            }
-
-            cubs_free((void*)self->names, self->capacity * sizeof(CubsStringSlice), _Alignof(CubsStringSlice));
-            cubs_free((void*)self->positions, self->capacity * sizeof(uint16_t), _Alignof(uint16_t));
-        } else {
-            // Validation
-            assert(self->positions == NULL);
-        }
-
-        self->names = newNames;
-        self->positions = newPositions;
-        self->capacity = newCapacity;
-    }
-
-    self->names[self->len] = name;
-    self->positions[self->len] = position;
-    self->len += 1;
-
+    assignment_append(self, name, position);
     return true;
 }
 
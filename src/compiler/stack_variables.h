@@ -22,6 +22,13 @@ typedef struct StackVariableInfo {
     /// `const a: int = ...`, which `taggedName` will hold the slice
     /// `"int"`. If this string is empty, there is no tag.
     CubsStringSlice taggedName;
+    /// Index of the statement within the function that this variable is first used in.
+    /// Set when pushed into a `StackVariablesArray`.
+    size_t firstUse;
+    /// Index of the statement within the function that this variable is last used in.
+    /// Along with `firstUse`, is the lifetime of the variable, outside of which it's stack
+    /// slots may be used by other variables.
+    size_t lastUse;
 } StackVariableInfo;
 
 void cubs_stack_variable_info_deinit(StackVariableInfo* self);
@@ -30,6 +37,9 @@ typedef struct StackVariablesArray {
     StackVariableInfo* variables;
     size_t len;
     size_t capacity;
+    /// Index of the statement currently being parsed. Variables pushed or used
+    /// are live during it.
+    size_t currentStatement;
 } StackVariablesArray;
 
 void cubs_stack_variables_array_deinit(StackVariablesArray* self);
@@ -52,6 +62,9 @@ void cubs_stack_variables_array_push_temporary(StackVariablesArray* self, StackV
 
 bool cubs_stack_variables_array_find(const StackVariablesArray* self, size_t* outIndex, CubsStringSlice name);
 
+/// Extends the lifetime of the variable at `index` to `self->currentStatement`.
+void cubs_stack_variables_array_mark_used(StackVariablesArray* self, size_t index);
+
 /// Zero initialize.
 /// Stores stack positions of all variables within a stack frame
 typedef struct StackVariablesAssignment {
@@ -67,6 +80,17 @@ typedef struct StackVariablesAssignment {
     size_t capacity;
 } StackVariablesAssignment;
 
+/// Assigns every variable in `variables` a stack position. Variables whose lifetimes don't overlap
+/// may share stack slots, keeping `requiredFrameSize` down to the most slots live at once, rather
+/// than the total of all variables and temporaries. Variables with destructors are never
+/// shared, as their slots must hold them until the frame is unwound.
+/// Function arguments must be the first variables, and all be live from the first statement, so
+/// that they are assigned sequential positions starting at 0, matching how they're pushed.
+/// Lifetimes only come from the order statements appear in, see `cubs_stack_variables_array_mark_used(...)`,
+/// so this is only correct for straight line code. With loops or any other backward jumps, a variable last
+/// used early in a loop body would be considered dead for the rest of it, so it's slots could be reused and
+/// overwritten before the next iteration reads it.
+/// Panics if the variables require more than `MAX_FRAME_LENGTH` slots.
 StackVariablesAssignment cubs_stack_assignment_init(const StackVariablesArray* variables);
 
 void cubs_stack_assignment_deinit(StackVariablesAssignment* self);
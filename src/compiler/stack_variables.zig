@@ -353,3 +353,40 @@ test "stack assignment duplicate names" {
     try expect(assignment.len == 1);
     try expect(assignment.requiredFrameSize == 1);
 }
+
+fn pushVariable(variables: *StackVariablesArray, comptime name: []const u8, context: *const c.CubsTypeContext) !void {
+    const variable = StackVariableInfo{ .name = c.cubs_string_init_unchecked(sliceFromLiteral(name)), .context = context };
+    try expect(c.cubs_stack_variables_array_push(variables, variable));
+}
+
+test "stack assignment reuses slots of dead variables" {
+    var variables = StackVariablesArray{};
+    defer c.cubs_stack_variables_array_deinit(&variables);
+
+    // statement 0: const a = 1;
+    try pushVariable(&variables, "a", &c.CUBS_INT_CONTEXT);
+    // statement 1: const b = a;
+    variables.currentStatement = 1;
+    try pushVariable(&variables, "b", &c.CUBS_INT_CONTEXT);
+    c.cubs_stack_variables_array_mark_used(&variables, 0);
+    // statement 2: const s: string; const d = b;
+    variables.currentStatement = 2;
+    try pushVariable(&variables, "s", &c.CUBS_STRING_CONTEXT);
+    try pushVariable(&variables, "d", &c.CUBS_INT_CONTEXT);
+    c.cubs_stack_variables_array_mark_used(&variables, 1);
+    // statement 3: const e = 1;
+    variables.currentStatement = 3;
+    try pushVariable(&variables, "e", &c.CUBS_INT_CONTEXT);
+
+    var assignment = c.cubs_stack_assignment_init(&variables);
+    defer c.cubs_stack_assignment_deinit(&assignment);
+
+    try expect(c.cubs_stack_assignment_find(&assignment, sliceFromLiteral("a")) == 0);
+    try expect(c.cubs_stack_assignment_find(&assignment, sliceFromLiteral("b")) == 1);
+    // `a` is dead, but the string needs 4 slots
+    try expect(c.cubs_stack_assignment_find(&assignment, sliceFromLiteral("s")) == 2);
+    try expect(c.cubs_stack_assignment_find(&assignment, sliceFromLiteral("d")) == 0);
+    // `s` has a destructor, so it's slots are never reused
+    try expect(c.cubs_stack_assignment_find(&assignment, sliceFromLiteral("e")) == 0);
+    try expect(assignment.requiredFrameSize == 6);
+}
@@ -77,9 +77,58 @@ typedef enum OpCode {
     OpCodeGreaterOrEqual,
     /// Increments an integer or iterator
     OpCodeIncrement,
-    /// 
+    ///
     OpCodeAdd,
 
+    // Type specialized operations. These use the exact same operands as their generic
+    // counterparts, but skip looking up and branching on the source contexts, as the
+    // types are already known at compile time. See `cubs_operands_specialize(...)`.
+
+    /// `OpCodeIncrement` where `src` is an int.
+    OpCodeIncrementInt,
+    /// `OpCodeAdd` where `src1` and `src2` are ints.
+    OpCodeAddInt,
+    /// `OpCodeAdd` where `src1` and `src2` are floats.
+    OpCodeAddFloat,
+    /// `OpCodeEqual` where `src1` and `src2` are ints.
+    OpCodeEqualInt,
+    /// `OpCodeNotEqual` where `src1` and `src2` are ints.
+    OpCodeNotEqualInt,
+    /// `OpCodeLess` where `src1` and `src2` are ints.
+    OpCodeLessInt,
+    /// `OpCodeGreater` where `src1` and `src2` are ints.
+    OpCodeGreaterInt,
+    /// `OpCodeLessOrEqual` where `src1` and `src2` are ints.
+    OpCodeLessOrEqualInt,
+    /// `OpCodeGreaterOrEqual` where `src1` and `src2` are ints.
+    OpCodeGreaterOrEqualInt,
+    /// `OpCodeLess` where `src1` and `src2` are floats.
+    OpCodeLessFloat,
+    /// `OpCodeGreater` where `src1` and `src2` are floats.
+    OpCodeGreaterFloat,
+    /// `OpCodeLessOrEqual` where `src1` and `src2` are floats.
+    OpCodeLessOrEqualFloat,
+    /// `OpCodeGreaterOrEqual` where `src1` and `src2` are floats.
+    OpCodeGreaterOrEqualFloat,
+    /// Suspends the executing coroutine (or budgeted execution) after this operation, optionally
+    /// yielding the value at `src` to whoever resumes it. The value is moved out, making `src`
+    /// invalid memory. Executing it outside of one is a `cubsProgramRuntimeErrorYieldOutsideCoroutine`.
+    /// See `coroutine.h`.
+    OpCodeYield,
+
+    // Superinstructions. These are fused from common sequences of operations by
+    // `cubs_function_builder_push_bytecode(...)`. The fused operation replaces only the
+    // first bytecode of the sequence, leaving the rest in place, so jump offsets stay
+    // valid, and jumping into the middle of the sequence executes the original operations.
+
+    /// Fused `OpCodeIncrementInt` (assign) + `OpCodeLessInt` + `OpCodeJump` (if true or if false),
+    /// where the compare's `src1` is the incremented value and the jump's condition is the
+    /// compare's `dst`. The jump amount and type are read from the original jump bytecode.
+    OpCodeIncrementLessIntJump,
+    /// Fused int `OpCodeLoad` (immediate) + `OpCodeAddInt`. The add operands are read
+    /// from the original add bytecode.
+    OpCodeLoadImmediateAddInt,
+
     OPCODE_USED_BITS = 8,
     OPCODE_USED_BITMASK = 0b11111111,
 } OpCode;
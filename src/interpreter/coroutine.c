@@ -0,0 +1,139 @@
+#include "coroutine.h"
+#include "stack.h"
+#include "../primitives/context.h"
+#include "../platform/mem.h"
+#include "../util/context_size_round.h"
+#include <assert.h>
+#include <string.h>
+
+struct CubsCoroutine {
+    const CubsScriptFunctionPtr* function;
+    /// Swapped in for the thread's own stack while resuming.
+    InterpreterStackState* stack;
+    CubsBudgetedExecution execution;
+    CubsCoroutineStatus status;
+    bool started;
+    /// Arguments pushed before starting.
+    size_t argCount;
+    /// Slot the next pushed argument goes in.
+    size_t argsOffset;
+    /// Return value destination of the executed function's frame, which has to outlive every resume.
+    /// NULL if the function doesn't return a value.
+    void* returnValue;
+    const CubsTypeContext* returnContext;
+};
+
+static size_t return_value_size(const CubsScriptFunctionPtr* function) {
+    return ROUND_SIZE_TO_MULTIPLE_OF_8(function->returnType->sizeOfType);
+}
+
+CubsCoroutine* cubs_coroutine_init(const CubsScriptFunctionPtr* function)
+{
+    assert(function != NULL);
+    CubsCoroutine* self = MALLOC_TYPE(CubsCoroutine);
+    const CubsCoroutine coroutine = {
+        .function = function,
+        .stack = cubs_interpreter_stack_state_create(CUBS_COROUTINE_STACK_SLOTS),
+        .status = cubsCoroutineStatusSuspended,
+        .started = false,
+        .argCount = 0,
+        .argsOffset = 0,
+        .returnValue = NULL,
+        .returnContext = NULL,
+    };
+    *self = coroutine;
+    if(function->returnType != NULL) {
+        self->returnValue = cubs_malloc(return_value_size(function), _Alignof(size_t));
+    }
+    return self;
+}
+
+void cubs_coroutine_deinit(CubsCoroutine* self)
+{
+    assert(self->status != cubsCoroutineStatusRunning && "Cannot deinitialize a running coroutine");
+
+    if(self->status == cubsCoroutineStatusSuspended && (self->started || self->argCount > 0)) {
+        cubs_interpreter_stack_state_swap(self->stack);
+        if(self->started) {
+            cubs_interpreter_cancel(&self->execution);
+        } else {
+            // The arguments are already where the function's frame would be
+            cubs_interpreter_push_script_frame(self->function, NULL, NULL);
+            cubs_interpreter_stack_unwind_frame();
+            cubs_interpreter_pop_frame();
+        }
+        cubs_interpreter_stack_state_swap(self->stack);
+    }
+
+    cubs_interpreter_stack_state_destroy(self->stack);
+    if(self->returnValue != NULL) {
+        cubs_free(self->returnValue, return_value_size(self->function), _Alignof(size_t));
+    }
+    FREE_TYPE(CubsCoroutine, self);
+}
+
+void cubs_coroutine_push_arg(CubsCoroutine* self, void* arg, const CubsTypeContext* context)
+{
+    assert(!self->started && "Cannot push arguments to a coroutine that already started");
+    assert(self->argCount < self->function->argsLen);
+    assert(context == self->function->argsTypes[self->argCount]);
+
+    cubs_interpreter_stack_state_swap(self->stack);
+    cubs_interpreter_push_script_function_arg(arg, context, self->argsOffset);
+    cubs_interpreter_stack_state_swap(self->stack);
+
+    self->argCount += 1;
+    self->argsOffset += ROUND_SIZE_TO_MULTIPLE_OF_8(context->sizeOfType) / 8;
+}
+
+CubsProgramRuntimeError cubs_coroutine_resume(CubsCoroutine* self, CubsExecutionBudget budget, CubsFunctionReturn outValue)
+{
+    assert(self->status == cubsCoroutineStatusSuspended && "Can only resume a suspended coroutine");
+    if(outValue.context != NULL) {
+        *outValue.context = NULL;
+    }
+
+    self->status = cubsCoroutineStatusRunning;
+    cubs_interpreter_stack_state_swap(self->stack);
+
+    CubsProgramRuntimeError err;
+    if(!self->started) {
+        assert(self->argCount == self->function->argsLen);
+        self->started = true;
+        err = cubs_interpreter_execute_function_budgeted(self->function, self->returnValue, &self->returnContext, budget, &self->execution);
+    } else {
+        err = cubs_interpreter_resume(&self->execution, budget);
+    }
+
+    if(self->execution.suspended) {
+        if(outValue.value != NULL && outValue.context != NULL) {
+            // Otherwise deinitialized once resumed or cancelled
+            (void)cubs_interpreter_take_yielded_value(&self->execution, outValue.value, outValue.context);
+        }
+        self->status = cubsCoroutineStatusSuspended;
+    } else {
+        self->status = cubsCoroutineStatusFinished;
+    }
+    cubs_interpreter_stack_state_swap(self->stack);
+
+    if(self->status == cubsCoroutineStatusFinished && err == cubsProgramRuntimeErrorNone && self->returnValue != NULL) {
+        assert(self->returnContext != NULL);
+        if(outValue.value != NULL && outValue.context != NULL) {
+            memcpy(outValue.value, self->returnValue, self->returnContext->sizeOfType);
+            *outValue.context = self->returnContext;
+        } else {
+            cubs_context_fast_deinit(self->returnValue, self->returnContext);
+        }
+    }
+    return err;
+}
+
+CubsCoroutineStatus cubs_coroutine_status(const CubsCoroutine* self)
+{
+    return self->status;
+}
+
+bool cubs_coroutine_yielded(const CubsCoroutine* self)
+{
+    return self->status == cubsCoroutineStatusSuspended && self->started && self->execution.yielded;
+}
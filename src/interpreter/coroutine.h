@@ -0,0 +1,62 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "interpreter.h"
+#include "../program/program_runtime_error.h"
+#include "../program/function_call_args.h"
+
+struct CubsScriptFunctionPtr;
+struct CubsTypeContext;
+
+/*
+Stackful script coroutines. Each coroutine executes a script function on it's own interpreter stack,
+separate from every thread's, so it can suspend with all of it's script call frames intact, and
+continue where it left off when resumed, rather than re-entering the script from scratch.
+Script code suspends with `OpCodeYield`, optionally yielding a value to the host that resumed it.
+Only the script functions the coroutine calls directly may yield, not ones called through C functions.
+
+A coroutine's stack is only reserved on first resume, and grows in small steps up to
+`CUBS_COROUTINE_STACK_SLOTS`, so thousands of them can be kept around without a native thread each.
+Since none of it's frames are on a thread's stack, a suspended coroutine may be resumed by a different
+thread than it last ran on, as long as only one thread resumes it at a time. Resuming a coroutine
+from within a C function called by a script, including by another coroutine, is fine.
+*/
+
+typedef enum CubsCoroutineStatus {
+    /// Not started yet, or suspended. Can be resumed.
+    cubsCoroutineStatusSuspended = 0,
+    /// Currently executing, in which case it can't be resumed or deinitialized.
+    cubsCoroutineStatusRunning = 1,
+    /// Returned, or errored. Can only be deinitialized.
+    cubsCoroutineStatusFinished = 2,
+
+    _CUBS_COROUTINE_STATUS_MAX_VALUE = 0x7FFFFFFF,
+} CubsCoroutineStatus;
+
+typedef struct CubsCoroutine CubsCoroutine;
+
+/// Creates a coroutine that executes `function` when first resumed. Push it's arguments with
+/// `cubs_coroutine_push_arg(...)` before then.
+CubsCoroutine* cubs_coroutine_init(const struct CubsScriptFunctionPtr* function);
+
+/// Unwinds a suspended coroutine's frames, deinitializing all objects on them, including arguments
+/// that were pushed but never used. Then frees the coroutine and it's stack.
+void cubs_coroutine_deinit(CubsCoroutine* self);
+
+/// Takes ownership of the memory at `arg`, pushing it as the next argument in order.
+/// Only valid before the coroutine is first resumed.
+void cubs_coroutine_push_arg(CubsCoroutine* self, void* arg, const struct CubsTypeContext* context);
+
+/// Runs the coroutine until it yields, returns, errors, or `budget` runs out. Zero initializing
+/// `budget` runs it until it yields or returns. If it yielded a value, or returned a value, moves it
+/// to `outValue.value` and sets `*outValue.context` to it's context. Otherwise, sets `*outValue.context`
+/// to NULL. If the coroutine can yield or return values, both `outValue.value` and `outValue.context`
+/// must be non-NULL, with `outValue.value` large enough for any of them.
+/// Returns an error if one occurred, in which case the coroutine is finished.
+CubsProgramRuntimeError cubs_coroutine_resume(CubsCoroutine* self, CubsExecutionBudget budget, CubsFunctionReturn outValue);
+
+CubsCoroutineStatus cubs_coroutine_status(const CubsCoroutine* self);
+
+/// If the coroutine is suspended, true if it yielded, rather than running out of budget, or not having started.
+bool cubs_coroutine_yielded(const CubsCoroutine* self);
@@ -0,0 +1,139 @@
+const std = @import("std");
+const expect = std.testing.expect;
+
+const c = @cImport({
+    @cInclude("interpreter/interpreter.h");
+    @cInclude("interpreter/coroutine.h");
+    @cInclude("interpreter/function_definition.h");
+    @cInclude("interpreter/bytecode.h");
+    @cInclude("interpreter/operations.h");
+    @cInclude("interpreter/stack.h");
+    @cInclude("primitives/context.h");
+    @cInclude("primitives/string/string.h");
+    @cInclude("program/program.h");
+    @cInclude("program/program_internal.h");
+});
+
+const unlimited = c.CubsExecutionBudget{ .operations = 0, .nanoseconds = 0 };
+
+/// fn count(n: int) int { mut i = 0; do { yield i; i += 1; } while(i < n); return i; }
+fn buildCount(program: *c.CubsProgram) *const c.CubsScriptFunctionPtr {
+    var builder = c.FunctionBuilder{ .stackSpaceRequired = 5, .optReturnType = &c.CUBS_INT_CONTEXT };
+    defer c.cubs_function_builder_deinit(&builder);
+    c.cubs_function_builder_add_arg(&builder, &c.CUBS_INT_CONTEXT);
+
+    c.cubs_function_builder_push_bytecode(&builder, c.operands_make_load_immediate(c.LOAD_IMMEDIATE_INT, 1, 0));
+    c.cubs_function_builder_push_bytecode(&builder, c.operands_make_load_immediate(c.LOAD_IMMEDIATE_INT, 3, 1));
+    c.cubs_function_builder_push_bytecode(&builder, c.cubs_operands_make_clone(4, 1));
+    c.cubs_function_builder_push_bytecode(&builder, c.operands_make_yield(true, 4));
+    c.cubs_function_builder_push_bytecode(&builder, c.operands_make_add_dst(false, 1, 1, 3));
+    c.cubs_function_builder_push_bytecode(&builder, c.cubs_operands_make_compare(c.COMPARE_OP_LESS, 2, 1, 0));
+    c.cubs_function_builder_push_bytecode(&builder, c.cubs_operands_make_jump(c.JUMP_TYPE_IF_TRUE, -4, 2));
+    c.cubs_function_builder_push_bytecode(&builder, c.operands_make_return(true, 1));
+
+    return c.cubs_function_builder_build(&builder, program);
+}
+
+test "coroutine yields and returns" {
+    var program = c.cubs_program_init(.{});
+    defer c.cubs_program_deinit(&program);
+
+    const count = buildCount(&program);
+
+    const co = c.cubs_coroutine_init(count);
+    defer c.cubs_coroutine_deinit(co);
+    var n: i64 = 3;
+    c.cubs_coroutine_push_arg(co, @ptrCast(&n), &c.CUBS_INT_CONTEXT);
+
+    var value: i64 = undefined;
+    var context: ?*const c.CubsTypeContext = undefined;
+    for (0..3) |i| {
+        try expect(c.cubs_coroutine_resume(co, unlimited, .{ .value = @ptrCast(&value), .context = @ptrCast(&context) }) == 0);
+        try expect(c.cubs_coroutine_status(co) == c.cubsCoroutineStatusSuspended);
+        try expect(c.cubs_coroutine_yielded(co));
+        try expect(context == &c.CUBS_INT_CONTEXT);
+        try expect(value == @as(i64, @intCast(i)));
+    }
+
+    try expect(c.cubs_coroutine_resume(co, unlimited, .{ .value = @ptrCast(&value), .context = @ptrCast(&context) }) == 0);
+    try expect(c.cubs_coroutine_status(co) == c.cubsCoroutineStatusFinished);
+    try expect(context == &c.CUBS_INT_CONTEXT);
+    try expect(value == 3);
+}
+
+test "coroutines resume in any order" {
+    var program = c.cubs_program_init(.{});
+    defer c.cubs_program_deinit(&program);
+
+    const count = buildCount(&program);
+
+    var coroutines: [3]*c.CubsCoroutine = undefined;
+    for (&coroutines) |*co| {
+        co.* = c.cubs_coroutine_init(count).?;
+        var n: i64 = 2;
+        c.cubs_coroutine_push_arg(co.*, @ptrCast(&n), &c.CUBS_INT_CONTEXT);
+    }
+    defer for (coroutines) |co| {
+        c.cubs_coroutine_deinit(co);
+    };
+
+    // The thread's own stack is unaffected by them
+    try expect(c.cubs_coroutine_resume(coroutines[2], unlimited, .{}) == 0);
+    try expect(c.cubs_coroutine_resume(coroutines[0], unlimited, .{}) == 0);
+    try expect(c.cubs_coroutine_resume(coroutines[2], unlimited, .{}) == 0);
+    try expect(c.cubs_interpreter_current_stack_frame().basePointerOffset == 0);
+
+    var value: i64 = undefined;
+    var context: ?*const c.CubsTypeContext = undefined;
+    try expect(c.cubs_coroutine_resume(coroutines[2], unlimited, .{ .value = @ptrCast(&value), .context = @ptrCast(&context) }) == 0);
+    try expect(c.cubs_coroutine_status(coroutines[2]) == c.cubsCoroutineStatusFinished);
+    try expect(value == 2);
+
+    try expect(c.cubs_coroutine_resume(coroutines[0], unlimited, .{ .value = @ptrCast(&value), .context = @ptrCast(&context) }) == 0);
+    try expect(c.cubs_coroutine_status(coroutines[0]) == c.cubsCoroutineStatusSuspended);
+    try expect(value == 1);
+    // coroutines[1] never started, and coroutines[0] is deinitialized while suspended
+}
+
+test "deinit suspended coroutine unwinds it's frames" {
+    var program = c.cubs_program_init(.{});
+    defer c.cubs_program_deinit(&program);
+
+    // fn holdString(s: string) { yield; }
+    var builder = c.FunctionBuilder{ .stackSpaceRequired = 4 };
+    defer c.cubs_function_builder_deinit(&builder);
+    c.cubs_function_builder_add_arg(&builder, &c.CUBS_STRING_CONTEXT);
+    c.cubs_function_builder_push_bytecode(&builder, c.operands_make_yield(false, 0));
+    c.cubs_function_builder_push_bytecode(&builder, c.operands_make_return(false, 0));
+    const func = c.cubs_function_builder_build(&builder, &program);
+
+    const s = "a string long enough to be allocated on the heap";
+    // The testing allocator would report either string as leaked if it wasn't unwound
+    {
+        const co = c.cubs_coroutine_init(func);
+        var str = c.cubs_string_init_unchecked(.{ .str = s.ptr, .len = s.len });
+        c.cubs_coroutine_push_arg(co, @ptrCast(&str), &c.CUBS_STRING_CONTEXT);
+        try expect(c.cubs_coroutine_resume(co, unlimited, .{}) == 0);
+        try expect(c.cubs_coroutine_yielded(co));
+        c.cubs_coroutine_deinit(co);
+    }
+    {
+        const co = c.cubs_coroutine_init(func);
+        var str = c.cubs_string_init_unchecked(.{ .str = s.ptr, .len = s.len });
+        c.cubs_coroutine_push_arg(co, @ptrCast(&str), &c.CUBS_STRING_CONTEXT);
+        c.cubs_coroutine_deinit(co);
+    }
+}
+
+test "yield outside of coroutine" {
+    var program = c.cubs_program_init(.{});
+    defer c.cubs_program_deinit(&program);
+
+    const count = buildCount(&program);
+
+    var n: i64 = 1;
+    c.cubs_interpreter_push_script_function_arg(@ptrCast(&n), &c.CUBS_INT_CONTEXT, 0);
+    var result: i64 = undefined;
+    var retContext: *const c.CubsTypeContext = undefined;
+    try expect(c.cubs_interpreter_execute_function(count, @ptrCast(&result), @ptrCast(&retContext)) == c.cubsProgramRuntimeErrorYieldOutsideCoroutine);
+}
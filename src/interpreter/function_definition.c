@@ -3,7 +3,11 @@
 #include "../primitives/context.h"
 #include "../platform/mem.h"
 #include "bytecode.h"
+#include "operations.h"
+#include "stack.h"
 #include "../program/program.h"
+#include "../util/context_size_round.h"
+#include "../util/unreachable.h"
 #include <string.h>
 #include <stdio.h>
 
@@ -71,6 +75,14 @@ void cubs_function_builder_push_bytecode(FunctionBuilder *self, Bytecode bytecod
     Bytecode* start = function_builder_add_n(self, 1);
     *start = bytecode;
     self->bytecodeLen += 1;
+    self->_singleBytecodeRun += 1;
+
+    Bytecode fused;
+    size_t fusedIndex;
+    const Bytecode* run = &self->bytecode[self->bytecodeLen - self->_singleBytecodeRun];
+    if(cubs_operands_try_fuse(run, self->_singleBytecodeRun, &fused, &fusedIndex)) {
+        self->bytecode[self->bytecodeLen - self->_singleBytecodeRun + fusedIndex] = fused;
+    }
 }
 
 void cubs_function_builder_push_bytecode_many(FunctionBuilder* self, const Bytecode *bytecode, size_t count)
@@ -78,6 +90,7 @@ void cubs_function_builder_push_bytecode_many(FunctionBuilder* self, const Bytec
     Bytecode* start = function_builder_add_n(self, count);
     memcpy((void*)start, (const void*)bytecode, count * sizeof(Bytecode));
     self->bytecodeLen += count;
+    self->_singleBytecodeRun = 0;
 }
 
 void cubs_function_builder_add_arg(FunctionBuilder *self, const CubsTypeContext *argType)
@@ -89,3 +102,730 @@ const Bytecode *cubs_function_bytecode_start(const CubsScriptFunctionPtr *header
 {
     return (const Bytecode*)&header[1];
 }
+
+#pragma region Destructor Slots
+
+static bool slot_is_marked(const uint64_t* slots, size_t slot) {
+    return (slots[slot / 64] & (1ULL << (slot % 64))) != 0;
+}
+
+static void mark_slot(uint64_t* slots, size_t slot, size_t slotCount, bool* changed) {
+    assert(slot < slotCount);
+    (void)slotCount;
+    if(!slot_is_marked(slots, slot)) {
+        slots[slot / 64] |= 1ULL << (slot % 64);
+        *changed = true;
+    }
+}
+
+/// Only primitives are stored on the stack without a full context. See `_cubs_frame_set_context_at(...)`.
+static bool context_may_need_destructor(const CubsTypeContext* context) {
+    return context != &CUBS_BOOL_CONTEXT
+        && context != &CUBS_INT_CONTEXT
+        && context != &CUBS_FLOAT_CONTEXT
+        && context != &CUBS_CHAR_CONTEXT;
+}
+
+static bool value_tag_may_need_destructor(CubsValueTag tag) {
+    return tag != cubsValueTagBool
+        && tag != cubsValueTagInt
+        && tag != cubsValueTagFloat
+        && tag != cubsValueTagChar;
+}
+
+/// Bytecode required for the argument sources following a call, 4 per bytecode.
+/// See `cubs_operands_make_call_immediate(...)` and `cubs_operands_make_call_src(...)`.
+static size_t call_args_bytecode_required(size_t argCount) {
+    if((argCount % 4) == 0) {
+        return argCount / 4;
+    }
+    return (argCount / 4) + 1;
+}
+
+/// Marks the slots the operation at `bytecode[0]` may store a value needing a destructor in.
+/// Values moved or copied from another slot are only marked if that slot already is, so
+/// this must be repeated until nothing changes.
+/// @return The number of bytecodes the operation occupies.
+static size_t mark_operation_destructor_slots(const Bytecode* bytecode, uint64_t* slots, size_t slotCount, bool* changed) {
+    const OpCode opcode = cubs_bytecode_get_opcode(bytecode[0]);
+    switch(opcode) {
+        case OpCodeLoad: {
+            const OperandsLoadUnknown unknownOperands = *(const OperandsLoadUnknown*)bytecode;
+            switch(unknownOperands.loadType) {
+                case LOAD_TYPE_IMMEDIATE: {
+                    return 1;
+                }
+                case LOAD_TYPE_IMMEDIATE_LONG: {
+                    const OperandsLoadImmediateLong operands = *(const OperandsLoadImmediateLong*)bytecode;
+                    if(value_tag_may_need_destructor((CubsValueTag)operands.immediateValueTag)) {
+                        mark_slot(slots, operands.dst, slotCount, changed);
+                    }
+                    return 2;
+                }
+                case LOAD_TYPE_DEFAULT: {
+                    const OperandsLoadDefault operands = *(const OperandsLoadDefault*)bytecode;
+                    if(value_tag_may_need_destructor((CubsValueTag)operands.tag)) {
+                        mark_slot(slots, operands.dst, slotCount, changed);
+                    }
+                    // See `execute_load(...)`
+                    switch(operands.tag) {
+                        case cubsValueTagArray:
+                        case cubsValueTagSet:
+                        case cubsValueTagOption:
+                            return 2;
+                        case cubsValueTagMap:
+                            return 3;
+                        default:
+                            return 1;
+                    }
+                }
+                case LOAD_TYPE_CLONE_FROM_PTR: {
+                    const OperandsLoadCloneFromPtr operands = *(const OperandsLoadCloneFromPtr*)bytecode;
+                    const CubsTypeContext* context = (const CubsTypeContext*)bytecode[2].value;
+                    if(context_may_need_destructor(context)) {
+                        mark_slot(slots, operands.dst, slotCount, changed);
+                    }
+                    return 3;
+                }
+                default: {
+                    unreachable();
+                }
+            }
+        }
+        case OpCodeCall: {
+            const OperandsCallUnknown operands = *(const OperandsCallUnknown*)bytecode;
+            const size_t argsBytecode = call_args_bytecode_required(operands.argCount);
+            if(operands.opType == CALL_TYPE_IMMEDIATE) {
+                const OperandsCallImmediate immediateOperands = *(const OperandsCallImmediate*)bytecode;
+                if(operands.hasReturn) {
+                    // The return type of C functions isn't known ahead of time. Neither is a script
+                    // function's that isn't set yet, such as a recursive call to the function being built.
+                    const CubsTypeContext* returnType = NULL;
+                    if(immediateOperands.funcType == cubsFunctionPtrTypeScript && bytecode[1].value != 0) {
+                        returnType = ((const CubsScriptFunctionPtr*)bytecode[1].value)->returnType;
+                    }
+                    if(returnType == NULL || context_may_need_destructor(returnType)) {
+                        mark_slot(slots, operands.returnDst, slotCount, changed);
+                    }
+                }
+                return 2 + argsBytecode;
+            } else {
+                if(operands.hasReturn) {
+                    mark_slot(slots, operands.returnDst, slotCount, changed);
+                }
+                // Followed by the inline cache
+                return 2 + argsBytecode;
+            }
+        }
+        case OpCodeSync: {
+            const OperandsSync operands = *(const OperandsSync*)bytecode;
+            if(operands.opType == SYNC_TYPE_UNSYNC) {
+                return 1;
+            }
+            return cubs_operands_sync_bytecode_required(operands.num);
+        }
+        case OpCodeMove: {
+            const OperandsMove operands = *(const OperandsMove*)bytecode;
+            if(slot_is_marked(slots, operands.src)) {
+                mark_slot(slots, operands.dst, slotCount, changed);
+            }
+            return 1;
+        }
+        case OpCodeClone: {
+            const OperandsClone operands = *(const OperandsClone*)bytecode;
+            if(slot_is_marked(slots, operands.src)) {
+                mark_slot(slots, operands.dst, slotCount, changed);
+            }
+            return 1;
+        }
+        case OpCodeMakeReference: {
+            const OperandsMakeReference operands = *(const OperandsMakeReference*)bytecode;
+            mark_slot(slots, operands.dst, slotCount, changed);
+            return 1;
+        }
+        case OpCodeIncrement: {
+            const OperandsIncrementUnknown unknownOperands = *(const OperandsIncrementUnknown*)bytecode;
+            if(unknownOperands.opType == MATH_TYPE_DST) {
+                const OperandsIncrementDst operands = *(const OperandsIncrementDst*)bytecode;
+                if(slot_is_marked(slots, operands.src)) {
+                    mark_slot(slots, operands.dst, slotCount, changed);
+                }
+            }
+            return 1;
+        }
+        case OpCodeAdd: {
+            const OperandsAddUnknown unknownOperands = *(const OperandsAddUnknown*)bytecode;
+            if(unknownOperands.opType == MATH_TYPE_DST) {
+                const OperandsAddDst operands = *(const OperandsAddDst*)bytecode;
+                if(slot_is_marked(slots, operands.src1)) {
+                    mark_slot(slots, operands.dst, slotCount, changed);
+                }
+            }
+            return 1;
+        }
+        // Dereferencing and getting members store non-owning values, which are never deinitialized.
+        // The type specialized operations and superinstructions only store primitives.
+        // Yielding moves a value out, rather than storing one.
+        case OpCodeNop:
+        case OpCodeReturn:
+        case OpCodeJump:
+        case OpCodeDeinit:
+        case OpCodeDereference:
+        case OpCodeSetReference:
+        case OpCodeGetMember:
+        case OpCodeSetMember:
+        case OpCodeEqual:
+        case OpCodeNotEqual:
+        case OpCodeLess:
+        case OpCodeGreater:
+        case OpCodeLessOrEqual:
+        case OpCodeGreaterOrEqual:
+        case OpCodeIncrementInt:
+        case OpCodeAddInt:
+        case OpCodeAddFloat:
+        case OpCodeEqualInt:
+        case OpCodeNotEqualInt:
+        case OpCodeLessInt:
+        case OpCodeGreaterInt:
+        case OpCodeLessOrEqualInt:
+        case OpCodeGreaterOrEqualInt:
+        case OpCodeLessFloat:
+        case OpCodeGreaterFloat:
+        case OpCodeLessOrEqualFloat:
+        case OpCodeGreaterOrEqualFloat:
+        case OpCodeYield:
+        case OpCodeIncrementLessIntJump:
+        case OpCodeLoadImmediateAddInt: {
+            return 1;
+        }
+        default: {
+            unreachable();
+        }
+    }
+}
+
+size_t cubs_function_builder_find_destructor_slots(const FunctionBuilder* self, uint64_t* outSlots)
+{
+    const size_t slotCount = self->stackSpaceRequired;
+    const size_t words = CUBS_DESTRUCTOR_SLOTS_WORDS(slotCount);
+    memset((void*)outSlots, 0, words * sizeof(uint64_t));
+
+    bool changed = false;
+    { // arguments are stored in order at the start of the frame
+        size_t offset = 0;
+        for(size_t i = 0; i < self->args.len; i++) {
+            const CubsTypeContext* argType = self->args.optTypes[i];
+            if(context_may_need_destructor(argType)) {
+                mark_slot(outSlots, offset, slotCount, &changed);
+            }
+            offset += ROUND_SIZE_TO_MULTIPLE_OF_8(argType->sizeOfType) / 8;
+        }
+    }
+
+    // Moves, clones, and arithmetic propagate from their sources, which may be written
+    // later in the bytecode, such as in loops.
+    do {
+        changed = false;
+        size_t i = 0;
+        while(i < self->bytecodeLen) {
+            i += mark_operation_destructor_slots(&self->bytecode[i], outSlots, slotCount, &changed);
+        }
+        assert(i == self->bytecodeLen);
+    } while(changed);
+
+    size_t usedWords = words;
+    while(usedWords > 0 && outSlots[usedWords - 1] == 0) {
+        usedWords -= 1;
+    }
+    return usedWords;
+}
+
+#pragma endregion
+
+#pragma region Inlining
+
+/// Number of bytecodes of the operation starting at `bytecode`.
+static size_t operation_bytecode_len(const Bytecode* bytecode) {
+    switch(cubs_bytecode_get_opcode(*bytecode)) {
+        case OpCodeLoad: {
+            const OperandsLoadUnknown unknownOperands = *(const OperandsLoadUnknown*)bytecode;
+            switch(unknownOperands.loadType) {
+                case LOAD_TYPE_IMMEDIATE: return 1;
+                case LOAD_TYPE_IMMEDIATE_LONG: return 2;
+                case LOAD_TYPE_DEFAULT: {
+                    const OperandsLoadDefault operands = *(const OperandsLoadDefault*)bytecode;
+                    switch(operands.tag) {
+                        case cubsValueTagArray:
+                        case cubsValueTagSet:
+                        case cubsValueTagOption:
+                            return 2;
+                        case cubsValueTagMap:
+                            return 3;
+                        default:
+                            return 1;
+                    }
+                }
+                case LOAD_TYPE_CLONE_FROM_PTR: return 3;
+                default: unreachable();
+            }
+        }
+        case OpCodeCall: {
+            const OperandsCallUnknown operands = *(const OperandsCallUnknown*)bytecode;
+            return 2 + call_args_bytecode_required(operands.argCount);
+        }
+        case OpCodeSync: {
+            const OperandsSync operands = *(const OperandsSync*)bytecode;
+            if(operands.opType == SYNC_TYPE_UNSYNC) {
+                return 1;
+            }
+            return cubs_operands_sync_bytecode_required(operands.num);
+        }
+        default: {
+            return 1;
+        }
+    }
+}
+
+/// Called for each stack slot operand of an operation, which may be rewritten through `slot`.
+/// `isWrite` is true if the operation may modify the slot, including moving out of it.
+typedef void (*VisitOperandSlot)(void* context, uint16_t* slot, bool isWrite);
+
+/// Copies the bit field `field` of `operands` out, visits it, and writes it back.
+#define VISIT_OPERAND_SLOT(operands, field, isWrite) do { \
+    uint16_t _slot = (uint16_t)(operands).field; \
+    visit(context, &_slot, isWrite); \
+    (operands).field = _slot; \
+} while(0)
+
+/// Visits every stack slot operand of the operation at `bytecode`, other than a return.
+/// Only operations that access nothing but their own operands, and never jump, call, or
+/// take references to slots, can be inlined.
+/// @return The number of bytecodes the operation occupies, or 0 if it can't be inlined.
+static size_t visit_inlinable_operation_slots(Bytecode* bytecode, VisitOperandSlot visit, void* context) {
+    const OpCode opcode = cubs_bytecode_get_opcode(*bytecode);
+    switch(opcode) {
+        case OpCodeNop: {
+            return 1;
+        }
+        case OpCodeLoad: {
+            const OperandsLoadUnknown unknownOperands = *(const OperandsLoadUnknown*)bytecode;
+            switch(unknownOperands.loadType) {
+                case LOAD_TYPE_IMMEDIATE: {
+                    OperandsLoadImmediate operands = *(const OperandsLoadImmediate*)bytecode;
+                    VISIT_OPERAND_SLOT(operands, dst, true);
+                    *(OperandsLoadImmediate*)bytecode = operands;
+                    return 1;
+                }
+                case LOAD_TYPE_IMMEDIATE_LONG: {
+                    OperandsLoadImmediateLong operands = *(const OperandsLoadImmediateLong*)bytecode;
+                    VISIT_OPERAND_SLOT(operands, dst, true);
+                    *(OperandsLoadImmediateLong*)bytecode = operands;
+                    return 2;
+                }
+                case LOAD_TYPE_CLONE_FROM_PTR: {
+                    OperandsLoadCloneFromPtr operands = *(const OperandsLoadCloneFromPtr*)bytecode;
+                    VISIT_OPERAND_SLOT(operands, dst, true);
+                    *(OperandsLoadCloneFromPtr*)bytecode = operands;
+                    return 3;
+                }
+                default: {
+                    return 0;
+                }
+            }
+        }
+        case OpCodeMove: {
+            OperandsMove operands = *(const OperandsMove*)bytecode;
+            VISIT_OPERAND_SLOT(operands, dst, true);
+            VISIT_OPERAND_SLOT(operands, src, true);
+            *(OperandsMove*)bytecode = operands;
+            return 1;
+        }
+        case OpCodeClone: {
+            OperandsClone operands = *(const OperandsClone*)bytecode;
+            VISIT_OPERAND_SLOT(operands, dst, true);
+            VISIT_OPERAND_SLOT(operands, src, false);
+            *(OperandsClone*)bytecode = operands;
+            return 1;
+        }
+        case OpCodeGetMember: {
+            OperandsGetMember operands = *(const OperandsGetMember*)bytecode;
+            VISIT_OPERAND_SLOT(operands, dst, true);
+            VISIT_OPERAND_SLOT(operands, src, false);
+            *(OperandsGetMember*)bytecode = operands;
+            return 1;
+        }
+        case OpCodeSetMember: {
+            OperandsSetMember operands = *(const OperandsSetMember*)bytecode;
+            VISIT_OPERAND_SLOT(operands, dst, true);
+            VISIT_OPERAND_SLOT(operands, src, true);
+            *(OperandsSetMember*)bytecode = operands;
+            return 1;
+        }
+        case OpCodeEqual:
+        case OpCodeNotEqual:
+        case OpCodeLess:
+        case OpCodeGreater:
+        case OpCodeLessOrEqual:
+        case OpCodeGreaterOrEqual:
+        case OpCodeEqualInt:
+        case OpCodeNotEqualInt:
+        case OpCodeLessInt:
+        case OpCodeGreaterInt:
+        case OpCodeLessOrEqualInt:
+        case OpCodeGreaterOrEqualInt:
+        case OpCodeLessFloat:
+        case OpCodeGreaterFloat:
+        case OpCodeLessOrEqualFloat:
+        case OpCodeGreaterOrEqualFloat: {
+            OperandsUnknownCompare operands = *(const OperandsUnknownCompare*)bytecode;
+            VISIT_OPERAND_SLOT(operands, dst, true);
+            VISIT_OPERAND_SLOT(operands, src1, false);
+            VISIT_OPERAND_SLOT(operands, src2, false);
+            *(OperandsUnknownCompare*)bytecode = operands;
+            return 1;
+        }
+        case OpCodeIncrement:
+        case OpCodeIncrementInt: {
+            const OperandsIncrementUnknown unknownOperands = *(const OperandsIncrementUnknown*)bytecode;
+            if(unknownOperands.opType == MATH_TYPE_DST) {
+                OperandsIncrementDst operands = *(const OperandsIncrementDst*)bytecode;
+                VISIT_OPERAND_SLOT(operands, dst, true);
+                VISIT_OPERAND_SLOT(operands, src, false);
+                *(OperandsIncrementDst*)bytecode = operands;
+            } else {
+                OperandsIncrementAssign operands = *(const OperandsIncrementAssign*)bytecode;
+                VISIT_OPERAND_SLOT(operands, src, true);
+                *(OperandsIncrementAssign*)bytecode = operands;
+            }
+            return 1;
+        }
+        case OpCodeAdd:
+        case OpCodeAddInt:
+        case OpCodeAddFloat: {
+            const OperandsAddUnknown unknownOperands = *(const OperandsAddUnknown*)bytecode;
+            if(unknownOperands.opType == MATH_TYPE_DST) {
+                OperandsAddDst operands = *(const OperandsAddDst*)bytecode;
+                VISIT_OPERAND_SLOT(operands, dst, true);
+                VISIT_OPERAND_SLOT(operands, src1, false);
+                VISIT_OPERAND_SLOT(operands, src2, false);
+                *(OperandsAddDst*)bytecode = operands;
+            } else {
+                OperandsAddAssign operands = *(const OperandsAddAssign*)bytecode;
+                VISIT_OPERAND_SLOT(operands, src1, true);
+                VISIT_OPERAND_SLOT(operands, src2, false);
+                *(OperandsAddAssign*)bytecode = operands;
+            }
+            return 1;
+        }
+        case OpCodeLoadImmediateAddInt: {
+            // The add it was fused with follows, and is visited on it's own
+            OperandsLoadImmediateAddInt operands = *(const OperandsLoadImmediateAddInt*)bytecode;
+            VISIT_OPERAND_SLOT(operands, dst, true);
+            *(OperandsLoadImmediateAddInt*)bytecode = operands;
+            return 1;
+        }
+        default: {
+            return 0;
+        }
+    }
+}
+
+#undef VISIT_OPERAND_SLOT
+
+static void ignore_slot(void* context, uint16_t* slot, bool isWrite) {
+    (void)context;
+    (void)slot;
+    (void)isWrite;
+}
+
+/// Whether calls to `callee` can be replaced with it's bytecode. Its values must all be trivially
+/// destructible, as they're no longer unwound when it returns, and it's arguments clonable, as
+/// they may be copied into the caller's frame. It must end in it's only return.
+static bool can_inline(const CubsScriptFunctionPtr* callee, size_t maxCalleeBytecode) {
+    if(callee->_bytecodeCount > maxCalleeBytecode || callee->_destructorSlots[0] != 0) {
+        return false;
+    }
+    if(callee->returnType != NULL && callee->returnType->clone.func.externC == NULL) {
+        return false;
+    }
+    for(size_t i = 0; i < callee->argsLen; i++) {
+        if(callee->argsTypes[i]->clone.func.externC == NULL) {
+            return false;
+        }
+    }
+
+    const Bytecode* bytecode = cubs_function_bytecode_start(callee);
+    const size_t returnIndex = callee->_bytecodeCount - 1;
+    if(cubs_bytecode_get_opcode(bytecode[returnIndex]) != OpCodeReturn) {
+        return false;
+    }
+    size_t i = 0;
+    while(i < returnIndex) {
+        // Visiting without rewriting, so a copy is fine
+        Bytecode operation[3];
+        memcpy((void*)operation, (const void*)&bytecode[i], sizeof(Bytecode) * (returnIndex - i < 3 ? returnIndex - i : 3));
+        const size_t len = visit_inlinable_operation_slots(operation, ignore_slot, NULL);
+        if(len == 0) {
+            return false;
+        }
+        i += len;
+    }
+    return i == returnIndex;
+}
+
+/// Where the stack slots of an inlined callee end up in the caller's frame.
+typedef struct InlineSlots {
+    /// Callee slots below this are arguments.
+    size_t argSlots;
+    /// For each argument slot, the caller slot it's read from directly, or `UINT16_MAX`
+    /// if the callee modifies it, in which case it's copied to `base` + the slot.
+    uint16_t* argSources;
+    /// The caller's slots from this onward are the callee's own.
+    uint16_t base;
+} InlineSlots;
+
+static void mark_written_arg_slot(void* context, uint16_t* slot, bool isWrite) {
+    InlineSlots* self = (InlineSlots*)context;
+    if(isWrite && *slot < self->argSlots) {
+        self->argSources[*slot] = UINT16_MAX;
+    }
+}
+
+static uint16_t inline_slot(const InlineSlots* self, uint16_t slot) {
+    if(slot < self->argSlots && self->argSources[slot] != UINT16_MAX) {
+        return self->argSources[slot];
+    }
+    return (uint16_t)(self->base + slot);
+}
+
+static void remap_inline_slot(void* context, uint16_t* slot, bool isWrite) {
+    (void)isWrite;
+    *slot = inline_slot((const InlineSlots*)context, *slot);
+}
+
+/// Appends the bytecode of `callee` to `out` in place of the call at `call`, with it's slots
+/// starting at `base` in the caller's frame.
+static void inline_call(FunctionBuilder* out, const Bytecode* call, const CubsScriptFunctionPtr* callee, uint16_t base) {
+    const OperandsCallImmediate operands = *(const OperandsCallImmediate*)call;
+    assert(operands.argCount == callee->argsLen);
+    const uint16_t* argsSrcs = (const uint16_t*)&call[2];
+
+    size_t argSlots = 0;
+    for(size_t i = 0; i < callee->argsLen; i++) {
+        argSlots += ROUND_SIZE_TO_MULTIPLE_OF_8(callee->argsTypes[i]->sizeOfType) / 8;
+    }
+    InlineSlots slots = {.argSlots = argSlots, .argSources = NULL, .base = base};
+    if(argSlots > 0) {
+        slots.argSources = MALLOC_TYPE_ARRAY(uint16_t, argSlots);
+        size_t offset = 0;
+        for(size_t i = 0; i < callee->argsLen; i++) {
+            const size_t argLen = ROUND_SIZE_TO_MULTIPLE_OF_8(callee->argsTypes[i]->sizeOfType) / 8;
+            for(size_t j = 0; j < argLen; j++) {
+                slots.argSources[offset + j] = (uint16_t)(argsSrcs[i] + j);
+            }
+            offset += argLen;
+        }
+    }
+
+    const Bytecode* calleeBytecode = cubs_function_bytecode_start(callee);
+    const size_t returnIndex = callee->_bytecodeCount - 1;
+
+    { // Arguments the callee modifies are copied, so the caller's values are unaffected
+        if(returnIndex > 0) {
+            Bytecode* scratch = MALLOC_TYPE_ARRAY(Bytecode, returnIndex);
+            memcpy((void*)scratch, (const void*)calleeBytecode, sizeof(Bytecode) * returnIndex);
+            size_t i = 0;
+            while(i < returnIndex) {
+                i += visit_inlinable_operation_slots(&scratch[i], mark_written_arg_slot, (void*)&slots);
+            }
+            FREE_TYPE_ARRAY(Bytecode, scratch, returnIndex);
+        }
+
+        size_t offset = 0;
+        for(size_t argIndex = 0; argIndex < callee->argsLen; argIndex++) {
+            const size_t argLen = ROUND_SIZE_TO_MULTIPLE_OF_8(callee->argsTypes[argIndex]->sizeOfType) / 8;
+            bool written = false;
+            for(size_t j = 0; j < argLen; j++) {
+                written = written || slots.argSources[offset + j] == UINT16_MAX;
+            }
+            if(written) {
+                for(size_t j = 0; j < argLen; j++) {
+                    slots.argSources[offset + j] = UINT16_MAX;
+                }
+                const Bytecode clone = cubs_operands_make_clone((uint16_t)(base + offset), argsSrcs[argIndex]);
+                cubs_function_builder_push_bytecode_many(out, &clone, 1);
+            }
+            offset += argLen;
+        }
+    }
+
+    if(returnIndex > 0) { // The body, other than the return
+        cubs_function_builder_push_bytecode_many(out, calleeBytecode, returnIndex);
+        Bytecode* body = &out->bytecode[out->bytecodeLen - returnIndex];
+        size_t i = 0;
+        while(i < returnIndex) {
+            i += visit_inlinable_operation_slots(&body[i], remap_inline_slot, (void*)&slots);
+        }
+    }
+
+    const OperandsReturn returnOperands = *(const OperandsReturn*)&calleeBytecode[returnIndex];
+    if(operands.hasReturn && returnOperands.hasReturn) {
+        const uint16_t returnSrc = inline_slot(&slots, (uint16_t)returnOperands.returnSrc);
+        if(returnSrc != operands.returnDst) {
+            // Values in the callee's own slots can be moved out, but arguments are still the caller's
+            const Bytecode ret = returnSrc >= base
+                ? cubs_operands_make_move((uint16_t)operands.returnDst, returnSrc)
+                : cubs_operands_make_clone((uint16_t)operands.returnDst, returnSrc);
+            cubs_function_builder_push_bytecode_many(out, &ret, 1);
+        }
+    }
+
+    if(argSlots > 0) {
+        FREE_TYPE_ARRAY(uint16_t, slots.argSources, argSlots);
+    }
+}
+
+/// If the operation at `bytecode` is an immediate call to a script function that can be inlined, returns it.
+/// The callee's slots go after the caller's `callerFrameLength`, so together they must fit in a frame, or
+/// the remapped slots would overflow the stack operands.
+static const CubsScriptFunctionPtr* inline_call_target(const Bytecode* bytecode, size_t maxCalleeBytecode, size_t callerFrameLength) {
+    if(cubs_bytecode_get_opcode(*bytecode) != OpCodeCall) {
+        return NULL;
+    }
+    const OperandsCallImmediate operands = *(const OperandsCallImmediate*)bytecode;
+    // Recursive calls to the function being built don't have the function set yet. Tail calls return
+    // from the caller, which an inlined callee's return doesn't.
+    if(operands.opType != CALL_TYPE_IMMEDIATE || operands.funcType != cubsFunctionPtrTypeScript || bytecode[1].value == 0 || operands.isTailCall) {
+        return NULL;
+    }
+    const CubsScriptFunctionPtr* callee = (const CubsScriptFunctionPtr*)bytecode[1].value;
+    if((callerFrameLength + callee->_stackSpaceRequired) > MAX_FRAME_LENGTH || !can_inline(callee, maxCalleeBytecode)) {
+        return NULL;
+    }
+    const OperandsReturn returnOperands = *(const OperandsReturn*)&cubs_function_bytecode_start(callee)[callee->_bytecodeCount - 1];
+    if(operands.hasReturn && !returnOperands.hasReturn) {
+        return NULL;
+    }
+    return callee;
+}
+
+void cubs_function_builder_inline_calls(FunctionBuilder *self, size_t maxCalleeBytecode)
+{
+    if(maxCalleeBytecode == 0) {
+        return;
+    }
+
+    bool anyInlined = false;
+    for(size_t i = 0; i < self->bytecodeLen; i += operation_bytecode_len(&self->bytecode[i])) {
+        if(inline_call_target(&self->bytecode[i], maxCalleeBytecode, self->stackSpaceRequired) != NULL) {
+            anyInlined = true;
+            break;
+        }
+    }
+    if(!anyInlined) {
+        return;
+    }
+
+    // Every inlined callee's slots start after the caller's own. Calls don't overlap, so they share them.
+    const uint16_t base = (uint16_t)self->stackSpaceRequired;
+    size_t frameSize = self->stackSpaceRequired;
+
+    // Maps the start of each of the caller's operations to where it ends up, for jumps
+    const size_t newIndicesLen = self->bytecodeLen + 1;
+    size_t* newIndices = MALLOC_TYPE_ARRAY(size_t, newIndicesLen);
+    FunctionBuilder out = {0};
+    size_t i = 0;
+    while(i < self->bytecodeLen) {
+        const Bytecode* operation = &self->bytecode[i];
+        const size_t len = operation_bytecode_len(operation);
+        newIndices[i] = out.bytecodeLen;
+
+        const CubsScriptFunctionPtr* callee = inline_call_target(operation, maxCalleeBytecode, self->stackSpaceRequired);
+        if(callee != NULL) {
+            inline_call(&out, operation, callee, base);
+            if(frameSize < ((size_t)base + callee->_stackSpaceRequired)) {
+                frameSize = (size_t)base + callee->_stackSpaceRequired;
+            }
+        } else {
+            cubs_function_builder_push_bytecode_many(&out, operation, len);
+        }
+        i += len;
+    }
+    newIndices[self->bytecodeLen] = out.bytecodeLen;
+
+    // Jumps are relative to themselves
+    i = 0;
+    while(i < self->bytecodeLen) {
+        const Bytecode* operation = &self->bytecode[i];
+        if(cubs_bytecode_get_opcode(*operation) == OpCodeJump) {
+            OperandsJump operands = *(const OperandsJump*)operation;
+            const int64_t target = (int64_t)i + (int64_t)operands.jumpAmount;
+            assert(target >= 0 && target <= (int64_t)self->bytecodeLen);
+            operands.jumpAmount = (int64_t)newIndices[target] - (int64_t)newIndices[i];
+            *(OperandsJump*)&out.bytecode[newIndices[i]] = operands;
+        }
+        i += operation_bytecode_len(operation);
+    }
+
+    FREE_TYPE_ARRAY(size_t, newIndices, newIndicesLen);
+    cubs_free(self->bytecode, self->bytecodeCapacity * sizeof(Bytecode), _Alignof(Bytecode));
+    self->bytecode = out.bytecode;
+    self->bytecodeLen = out.bytecodeLen;
+    self->bytecodeCapacity = out.bytecodeCapacity;
+    self->stackSpaceRequired = frameSize;
+    self->_singleBytecodeRun = 0;
+}
+
+#pragma endregion
+
+#pragma region Tail Calls
+
+/// Whether the call at `call`, immediately followed by `ret`, returns exactly what the call does, and
+/// can safely be made a tail call. Only immediate calls are considered, as the callee must be known
+/// to return the same type, and to not take references, which would point into the unwound frame.
+static bool can_tail_call(const FunctionBuilder* self, const Bytecode* call, OperandsReturn ret) {
+    const OperandsCallImmediate operands = *(const OperandsCallImmediate*)call;
+    if(operands.opType != CALL_TYPE_IMMEDIATE || operands.isTailCall) {
+        return false;
+    }
+    if(operands.hasReturn != ret.hasReturn || (operands.hasReturn && operands.returnDst != ret.returnSrc)) {
+        return false;
+    }
+    if(operands.funcType != cubsFunctionPtrTypeScript) {
+        // C functions finish executing before the frame is unwound, but may return nothing
+        return operands.hasReturn;
+    }
+
+    const CubsScriptFunctionPtr* callee = (const CubsScriptFunctionPtr*)call[1].value;
+    // Recursive calls to the function being built don't have the function set yet
+    const CubsTypeContext* returnType = callee == NULL ? self->optReturnType : callee->returnType;
+    const CubsTypeContext* const* argsTypes = callee == NULL ? self->args.optTypes : callee->argsTypes;
+    if(returnType != self->optReturnType) {
+        return false;
+    }
+    for(size_t i = 0; i < operands.argCount; i++) {
+        if(argsTypes[i] == &CUBS_CONST_REF_CONTEXT || argsTypes[i] == &CUBS_MUT_REF_CONTEXT) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void cubs_function_builder_make_tail_calls(FunctionBuilder *self)
+{
+    size_t i = 0;
+    while(i < self->bytecodeLen) {
+        Bytecode* operation = &self->bytecode[i];
+        const size_t len = operation_bytecode_len(operation);
+        if(cubs_bytecode_get_opcode(*operation) == OpCodeCall && (i + len) < self->bytecodeLen) {
+            const Bytecode next = self->bytecode[i + len];
+            if(cubs_bytecode_get_opcode(next) == OpCodeReturn && can_tail_call(self, operation, *(const OperandsReturn*)&next)) {
+                // The return is left in place, as jumps may still target it
+                cubs_operands_make_tail_call(operation);
+            }
+        }
+        i += len;
+    }
+}
+
+#pragma endregion
@@ -30,10 +30,19 @@ typedef struct FunctionBuilder {
     Bytecode* bytecode;
     size_t bytecodeLen;
     size_t bytecodeCapacity;
+    /// How many single bytecode operations were pushed in a row by
+    /// `cubs_function_builder_push_bytecode(...)`. Only these are considered for
+    /// fusing into superinstructions, as multi bytecode operations contain
+    /// immediate data that could be mistaken for operations.
+    size_t _singleBytecodeRun;
 } FunctionBuilder;
 
 void cubs_function_builder_deinit(FunctionBuilder* self);
 
+/// `bytecode` must be an entire single bytecode operation. Multi bytecode operations must use
+/// `cubs_function_builder_push_bytecode_many(...)`.
+/// Common sequences of operations will be fused into superinstructions, 
+/// see `cubs_operands_try_fuse(...)`. This doesn't change the bytecode length.
 void cubs_function_builder_push_bytecode(FunctionBuilder* self, Bytecode bytecode);
 
 /// `count` is the number of bytecodes to copy
@@ -48,4 +57,26 @@ void cubs_function_builder_add_arg(FunctionBuilder* self, const CubsTypeContext*
 /// Defined in `src/program/program.c`
 extern CubsScriptFunctionPtr* cubs_function_builder_build(FunctionBuilder* self, CubsProgram* program);
 
-const Bytecode* cubs_function_bytecode_start(const CubsScriptFunctionPtr* header);
\ No newline at end of file
+const Bytecode* cubs_function_bytecode_start(const CubsScriptFunctionPtr* header);
+
+/// Number of words in a bitmap of `slotCount` stack slots.
+#define CUBS_DESTRUCTOR_SLOTS_WORDS(slotCount) (((slotCount) + 63) / 64)
+
+/// Finds every stack slot that the function may ever store an owned non-primitive value in,
+/// from the argument types and the bytecode, setting the slot's bit in `outSlots`. Any slot not
+/// found is guaranteed to never need a destructor, so unwinding can skip it.
+/// `outSlots` must have space for `CUBS_DESTRUCTOR_SLOTS_WORDS(self->stackSpaceRequired)` words.
+/// @return The number of words up to and including the last word with any slot set.
+size_t cubs_function_builder_find_destructor_slots(const FunctionBuilder* self, uint64_t* outSlots);
+
+/// Replaces immediate calls to script functions with at most `maxCalleeBytecode` bytecodes with the
+/// callee's bytecode, with it's stack slots placed after the caller's own. Only callees that end in
+/// their only return, don't jump or call, and never hold values needing a destructor are inlined.
+/// Called by `cubs_function_builder_build(...)` with the program's inline threshold.
+void cubs_function_builder_inline_calls(FunctionBuilder* self, size_t maxCalleeBytecode);
+
+/// Makes every immediate call that is directly followed by returning it's result, or by returning nothing
+/// from a call that has no result, a tail call. See `cubs_operands_make_tail_call(...)`. Only callees known
+/// to return the same type, and that take no references, are tail called.
+/// Called by `cubs_function_builder_build(...)` after inlining.
+void cubs_function_builder_make_tail_calls(FunctionBuilder* self);
\ No newline at end of file
@@ -11,6 +11,7 @@ const c = @cImport({
     @cInclude("interpreter/function_definition.h");
     @cInclude("interpreter/bytecode.h");
     @cInclude("interpreter/operations.h");
+    @cInclude("interpreter/stack.h");
     @cInclude("primitives/context.h");
     @cInclude("primitives/string/string.h");
     @cInclude("program/program.h");
@@ -324,6 +325,51 @@ test "call through cubs function script return value" {
     try expect(retContext == TypeContext.auto(i64));
 }
 
+test "call batch" {
+    var program = c.cubs_program_init(.{});
+    defer c.cubs_program_deinit(&program);
+
+    // fn add(a: int, b: int) int { return a + b; }
+    var builder = c.FunctionBuilder{ .stackSpaceRequired = 3, .optReturnType = &c.CUBS_INT_CONTEXT };
+    defer c.cubs_function_builder_deinit(&builder);
+
+    c.cubs_function_builder_add_arg(&builder, &c.CUBS_INT_CONTEXT);
+    c.cubs_function_builder_add_arg(&builder, &c.CUBS_INT_CONTEXT);
+    c.cubs_function_builder_push_bytecode(&builder, c.operands_make_add_dst(false, 2, 0, 1));
+    c.cubs_function_builder_push_bytecode(&builder, c.operands_make_return(true, 2));
+
+    const func = CubsFunction{ .func = .{ .script = @ptrCast(c.cubs_function_builder_build(&builder, &program)) }, .funcType = .Script };
+
+    var results: [4]i64 = undefined;
+    var completed: usize = undefined;
+    { // array of structs
+        const Entity = extern struct { a: i64, health: f64, b: i64 };
+        const entities = [4]Entity{
+            .{ .a = 1, .health = 0.5, .b = 10 },
+            .{ .a = 2, .health = 0.5, .b = 20 },
+            .{ .a = 3, .health = 0.5, .b = 30 },
+            .{ .a = 4, .health = 0.5, .b = 40 },
+        };
+        const argArrays = [2]*const anyopaque{ @ptrCast(&entities[0].a), @ptrCast(&entities[0].b) };
+        const argStrides = [2]usize{ @sizeOf(Entity), @sizeOf(Entity) };
+        try expect(func.cubs_function_call_batch(&argArrays, &argStrides, entities.len, @ptrCast(&results), &completed) == 0);
+        try expect(completed == entities.len);
+        for (entities, results) |entity, result| {
+            try expect(result == entity.a + entity.b);
+        }
+    }
+    { // separate arrays, stopping at the call that overflows
+        const as = [4]i64{ 5, 6, std.math.maxInt(i64), 8 };
+        const bs = [4]i64{ 50, 60, 1, 80 };
+        const argArrays = [2]*const anyopaque{ @ptrCast(&as), @ptrCast(&bs) };
+        const argStrides = [2]usize{ @sizeOf(i64), @sizeOf(i64) };
+        try expect(func.cubs_function_call_batch(&argArrays, &argStrides, as.len, @ptrCast(&results), &completed) == c.cubsProgramRuntimeErrorAdditionIntegerOverflow);
+        try expect(completed == 2);
+        try expect(results[0] == 55);
+        try expect(results[1] == 66);
+    }
+}
+
 test "sanity call through cubs function return complex type" {
     var program = c.cubs_program_init(.{});
     defer c.cubs_program_deinit(&program);
@@ -354,3 +400,477 @@ test "sanity call through cubs function return complex type" {
     try expect(retVal.eqlSlice("well hello to this truly glorious world!"));
     try expect(retContext == TypeContext.auto(String));
 }
+
+/// Pushing as "many" bytecode isn't considered for fusing into superinstructions
+fn pushMaybeFused(builder: *c.FunctionBuilder, bytecode: c.Bytecode, fuse: bool) void {
+    if (fuse) {
+        c.cubs_function_builder_push_bytecode(builder, bytecode);
+    } else {
+        c.cubs_function_builder_push_bytecode_many(builder, &bytecode, 1);
+    }
+}
+
+test "superinstruction increment less jump" {
+    var program = c.cubs_program_init(.{});
+    defer c.cubs_program_deinit(&program);
+
+    var results: [2]i64 = undefined;
+    for ([_]bool{ false, true }, 0..) |fuse, i| {
+        var builder = c.FunctionBuilder{ .stackSpaceRequired = 4, .optReturnType = &c.CUBS_INT_CONTEXT };
+        defer c.cubs_function_builder_deinit(&builder);
+
+        c.cubs_function_builder_push_bytecode(&builder, c.operands_make_load_immediate(c.LOAD_IMMEDIATE_INT, 0, 0));
+        c.cubs_function_builder_push_bytecode(&builder, c.operands_make_load_immediate(c.LOAD_IMMEDIATE_INT, 1, 100));
+        c.cubs_function_builder_push_bytecode(&builder, c.operands_make_load_immediate(c.LOAD_IMMEDIATE_INT, 2, 0));
+        // loop start
+        pushMaybeFused(&builder, c.cubs_operands_specialize(c.operands_make_add_assign(false, 2, 0), &c.CUBS_INT_CONTEXT), fuse);
+        pushMaybeFused(&builder, c.cubs_operands_specialize(c.operands_make_increment_assign(false, 0), &c.CUBS_INT_CONTEXT), fuse);
+        pushMaybeFused(&builder, c.cubs_operands_specialize(c.cubs_operands_make_compare(c.COMPARE_OP_LESS, 3, 0, 1), &c.CUBS_INT_CONTEXT), fuse);
+        pushMaybeFused(&builder, c.cubs_operands_make_jump(c.JUMP_TYPE_IF_TRUE, -3, 3), fuse);
+        // loop end
+        c.cubs_function_builder_push_bytecode(&builder, c.operands_make_return(true, 2));
+
+        // Fusing never changes the bytecode length
+        try expect(builder.bytecodeLen == 8);
+        try expect((c.cubs_bytecode_get_opcode(builder.bytecode[2]) == c.OpCodeLoadImmediateAddInt) == fuse);
+        try expect((c.cubs_bytecode_get_opcode(builder.bytecode[4]) == c.OpCodeIncrementLessIntJump) == fuse);
+
+        const func = c.cubs_function_builder_build(&builder, &program);
+
+        var retContext: *const c.CubsTypeContext = undefined;
+        try expect(c.cubs_interpreter_execute_function(func, @ptrCast(&results[i]), @ptrCast(&retContext)) == 0);
+        try expect(retContext == &c.CUBS_INT_CONTEXT);
+    }
+
+    try expect(results[0] == 4950);
+    try expect(results[0] == results[1]);
+}
+
+test "superinstruction load immediate add" {
+    var program = c.cubs_program_init(.{});
+    defer c.cubs_program_deinit(&program);
+
+    var results: [2]i64 = undefined;
+    for ([_]bool{ false, true }, 0..) |fuse, i| {
+        var builder = c.FunctionBuilder{ .stackSpaceRequired = 3, .optReturnType = &c.CUBS_INT_CONTEXT };
+        defer c.cubs_function_builder_deinit(&builder);
+
+        pushMaybeFused(&builder, c.operands_make_load_immediate(c.LOAD_IMMEDIATE_INT, 0, 10), fuse);
+        pushMaybeFused(&builder, c.operands_make_load_immediate(c.LOAD_IMMEDIATE_INT, 1, -5), fuse);
+        pushMaybeFused(&builder, c.cubs_operands_specialize(c.operands_make_add_dst(false, 2, 0, 1), &c.CUBS_INT_CONTEXT), fuse);
+        c.cubs_function_builder_push_bytecode(&builder, c.operands_make_return(true, 2));
+
+        try expect(builder.bytecodeLen == 4);
+        try expect((c.cubs_bytecode_get_opcode(builder.bytecode[1]) == c.OpCodeLoadImmediateAddInt) == fuse);
+
+        const func = c.cubs_function_builder_build(&builder, &program);
+
+        var retContext: *const c.CubsTypeContext = undefined;
+        try expect(c.cubs_interpreter_execute_function(func, @ptrCast(&results[i]), @ptrCast(&retContext)) == 0);
+        try expect(retContext == &c.CUBS_INT_CONTEXT);
+    }
+
+    try expect(results[0] == 5);
+    try expect(results[0] == results[1]);
+
+    { // Adds that can overflow aren't fused, as the superinstruction reports overflow
+        const bytecode = [_]c.Bytecode{
+            c.operands_make_load_immediate(c.LOAD_IMMEDIATE_INT, 1, -5),
+            c.cubs_operands_specialize(c.operands_make_add_dst(true, 2, 0, 1), &c.CUBS_INT_CONTEXT),
+        };
+        var fused: c.Bytecode = undefined;
+        var fusedIndex: usize = undefined;
+        try expect(!c.cubs_operands_try_fuse(&bytecode, bytecode.len, &fused, &fusedIndex));
+    }
+}
+
+test "destructor slots" {
+    var program = c.cubs_program_init(.{});
+    defer c.cubs_program_deinit(&program);
+
+    {
+        var builder = c.FunctionBuilder{ .stackSpaceRequired = 100 };
+        defer c.cubs_function_builder_deinit(&builder);
+
+        c.cubs_function_builder_push_bytecode(&builder, c.operands_make_load_immediate(c.LOAD_IMMEDIATE_INT, 99, 1));
+        c.cubs_function_builder_push_bytecode(&builder, c.operands_make_add_dst(false, 50, 99, 99));
+        c.cubs_function_builder_push_bytecode(&builder, c.operands_make_return(false, 0));
+
+        const func = c.cubs_function_builder_build(&builder, &program);
+        // Only ints, so unwinding has nothing to check
+        try expect(func.*._destructorSlots[0] == 0);
+        try expect(c.cubs_interpreter_execute_function(func, null, null) == 0);
+    }
+    {
+        var builder = c.FunctionBuilder{ .stackSpaceRequired = 200, .optReturnType = &c.CUBS_INT_CONTEXT };
+        defer c.cubs_function_builder_deinit(&builder);
+
+        c.cubs_function_builder_add_arg(&builder, &c.CUBS_STRING_CONTEXT);
+        // Moves from a slot that is only written after it in the bytecode, such as in a loop
+        c.cubs_function_builder_push_bytecode(&builder, c.cubs_operands_make_move(150, 4));
+        var loadDefault: c.Bytecode = undefined;
+        c.operands_make_load_default(&loadDefault, c.cubsValueTagString, 4, null, null);
+        c.cubs_function_builder_push_bytecode(&builder, loadDefault);
+        c.cubs_function_builder_push_bytecode(&builder, c.operands_make_load_immediate(c.LOAD_IMMEDIATE_INT, 8, 1));
+        c.cubs_function_builder_push_bytecode(&builder, c.operands_make_return(true, 8));
+
+        const func = c.cubs_function_builder_build(&builder, &program);
+        const slots = func.*._destructorSlots;
+        try expect(slots[0] == 3);
+        try expect(slots[1] == ((1 << 0) | (1 << 4)));
+        try expect(slots[2] == 0);
+        try expect(slots[3] == (1 << (150 - 128)));
+
+        var arg = String.initUnchecked("a string long enough to need a heap allocation");
+        c.cubs_interpreter_push_script_function_arg(@ptrCast(&arg), &c.CUBS_STRING_CONTEXT, 0);
+
+        var result: i64 = undefined;
+        var retContext: *const c.CubsTypeContext = undefined;
+        // The argument is deinitialized on return, which the testing allocator checks
+        try expect(c.cubs_interpreter_execute_function(func, @ptrCast(&result), @ptrCast(&retContext)) == 0);
+        try expect(result == 1);
+    }
+}
+
+test "deep script recursion" {
+    var program = c.cubs_program_init(.{});
+    defer c.cubs_program_deinit(&program);
+
+    // fn sum(n: int) int { if(n == 0) { return n; } return n + sum(n - 1); }
+    var builder = c.FunctionBuilder{ .stackSpaceRequired = 6, .optReturnType = &c.CUBS_INT_CONTEXT };
+    defer c.cubs_function_builder_deinit(&builder);
+
+    c.cubs_function_builder_add_arg(&builder, &c.CUBS_INT_CONTEXT);
+    c.cubs_function_builder_push_bytecode(&builder, c.operands_make_load_immediate(c.LOAD_IMMEDIATE_INT, 1, 0));
+    c.cubs_function_builder_push_bytecode(&builder, c.cubs_operands_make_compare(c.COMPARE_OP_EQUAL, 2, 0, 1));
+    c.cubs_function_builder_push_bytecode(&builder, c.cubs_operands_make_jump(c.JUMP_TYPE_IF_FALSE, 2, 2));
+    c.cubs_function_builder_push_bytecode(&builder, c.operands_make_return(true, 0));
+    c.cubs_function_builder_push_bytecode(&builder, c.operands_make_load_immediate(c.LOAD_IMMEDIATE_INT, 1, -1));
+    c.cubs_function_builder_push_bytecode(&builder, c.operands_make_add_dst(false, 3, 0, 1));
+    {
+        // The function can't reference itself until it's built, so it's set below
+        const placeholder = c.CubsFunction{ .func = .{ .script = null }, .funcType = c.cubsFunctionPtrTypeScript };
+        const args = [1]u16{3};
+        var call: [3]c.Bytecode = undefined;
+        c.cubs_operands_make_call_immediate(&call, 3, 1, &args, true, 4, placeholder);
+        c.cubs_function_builder_push_bytecode_many(&builder, &call, 3);
+    }
+    c.cubs_function_builder_push_bytecode(&builder, c.operands_make_add_dst(false, 5, 0, 4));
+    c.cubs_function_builder_push_bytecode(&builder, c.operands_make_return(true, 5));
+
+    const func = c.cubs_function_builder_build(&builder, &program);
+    @constCast(c.cubs_function_bytecode_start(func))[7].value = @intFromPtr(func);
+
+    // Deep enough to overflow the native stack if each call recursed through the C interpreter
+    const n: i64 = 50000;
+    c.cubs_interpreter_push_script_function_arg(@ptrCast(&n), &c.CUBS_INT_CONTEXT, 0);
+
+    var result: i64 = undefined;
+    var retContext: *const c.CubsTypeContext = undefined;
+    try expect(c.cubs_interpreter_execute_function(func, @ptrCast(&result), @ptrCast(&retContext)) == 0);
+    try expect(result == @divExact(n * (n + 1), 2));
+    try expect(retContext == &c.CUBS_INT_CONTEXT);
+}
+
+test "indirect call inline cache" {
+    var program = c.cubs_program_init(.{});
+    defer c.cubs_program_deinit(&program);
+
+    const Example = struct {
+        fn returnHundred(handler: c.CubsCFunctionHandler) callconv(.C) c_int {
+            var out: i64 = 100;
+            c.cubs_function_return_set_value(handler, @ptrCast(&out), @ptrCast(&c.CUBS_INT_CONTEXT));
+            return 0;
+        }
+
+        fn returnConst(p: *c.CubsProgram, n: i64) *const c.CubsScriptFunctionPtr {
+            var builder = c.FunctionBuilder{ .stackSpaceRequired = 1, .optReturnType = &c.CUBS_INT_CONTEXT };
+            defer c.cubs_function_builder_deinit(&builder);
+            c.cubs_function_builder_push_bytecode(&builder, c.operands_make_load_immediate(c.LOAD_IMMEDIATE_INT, 0, n));
+            c.cubs_function_builder_push_bytecode(&builder, c.operands_make_return(true, 0));
+            return c.cubs_function_builder_build(&builder, p);
+        }
+    };
+
+    const one = Example.returnConst(&program, 1);
+    const ten = Example.returnConst(&program, 10);
+
+    // fn apply(f: fn() int) int { return f(); }
+    var builder = c.FunctionBuilder{ .stackSpaceRequired = 3, .optReturnType = &c.CUBS_INT_CONTEXT };
+    defer c.cubs_function_builder_deinit(&builder);
+
+    c.cubs_function_builder_add_arg(&builder, &c.CUBS_FUNCTION_CONTEXT);
+    {
+        var call: [2]c.Bytecode = undefined;
+        c.cubs_operands_make_call_src(&call, 2, 0, null, true, 2, 0);
+        c.cubs_function_builder_push_bytecode_many(&builder, &call, 2);
+    }
+    c.cubs_function_builder_push_bytecode(&builder, c.operands_make_return(true, 2));
+
+    const apply = c.cubs_function_builder_build(&builder, &program);
+    const inlineCache = &c.cubs_function_bytecode_start(apply)[1];
+    try expect(inlineCache.value == 0);
+
+    const targets = [_]c.CubsFunction{
+        .{ .func = .{ .script = one }, .funcType = c.cubsFunctionPtrTypeScript },
+        .{ .func = .{ .script = one }, .funcType = c.cubsFunctionPtrTypeScript },
+        .{ .func = .{ .script = ten }, .funcType = c.cubsFunctionPtrTypeScript },
+        .{ .func = .{ .externC = &Example.returnHundred }, .funcType = c.cubsFunctionPtrTypeC },
+        .{ .func = .{ .script = one }, .funcType = c.cubsFunctionPtrTypeScript },
+    };
+    const expectedResults = [_]i64{ 1, 1, 10, 100, 1 };
+    // C functions are called without replacing the cached script function, which is tagged as one
+    const tag = c.CALL_INLINE_CACHE_SCRIPT_TAG;
+    const expectedCache = [_]usize{ @intFromPtr(one) | tag, @intFromPtr(one) | tag, @intFromPtr(ten) | tag, @intFromPtr(ten) | tag, @intFromPtr(one) | tag };
+
+    for (targets, expectedResults, expectedCache) |target, expectedResult, cached| {
+        c.cubs_interpreter_push_script_function_arg(@ptrCast(&target), &c.CUBS_FUNCTION_CONTEXT, 0);
+
+        var result: i64 = undefined;
+        var retContext: *const c.CubsTypeContext = undefined;
+        try expect(c.cubs_interpreter_execute_function(apply, @ptrCast(&result), @ptrCast(&retContext)) == 0);
+        try expect(result == expectedResult);
+        try expect(retContext == &c.CUBS_INT_CONTEXT);
+        try expect(inlineCache.value == cached);
+    }
+
+    // A C function at the same address as the cached script function must not hit the cache
+    const aliased = c.CubsFunction{ .func = .{ .externC = @ptrFromInt(@intFromPtr(one)) }, .funcType = c.cubsFunctionPtrTypeC };
+    try expect(inlineCache.value != @intFromPtr(aliased.func.externC));
+}
+
+test "budgeted execution suspends and resumes" {
+    var program = c.cubs_program_init(.{});
+    defer c.cubs_program_deinit(&program);
+
+    // fn count() int { mut i = 0; while(i < 1000) { i += 1; } return i; }
+    var builder = c.FunctionBuilder{ .stackSpaceRequired = 3, .optReturnType = &c.CUBS_INT_CONTEXT };
+    defer c.cubs_function_builder_deinit(&builder);
+
+    c.cubs_function_builder_push_bytecode(&builder, c.operands_make_load_immediate(c.LOAD_IMMEDIATE_INT, 0, 0));
+    c.cubs_function_builder_push_bytecode(&builder, c.operands_make_load_immediate(c.LOAD_IMMEDIATE_INT, 1, 1000));
+    c.cubs_function_builder_push_bytecode(&builder, c.operands_make_increment_assign(false, 0));
+    c.cubs_function_builder_push_bytecode(&builder, c.cubs_operands_make_compare(c.COMPARE_OP_LESS, 2, 0, 1));
+    c.cubs_function_builder_push_bytecode(&builder, c.cubs_operands_make_jump(c.JUMP_TYPE_IF_TRUE, -2, 2));
+    c.cubs_function_builder_push_bytecode(&builder, c.operands_make_return(true, 0));
+
+    const func = c.cubs_function_builder_build(&builder, &program);
+
+    var result: i64 = undefined;
+    var retContext: *const c.CubsTypeContext = undefined;
+    var execution: c.CubsBudgetedExecution = undefined;
+    const budget = c.CubsExecutionBudget{ .operations = 100, .nanoseconds = 0 };
+
+    try expect(c.cubs_interpreter_execute_function_budgeted(func, @ptrCast(&result), @ptrCast(&retContext), budget, &execution) == 0);
+    try expect(execution.suspended);
+
+    var resumes: usize = 0;
+    while (execution.suspended) {
+        try expect(c.cubs_interpreter_resume(&execution, budget) == 0);
+        resumes += 1;
+    }
+
+    // 2 loads, 3 operations per iteration, and the return
+    try expect(resumes == (2 + (3 * 1000) + 1 - 1) / 100);
+    try expect(result == 1000);
+    try expect(retContext == &c.CUBS_INT_CONTEXT);
+}
+
+test "cancel suspended execution" {
+    var program = c.cubs_program_init(.{});
+    defer c.cubs_program_deinit(&program);
+
+    // fn forever() { mut s = "..."; while(true) {} }
+    var builder = c.FunctionBuilder{ .stackSpaceRequired = 4 };
+    defer c.cubs_function_builder_deinit(&builder);
+
+    const s = "a string long enough to be allocated on the heap";
+    var str = c.cubs_string_init_unchecked(.{ .str = s.ptr, .len = s.len });
+    defer c.cubs_string_deinit(&str);
+    {
+        var load: [3]c.Bytecode = undefined;
+        c.operands_make_load_clone_from_ptr(&load, 0, @ptrCast(&str), &c.CUBS_STRING_CONTEXT);
+        c.cubs_function_builder_push_bytecode_many(&builder, &load, 3);
+    }
+    c.cubs_function_builder_push_bytecode(&builder, c.cubs_operands_make_jump(c.JUMP_TYPE_DEFAULT, 0, 0));
+
+    const func = c.cubs_function_builder_build(&builder, &program);
+
+    var execution: c.CubsBudgetedExecution = undefined;
+    const budget = c.CubsExecutionBudget{ .operations = 1000, .nanoseconds = 0 };
+
+    try expect(c.cubs_interpreter_execute_function_budgeted(func, null, null, budget, &execution) == 0);
+    try expect(execution.suspended);
+    try expect(c.cubs_interpreter_resume(&execution, budget) == 0);
+    try expect(execution.suspended);
+
+    // Unwinds the cloned string, which the testing allocator would otherwise report as leaked
+    c.cubs_interpreter_cancel(&execution);
+    try expect(!execution.suspended);
+}
+
+test "inline small functions" {
+    var program = c.cubs_program_init(.{});
+    defer c.cubs_program_deinit(&program);
+    @as(*c.ProgramInner, @ptrCast(@alignCast(program._inner))).inlineThreshold = 16;
+
+    // fn add(a: int, b: int) int { return a + b; }
+    var addBuilder = c.FunctionBuilder{ .stackSpaceRequired = 3, .optReturnType = &c.CUBS_INT_CONTEXT };
+    c.cubs_function_builder_add_arg(&addBuilder, &c.CUBS_INT_CONTEXT);
+    c.cubs_function_builder_add_arg(&addBuilder, &c.CUBS_INT_CONTEXT);
+    c.cubs_function_builder_push_bytecode(&addBuilder, c.operands_make_add_dst(false, 2, 0, 1));
+    c.cubs_function_builder_push_bytecode(&addBuilder, c.operands_make_return(true, 2));
+    const add = c.cubs_function_builder_build(&addBuilder, &program);
+
+    // fn increment(mut a: int) int { a += 1; return a; }
+    var incrementBuilder = c.FunctionBuilder{ .stackSpaceRequired = 1, .optReturnType = &c.CUBS_INT_CONTEXT };
+    c.cubs_function_builder_add_arg(&incrementBuilder, &c.CUBS_INT_CONTEXT);
+    c.cubs_function_builder_push_bytecode(&incrementBuilder, c.operands_make_increment_assign(false, 0));
+    c.cubs_function_builder_push_bytecode(&incrementBuilder, c.operands_make_return(true, 0));
+    const increment = c.cubs_function_builder_build(&incrementBuilder, &program);
+
+    // fn sum(n: int) int { mut s = 0; mut i = 0; do { const next = increment(i); s = add(s, i); i = next; } while(i < n); return s; }
+    var builder = c.FunctionBuilder{ .stackSpaceRequired = 5, .optReturnType = &c.CUBS_INT_CONTEXT };
+    c.cubs_function_builder_add_arg(&builder, &c.CUBS_INT_CONTEXT);
+    c.cubs_function_builder_push_bytecode(&builder, c.operands_make_load_immediate(c.LOAD_IMMEDIATE_INT, 1, 0));
+    c.cubs_function_builder_push_bytecode(&builder, c.operands_make_load_immediate(c.LOAD_IMMEDIATE_INT, 2, 0));
+    {
+        var call: [3]c.Bytecode = undefined;
+        const args = [_]u16{2};
+        c.cubs_operands_make_call_immediate(&call, 3, 1, &args, true, 4, .{ .func = .{ .script = increment }, .funcType = c.cubsFunctionPtrTypeScript });
+        c.cubs_function_builder_push_bytecode_many(&builder, &call, 3);
+    }
+    {
+        var call: [3]c.Bytecode = undefined;
+        const args = [_]u16{ 1, 2 };
+        c.cubs_operands_make_call_immediate(&call, 3, 2, &args, true, 1, .{ .func = .{ .script = add }, .funcType = c.cubsFunctionPtrTypeScript });
+        c.cubs_function_builder_push_bytecode_many(&builder, &call, 3);
+    }
+    c.cubs_function_builder_push_bytecode(&builder, c.cubs_operands_make_move(2, 4));
+    c.cubs_function_builder_push_bytecode(&builder, c.cubs_operands_make_compare(c.COMPARE_OP_LESS, 3, 2, 0));
+    c.cubs_function_builder_push_bytecode(&builder, c.cubs_operands_make_jump(c.JUMP_TYPE_IF_TRUE, -8, 3));
+    c.cubs_function_builder_push_bytecode(&builder, c.operands_make_return(true, 1));
+    const func = c.cubs_function_builder_build(&builder, &program);
+
+    const bytecode = c.cubs_function_bytecode_start(func);
+    for (0..func.*._bytecodeCount) |i| {
+        try expect(c.cubs_bytecode_get_opcode(bytecode[i]) != c.OpCodeCall);
+    }
+
+    var n: i64 = 5;
+    c.cubs_interpreter_push_script_function_arg(@ptrCast(&n), &c.CUBS_INT_CONTEXT, 0);
+    var result: i64 = undefined;
+    var retContext: *const c.CubsTypeContext = undefined;
+    try expect(c.cubs_interpreter_execute_function(func, @ptrCast(&result), @ptrCast(&retContext)) == 0);
+    // `increment(...)` modifying it's argument doesn't affect the caller's `i`
+    try expect(result == 0 + 1 + 2 + 3 + 4);
+    try expect(retContext == &c.CUBS_INT_CONTEXT);
+}
+
+test "inlining keeps the frame within the maximum length" {
+    var program = c.cubs_program_init(.{});
+    defer c.cubs_program_deinit(&program);
+    @as(*c.ProgramInner, @ptrCast(@alignCast(program._inner))).inlineThreshold = 16;
+
+    // fn add(a: int, b: int) int { return a + b; }
+    var addBuilder = c.FunctionBuilder{ .stackSpaceRequired = 3, .optReturnType = &c.CUBS_INT_CONTEXT };
+    c.cubs_function_builder_add_arg(&addBuilder, &c.CUBS_INT_CONTEXT);
+    c.cubs_function_builder_add_arg(&addBuilder, &c.CUBS_INT_CONTEXT);
+    c.cubs_function_builder_push_bytecode(&addBuilder, c.operands_make_add_dst(false, 2, 0, 1));
+    c.cubs_function_builder_push_bytecode(&addBuilder, c.operands_make_return(true, 2));
+    const add = c.cubs_function_builder_build(&addBuilder, &program);
+
+    const Caller = struct {
+        /// fn caller(a: int) int { return add(a, a); }, with it's frame padded to `frameLength`.
+        fn build(p: *c.CubsProgram, callee: *const c.CubsScriptFunctionPtr, frameLength: usize) *const c.CubsScriptFunctionPtr {
+            var builder = c.FunctionBuilder{ .stackSpaceRequired = frameLength, .optReturnType = &c.CUBS_INT_CONTEXT };
+            c.cubs_function_builder_add_arg(&builder, &c.CUBS_INT_CONTEXT);
+            var call: [3]c.Bytecode = undefined;
+            const args = [_]u16{ 0, 0 };
+            const dst: u16 = @intCast(frameLength - 1);
+            c.cubs_operands_make_call_immediate(&call, 3, 2, &args, true, dst, .{ .func = .{ .script = callee }, .funcType = c.cubsFunctionPtrTypeScript });
+            c.cubs_function_builder_push_bytecode_many(&builder, &call, 3);
+            c.cubs_function_builder_push_bytecode(&builder, c.operands_make_return(true, dst));
+            return c.cubs_function_builder_build(&builder, p);
+        }
+
+        fn hasCall(func: *const c.CubsScriptFunctionPtr) bool {
+            const bytecode = c.cubs_function_bytecode_start(func);
+            for (0..func.*._bytecodeCount) |i| {
+                if (c.cubs_bytecode_get_opcode(bytecode[i]) == c.OpCodeCall) {
+                    return true;
+                }
+            }
+            return false;
+        }
+    };
+
+    // Exactly fits, so it's inlined
+    const fits = Caller.build(&program, add, c.MAX_FRAME_LENGTH - 3);
+    try expect(!Caller.hasCall(fits));
+    try expect(fits.*._stackSpaceRequired == c.MAX_FRAME_LENGTH);
+
+    // The callee's slots would go past the last slot a stack operand can address
+    const tooLarge = Caller.build(&program, add, c.MAX_FRAME_LENGTH - 2);
+    try expect(Caller.hasCall(tooLarge));
+    try expect(tooLarge.*._stackSpaceRequired == c.MAX_FRAME_LENGTH - 2);
+
+    for ([_]*const c.CubsScriptFunctionPtr{ fits, tooLarge }) |func| {
+        var a: i64 = 21;
+        c.cubs_interpreter_push_script_function_arg(@ptrCast(&a), &c.CUBS_INT_CONTEXT, 0);
+        var result: i64 = undefined;
+        var retContext: *const c.CubsTypeContext = undefined;
+        try expect(c.cubs_interpreter_execute_function(func, @ptrCast(&result), @ptrCast(&retContext)) == 0);
+        try expect(result == 42);
+    }
+}
+
+test "tail recursion runs in constant stack space" {
+    var program = c.cubs_program_init(.{});
+    defer c.cubs_program_deinit(&program);
+
+    // fn sum(n: int, acc: int) int { if(n == 0) { return acc; } return sum(n - 1, acc + n); }
+    var builder = c.FunctionBuilder{ .stackSpaceRequired = 7, .optReturnType = &c.CUBS_INT_CONTEXT };
+    defer c.cubs_function_builder_deinit(&builder);
+
+    c.cubs_function_builder_add_arg(&builder, &c.CUBS_INT_CONTEXT);
+    c.cubs_function_builder_add_arg(&builder, &c.CUBS_INT_CONTEXT);
+    c.cubs_function_builder_push_bytecode(&builder, c.operands_make_load_immediate(c.LOAD_IMMEDIATE_INT, 2, 0));
+    c.cubs_function_builder_push_bytecode(&builder, c.cubs_operands_make_compare(c.COMPARE_OP_EQUAL, 3, 0, 2));
+    c.cubs_function_builder_push_bytecode(&builder, c.cubs_operands_make_jump(c.JUMP_TYPE_IF_FALSE, 2, 3));
+    c.cubs_function_builder_push_bytecode(&builder, c.operands_make_return(true, 1));
+    c.cubs_function_builder_push_bytecode(&builder, c.operands_make_load_immediate(c.LOAD_IMMEDIATE_INT, 2, -1));
+    c.cubs_function_builder_push_bytecode(&builder, c.operands_make_add_dst(false, 4, 0, 2));
+    c.cubs_function_builder_push_bytecode(&builder, c.operands_make_add_dst(false, 5, 1, 0));
+    // The function can't reference itself until it's built, so it's set below
+    const placeholder = c.CubsFunction{ .func = .{ .script = null }, .funcType = c.cubsFunctionPtrTypeScript };
+    const args = [2]u16{ 4, 5 };
+    var call: [3]c.Bytecode = undefined;
+    c.cubs_operands_make_call_immediate(&call, 3, 2, &args, true, 6, placeholder);
+    c.cubs_function_builder_push_bytecode_many(&builder, &call, 3);
+    c.cubs_function_builder_push_bytecode(&builder, c.operands_make_return(true, 6));
+
+    const func = c.cubs_function_builder_build(&builder, &program);
+    const bytecode: [*]c.Bytecode = @constCast(c.cubs_function_bytecode_start(func));
+    bytecode[8].value = @intFromPtr(func);
+
+    // Calling and then returning the result is made a tail call
+    c.cubs_operands_make_tail_call(&call);
+    try expect(bytecode[7].value == call[0].value);
+
+    // Far deeper than the stack could fit if each call pushed a frame
+    const defaultLimit = c.cubs_interpreter_stack_limit();
+    c.cubs_interpreter_set_stack_limit(1024);
+    defer c.cubs_interpreter_set_stack_limit(defaultLimit);
+
+    const n: i64 = 1000000;
+    const acc: i64 = 0;
+    c.cubs_interpreter_push_script_function_arg(@ptrCast(&n), &c.CUBS_INT_CONTEXT, 0);
+    c.cubs_interpreter_push_script_function_arg(@ptrCast(&acc), &c.CUBS_INT_CONTEXT, 1);
+
+    var result: i64 = undefined;
+    var retContext: *const c.CubsTypeContext = undefined;
+    try expect(c.cubs_interpreter_execute_function(func, @ptrCast(&result), @ptrCast(&retContext)) == 0);
+    try expect(result == @divExact(n * (n + 1), 2));
+    try expect(retContext == &c.CUBS_INT_CONTEXT);
+}
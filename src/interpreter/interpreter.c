@@ -8,6 +8,7 @@
 #include "../program/program.h"
 #include "value_tag.h"
 #include <string.h>
+#include "../platform/clock.h"
 #include "../primitives/context.h"
 #include "../primitives/string/string.h"
 #include "../primitives/array/array.h"
@@ -24,8 +25,11 @@
 #include "../util/context_size_round.h"
 #include "../sync/sync_queue.h"
 #include "../program/program_internal.h"
+#include "../sync/atomic.h"
+#include "profiler.h"
+#include "jit.h"
 
-static void execute_load(int64_t* const ipIncrement, const Bytecode* bytecode) {
+static void execute_load(const InterpreterFramePointer* frame, int64_t* const ipIncrement, const Bytecode* bytecode) {
     const OperandsLoadUnknown unknownOperands = *(const OperandsLoadUnknown*)bytecode;
 
     switch(unknownOperands.loadType) {
@@ -34,12 +38,12 @@ static void execute_load(int64_t* const ipIncrement, const Bytecode* bytecode) {
 
             switch(operands.immediateType) {
                 case LOAD_IMMEDIATE_BOOL: {
-                    *((bool*)cubs_interpreter_stack_value_at(operands.dst)) = operands.immediate != 0;
-                    cubs_interpreter_stack_set_context_at(operands.dst, &CUBS_BOOL_CONTEXT);
+                    *((bool*)cubs_frame_value_at(frame, operands.dst)) = operands.immediate != 0;
+                    cubs_frame_set_context_at(frame, operands.dst, &CUBS_BOOL_CONTEXT);
                 } break;
                 case LOAD_IMMEDIATE_INT: {
-                    *((int64_t*)cubs_interpreter_stack_value_at(operands.dst)) = (int64_t)operands.immediate;
-                    cubs_interpreter_stack_set_context_at(operands.dst, &CUBS_INT_CONTEXT);
+                    *((int64_t*)cubs_frame_value_at(frame, operands.dst)) = (int64_t)operands.immediate;
+                    cubs_frame_set_context_at(frame, operands.dst, &CUBS_INT_CONTEXT);
                 } break;
                 default: {
                     unreachable();
@@ -52,28 +56,28 @@ static void execute_load(int64_t* const ipIncrement, const Bytecode* bytecode) {
             assert(operands.immediateValueTag != cubsValueTagBool && "Don't use 64 bit immediate load for booleans");
 
             const uint64_t immediate = bytecode[1].value;
-            *((uint64_t*)cubs_interpreter_stack_value_at(operands.dst)) = immediate; // will reinterpret cast
-            cubs_interpreter_stack_set_context_at(operands.dst, cubs_primitive_context_for_tag(operands.immediateValueTag));      
+            *((uint64_t*)cubs_frame_value_at(frame, operands.dst)) = immediate; // will reinterpret cast
+            cubs_frame_set_context_at(frame, operands.dst, cubs_primitive_context_for_tag(operands.immediateValueTag));      
             (*ipIncrement) += 1; // move instruction pointer further into the bytecode
         } break;
         case LOAD_TYPE_DEFAULT: {
             const OperandsLoadDefault operands = *(const OperandsLoadDefault*)bytecode;
             assert(operands.tag != _CUBS_VALUE_TAG_NONE);
             
-            void* dst = cubs_interpreter_stack_value_at(operands.dst);
+            void* dst = cubs_frame_value_at(frame, operands.dst);
 
             switch(operands.tag) {
                 case cubsValueTagBool: {
                     *(bool*)dst = false;
-                    cubs_interpreter_stack_set_context_at(operands.dst, &CUBS_BOOL_CONTEXT);
+                    cubs_frame_set_context_at(frame, operands.dst, &CUBS_BOOL_CONTEXT);
                 } break;
                 case cubsValueTagInt: {
                     *(int64_t*)dst = 0;
-                    cubs_interpreter_stack_set_context_at(operands.dst, &CUBS_INT_CONTEXT);
+                    cubs_frame_set_context_at(frame, operands.dst, &CUBS_INT_CONTEXT);
                 } break;
                 case cubsValueTagFloat: {
                     *(double*)dst = 0;
-                    cubs_interpreter_stack_set_context_at(operands.dst, &CUBS_FLOAT_CONTEXT);
+                    cubs_frame_set_context_at(frame, operands.dst, &CUBS_FLOAT_CONTEXT);
                 } break;
                 case cubsValueTagChar: {
                     cubs_panic("TODO char");
@@ -81,31 +85,31 @@ static void execute_load(int64_t* const ipIncrement, const Bytecode* bytecode) {
                 case cubsValueTagString: {
                     const CubsString defaultString = {0};
                     *(CubsString*)dst = defaultString;
-                    cubs_interpreter_stack_set_context_at(operands.dst, &CUBS_STRING_CONTEXT);
+                    cubs_frame_set_context_at(frame, operands.dst, &CUBS_STRING_CONTEXT);
                 } break;
                 case cubsValueTagArray: {
                     const CubsTypeContext* context = (const CubsTypeContext*)bytecode[1].value;
                     *(CubsArray*)dst = cubs_array_init(context);
-                    cubs_interpreter_stack_set_context_at(operands.dst, &CUBS_ARRAY_CONTEXT);
+                    cubs_frame_set_context_at(frame, operands.dst, &CUBS_ARRAY_CONTEXT);
                     (*ipIncrement) += 1; // move instruction pointer further into the bytecode
                 } break;
                 case cubsValueTagSet: {
                     const CubsTypeContext* context = (const CubsTypeContext*)bytecode[1].value;
                     *(CubsSet*)dst = cubs_set_init(context);
-                    cubs_interpreter_stack_set_context_at(operands.dst, &CUBS_SET_CONTEXT);
+                    cubs_frame_set_context_at(frame, operands.dst, &CUBS_SET_CONTEXT);
                     (*ipIncrement) += 1; // move instruction pointer further into the bytecode
                 } break;
                 case cubsValueTagMap: {
                     const CubsTypeContext* keyContext = (const CubsTypeContext*)bytecode[1].value;
                     const CubsTypeContext* valueContext = (const CubsTypeContext*)bytecode[2].value;
                     *(CubsMap*)dst = cubs_map_init(keyContext, valueContext);
-                    cubs_interpreter_stack_set_context_at(operands.dst, &CUBS_MAP_CONTEXT);
+                    cubs_frame_set_context_at(frame, operands.dst, &CUBS_MAP_CONTEXT);
                     (*ipIncrement) += 2; // move instruction pointer further into the bytecode
                 } break;
                 case cubsValueTagOption: {
                     const CubsTypeContext* context = (const CubsTypeContext*)bytecode[1].value;
                     *(CubsOption*)dst = cubs_option_init(context, NULL);
-                    cubs_interpreter_stack_set_context_at(operands.dst, &CUBS_SET_CONTEXT);
+                    cubs_frame_set_context_at(frame, operands.dst, &CUBS_SET_CONTEXT);
                     (*ipIncrement) += 1; // move instruction pointer further into the bytecode
                 } break;
                 case cubsValueTagError: {
@@ -128,12 +132,12 @@ static void execute_load(int64_t* const ipIncrement, const Bytecode* bytecode) {
             assert(immediate != NULL);
             assert(context != NULL);
 
-            void* dst = cubs_interpreter_stack_value_at(operands.dst);
+            void* dst = cubs_frame_value_at(frame, operands.dst);
 
             assert(context->clone.func.externC != NULL);
             cubs_context_fast_clone(dst, immediate, context);
 
-            cubs_interpreter_stack_set_context_at(operands.dst, context);      
+            cubs_frame_set_context_at(frame, operands.dst, context);      
             (*ipIncrement) += 2; // move instruction pointer further into the bytecode
         } break;
         default: {
@@ -142,7 +146,7 @@ static void execute_load(int64_t* const ipIncrement, const Bytecode* bytecode) {
     }
 }
 
-static void execute_return(int64_t* const ipIncrement, const Bytecode bytecode) {
+static void execute_return(const InterpreterFramePointer* frame, int64_t* const ipIncrement, const Bytecode bytecode) {
     const OperandsReturn operands = *(const OperandsReturn*)&bytecode;
 
     if(operands.hasReturn) {
@@ -150,9 +154,9 @@ static void execute_return(int64_t* const ipIncrement, const Bytecode bytecode)
         assert(ret.value != NULL);
         assert(ret.context != NULL);
 
-        void* src = cubs_interpreter_stack_value_at(operands.returnSrc);
-        const CubsTypeContext* context = cubs_interpreter_stack_context_at(operands.returnSrc);
-        cubs_interpreter_stack_set_null_context_at(operands.returnSrc);
+        void* src = cubs_frame_value_at(frame, operands.returnSrc);
+        const CubsTypeContext* context = cubs_frame_context_at(frame, operands.returnSrc);
+        cubs_frame_set_null_context_at(frame, operands.returnSrc);
 
         memcpy(ret.value, src, context->sizeOfType);
         *ret.context = context;
@@ -162,7 +166,21 @@ static void execute_return(int64_t* const ipIncrement, const Bytecode bytecode)
     cubs_interpreter_pop_frame();
 }
 
-static void execute_call(int64_t* const ipIncrement, const Bytecode* bytecode) {
+/// Bytecode required for a call operation. See `cubs_operands_make_call_immediate(...)`
+/// and `cubs_operands_make_call_src(...)`.
+static size_t call_bytecode_required(const Bytecode* bytecode) {
+    const OperandsCallUnknown operands = *(const OperandsCallUnknown*)bytecode;
+    // Initial bytecode, + immediate function or inline cache, + 4 argument sources per bytecode
+    size_t requiredBytecode = 2;
+    if((operands.argCount % 4) == 0) {
+        requiredBytecode += (operands.argCount / 4);
+    } else {
+        requiredBytecode += (operands.argCount / 4) + 1;
+    }
+    return requiredBytecode;
+}
+
+static void execute_call(const InterpreterFramePointer* frame, int64_t* const ipIncrement, const Bytecode* bytecode) {
     const OperandsCallUnknown operands = *(const OperandsCallUnknown*)&bytecode[0];
     const enum CallType opType = (enum CallType)operands.opType;
     const unsigned int argCount = (unsigned int)operands.argCount;
@@ -180,54 +198,223 @@ static void execute_call(int64_t* const ipIncrement, const Bytecode* bytecode) {
             };
             func = _func;
             argsSrcs = (const uint16_t*)&bytecode[2];
-
-            // See operands.c cubs_operands_make_call_immediate
-            /// Initial bytecode + immediate function
-            size_t requiredBytecode = 1 + 1;
-            if((argCount % 4) == 0) {
-                requiredBytecode += (argCount / 4);
-            } else {
-                requiredBytecode += (argCount / 4) + 1;
-            }
-            *ipIncrement = requiredBytecode;
         } break;
         case CALL_TYPE_SRC: {
             const OperandsCallSrc srcOperands = *(const OperandsCallSrc*)&bytecode[0];
-            assert(cubs_interpreter_stack_context_at(srcOperands.funcSrc) == &CUBS_FUNCTION_CONTEXT);
-            func = *(const CubsFunction*)cubs_interpreter_stack_value_at(srcOperands.funcSrc);
-            argsSrcs = (const uint16_t*)&bytecode[1];
-         
-            // See operands.c cubs_operands_make_call_src
-            /// Initial bytecode
-            size_t requiredBytecode = 1;
-            if((argCount % 4) == 0) {
-                requiredBytecode += (argCount / 4);
-            } else {
-                requiredBytecode += (argCount / 4) + 1;
-            }
-            *ipIncrement = requiredBytecode;
+            assert(cubs_frame_context_at(frame, srcOperands.funcSrc) == &CUBS_FUNCTION_CONTEXT);
+            func = *(const CubsFunction*)cubs_frame_value_at(frame, srcOperands.funcSrc);
+            argsSrcs = (const uint16_t*)&bytecode[2];
         } break;
     }
 
+    *ipIncrement = (int64_t)call_bytecode_required(bytecode);
+
     CubsFunctionCallArgs funcArgs = cubs_function_start_call(&func);
     for(unsigned int i = 0; i < argCount; i++) {
         const uint16_t argSrc = argsSrcs[i];
-        assert(cubs_interpreter_stack_context_at(argSrc) != NULL);
-        cubs_function_push_arg(&funcArgs, cubs_interpreter_stack_value_at(argSrc), cubs_interpreter_stack_context_at(argSrc));
+        assert(cubs_frame_context_at(frame, argSrc) != NULL);
+        cubs_function_push_arg(&funcArgs, cubs_frame_value_at(frame, argSrc), cubs_frame_context_at(frame, argSrc));
     }
 
     if(operands.hasReturn) {
-        void* retValue = cubs_interpreter_stack_value_at(operands.returnDst);
-        const CubsTypeContext** retContext = cubs_interpreter_stack_context_ptr_at(operands.returnDst);
-        const CubsFunctionReturn ret = {.value = retValue, .context = retContext};
+        // The callee writes a full context, which then needs to be converted to the slot's tag
+        void* retValue = cubs_frame_value_at(frame, operands.returnDst);
+        const CubsTypeContext* retContext = NULL;
+        const CubsFunctionReturn ret = {.value = retValue, .context = &retContext};
         cubs_function_call(funcArgs, ret);
+        if(retContext != NULL) {
+            cubs_frame_set_context_at(frame, operands.returnDst, retContext);
+        }
     } else {
         const CubsFunctionReturn nullRet = {0};
         cubs_function_call(funcArgs, nullRet);
     }
 }
 
-static void execute_jump(int64_t* const ipIncrement, const Bytecode bytecode) {
+/// For a call to the script function `callee` at `callIp`, pushes the callee's frame with the
+/// arguments copied directly from the caller's slots, without going through `CubsFunctionCallArgs`.
+/// `frame` is the caller's frame, which is replaced with the callee's. `callIp` is restored as the
+/// instruction pointer once the callee returns, for `finish_script_call(...)`.
+/// Returns the instruction pointer to continue executing from.
+static const Bytecode* push_script_call(InterpreterFramePointer* frame, const Bytecode* callIp, const CubsScriptFunctionPtr* callee) {
+    const OperandsCallUnknown operands = *(const OperandsCallUnknown*)callIp;
+    // Both call types have the arguments following the immediate function or inline cache
+    const uint16_t* argsSrcs = (const uint16_t*)&callIp[2];
+
+    void* returnValueDst = NULL;
+    const CubsTypeContext** returnContextDst = NULL;
+    if(operands.hasReturn) {
+        returnValueDst = cubs_frame_value_at(frame, operands.returnDst);
+        // The callee writes a full context, which `finish_script_call(...)` converts to the slot's tag
+        returnContextDst = (const CubsTypeContext**)&frame->contexts[operands.returnDst];
+    }
+
+    *frame = cubs_interpreter_push_script_call_frame(callee, frame, argsSrcs, operands.argCount, returnValueDst, returnContextDst, callIp);
+    return cubs_function_bytecode_start(callee);
+}
+
+/// If the call operation at `callIp` calls a script function, returns it, otherwise returns NULL.
+/// `CALL_TYPE_SRC` calls check their inline cache first, and update it if it missed.
+static const CubsScriptFunctionPtr* script_call_target(const InterpreterFramePointer* frame, const Bytecode* callIp) {
+    const OperandsCallUnknown operands = *(const OperandsCallUnknown*)callIp;
+    if(operands.opType == CALL_TYPE_IMMEDIATE) {
+        const OperandsCallImmediate immediateOperands = *(const OperandsCallImmediate*)callIp;
+        if(immediateOperands.funcType != cubsFunctionPtrTypeScript) {
+            return NULL;
+        }
+        return (const CubsScriptFunctionPtr*)callIp[1].value;
+    }
+
+    const OperandsCallSrc srcOperands = *(const OperandsCallSrc*)callIp;
+    assert(cubs_frame_context_at(frame, srcOperands.funcSrc) == &CUBS_FUNCTION_CONTEXT);
+    const CubsFunction* func = (const CubsFunction*)cubs_frame_value_at(frame, srcOperands.funcSrc);
+
+    // Other threads may execute the same bytecode, so the cache is accessed atomically. The cache only
+    // ever holds tagged script functions, so comparing the tagged function also compares the type.
+    Bytecode* inlineCache = (Bytecode*)&callIp[1];
+    const uintptr_t cached = (uintptr_t)cubs_atomic_load_64(&inlineCache->value);
+    const uintptr_t tagged = (uintptr_t)func->func.script
+        | (func->funcType == cubsFunctionPtrTypeScript ? CALL_INLINE_CACHE_SCRIPT_TAG : 0);
+    if(tagged == cached) {
+        return func->func.script;
+    }
+    if(func->funcType != cubsFunctionPtrTypeScript) {
+        return NULL;
+    }
+    assert(((uintptr_t)func->func.script & CALL_INLINE_CACHE_SCRIPT_TAG) == 0);
+    cubs_atomic_store_64(&inlineCache->value, tagged);
+    return func->func.script;
+}
+
+/// After the callee of `push_script_call(...)` returned, and it's frame was popped, sets the
+/// returned value's tag. `frame` must be the caller's frame. Returns the instruction pointer
+/// of the operation following the call.
+static const Bytecode* finish_script_call(const InterpreterFramePointer* frame, const Bytecode* callIp) {
+    const OperandsCallImmediate operands = *(const OperandsCallImmediate*)callIp;
+    if(operands.hasReturn) {
+        const CubsTypeContext* retContext = (const CubsTypeContext*)frame->contexts[operands.returnDst];
+        cubs_frame_set_context_at(frame, operands.returnDst, retContext);
+    }
+    return &callIp[call_bytecode_required(callIp)];
+}
+
+/// Executes the tail call at `callIp` to a C function. It's arguments are moved out of `frame`, and
+/// it returns to wherever `frame`'s function would have, after which `frame` is unwound and popped.
+static void execute_extern_tail_call(const InterpreterFramePointer* frame, const Bytecode* callIp) {
+    const OperandsCallUnknown operands = *(const OperandsCallUnknown*)callIp;
+    const uint16_t* argsSrcs = (const uint16_t*)&callIp[2];
+    CubsFunction func;
+    if(operands.opType == CALL_TYPE_IMMEDIATE) {
+        const OperandsCallImmediate immediateOperands = *(const OperandsCallImmediate*)callIp;
+        const CubsFunction immediateFunc = {
+            .func = {.externC = (CubsCFunctionPtr)callIp[1].value},
+            .funcType = (CubsFunctionType)immediateOperands.funcType,
+        };
+        func = immediateFunc;
+    } else {
+        const OperandsCallSrc srcOperands = *(const OperandsCallSrc*)callIp;
+        func = *(const CubsFunction*)cubs_frame_value_at(frame, srcOperands.funcSrc);
+    }
+
+    CubsFunctionCallArgs funcArgs = cubs_function_start_call(&func);
+    for(unsigned int i = 0; i < operands.argCount; i++) {
+        assert(cubs_frame_context_at(frame, argsSrcs[i]) != NULL);
+        cubs_function_push_arg(&funcArgs, cubs_frame_value_at(frame, argsSrcs[i]), cubs_frame_context_at(frame, argsSrcs[i]));
+    }
+    // The function is called with the arguments still in `frame`, so the slot holding it isn't unwound yet
+    cubs_function_call(funcArgs, cubs_interpreter_return_dst());
+    for(unsigned int i = 0; i < operands.argCount; i++) {
+        cubs_frame_set_null_context_at(frame, argsSrcs[i]);
+    }
+
+    cubs_interpreter_stack_unwind_frame();
+    cubs_interpreter_pop_frame();
+}
+
+#if CUBS_JIT_ENABLED
+
+/// Compiled functions currently executing on this thread's native stack. See `CUBS_JIT_MAX_NATIVE_DEPTH`.
+static _Thread_local size_t jitNativeDepth = 0;
+
+/// Counts a call to `function`, compiling it once it's been called as many times as it's program's JIT
+/// threshold. Returns the compiled code to execute the call with, or NULL if it should be interpreted.
+static CubsJitFunction jit_code_for_call(const CubsScriptFunctionPtr* function) {
+    // The call count and compiled code are the only parts of a function written to after it's built
+    CubsScriptFunctionPtr* mutFunction = (CubsScriptFunctionPtr*)function;
+    const void* code = (const void*)(uintptr_t)cubs_atomic_load_64(&function->_jitCode);
+    if(code == NULL) {
+        if(cubs_atomic_load_64(&function->_jitCallsUntilCompile) == 0) {
+            return NULL;
+        }
+        const size_t callsLeft = cubs_atomic_fetch_sub_64(&mutFunction->_jitCallsUntilCompile, 1);
+        if(callsLeft == 0) {
+            // Another thread took the count to 0 after it was loaded
+            cubs_atomic_store_64(&mutFunction->_jitCallsUntilCompile, 0);
+            return NULL;
+        }
+        if(callsLeft != 1 || !cubs_jit_compile(function)) {
+            return NULL;
+        }
+        code = (const void*)(uintptr_t)cubs_atomic_load_64(&function->_jitCode);
+    }
+    if(jitNativeDepth >= CUBS_JIT_MAX_NATIVE_DEPTH) {
+        return NULL;
+    }
+    return (CubsJitFunction)code;
+}
+
+/// Set by a tail call from compiled code to the function it replaced the frame with, for
+/// `execute_compiled(...)` to run once the compiled code exits. See `jit_execute_tail_call(...)`.
+static _Thread_local const CubsScriptFunctionPtr* jitPendingTailCall = NULL;
+
+struct ExecutionBudgetState;
+static CubsProgramRuntimeError interpreter_execute_continuous(const CubsProgram *program, struct ExecutionBudgetState* optBudget);
+
+/// Executes compiled `code` in `frame`, and then the tail calls it made, until one of them returns from
+/// the frame. Compiled tail calls exit their code before executing the callee, so a chain of them
+/// doesn't grow the native stack.
+static CubsProgramRuntimeError execute_compiled(const CubsProgram* program, CubsJitFunction code, const InterpreterFramePointer* frame) {
+    jitNativeDepth += 1;
+    CubsProgramRuntimeError err = code(frame, program);
+    while(err == cubsProgramRuntimeErrorNone && jitPendingTailCall != NULL) {
+        const CubsScriptFunctionPtr* callee = jitPendingTailCall;
+        jitPendingTailCall = NULL;
+        const InterpreterFramePointer calleeFrame = cubs_interpreter_current_frame_pointer();
+        code = jit_code_for_call(callee);
+        if(code != NULL) {
+            err = code(&calleeFrame, program);
+        } else {
+            cubs_interpreter_set_instruction_pointer(cubs_function_bytecode_start(callee));
+            err = interpreter_execute_continuous(program, NULL);
+        }
+    }
+    jitNativeDepth -= 1;
+    return err;
+}
+
+/// Executes the call at `callIp` to the compiled script function `callee`, as `push_script_call(...)` and
+/// `finish_script_call(...)` do for interpreted calls. `frame` is the caller's frame, which is unchanged.
+/// If an error occurs, the callee's frame is unwound and popped.
+static CubsProgramRuntimeError execute_compiled_call(
+    const CubsProgram* program, const InterpreterFramePointer* frame, const Bytecode* callIp, const CubsScriptFunctionPtr* callee, CubsJitFunction code
+) {
+    InterpreterFramePointer calleeFrame = *frame;
+    (void)push_script_call(&calleeFrame, callIp, callee);
+
+    const CubsProgramRuntimeError err = execute_compiled(program, code, &calleeFrame);
+    if(err != cubsProgramRuntimeErrorNone) {
+        cubs_interpreter_stack_unwind_frame();
+        cubs_interpreter_pop_frame();
+        return err;
+    }
+
+    (void)finish_script_call(frame, callIp);
+    return cubsProgramRuntimeErrorNone;
+}
+
+#endif // CUBS_JIT_ENABLED
+
+static void execute_jump(const InterpreterFramePointer* frame, int64_t* const ipIncrement, const Bytecode bytecode) {
     const OperandsJump operands = *(const OperandsJump*)&bytecode;
     const int32_t jumpAmount = (int32_t)operands.jumpAmount;
     const enum JumpType jumpType = operands.opType;
@@ -236,15 +423,15 @@ static void execute_jump(int64_t* const ipIncrement, const Bytecode bytecode) {
             *ipIncrement = jumpAmount;
         } break;
         case JUMP_TYPE_IF_TRUE: {
-            assert(cubs_interpreter_stack_context_at(operands.optSrc) == &CUBS_BOOL_CONTEXT);
-            const bool value = *(const bool*)cubs_interpreter_stack_value_at(operands.optSrc);
+            assert(cubs_frame_context_at(frame, operands.optSrc) == &CUBS_BOOL_CONTEXT);
+            const bool value = *(const bool*)cubs_frame_value_at(frame, operands.optSrc);
             if(value) {
                 *ipIncrement = jumpAmount;
             }
         } break;
         case JUMP_TYPE_IF_FALSE: {
-            assert(cubs_interpreter_stack_context_at(operands.optSrc) == &CUBS_BOOL_CONTEXT);
-            const bool value = *(const bool*)cubs_interpreter_stack_value_at(operands.optSrc);
+            assert(cubs_frame_context_at(frame, operands.optSrc) == &CUBS_BOOL_CONTEXT);
+            const bool value = *(const bool*)cubs_frame_value_at(frame, operands.optSrc);
             if(!value) {
                 *ipIncrement = jumpAmount;
             }
@@ -252,23 +439,23 @@ static void execute_jump(int64_t* const ipIncrement, const Bytecode bytecode) {
     }
 }
 
-static void execute_deinit(const Bytecode bytecode) {
+static void execute_deinit(const InterpreterFramePointer* frame, const Bytecode bytecode) {
     const OperandsDeinit operands = *(const OperandsDeinit*)&bytecode;
-    const CubsTypeContext* context = cubs_interpreter_stack_context_at(operands.src);
+    const CubsTypeContext* context = cubs_frame_context_at(frame, operands.src);
     assert(context != NULL);
     // TODO should this be done at all?
     // It's a waste of processing power to do this, as if there is no destructor, the deinit operation shouldn't be used at all
     if(context->destructor.func.externC == NULL) {
         return;
     }
-    cubs_context_fast_deinit(cubs_interpreter_stack_value_at(operands.src), context);
-    cubs_interpreter_stack_set_null_context_at(operands.src);
+    cubs_context_fast_deinit(cubs_frame_value_at(frame, operands.src), context);
+    cubs_frame_set_null_context_at(frame, operands.src);
 }
 
-static void sync_value_at(OperandsSyncLockSource src) {
-    const CubsTypeContext* srcContext = cubs_interpreter_stack_context_at(src.src);
+static void sync_value_at(const InterpreterFramePointer* frame, OperandsSyncLockSource src) {
+    const CubsTypeContext* srcContext = cubs_frame_context_at(frame, src.src);
     const enum SyncLockType lockType = (enum SyncLockType)src.lock;
-    void* srcValue = cubs_interpreter_stack_value_at(src.src);
+    void* srcValue = cubs_frame_value_at(frame, src.src);
     bool canExclusiveLock = true;
 
     const CubsTypeContext* actualContext = srcContext;
@@ -311,23 +498,23 @@ static void sync_value_at(OperandsSyncLockSource src) {
     }
 }
 
-static void execute_sync(int64_t* const ipIncrement, const Bytecode* bytecode) {
+static void execute_sync(const InterpreterFramePointer* frame, int64_t* const ipIncrement, const Bytecode* bytecode) {
     const OperandsSync operands = *(const OperandsSync*)&bytecode[0];
     const enum SyncType syncType = (enum SyncType)operands.opType;
     if(syncType == SYNC_TYPE_UNSYNC) {
         cubs_sync_queue_unlock();
     } else {
         // first is guaranteed to get sync'd
-        sync_value_at(operands.src1);
+        sync_value_at(frame, operands.src1);
     
         if(operands.num > 1) {
-            sync_value_at(operands.src2);
+            sync_value_at(frame, operands.src2);
 
             const OperandsSyncLockSource* sources = (const OperandsSyncLockSource*)&bytecode[1];
 
             const size_t extended = operands.num - 2;
             for(uint16_t i = 0; i < extended; i++) {
-                sync_value_at(sources[i]);
+                sync_value_at(frame, sources[i]);
             }
 
             if(extended > 0) { // increment
@@ -346,26 +533,26 @@ static void execute_sync(int64_t* const ipIncrement, const Bytecode* bytecode) {
     }
 }
 
-static void execute_move(const Bytecode bytecode) {
+static void execute_move(const InterpreterFramePointer* frame, const Bytecode bytecode) {
     const OperandsMove operands = *(const OperandsMove*)&bytecode;
 
-    const CubsTypeContext* context = cubs_interpreter_stack_context_at(operands.src);
-    const void* src = cubs_interpreter_stack_value_at(operands.src);
-    void* dst = cubs_interpreter_stack_value_at(operands.dst);
+    const CubsTypeContext* context = cubs_frame_context_at(frame, operands.src);
+    const void* src = cubs_frame_value_at(frame, operands.src);
+    void* dst = cubs_frame_value_at(frame, operands.dst);
     memcpy(dst, src, context->sizeOfType);
-    cubs_interpreter_stack_set_context_at(operands.dst, context);
-    cubs_interpreter_stack_set_null_context_at(operands.src); // invalidate original location
+    cubs_frame_set_context_at(frame, operands.dst, context);
+    cubs_frame_set_null_context_at(frame, operands.src); // invalidate original location
 }
 
-static void execute_clone(const Bytecode bytecode) {
+static void execute_clone(const InterpreterFramePointer* frame, const Bytecode bytecode) {
     const OperandsClone operands = *(const OperandsClone*)&bytecode;
 
-    const CubsTypeContext* context = cubs_interpreter_stack_context_at(operands.src);
+    const CubsTypeContext* context = cubs_frame_context_at(frame, operands.src);
     assert(context->clone.func.externC != NULL);
-    const void* src = cubs_interpreter_stack_value_at(operands.src);
-    void* dst = cubs_interpreter_stack_value_at(operands.dst);
+    const void* src = cubs_frame_value_at(frame, operands.src);
+    void* dst = cubs_frame_value_at(frame, operands.dst);
     cubs_context_fast_clone(dst, src, context);
-    cubs_interpreter_stack_set_context_at(operands.dst, context);
+    cubs_frame_set_context_at(frame, operands.dst, context);
 }
 
 static bool is_reference_type_context(const CubsTypeContext* context) {
@@ -376,13 +563,13 @@ static bool is_reference_type_context(const CubsTypeContext* context) {
     || context == &CUBS_WEAK_CONTEXT;
 }
 
-static void execute_dereference(const Bytecode bytecode) {
+static void execute_dereference(const InterpreterFramePointer* frame, const Bytecode bytecode) {
     const OperandsDereference operands = *(const OperandsDereference*)&bytecode;
 
-    const CubsTypeContext* refContext = cubs_interpreter_stack_context_at(operands.src);
+    const CubsTypeContext* refContext = cubs_frame_context_at(frame, operands.src);
     assert(is_reference_type_context(refContext) && "Expected reference type for dereference operation");
 
-    const void* refSrc = cubs_interpreter_stack_value_at(operands.src);
+    const void* refSrc = cubs_frame_value_at(frame, operands.src);
     const CubsTypeContext* actualTypeContext = NULL;
     const void* actualSrc = NULL;
     if(refContext == &CUBS_CONST_REF_CONTEXT) {
@@ -408,18 +595,18 @@ static void execute_dereference(const Bytecode bytecode) {
         unreachable();
     }
 
-    cubs_interpreter_stack_set_reference_context_at(operands.dst, actualTypeContext);
-    memcpy(cubs_interpreter_stack_value_at(operands.dst), actualSrc, actualTypeContext->sizeOfType);
+    cubs_frame_set_reference_context_at(frame, operands.dst, actualTypeContext);
+    memcpy(cubs_frame_value_at(frame, operands.dst), actualSrc, actualTypeContext->sizeOfType);
 }
 
-static void execute_set_reference(const Bytecode bytecode) {
+static void execute_set_reference(const InterpreterFramePointer* frame, const Bytecode bytecode) {
     const OperandsSetReference operands = *(const OperandsSetReference*)&bytecode;
 
-    const CubsTypeContext* refContext = cubs_interpreter_stack_context_at(operands.dst);
-    const CubsTypeContext* srcContext = cubs_interpreter_stack_context_at(operands.src);
+    const CubsTypeContext* refContext = cubs_frame_context_at(frame, operands.dst);
+    const CubsTypeContext* srcContext = cubs_frame_context_at(frame, operands.src);
     assert(is_reference_type_context(refContext) && "Expected reference type for dereference operation");
 
-    void* refDst = cubs_interpreter_stack_value_at(operands.dst);
+    void* refDst = cubs_frame_value_at(frame, operands.dst);
     void* actualDst = NULL;
     if(refContext == &CUBS_CONST_REF_CONTEXT) {
         assert(false && "Cannot set the value of a const reference");
@@ -448,37 +635,37 @@ static void execute_set_reference(const Bytecode bytecode) {
         unreachable();
     }
 
-    memcpy(actualDst, cubs_interpreter_stack_value_at(operands.src), srcContext->sizeOfType);
+    memcpy(actualDst, cubs_frame_value_at(frame, operands.src), srcContext->sizeOfType);
 }
 
-static void execute_make_reference(const Bytecode bytecode) {
+static void execute_make_reference(const InterpreterFramePointer* frame, const Bytecode bytecode) {
     const OperandsMakeReference operands = *(const OperandsMakeReference*)&bytecode;
 
-    const CubsTypeContext* refContext = cubs_interpreter_stack_context_at(operands.src);
+    const CubsTypeContext* refContext = cubs_frame_context_at(frame, operands.src);
 
-    void* src = cubs_interpreter_stack_value_at(operands.src);
-    void* dst = cubs_interpreter_stack_value_at(operands.dst);
+    void* src = cubs_frame_value_at(frame, operands.src);
+    void* dst = cubs_frame_value_at(frame, operands.dst);
 
     if(operands.mutable) {
         CubsMutRef ref = {.ref = src, .context = refContext};
         *(CubsMutRef*)dst = ref;
-        cubs_interpreter_stack_set_context_at(operands.dst, &CUBS_MUT_REF_CONTEXT);
+        cubs_frame_set_context_at(frame, operands.dst, &CUBS_MUT_REF_CONTEXT);
     } else {
         CubsConstRef ref = {.ref = src, .context = refContext};
         *(CubsConstRef*)dst = ref;
-        cubs_interpreter_stack_set_context_at(operands.dst, &CUBS_CONST_REF_CONTEXT);    
+        cubs_frame_set_context_at(frame, operands.dst, &CUBS_CONST_REF_CONTEXT);    
     }
 }
 
-static void execute_get_member(const Bytecode bytecode) {
+static void execute_get_member(const InterpreterFramePointer* frame, const Bytecode bytecode) {
     const OperandsGetMember operands = *(const OperandsGetMember*)&bytecode;
 
     const void* srcValue = NULL;
     const CubsTypeContext* srcContext = NULL;
 
     { // automatically dereference if necessary
-        const CubsTypeContext* tempSrcContext = cubs_interpreter_stack_context_at(operands.src);
-        const void* tempSrcValue = cubs_interpreter_stack_value_at(operands.src);
+        const CubsTypeContext* tempSrcContext = cubs_frame_context_at(frame, operands.src);
+        const void* tempSrcValue = cubs_frame_value_at(frame, operands.src);
         if(!is_reference_type_context(tempSrcContext)) {
             srcValue = tempSrcValue;
             srcContext = tempSrcContext;
@@ -514,20 +701,20 @@ static void execute_get_member(const Bytecode bytecode) {
     
     const void* memberSrc = (const void*)&(((const uint8_t*)srcValue)[memberByteOffset]);
 
-    void* dst = cubs_interpreter_stack_value_at(operands.dst);
-    cubs_interpreter_stack_set_reference_context_at(operands.dst, memberContext);
+    void* dst = cubs_frame_value_at(frame, operands.dst);
+    cubs_frame_set_reference_context_at(frame, operands.dst, memberContext);
     memcpy(dst, memberSrc, memberContext->sizeOfType);
 }
 
-static void execute_set_member(const Bytecode bytecode) {
+static void execute_set_member(const InterpreterFramePointer* frame, const Bytecode bytecode) {
     const OperandsSetMember operands = *(const OperandsSetMember*)&bytecode;
 
     const void* dstValue = NULL;
     const CubsTypeContext* dstContext = NULL;
 
     { // handle both reference and value types
-        const CubsTypeContext* tempDstContext = cubs_interpreter_stack_context_at(operands.dst);
-        const void* tempDstValue = cubs_interpreter_stack_value_at(operands.dst);
+        const CubsTypeContext* tempDstContext = cubs_frame_context_at(frame, operands.dst);
+        const void* tempDstValue = cubs_frame_value_at(frame, operands.dst);
         if(!is_reference_type_context(tempDstContext)) {
             dstValue = tempDstValue;
             dstContext = tempDstContext;
@@ -563,102 +750,128 @@ static void execute_set_member(const Bytecode bytecode) {
     
     const void* memberDst = (const void*)&(((const uint8_t*)dstValue)[memberByteOffset]);
 
-    const void* src = cubs_interpreter_stack_value_at(operands.src);
-    assert(memberContext == cubs_interpreter_stack_context_at(operands.src));
+    const void* src = cubs_frame_value_at(frame, operands.src);
+    assert(memberContext == cubs_frame_context_at(frame, operands.src));
     memcpy(memberDst, src, memberContext->sizeOfType);
 }
 
-static void execute_equal(const Bytecode bytecode) {
+static void execute_equal(const InterpreterFramePointer* frame, const Bytecode bytecode) {
     const OperandsEqual operands = *(const OperandsEqual*)&bytecode;
-    const CubsTypeContext* context = cubs_interpreter_stack_context_at(operands.src1);
-    assert(context == cubs_interpreter_stack_context_at(operands.src2));
+    const CubsTypeContext* context = cubs_frame_context_at(frame, operands.src1);
+    assert(context == cubs_frame_context_at(frame, operands.src2));
 
-    const void* src1 = cubs_interpreter_stack_value_at(operands.src1);
-    const void* src2 = cubs_interpreter_stack_value_at(operands.src2);
-    void* dst = cubs_interpreter_stack_value_at(operands.dst);
+    const void* src1 = cubs_frame_value_at(frame, operands.src1);
+    const void* src2 = cubs_frame_value_at(frame, operands.src2);
+    void* dst = cubs_frame_value_at(frame, operands.dst);
 
     const bool eq = cubs_context_fast_eql(src1, src2, context);
 
     *(bool*)dst = eq; // normal
-    cubs_interpreter_stack_set_context_at(operands.dst, &CUBS_BOOL_CONTEXT);
+    cubs_frame_set_context_at(frame, operands.dst, &CUBS_BOOL_CONTEXT);
 }
 
-static void execute_not_equal(const Bytecode bytecode) {
+static void execute_not_equal(const InterpreterFramePointer* frame, const Bytecode bytecode) {
     const OperandsNotEqual operands = *(const OperandsNotEqual*)&bytecode;
-    const CubsTypeContext* context = cubs_interpreter_stack_context_at(operands.src1);
-    assert(context == cubs_interpreter_stack_context_at(operands.src2));
+    const CubsTypeContext* context = cubs_frame_context_at(frame, operands.src1);
+    assert(context == cubs_frame_context_at(frame, operands.src2));
 
-    const void* src1 = cubs_interpreter_stack_value_at(operands.src1);
-    const void* src2 = cubs_interpreter_stack_value_at(operands.src2);
-    void* dst = cubs_interpreter_stack_value_at(operands.dst);
+    const void* src1 = cubs_frame_value_at(frame, operands.src1);
+    const void* src2 = cubs_frame_value_at(frame, operands.src2);
+    void* dst = cubs_frame_value_at(frame, operands.dst);
 
     const bool eq = cubs_context_fast_eql(src1, src2, context);
 
     *(bool*)dst = !eq; // not
-    cubs_interpreter_stack_set_context_at(operands.dst, &CUBS_BOOL_CONTEXT);
+    cubs_frame_set_context_at(frame, operands.dst, &CUBS_BOOL_CONTEXT);
 }
 
-static void execute_less(const Bytecode bytecode) {
+static void execute_less(const InterpreterFramePointer* frame, const Bytecode bytecode) {
     const OperandsNotEqual operands = *(const OperandsNotEqual*)&bytecode;
-    const CubsTypeContext* context = cubs_interpreter_stack_context_at(operands.src1);
-    assert(context == cubs_interpreter_stack_context_at(operands.src2));
+    const CubsTypeContext* context = cubs_frame_context_at(frame, operands.src1);
+    assert(context == cubs_frame_context_at(frame, operands.src2));
 
-    const void* src1 = cubs_interpreter_stack_value_at(operands.src1);
-    const void* src2 = cubs_interpreter_stack_value_at(operands.src2);
-    void* dst = cubs_interpreter_stack_value_at(operands.dst);
+    const void* src1 = cubs_frame_value_at(frame, operands.src1);
+    const void* src2 = cubs_frame_value_at(frame, operands.src2);
+    void* dst = cubs_frame_value_at(frame, operands.dst);
 
     const CubsOrdering ordering = cubs_context_fast_compare(src1, src2, context);
     *(bool*)dst = ordering == cubsOrderingLess;
-    cubs_interpreter_stack_set_context_at(operands.dst, &CUBS_BOOL_CONTEXT);
+    cubs_frame_set_context_at(frame, operands.dst, &CUBS_BOOL_CONTEXT);
 }
 
-static void execute_less_or_equal(const Bytecode bytecode) {
+static void execute_less_or_equal(const InterpreterFramePointer* frame, const Bytecode bytecode) {
     const OperandsNotEqual operands = *(const OperandsNotEqual*)&bytecode;
-    const CubsTypeContext* context = cubs_interpreter_stack_context_at(operands.src1);
-    assert(context == cubs_interpreter_stack_context_at(operands.src2));
+    const CubsTypeContext* context = cubs_frame_context_at(frame, operands.src1);
+    assert(context == cubs_frame_context_at(frame, operands.src2));
 
-    const void* src1 = cubs_interpreter_stack_value_at(operands.src1);
-    const void* src2 = cubs_interpreter_stack_value_at(operands.src2);
-    void* dst = cubs_interpreter_stack_value_at(operands.dst);
+    const void* src1 = cubs_frame_value_at(frame, operands.src1);
+    const void* src2 = cubs_frame_value_at(frame, operands.src2);
+    void* dst = cubs_frame_value_at(frame, operands.dst);
 
     const CubsOrdering ordering = cubs_context_fast_compare(src1, src2, context);
     *(bool*)dst = (ordering == cubsOrderingLess) || (ordering == cubsOrderingEqual);
-    cubs_interpreter_stack_set_context_at(operands.dst, &CUBS_BOOL_CONTEXT);
+    cubs_frame_set_context_at(frame, operands.dst, &CUBS_BOOL_CONTEXT);
 }
 
-static void execute_greater(const Bytecode bytecode) {
+static void execute_greater(const InterpreterFramePointer* frame, const Bytecode bytecode) {
     const OperandsNotEqual operands = *(const OperandsNotEqual*)&bytecode;
-    const CubsTypeContext* context = cubs_interpreter_stack_context_at(operands.src1);
-    assert(context == cubs_interpreter_stack_context_at(operands.src2));
+    const CubsTypeContext* context = cubs_frame_context_at(frame, operands.src1);
+    assert(context == cubs_frame_context_at(frame, operands.src2));
 
-    const void* src1 = cubs_interpreter_stack_value_at(operands.src1);
-    const void* src2 = cubs_interpreter_stack_value_at(operands.src2);
-    void* dst = cubs_interpreter_stack_value_at(operands.dst);
+    const void* src1 = cubs_frame_value_at(frame, operands.src1);
+    const void* src2 = cubs_frame_value_at(frame, operands.src2);
+    void* dst = cubs_frame_value_at(frame, operands.dst);
 
     const CubsOrdering ordering = cubs_context_fast_compare(src1, src2, context);
     *(bool*)dst = ordering == cubsOrderingGreater;
-    cubs_interpreter_stack_set_context_at(operands.dst, &CUBS_BOOL_CONTEXT);
+    cubs_frame_set_context_at(frame, operands.dst, &CUBS_BOOL_CONTEXT);
 }
 
-static void execute_greater_or_equal(const Bytecode bytecode) {
+static void execute_greater_or_equal(const InterpreterFramePointer* frame, const Bytecode bytecode) {
     const OperandsNotEqual operands = *(const OperandsNotEqual*)&bytecode;
-    const CubsTypeContext* context = cubs_interpreter_stack_context_at(operands.src1);
-    assert(context == cubs_interpreter_stack_context_at(operands.src2));
+    const CubsTypeContext* context = cubs_frame_context_at(frame, operands.src1);
+    assert(context == cubs_frame_context_at(frame, operands.src2));
 
-    const void* src1 = cubs_interpreter_stack_value_at(operands.src1);
-    const void* src2 = cubs_interpreter_stack_value_at(operands.src2);
-    void* dst = cubs_interpreter_stack_value_at(operands.dst);
+    const void* src1 = cubs_frame_value_at(frame, operands.src1);
+    const void* src2 = cubs_frame_value_at(frame, operands.src2);
+    void* dst = cubs_frame_value_at(frame, operands.dst);
 
     const CubsOrdering ordering = cubs_context_fast_compare(src1, src2, context);
     *(bool*)dst = (ordering == cubsOrderingGreater) || (ordering == cubsOrderingEqual);
-    cubs_interpreter_stack_set_context_at(operands.dst, &CUBS_BOOL_CONTEXT);
+    cubs_frame_set_context_at(frame, operands.dst, &CUBS_BOOL_CONTEXT);
+}
+
+static CubsProgramRuntimeError report_increment_overflow(const CubsProgram* program, int64_t a) {
+    assert(program != NULL);
+    char errBuf[256];
+    #if defined(_WIN32) || defined(WIN32)
+    const int len = sprintf_s(errBuf, 256, "Increment integer overflow detected -> %lld + 1\n", a);
+    #else
+    const int len = sprintf(errBuf, "increment integer overflow detected -> %lld + 1\n", a);
+    #endif
+    assert(len >= 0);           
+    _cubs_internal_program_runtime_error(program, cubsProgramRuntimeErrorIncrementIntegerOverflow, errBuf, len);             
+    return cubsProgramRuntimeErrorIncrementIntegerOverflow;
+}
+
+static CubsProgramRuntimeError report_add_overflow(const CubsProgram* program, int64_t a, int64_t b) {
+    assert(program != NULL);
+    char errBuf[256];
+    #if defined(_WIN32) || defined(WIN32)
+    const int len = sprintf_s(errBuf, 256, "Integer overflow detected -> %lld + %lld\n", a, b);
+    #else
+    const int len = sprintf(errBuf, "Integer overflow detected -> %lld + %lld\n", a, b);
+    #endif
+    assert(len >= 0);           
+    _cubs_internal_program_runtime_error(program, cubsProgramRuntimeErrorAdditionIntegerOverflow, errBuf, len);             
+    return cubsProgramRuntimeErrorAdditionIntegerOverflow;
 }
 
-static CubsProgramRuntimeError execute_increment(const CubsProgram* program, const Bytecode bytecode) {
+static CubsProgramRuntimeError execute_increment(const CubsProgram* program, const InterpreterFramePointer* frame, const Bytecode bytecode) {
     const OperandsIncrementUnknown unknownOperands = *(const OperandsIncrementUnknown*)&bytecode;
-    const CubsTypeContext* context = cubs_interpreter_stack_context_at(unknownOperands.src);
+    const CubsTypeContext* context = cubs_frame_context_at(frame, unknownOperands.src);
 
-    void* src = cubs_interpreter_stack_value_at(unknownOperands.src);
+    void* src = cubs_frame_value_at(frame, unknownOperands.src);
 
     if(context == &CUBS_INT_CONTEXT) {
         const int64_t a = *(const int64_t*)src;
@@ -666,25 +879,16 @@ static CubsProgramRuntimeError execute_increment(const CubsProgram* program, con
         if(!unknownOperands.canOverflow) {
             const bool wouldOverflow = cubs_math_would_add_overflow(a, 1);
             if(wouldOverflow) {
-                assert(program != NULL);
-                char errBuf[256];
-                #if defined(_WIN32) || defined(WIN32)
-                const int len = sprintf_s(errBuf, 256, "Increment integer overflow detected -> %lld + 1\n", a);
-                #else
-                const int len = sprintf(errBuf, "increment integer overflow detected -> %lld + 1\n", a);
-                #endif
-                assert(len >= 0);           
-                _cubs_internal_program_runtime_error(program, cubsProgramRuntimeErrorIncrementIntegerOverflow, errBuf, len);             
-                return cubsProgramRuntimeErrorIncrementIntegerOverflow;
+                return report_increment_overflow(program, a);
             }
             result = a + 1;
         } else { // is allowed to overflow
             cubs_panic("overflow-abled increment not yet implemented");
         }              
         if(unknownOperands.opType == MATH_TYPE_DST) {
-            const OperandsAddDst dstOperands = *(const OperandsAddDst*)&bytecode;
-            *(int64_t*)(cubs_interpreter_stack_value_at(dstOperands.dst)) = result;
-            cubs_interpreter_stack_set_context_at(dstOperands.dst, &CUBS_INT_CONTEXT);
+            const OperandsIncrementDst dstOperands = *(const OperandsIncrementDst*)&bytecode;
+            *(int64_t*)(cubs_frame_value_at(frame, dstOperands.dst)) = result;
+            cubs_frame_set_context_at(frame, dstOperands.dst, &CUBS_INT_CONTEXT);
         } else if(unknownOperands.opType == MATH_TYPE_SRC_ASSIGN) {
             *(int64_t*)src = result;
         }
@@ -694,19 +898,19 @@ static CubsProgramRuntimeError execute_increment(const CubsProgram* program, con
     return cubsProgramRuntimeErrorNone;
 }
 
-static CubsProgramRuntimeError execute_add(const CubsProgram *program, const Bytecode bytecode) {
+static CubsProgramRuntimeError execute_add(const CubsProgram *program, const InterpreterFramePointer* frame, const Bytecode bytecode) {
     const OperandsAddUnknown unknownOperands = *(const OperandsAddUnknown*)&bytecode;
-    const CubsTypeContext* context = cubs_interpreter_stack_context_at(unknownOperands.src1);
+    const CubsTypeContext* context = cubs_frame_context_at(frame, unknownOperands.src1);
     #ifdef _DEBUG
-    if(cubs_interpreter_stack_context_at(unknownOperands.src2) != context) {
-        fprintf(stderr, "Mistmatched contexts found...\n\t%s\n\t%s\n", context->name, cubs_interpreter_stack_context_at(unknownOperands.src2)->name);
+    if(cubs_frame_context_at(frame, unknownOperands.src2) != context) {
+        fprintf(stderr, "Mistmatched contexts found...\n\t%s\n\t%s\n", context->name, cubs_frame_context_at(frame, unknownOperands.src2)->name);
         fflush(stderr);
         cubs_panic("Mismatched contexts");
     }
     #endif
 
-    void* src1 = cubs_interpreter_stack_value_at(unknownOperands.src1);
-    const void* src2 = cubs_interpreter_stack_value_at(unknownOperands.src2);
+    void* src1 = cubs_frame_value_at(frame, unknownOperands.src1);
+    const void* src2 = cubs_frame_value_at(frame, unknownOperands.src2);
 
     if(context == &CUBS_INT_CONTEXT) {
         const int64_t a = *(const int64_t*)src1;
@@ -715,16 +919,7 @@ static CubsProgramRuntimeError execute_add(const CubsProgram *program, const Byt
         if(!unknownOperands.canOverflow) {
             const bool wouldOverflow = cubs_math_would_add_overflow(a, b);
             if(wouldOverflow) {
-                assert(program != NULL);
-                char errBuf[256];
-                #if defined(_WIN32) || defined(WIN32)
-                const int len = sprintf_s(errBuf, 256, "Integer overflow detected -> %lld + %lld\n", a, b);
-                #else
-                const int len = sprintf(errBuf, "Integer overflow detected -> %lld + %lld\n", a, b);
-                #endif
-                assert(len >= 0);           
-                _cubs_internal_program_runtime_error(program, cubsProgramRuntimeErrorAdditionIntegerOverflow, errBuf, len);             
-                return cubsProgramRuntimeErrorAdditionIntegerOverflow;
+                return report_add_overflow(program, a, b);
             }
             result = a + b;
         } else { // is allowed to overflow
@@ -732,8 +927,8 @@ static CubsProgramRuntimeError execute_add(const CubsProgram *program, const Byt
         }
         if(unknownOperands.opType == MATH_TYPE_DST) {
             const OperandsAddDst dstOperands = *(const OperandsAddDst*)&bytecode;
-            *(int64_t*)(cubs_interpreter_stack_value_at(dstOperands.dst)) = result;
-            cubs_interpreter_stack_set_context_at(dstOperands.dst, &CUBS_INT_CONTEXT);
+            *(int64_t*)(cubs_frame_value_at(frame, dstOperands.dst)) = result;
+            cubs_frame_set_context_at(frame, dstOperands.dst, &CUBS_INT_CONTEXT);
         } else if(unknownOperands.opType == MATH_TYPE_SRC_ASSIGN) {
             *(int64_t*)src1 = result;
         }
@@ -743,8 +938,8 @@ static CubsProgramRuntimeError execute_add(const CubsProgram *program, const Byt
         double result = a + b;
         if(unknownOperands.opType == MATH_TYPE_DST) {
             const OperandsAddDst dstOperands = *(const OperandsAddDst*)&bytecode;
-            *(double*)(cubs_interpreter_stack_value_at(dstOperands.dst)) = result;
-            cubs_interpreter_stack_set_context_at(dstOperands.dst, &CUBS_FLOAT_CONTEXT);
+            *(double*)(cubs_frame_value_at(frame, dstOperands.dst)) = result;
+            cubs_frame_set_context_at(frame, dstOperands.dst, &CUBS_FLOAT_CONTEXT);
         } else if(unknownOperands.opType == MATH_TYPE_SRC_ASSIGN) {
             *(double*)src1 = result;
         }
@@ -752,8 +947,8 @@ static CubsProgramRuntimeError execute_add(const CubsProgram *program, const Byt
         const CubsString result = cubs_string_concat((const CubsString*)src1, (const CubsString*)src2);
         if(unknownOperands.opType == MATH_TYPE_DST) {
             const OperandsAddDst dstOperands = *(const OperandsAddDst*)&bytecode;
-            *(CubsString*)(cubs_interpreter_stack_value_at(dstOperands.dst)) = result;
-            cubs_interpreter_stack_set_context_at(dstOperands.dst, &CUBS_STRING_CONTEXT);
+            *(CubsString*)(cubs_frame_value_at(frame, dstOperands.dst)) = result;
+            cubs_frame_set_context_at(frame, dstOperands.dst, &CUBS_STRING_CONTEXT);
         } else if(unknownOperands.opType == MATH_TYPE_SRC_ASSIGN) {
             cubs_string_deinit((CubsString*)src1); // deinitialize the string first, freeing any used resources
             *(CubsString*)src1 = result;
@@ -764,10 +959,220 @@ static CubsProgramRuntimeError execute_add(const CubsProgram *program, const Byt
     return cubsProgramRuntimeErrorNone;
 }
 
-CubsProgramRuntimeError cubs_interpreter_execute_operation(const CubsProgram *program)
-{
+static CubsProgramRuntimeError execute_increment_int(const CubsProgram* program, const InterpreterFramePointer* frame, const Bytecode bytecode) {
+    const OperandsIncrementUnknown unknownOperands = *(const OperandsIncrementUnknown*)&bytecode;
+    assert(cubs_frame_context_at(frame, unknownOperands.src) == &CUBS_INT_CONTEXT);
+
+    int64_t* src = (int64_t*)cubs_frame_value_at(frame, unknownOperands.src);
+    const int64_t a = *src;
+    if(unknownOperands.canOverflow) {
+        cubs_panic("overflow-abled increment not yet implemented");
+    }
+    if(cubs_math_would_add_overflow(a, 1)) {
+        return report_increment_overflow(program, a);
+    }
+
+    if(unknownOperands.opType == MATH_TYPE_DST) {
+        const OperandsIncrementDst dstOperands = *(const OperandsIncrementDst*)&bytecode;
+        *(int64_t*)(cubs_frame_value_at(frame, dstOperands.dst)) = a + 1;
+        cubs_frame_set_context_at(frame, dstOperands.dst, &CUBS_INT_CONTEXT);
+    } else {
+        *src = a + 1;
+    }
+    return cubsProgramRuntimeErrorNone;
+}
+
+static CubsProgramRuntimeError execute_add_int(const CubsProgram* program, const InterpreterFramePointer* frame, const Bytecode bytecode) {
+    const OperandsAddUnknown unknownOperands = *(const OperandsAddUnknown*)&bytecode;
+    assert(cubs_frame_context_at(frame, unknownOperands.src1) == &CUBS_INT_CONTEXT);
+    assert(cubs_frame_context_at(frame, unknownOperands.src2) == &CUBS_INT_CONTEXT);
+
+    int64_t* src1 = (int64_t*)cubs_frame_value_at(frame, unknownOperands.src1);
+    const int64_t a = *src1;
+    const int64_t b = *(const int64_t*)cubs_frame_value_at(frame, unknownOperands.src2);
+    if(unknownOperands.canOverflow) {
+        cubs_panic("overflow-abled addition not yet implemented");
+    }
+    if(cubs_math_would_add_overflow(a, b)) {
+        return report_add_overflow(program, a, b);
+    }
+
+    if(unknownOperands.opType == MATH_TYPE_DST) {
+        const OperandsAddDst dstOperands = *(const OperandsAddDst*)&bytecode;
+        *(int64_t*)(cubs_frame_value_at(frame, dstOperands.dst)) = a + b;
+        cubs_frame_set_context_at(frame, dstOperands.dst, &CUBS_INT_CONTEXT);
+    } else {
+        *src1 = a + b;
+    }
+    return cubsProgramRuntimeErrorNone;
+}
+
+static void execute_add_float(const InterpreterFramePointer* frame, const Bytecode bytecode) {
+    const OperandsAddUnknown unknownOperands = *(const OperandsAddUnknown*)&bytecode;
+    assert(cubs_frame_context_at(frame, unknownOperands.src1) == &CUBS_FLOAT_CONTEXT);
+    assert(cubs_frame_context_at(frame, unknownOperands.src2) == &CUBS_FLOAT_CONTEXT);
+
+    double* src1 = (double*)cubs_frame_value_at(frame, unknownOperands.src1);
+    const double result = *src1 + *(const double*)cubs_frame_value_at(frame, unknownOperands.src2);
+
+    if(unknownOperands.opType == MATH_TYPE_DST) {
+        const OperandsAddDst dstOperands = *(const OperandsAddDst*)&bytecode;
+        *(double*)(cubs_frame_value_at(frame, dstOperands.dst)) = result;
+        cubs_frame_set_context_at(frame, dstOperands.dst, &CUBS_FLOAT_CONTEXT);
+    } else {
+        *src1 = result;
+    }
+}
+
+/// Stores the bool result of a specialized compare operation.
+static void store_compare_result(const InterpreterFramePointer* frame, uint16_t dst, bool result) {
+    *(bool*)cubs_frame_value_at(frame, dst) = result;
+    cubs_frame_set_context_at(frame, dst, &CUBS_BOOL_CONTEXT);
+}
+
+static void execute_equal_int(const InterpreterFramePointer* frame, const Bytecode bytecode) {
+    const OperandsEqual operands = *(const OperandsEqual*)&bytecode;
+    assert(cubs_frame_context_at(frame, operands.src1) == &CUBS_INT_CONTEXT);
+    assert(cubs_frame_context_at(frame, operands.src2) == &CUBS_INT_CONTEXT);
+    const int64_t a = *(const int64_t*)cubs_frame_value_at(frame, operands.src1);
+    const int64_t b = *(const int64_t*)cubs_frame_value_at(frame, operands.src2);
+    store_compare_result(frame, operands.dst, a == b);
+}
+
+static void execute_not_equal_int(const InterpreterFramePointer* frame, const Bytecode bytecode) {
+    const OperandsNotEqual operands = *(const OperandsNotEqual*)&bytecode;
+    assert(cubs_frame_context_at(frame, operands.src1) == &CUBS_INT_CONTEXT);
+    assert(cubs_frame_context_at(frame, operands.src2) == &CUBS_INT_CONTEXT);
+    const int64_t a = *(const int64_t*)cubs_frame_value_at(frame, operands.src1);
+    const int64_t b = *(const int64_t*)cubs_frame_value_at(frame, operands.src2);
+    store_compare_result(frame, operands.dst, a != b);
+}
+
+static void execute_less_int(const InterpreterFramePointer* frame, const Bytecode bytecode) {
+    const OperandsLess operands = *(const OperandsLess*)&bytecode;
+    assert(cubs_frame_context_at(frame, operands.src1) == &CUBS_INT_CONTEXT);
+    assert(cubs_frame_context_at(frame, operands.src2) == &CUBS_INT_CONTEXT);
+    const int64_t a = *(const int64_t*)cubs_frame_value_at(frame, operands.src1);
+    const int64_t b = *(const int64_t*)cubs_frame_value_at(frame, operands.src2);
+    store_compare_result(frame, operands.dst, a < b);
+}
+
+static void execute_greater_int(const InterpreterFramePointer* frame, const Bytecode bytecode) {
+    const OperandsGreater operands = *(const OperandsGreater*)&bytecode;
+    assert(cubs_frame_context_at(frame, operands.src1) == &CUBS_INT_CONTEXT);
+    assert(cubs_frame_context_at(frame, operands.src2) == &CUBS_INT_CONTEXT);
+    const int64_t a = *(const int64_t*)cubs_frame_value_at(frame, operands.src1);
+    const int64_t b = *(const int64_t*)cubs_frame_value_at(frame, operands.src2);
+    store_compare_result(frame, operands.dst, a > b);
+}
+
+static void execute_less_or_equal_int(const InterpreterFramePointer* frame, const Bytecode bytecode) {
+    const OperandsLessOrEqual operands = *(const OperandsLessOrEqual*)&bytecode;
+    assert(cubs_frame_context_at(frame, operands.src1) == &CUBS_INT_CONTEXT);
+    assert(cubs_frame_context_at(frame, operands.src2) == &CUBS_INT_CONTEXT);
+    const int64_t a = *(const int64_t*)cubs_frame_value_at(frame, operands.src1);
+    const int64_t b = *(const int64_t*)cubs_frame_value_at(frame, operands.src2);
+    store_compare_result(frame, operands.dst, a <= b);
+}
+
+static void execute_greater_or_equal_int(const InterpreterFramePointer* frame, const Bytecode bytecode) {
+    const OperandsGreaterOrEqual operands = *(const OperandsGreaterOrEqual*)&bytecode;
+    assert(cubs_frame_context_at(frame, operands.src1) == &CUBS_INT_CONTEXT);
+    assert(cubs_frame_context_at(frame, operands.src2) == &CUBS_INT_CONTEXT);
+    const int64_t a = *(const int64_t*)cubs_frame_value_at(frame, operands.src1);
+    const int64_t b = *(const int64_t*)cubs_frame_value_at(frame, operands.src2);
+    store_compare_result(frame, operands.dst, a >= b);
+}
+
+static void execute_less_float(const InterpreterFramePointer* frame, const Bytecode bytecode) {
+    const OperandsLess operands = *(const OperandsLess*)&bytecode;
+    assert(cubs_frame_context_at(frame, operands.src1) == &CUBS_FLOAT_CONTEXT);
+    assert(cubs_frame_context_at(frame, operands.src2) == &CUBS_FLOAT_CONTEXT);
+    const double a = *(const double*)cubs_frame_value_at(frame, operands.src1);
+    const double b = *(const double*)cubs_frame_value_at(frame, operands.src2);
+    store_compare_result(frame, operands.dst, a < b);
+}
+
+static void execute_greater_float(const InterpreterFramePointer* frame, const Bytecode bytecode) {
+    const OperandsGreater operands = *(const OperandsGreater*)&bytecode;
+    assert(cubs_frame_context_at(frame, operands.src1) == &CUBS_FLOAT_CONTEXT);
+    assert(cubs_frame_context_at(frame, operands.src2) == &CUBS_FLOAT_CONTEXT);
+    const double a = *(const double*)cubs_frame_value_at(frame, operands.src1);
+    const double b = *(const double*)cubs_frame_value_at(frame, operands.src2);
+    // Matches `cubs_context_fast_compare(...)`, where NaN compares as greater
+    store_compare_result(frame, operands.dst, !(a == b) && !(a < b));
+}
+
+static void execute_less_or_equal_float(const InterpreterFramePointer* frame, const Bytecode bytecode) {
+    const OperandsLessOrEqual operands = *(const OperandsLessOrEqual*)&bytecode;
+    assert(cubs_frame_context_at(frame, operands.src1) == &CUBS_FLOAT_CONTEXT);
+    assert(cubs_frame_context_at(frame, operands.src2) == &CUBS_FLOAT_CONTEXT);
+    const double a = *(const double*)cubs_frame_value_at(frame, operands.src1);
+    const double b = *(const double*)cubs_frame_value_at(frame, operands.src2);
+    store_compare_result(frame, operands.dst, a <= b);
+}
+
+static void execute_greater_or_equal_float(const InterpreterFramePointer* frame, const Bytecode bytecode) {
+    const OperandsGreaterOrEqual operands = *(const OperandsGreaterOrEqual*)&bytecode;
+    assert(cubs_frame_context_at(frame, operands.src1) == &CUBS_FLOAT_CONTEXT);
+    assert(cubs_frame_context_at(frame, operands.src2) == &CUBS_FLOAT_CONTEXT);
+    const double a = *(const double*)cubs_frame_value_at(frame, operands.src1);
+    const double b = *(const double*)cubs_frame_value_at(frame, operands.src2);
+    // Matches `cubs_context_fast_compare(...)`, where NaN compares as greater
+    store_compare_result(frame, operands.dst, !(a < b));
+}
+
+/// See `OpCodeIncrementLessIntJump`. Reads the jump from `bytecode[2]`.
+static CubsProgramRuntimeError execute_increment_less_int_jump(const CubsProgram* program, const InterpreterFramePointer* frame, int64_t* const ipIncrement, const Bytecode* bytecode) {
+    const OperandsIncrementLessIntJump operands = *(const OperandsIncrementLessIntJump*)bytecode;
+    assert(cubs_frame_context_at(frame, operands.src) == &CUBS_INT_CONTEXT);
+    assert(cubs_frame_context_at(frame, operands.compareSrc2) == &CUBS_INT_CONTEXT);
+
+    int64_t* src = (int64_t*)cubs_frame_value_at(frame, operands.src);
+    const int64_t a = *src;
+    if(cubs_math_would_add_overflow(a, 1)) {
+        return report_increment_overflow(program, a);
+    }
+    *src = a + 1;
+
+    // `compareSrc2` may be the same as `src`, so read it after incrementing
+    const bool isLess = *src < *(const int64_t*)cubs_frame_value_at(frame, operands.compareSrc2);
+    store_compare_result(frame, operands.compareDst, isLess);
+
+    const OperandsJump jump = *(const OperandsJump*)&bytecode[2];
+    assert(cubs_bytecode_get_opcode(bytecode[2]) == OpCodeJump);
+    const bool shouldJump = jump.opType == JUMP_TYPE_IF_TRUE ? isLess : !isLess;
+    if(shouldJump) {
+        *ipIncrement = 2 + (int32_t)jump.jumpAmount; // relative to the original jump
+    } else {
+        *ipIncrement = 3;
+    }
+    return cubsProgramRuntimeErrorNone;
+}
+
+/// See `OpCodeLoadImmediateAddInt`. Reads the add from `bytecode[1]`.
+static CubsProgramRuntimeError execute_load_immediate_add_int(const CubsProgram* program, const InterpreterFramePointer* frame, const Bytecode* bytecode) {
+    const OperandsLoadImmediateAddInt operands = *(const OperandsLoadImmediateAddInt*)bytecode;
+    *((int64_t*)cubs_frame_value_at(frame, operands.dst)) = (int64_t)operands.immediate;
+    cubs_frame_set_context_at(frame, operands.dst, &CUBS_INT_CONTEXT);
+
+    assert(cubs_bytecode_get_opcode(bytecode[1]) == OpCodeAddInt);
+    return execute_add_int(program, frame, bytecode[1]);
+}
+
+static CubsProgramRuntimeError report_yield_outside_coroutine(const CubsProgram* program) {
+    assert(program != NULL);
+    const char message[] = "yield executed outside of a coroutine or budgeted execution\n";
+    _cubs_internal_program_runtime_error(program, cubsProgramRuntimeErrorYieldOutsideCoroutine, message, sizeof(message) - 1);
+    return cubsProgramRuntimeErrorYieldOutsideCoroutine;
+}
+
+static CubsProgramRuntimeError execute_tail_call(const CubsProgram* program, const InterpreterFramePointer* frame, const Bytecode* callIp);
+
+/// Executes the operation at `instructionPointer` in `frame`, setting `ipIncrement` to how far
+/// the instruction pointer moves. Calls to script functions execute through `cubs_function_call(...)`.
+static CubsProgramRuntimeError execute_operation_at(const CubsProgram* program, const InterpreterFramePointer* frame, int64_t* const ipIncrementOut, const Bytecode* instructionPointer) {
     int64_t ipIncrement = 1;
-    const Bytecode* instructionPointer = cubs_interpreter_get_instruction_pointer();
     const OpCode opcode = cubs_bytecode_get_opcode(*instructionPointer);
 
     CubsProgramRuntimeError potentialErr = cubsProgramRuntimeErrorNone;
@@ -776,100 +1181,1032 @@ CubsProgramRuntimeError cubs_interpreter_execute_operation(const CubsProgram *pr
             fprintf(stderr, "nop :)\n");
         } break;
         case OpCodeLoad: {
-            execute_load(&ipIncrement, instructionPointer);
+            execute_load(frame, &ipIncrement, instructionPointer);
         } break;
         case OpCodeReturn: {
-            execute_return(&ipIncrement, *instructionPointer);
+            execute_return(frame, &ipIncrement, *instructionPointer);
         } break;
         case OpCodeCall: {
-            execute_call(&ipIncrement, instructionPointer);
+            if(((const OperandsCallUnknown*)instructionPointer)->isTailCall) {
+                potentialErr = execute_tail_call(program, frame, instructionPointer);
+            } else {
+                execute_call(frame, &ipIncrement, instructionPointer);
+            }
         } break;
         case OpCodeJump: {
-            execute_jump(&ipIncrement, *instructionPointer);
+            execute_jump(frame, &ipIncrement, *instructionPointer);
         } break;
         case OpCodeDeinit: {
-            execute_deinit(*instructionPointer);
+            execute_deinit(frame, *instructionPointer);
         } break;
         case OpCodeSync: {
-            execute_sync(&ipIncrement, instructionPointer);
+            execute_sync(frame, &ipIncrement, instructionPointer);
         } break;
         case OpCodeMove: {
-            execute_move(*instructionPointer);
+            execute_move(frame, *instructionPointer);
         } break;
         case OpCodeClone: {
-            execute_clone(*instructionPointer);
+            execute_clone(frame, *instructionPointer);
         } break;
         case OpCodeDereference: {
-            execute_dereference(*instructionPointer);
+            execute_dereference(frame, *instructionPointer);
         } break;
         case OpCodeSetReference: {
-            execute_set_reference(*instructionPointer);
+            execute_set_reference(frame, *instructionPointer);
         } break;
         case OpCodeMakeReference: {
-            execute_make_reference(*instructionPointer);
+            execute_make_reference(frame, *instructionPointer);
         } break;
         case OpCodeGetMember: {
-            execute_get_member(*instructionPointer);
+            execute_get_member(frame, *instructionPointer);
         } break;
         case OpCodeSetMember: {
-            execute_set_member(*instructionPointer);
+            execute_set_member(frame, *instructionPointer);
         } break;
         case OpCodeEqual: {
-            execute_equal(*instructionPointer);
+            execute_equal(frame, *instructionPointer);
         } break;
         case OpCodeNotEqual: {
-            execute_not_equal(*instructionPointer);
+            execute_not_equal(frame, *instructionPointer);
         } break;
         case OpCodeLess: {
-            execute_less(*instructionPointer);
+            execute_less(frame, *instructionPointer);
         } break;
         case OpCodeLessOrEqual: {
-            execute_less_or_equal(*instructionPointer);
+            execute_less_or_equal(frame, *instructionPointer);
         } break;
         case OpCodeGreater: {
-            execute_greater(*instructionPointer);
+            execute_greater(frame, *instructionPointer);
         } break;
         case OpCodeGreaterOrEqual: {
-            execute_greater_or_equal(*instructionPointer);
+            execute_greater_or_equal(frame, *instructionPointer);
         } break;
         case OpCodeIncrement: {
-            potentialErr = execute_increment(program, *instructionPointer);
+            potentialErr = execute_increment(program, frame, *instructionPointer);
         } break;
         case OpCodeAdd: {
-            potentialErr = execute_add(program, *instructionPointer);
+            potentialErr = execute_add(program, frame, *instructionPointer);
+        } break;
+        case OpCodeIncrementInt: {
+            potentialErr = execute_increment_int(program, frame, *instructionPointer);
+        } break;
+        case OpCodeAddInt: {
+            potentialErr = execute_add_int(program, frame, *instructionPointer);
+        } break;
+        case OpCodeAddFloat: {
+            execute_add_float(frame, *instructionPointer);
+        } break;
+        case OpCodeEqualInt: {
+            execute_equal_int(frame, *instructionPointer);
+        } break;
+        case OpCodeNotEqualInt: {
+            execute_not_equal_int(frame, *instructionPointer);
+        } break;
+        case OpCodeLessInt: {
+            execute_less_int(frame, *instructionPointer);
+        } break;
+        case OpCodeGreaterInt: {
+            execute_greater_int(frame, *instructionPointer);
+        } break;
+        case OpCodeLessOrEqualInt: {
+            execute_less_or_equal_int(frame, *instructionPointer);
+        } break;
+        case OpCodeGreaterOrEqualInt: {
+            execute_greater_or_equal_int(frame, *instructionPointer);
+        } break;
+        case OpCodeLessFloat: {
+            execute_less_float(frame, *instructionPointer);
+        } break;
+        case OpCodeGreaterFloat: {
+            execute_greater_float(frame, *instructionPointer);
+        } break;
+        case OpCodeLessOrEqualFloat: {
+            execute_less_or_equal_float(frame, *instructionPointer);
+        } break;
+        case OpCodeGreaterOrEqualFloat: {
+            execute_greater_or_equal_float(frame, *instructionPointer);
+        } break;
+        case OpCodeYield: {
+            // Executing a single operation can't suspend
+            potentialErr = report_yield_outside_coroutine(program);
+        } break;
+        case OpCodeIncrementLessIntJump: {
+            potentialErr = execute_increment_less_int_jump(program, frame, &ipIncrement, instructionPointer);
+        } break;
+        case OpCodeLoadImmediateAddInt: {
+            potentialErr = execute_load_immediate_add_int(program, frame, instructionPointer);
+            ipIncrement = 2;
         } break;
         default: {
             unreachable();
         } break;
     }
-    cubs_interpreter_set_instruction_pointer(&instructionPointer[ipIncrement]);
+    *ipIncrementOut = ipIncrement;
     return potentialErr;
 }
 
-static CubsProgramRuntimeError interpreter_execute_continuous(const CubsProgram *program) {
+CubsProgramRuntimeError cubs_interpreter_execute_operation(const CubsProgram *program)
+{
+    int64_t ipIncrement = 1;
+    const Bytecode* instructionPointer = cubs_interpreter_get_instruction_pointer();
+    const InterpreterFramePointer currentFrame = cubs_interpreter_current_frame_pointer();
+    const CubsProgramRuntimeError err = execute_operation_at(program, &currentFrame, &ipIncrement, instructionPointer);
+    cubs_interpreter_set_instruction_pointer(&instructionPointer[ipIncrement]);
+    return err;
+}
+
+#if defined(__GNUC__) && !defined(CUBS_INTERPRETER_NO_COMPUTED_GOTO)
+/// GCC and Clang support "labels as values", allowing each operation to jump
+/// directly to the next operation's handler, rather than going back through a single
+/// shared switch branch. MSVC doesn't, so it uses the switch fallback.
+#define CUBS_INTERPRETER_COMPUTED_GOTO 1
+#else
+#define CUBS_INTERPRETER_COMPUTED_GOTO 0
+#endif
+
+/// Profiling hooks, see `profiler.h`. Without `CUBS_INTERPRETER_PROFILE` they compile to nothing.
+#ifdef CUBS_INTERPRETER_PROFILE
+#define PROFILE_ENTER_FUNCTION(function) _cubs_profiler_enter_function(function)
+#define PROFILE_EXIT_FUNCTION() _cubs_profiler_exit_function()
+#define PROFILE_TAIL_CALL(function) _cubs_profiler_tail_call(function)
+#define PROFILE_DISPATCH_OP(opcode) _cubs_profiler_dispatch_op(opcode)
+#define PROFILE_ENTER_DISPATCH(function) _cubs_profiler_enter_dispatch(function)
+#define PROFILE_EXIT_DISPATCH() _cubs_profiler_exit_dispatch()
+#define PROFILE_SUSPEND(execution) _cubs_profiler_suspend(execution->_callDepth, &execution->_profilerSuspended)
+#define PROFILE_RESUME(execution) do { _cubs_profiler_resume(execution->_profilerSuspended); execution->_profilerSuspended = NULL; } while(0)
+#else
+#define PROFILE_ENTER_FUNCTION(function) ((void)0)
+#define PROFILE_EXIT_FUNCTION() ((void)0)
+#define PROFILE_TAIL_CALL(function) ((void)0)
+#define PROFILE_DISPATCH_OP(opcode) ((void)0)
+#define PROFILE_ENTER_DISPATCH(function) ((void)0)
+#define PROFILE_EXIT_DISPATCH() ((void)0)
+#define PROFILE_SUSPEND(execution) ((void)0)
+#define PROFILE_RESUME(execution) ((void)0)
+#endif
+
+/// If an error occurs within a script function called by `interpreter_execute_continuous(...)`,
+/// unwinds and pops the frames of all of those calls, leaving only the frame it started with.
+/// The instruction pointer is left at the operation that caused the error if there are no
+/// such calls, otherwise at the outermost call.
+static CubsProgramRuntimeError unwind_script_calls_on_error(const Bytecode* ip, size_t callDepth, CubsProgramRuntimeError err) {
+    assert(err != cubsProgramRuntimeErrorNone);
+    cubs_interpreter_set_instruction_pointer(ip);
+    for(size_t i = 0; i < callDepth; i++) {
+        cubs_interpreter_stack_unwind_frame();
+        cubs_interpreter_pop_frame();
+        PROFILE_EXIT_FUNCTION();
+    }
+    return err;
+}
+
+/// Budget of a single `interpreter_execute_continuous(...)` run.
+typedef struct ExecutionBudgetState {
+    /// Operations left to hand out, beyond the ones the loop is currently counting down.
+    /// `UINT64_MAX` if unlimited.
+    uint64_t operationsLeft;
+    /// 0 if unlimited.
+    uint64_t deadlineNs;
+    bool checkDeadline;
+    /// On input, the call depth to resume at. On output, the call depth when suspended.
+    size_t callDepth;
+    bool suspended;
+    /// Set by `OpCodeYield`, which suspends by using up the rest of the budget.
+    bool yielded;
+    bool hasYieldValue;
+    uint16_t yieldSrc;
+} ExecutionBudgetState;
+
+/// Monotonic, so changing the system time can't expire a budget early, or extend it.
+static uint64_t budget_now_ns() {
+    return _cubs_os_monotonic_ns();
+}
+
+static ExecutionBudgetState budget_state_init(CubsExecutionBudget budget, size_t callDepth) {
+    const ExecutionBudgetState state = {
+        .operationsLeft = budget.operations == 0 ? UINT64_MAX : budget.operations,
+        .deadlineNs = budget.nanoseconds == 0 ? 0 : budget_now_ns() + budget.nanoseconds,
+        .checkDeadline = false,
+        .callDepth = callDepth,
+        .suspended = false,
+        .yielded = false,
+        .hasYieldValue = false,
+        .yieldSrc = 0,
+    };
+    return state;
+}
+
+/// Returns how many operations may execute before checking the budget again, or 0 if it ran out.
+/// The deadline isn't checked the first time, so every run makes progress.
+static uint64_t budget_take_operations(ExecutionBudgetState* budget) {
+    if(budget->operationsLeft == 0) {
+        return 0;
+    }
+    if(budget->checkDeadline && budget_now_ns() >= budget->deadlineNs) {
+        return 0;
+    }
+    budget->checkDeadline = budget->deadlineNs != 0;
+    uint64_t take = budget->operationsLeft;
+    if(budget->deadlineNs != 0 && take > CUBS_BUDGET_TIME_CHECK_INTERVAL) {
+        take = CUBS_BUDGET_TIME_CHECK_INTERVAL;
+    }
+    if(budget->operationsLeft != UINT64_MAX) {
+        budget->operationsLeft -= take;
+    }
+    return take;
+}
+
+/// Runs operations until a return operation from the current frame, or until an error occurs.
+/// The instruction pointer is kept local to this function, and only read from the thread local
+/// interpreter stack once at the start, avoiding a thread local load and store per operation.
+/// Calls to script functions push the callee's frame and continue in this same loop,
+/// rather than recursing on the native stack, so script recursion is only bounded by the
+/// interpreter stack limit. Calls to C functions execute through `cubs_function_call(...)`, which leaves
+/// the local instruction pointer valid once it returns.
+/// The same applies to the frame pointer, which every operation accesses it's operands through.
+/// If `optBudget != NULL`, also stops before the next operation once the budget runs out, setting
+/// `optBudget->suspended`. The frames of the executing functions are left on the stack to resume from.
+/// Without a budget, operations aren't counted at all.
+static CubsProgramRuntimeError interpreter_execute_continuous(const CubsProgram *program, ExecutionBudgetState* optBudget) {
+    const Bytecode* ip = cubs_interpreter_get_instruction_pointer();
+    InterpreterFramePointer currentFrame = cubs_interpreter_current_frame_pointer();
+    const InterpreterFramePointer* frame = &currentFrame;
+    /// How many script function frames this loop pushed on top of the one it started with.
+    size_t callDepth = optBudget == NULL ? 0 : optBudget->callDepth;
+    /// Operations left until `optBudget` is checked again.
+    uint64_t operationsUntilCheck = 0;
+    int64_t ipIncrement;
+    CubsProgramRuntimeError err;
+
+    /// Before each operation when there is a budget.
+    #define BUDGET_CHECK() do { \
+        if(operationsUntilCheck == 0) { \
+            operationsUntilCheck = budget_take_operations(optBudget); \
+            if(operationsUntilCheck == 0) { \
+                cubs_interpreter_set_instruction_pointer(ip); \
+                optBudget->callDepth = callDepth; \
+                optBudget->suspended = true; \
+                return cubsProgramRuntimeErrorNone; \
+            } \
+        } \
+        operationsUntilCheck -= 1; \
+    } while(0)
+
+    #if CUBS_INTERPRETER_COMPUTED_GOTO
+    static const void* const dispatchTable[] = {
+        [OpCodeNop] = &&op_nop,
+        [OpCodeLoad] = &&op_load,
+        [OpCodeReturn] = &&op_return,
+        [OpCodeCall] = &&op_call,
+        [OpCodeJump] = &&op_jump,
+        [OpCodeDeinit] = &&op_deinit,
+        [OpCodeSync] = &&op_sync,
+        [OpCodeMove] = &&op_move,
+        [OpCodeClone] = &&op_clone,
+        [OpCodeDereference] = &&op_dereference,
+        [OpCodeSetReference] = &&op_set_reference,
+        [OpCodeMakeReference] = &&op_make_reference,
+        [OpCodeGetMember] = &&op_get_member,
+        [OpCodeSetMember] = &&op_set_member,
+        [OpCodeCast] = &&op_invalid,
+        [OpCodeEqual] = &&op_equal,
+        [OpCodeNotEqual] = &&op_not_equal,
+        [OpCodeLess] = &&op_less,
+        [OpCodeGreater] = &&op_greater,
+        [OpCodeLessOrEqual] = &&op_less_or_equal,
+        [OpCodeGreaterOrEqual] = &&op_greater_or_equal,
+        [OpCodeIncrement] = &&op_increment,
+        [OpCodeAdd] = &&op_add,
+        [OpCodeIncrementInt] = &&op_increment_int,
+        [OpCodeAddInt] = &&op_add_int,
+        [OpCodeAddFloat] = &&op_add_float,
+        [OpCodeEqualInt] = &&op_equal_int,
+        [OpCodeNotEqualInt] = &&op_not_equal_int,
+        [OpCodeLessInt] = &&op_less_int,
+        [OpCodeGreaterInt] = &&op_greater_int,
+        [OpCodeLessOrEqualInt] = &&op_less_or_equal_int,
+        [OpCodeGreaterOrEqualInt] = &&op_greater_or_equal_int,
+        [OpCodeLessFloat] = &&op_less_float,
+        [OpCodeGreaterFloat] = &&op_greater_float,
+        [OpCodeLessOrEqualFloat] = &&op_less_or_equal_float,
+        [OpCodeGreaterOrEqualFloat] = &&op_greater_or_equal_float,
+        [OpCodeYield] = &&op_yield,
+        [OpCodeIncrementLessIntJump] = &&op_increment_less_int_jump,
+        [OpCodeLoadImmediateAddInt] = &&op_load_immediate_add_int,
+    };
+    /// With a budget, every operation first goes through the budget check, which then
+    /// continues to the operation's handler. Without one, there is no cost besides
+    /// the table being in a register.
+    static const void* const budgetDispatchTable[OPCODE_USED_BITMASK + 1] = {
+        [0 ... OPCODE_USED_BITMASK] = &&op_budget_check,
+    };
+    const void* const* const activeDispatchTable = optBudget == NULL ? dispatchTable : budgetDispatchTable;
+
+    #define DISPATCH_CASE(label, opcode) label:
+    #define DISPATCH_DEFAULT() op_invalid:
+    #define DISPATCH() do { \
+        const OpCode _nextOpcode = cubs_bytecode_get_opcode(*ip); \
+        assert(_nextOpcode < (sizeof(dispatchTable) / sizeof(dispatchTable[0]))); \
+        PROFILE_DISPATCH_OP(_nextOpcode); \
+        goto *activeDispatchTable[_nextOpcode]; \
+    } while(0)
+
+    DISPATCH();
+
+    op_budget_check: {
+        BUDGET_CHECK();
+        goto *dispatchTable[cubs_bytecode_get_opcode(*ip)];
+    }
+    #else
+    #define DISPATCH_CASE(label, opcode) case opcode:
+    #define DISPATCH_DEFAULT() default:
+    #define DISPATCH() continue
+
     while(true) {
-        const Bytecode bytecode = *cubs_interpreter_get_instruction_pointer();
-        const OpCode opcode = cubs_bytecode_get_opcode(bytecode);
-        const bool isReturn = opcode == OpCodeReturn;
+    const OpCode _nextOpcode = cubs_bytecode_get_opcode(*ip);
+    PROFILE_DISPATCH_OP(_nextOpcode);
+    if(optBudget != NULL) {
+        BUDGET_CHECK();
+    }
+    switch(_nextOpcode) {
+    #endif
 
-        const CubsProgramRuntimeError err = cubs_interpreter_execute_operation(program);
-        if(err != cubsProgramRuntimeErrorNone || isReturn) {
-            return err;
+    DISPATCH_CASE(op_nop, OpCodeNop) {
+        fprintf(stderr, "nop :)\n");
+        ip += 1;
+        DISPATCH();
+    }
+    DISPATCH_CASE(op_load, OpCodeLoad) {
+        ipIncrement = 1;
+        execute_load(frame, &ipIncrement, ip);
+        ip += ipIncrement;
+        DISPATCH();
+    }
+    DISPATCH_CASE(op_return, OpCodeReturn) {
+        ipIncrement = 1;
+        execute_return(frame, &ipIncrement, *ip);
+    frame_popped:
+        if(callDepth > 0) {
+            // Popping the frame restored the caller's instruction pointer to it's call operation
+            callDepth -= 1;
+            PROFILE_EXIT_FUNCTION();
+            currentFrame = cubs_interpreter_current_frame_pointer();
+            ip = finish_script_call(frame, cubs_interpreter_get_instruction_pointer());
+            DISPATCH();
+        }
+        // Popping the frame restored the instruction pointer to what it was before it was pushed,
+        // which a suspended execution below it may resume from, so it's left as is.
+        return cubsProgramRuntimeErrorNone;
+    }
+    DISPATCH_CASE(op_call, OpCodeCall) {
+        const CubsScriptFunctionPtr* callee = script_call_target(frame, ip);
+        if(((const OperandsCallUnknown*)ip)->isTailCall) {
+            if(callee == NULL) {
+                execute_extern_tail_call(frame, ip);
+                goto frame_popped;
+            }
+            currentFrame = cubs_interpreter_replace_script_call_frame(callee, frame, (const uint16_t*)&ip[2], ((const OperandsCallUnknown*)ip)->argCount);
+            PROFILE_TAIL_CALL(callee);
+            #if CUBS_JIT_ENABLED
+            const CubsJitFunction jitCode = optBudget == NULL ? jit_code_for_call(callee) : NULL;
+            if(jitCode != NULL) {
+                // Compiled code returns from the replaced frame itself
+                err = execute_compiled(program, jitCode, frame);
+                if(err != cubsProgramRuntimeErrorNone) {
+                    return unwind_script_calls_on_error(cubs_function_bytecode_start(callee), callDepth, err);
+                }
+                goto frame_popped;
+            }
+            #endif
+            ip = cubs_function_bytecode_start(callee);
+            DISPATCH();
+        }
+        if(callee != NULL) {
+            #if CUBS_JIT_ENABLED
+            // Compiled code can't suspend, so budgeted executions are always interpreted
+            const CubsJitFunction jitCode = optBudget == NULL ? jit_code_for_call(callee) : NULL;
+            if(jitCode != NULL) {
+                err = execute_compiled_call(program, frame, ip, callee, jitCode);
+                if(err != cubsProgramRuntimeErrorNone) {
+                    return unwind_script_calls_on_error(ip, callDepth, err);
+                }
+                ip += call_bytecode_required(ip);
+                DISPATCH();
+            }
+            #endif
+            ip = push_script_call(&currentFrame, ip, callee);
+            callDepth += 1;
+            PROFILE_ENTER_FUNCTION(callee);
+            DISPATCH();
+        }
+        ipIncrement = 1;
+        execute_call(frame, &ipIncrement, ip);
+        ip += ipIncrement;
+        DISPATCH();
+    }
+    DISPATCH_CASE(op_jump, OpCodeJump) {
+        ipIncrement = 1;
+        execute_jump(frame, &ipIncrement, *ip);
+        ip += ipIncrement;
+        DISPATCH();
+    }
+    DISPATCH_CASE(op_deinit, OpCodeDeinit) {
+        execute_deinit(frame, *ip);
+        ip += 1;
+        DISPATCH();
+    }
+    DISPATCH_CASE(op_sync, OpCodeSync) {
+        ipIncrement = 1;
+        execute_sync(frame, &ipIncrement, ip);
+        ip += ipIncrement;
+        DISPATCH();
+    }
+    DISPATCH_CASE(op_move, OpCodeMove) {
+        execute_move(frame, *ip);
+        ip += 1;
+        DISPATCH();
+    }
+    DISPATCH_CASE(op_clone, OpCodeClone) {
+        execute_clone(frame, *ip);
+        ip += 1;
+        DISPATCH();
+    }
+    DISPATCH_CASE(op_dereference, OpCodeDereference) {
+        execute_dereference(frame, *ip);
+        ip += 1;
+        DISPATCH();
+    }
+    DISPATCH_CASE(op_set_reference, OpCodeSetReference) {
+        execute_set_reference(frame, *ip);
+        ip += 1;
+        DISPATCH();
+    }
+    DISPATCH_CASE(op_make_reference, OpCodeMakeReference) {
+        execute_make_reference(frame, *ip);
+        ip += 1;
+        DISPATCH();
+    }
+    DISPATCH_CASE(op_get_member, OpCodeGetMember) {
+        execute_get_member(frame, *ip);
+        ip += 1;
+        DISPATCH();
+    }
+    DISPATCH_CASE(op_set_member, OpCodeSetMember) {
+        execute_set_member(frame, *ip);
+        ip += 1;
+        DISPATCH();
+    }
+    DISPATCH_CASE(op_equal, OpCodeEqual) {
+        execute_equal(frame, *ip);
+        ip += 1;
+        DISPATCH();
+    }
+    DISPATCH_CASE(op_not_equal, OpCodeNotEqual) {
+        execute_not_equal(frame, *ip);
+        ip += 1;
+        DISPATCH();
+    }
+    DISPATCH_CASE(op_less, OpCodeLess) {
+        execute_less(frame, *ip);
+        ip += 1;
+        DISPATCH();
+    }
+    DISPATCH_CASE(op_less_or_equal, OpCodeLessOrEqual) {
+        execute_less_or_equal(frame, *ip);
+        ip += 1;
+        DISPATCH();
+    }
+    DISPATCH_CASE(op_greater, OpCodeGreater) {
+        execute_greater(frame, *ip);
+        ip += 1;
+        DISPATCH();
+    }
+    DISPATCH_CASE(op_greater_or_equal, OpCodeGreaterOrEqual) {
+        execute_greater_or_equal(frame, *ip);
+        ip += 1;
+        DISPATCH();
+    }
+    DISPATCH_CASE(op_increment, OpCodeIncrement) {
+        err = execute_increment(program, frame, *ip);
+        if(err != cubsProgramRuntimeErrorNone) {
+            return unwind_script_calls_on_error(ip, callDepth, err);
+        }
+        ip += 1;
+        DISPATCH();
+    }
+    DISPATCH_CASE(op_add, OpCodeAdd) {
+        err = execute_add(program, frame, *ip);
+        if(err != cubsProgramRuntimeErrorNone) {
+            return unwind_script_calls_on_error(ip, callDepth, err);
+        }
+        ip += 1;
+        DISPATCH();
+    }
+    DISPATCH_CASE(op_increment_int, OpCodeIncrementInt) {
+        err = execute_increment_int(program, frame, *ip);
+        if(err != cubsProgramRuntimeErrorNone) {
+            return unwind_script_calls_on_error(ip, callDepth, err);
+        }
+        ip += 1;
+        DISPATCH();
+    }
+    DISPATCH_CASE(op_add_int, OpCodeAddInt) {
+        err = execute_add_int(program, frame, *ip);
+        if(err != cubsProgramRuntimeErrorNone) {
+            return unwind_script_calls_on_error(ip, callDepth, err);
+        }
+        ip += 1;
+        DISPATCH();
+    }
+    DISPATCH_CASE(op_add_float, OpCodeAddFloat) {
+        execute_add_float(frame, *ip);
+        ip += 1;
+        DISPATCH();
+    }
+    DISPATCH_CASE(op_equal_int, OpCodeEqualInt) {
+        execute_equal_int(frame, *ip);
+        ip += 1;
+        DISPATCH();
+    }
+    DISPATCH_CASE(op_not_equal_int, OpCodeNotEqualInt) {
+        execute_not_equal_int(frame, *ip);
+        ip += 1;
+        DISPATCH();
+    }
+    DISPATCH_CASE(op_less_int, OpCodeLessInt) {
+        execute_less_int(frame, *ip);
+        ip += 1;
+        DISPATCH();
+    }
+    DISPATCH_CASE(op_greater_int, OpCodeGreaterInt) {
+        execute_greater_int(frame, *ip);
+        ip += 1;
+        DISPATCH();
+    }
+    DISPATCH_CASE(op_less_or_equal_int, OpCodeLessOrEqualInt) {
+        execute_less_or_equal_int(frame, *ip);
+        ip += 1;
+        DISPATCH();
+    }
+    DISPATCH_CASE(op_greater_or_equal_int, OpCodeGreaterOrEqualInt) {
+        execute_greater_or_equal_int(frame, *ip);
+        ip += 1;
+        DISPATCH();
+    }
+    DISPATCH_CASE(op_less_float, OpCodeLessFloat) {
+        execute_less_float(frame, *ip);
+        ip += 1;
+        DISPATCH();
+    }
+    DISPATCH_CASE(op_greater_float, OpCodeGreaterFloat) {
+        execute_greater_float(frame, *ip);
+        ip += 1;
+        DISPATCH();
+    }
+    DISPATCH_CASE(op_less_or_equal_float, OpCodeLessOrEqualFloat) {
+        execute_less_or_equal_float(frame, *ip);
+        ip += 1;
+        DISPATCH();
+    }
+    DISPATCH_CASE(op_greater_or_equal_float, OpCodeGreaterOrEqualFloat) {
+        execute_greater_or_equal_float(frame, *ip);
+        ip += 1;
+        DISPATCH();
+    }
+    DISPATCH_CASE(op_yield, OpCodeYield) {
+        if(optBudget == NULL) {
+            err = report_yield_outside_coroutine(program);
+            return unwind_script_calls_on_error(ip, callDepth, err);
+        }
+        const OperandsYield operands = *(const OperandsYield*)ip;
+        optBudget->yielded = true;
+        optBudget->hasYieldValue = operands.hasValue;
+        optBudget->yieldSrc = (uint16_t)operands.src;
+        // Suspends at the budget check before the next operation, so the next
+        // operation is where it resumes from.
+        optBudget->operationsLeft = 0;
+        operationsUntilCheck = 0;
+        ip += 1;
+        DISPATCH();
+    }
+    DISPATCH_CASE(op_increment_less_int_jump, OpCodeIncrementLessIntJump) {
+        ipIncrement = 3;
+        err = execute_increment_less_int_jump(program, frame, &ipIncrement, ip);
+        if(err != cubsProgramRuntimeErrorNone) {
+            return unwind_script_calls_on_error(ip, callDepth, err);
+        }
+        ip += ipIncrement;
+        DISPATCH();
+    }
+    DISPATCH_CASE(op_load_immediate_add_int, OpCodeLoadImmediateAddInt) {
+        err = execute_load_immediate_add_int(program, frame, ip);
+        if(err != cubsProgramRuntimeErrorNone) {
+            return unwind_script_calls_on_error(ip, callDepth, err);
         }
+        ip += 2;
+        DISPATCH();
     }
+    DISPATCH_DEFAULT() {
+        unreachable();
+    }
+
+    #if !CUBS_INTERPRETER_COMPUTED_GOTO
+    } // switch
+    } // while
+    #endif
+
+    #undef DISPATCH_CASE
+    #undef DISPATCH_DEFAULT
+    #undef DISPATCH
+    #undef BUDGET_CHECK
 }
 
-CubsProgramRuntimeError cubs_interpreter_execute_function(const CubsScriptFunctionPtr *function, void *outReturnValue, const CubsTypeContext **outContext)
+/// Executes the tail call at `callIp` outside of the dispatch loop, running the callee until it
+/// returns, which pops the frame `frame` was replaced with. If an error occurs, that frame is left
+/// pushed, as it is for any other operation.
+static CubsProgramRuntimeError execute_tail_call(const CubsProgram* program, const InterpreterFramePointer* frame, const Bytecode* callIp) {
+    const CubsScriptFunctionPtr* callee = script_call_target(frame, callIp);
+    if(callee == NULL) {
+        execute_extern_tail_call(frame, callIp);
+        return cubsProgramRuntimeErrorNone;
+    }
+
+    const InterpreterFramePointer calleeFrame = cubs_interpreter_replace_script_call_frame(
+        callee, frame, (const uint16_t*)&callIp[2], ((const OperandsCallUnknown*)callIp)->argCount
+    );
+    PROFILE_TAIL_CALL(callee);
+    #if CUBS_JIT_ENABLED
+    const CubsJitFunction jitCode = jit_code_for_call(callee);
+    if(jitCode != NULL) {
+        return execute_compiled(program, jitCode, &calleeFrame);
+    }
+    #else
+    (void)calleeFrame;
+    #endif
+    cubs_interpreter_set_instruction_pointer(cubs_function_bytecode_start(callee));
+    return interpreter_execute_continuous(program, NULL);
+}
+
+#if CUBS_JIT_ENABLED
+
+/// Executes the call at `callIp` for compiled code. Calls to script functions execute the callee
+/// compiled if it is, otherwise interpret it until it returns, without going through `cubs_function_call(...)`.
+static CubsProgramRuntimeError execute_call_from_compiled(const CubsProgram* program, const InterpreterFramePointer* frame, const Bytecode* callIp) {
+    const CubsScriptFunctionPtr* callee = script_call_target(frame, callIp);
+    if(callee == NULL) {
+        int64_t ipIncrement = 1;
+        execute_call(frame, &ipIncrement, callIp);
+        return cubsProgramRuntimeErrorNone;
+    }
+
+    const CubsJitFunction jitCode = jit_code_for_call(callee);
+    if(jitCode != NULL) {
+        return execute_compiled_call(program, frame, callIp, callee, jitCode);
+    }
+
+    InterpreterFramePointer calleeFrame = *frame;
+    cubs_interpreter_set_instruction_pointer(push_script_call(&calleeFrame, callIp, callee));
+    const CubsProgramRuntimeError err = interpreter_execute_continuous(program, NULL);
+    if(err != cubsProgramRuntimeErrorNone) {
+        cubs_interpreter_stack_unwind_frame();
+        cubs_interpreter_pop_frame();
+        return err;
+    }
+    (void)finish_script_call(frame, callIp);
+    return cubsProgramRuntimeErrorNone;
+}
+
+/// Executes the tail call at `callIp` for compiled code, which exits right after. A C function is
+/// called immediately, and pops `frame`. For a script function, `frame` is replaced with it's frame,
+/// and it's left to `execute_compiled(...)` to execute once the compiled code exits.
+static CubsProgramRuntimeError jit_execute_tail_call(const CubsProgram* program, const InterpreterFramePointer* frame, const Bytecode* callIp) {
+    (void)program;
+    const CubsScriptFunctionPtr* callee = script_call_target(frame, callIp);
+    if(callee == NULL) {
+        execute_extern_tail_call(frame, callIp);
+        return cubsProgramRuntimeErrorNone;
+    }
+    (void)cubs_interpreter_replace_script_call_frame(callee, frame, (const uint16_t*)&callIp[2], ((const OperandsCallUnknown*)callIp)->argCount);
+    PROFILE_TAIL_CALL(callee);
+    jitPendingTailCall = callee;
+    return cubsProgramRuntimeErrorNone;
+}
+
+/// Operations compiled code calls, besides the ones below, which have their own.
+static CubsProgramRuntimeError jit_execute_operation(const CubsProgram* program, const InterpreterFramePointer* frame, const Bytecode* bytecode) {
+    // Compiled code knows every operation's length, so the increment isn't needed
+    int64_t ipIncrement = 1;
+    return execute_operation_at(program, frame, &ipIncrement, bytecode);
+}
+
+static CubsProgramRuntimeError jit_execute_load(const CubsProgram* program, const InterpreterFramePointer* frame, const Bytecode* bytecode) {
+    (void)program;
+    int64_t ipIncrement = 1;
+    execute_load(frame, &ipIncrement, bytecode);
+    return cubsProgramRuntimeErrorNone;
+}
+
+static CubsProgramRuntimeError jit_execute_return(const CubsProgram* program, const InterpreterFramePointer* frame, const Bytecode* bytecode) {
+    (void)program;
+    int64_t ipIncrement = 1;
+    execute_return(frame, &ipIncrement, *bytecode);
+    return cubsProgramRuntimeErrorNone;
+}
+
+static CubsProgramRuntimeError jit_execute_deinit(const CubsProgram* program, const InterpreterFramePointer* frame, const Bytecode* bytecode) {
+    (void)program;
+    execute_deinit(frame, *bytecode);
+    return cubsProgramRuntimeErrorNone;
+}
+
+static CubsProgramRuntimeError jit_execute_move(const CubsProgram* program, const InterpreterFramePointer* frame, const Bytecode* bytecode) {
+    (void)program;
+    execute_move(frame, *bytecode);
+    return cubsProgramRuntimeErrorNone;
+}
+
+static CubsProgramRuntimeError jit_execute_clone(const CubsProgram* program, const InterpreterFramePointer* frame, const Bytecode* bytecode) {
+    (void)program;
+    execute_clone(frame, *bytecode);
+    return cubsProgramRuntimeErrorNone;
+}
+
+static CubsProgramRuntimeError jit_execute_dereference(const CubsProgram* program, const InterpreterFramePointer* frame, const Bytecode* bytecode) {
+    (void)program;
+    execute_dereference(frame, *bytecode);
+    return cubsProgramRuntimeErrorNone;
+}
+
+static CubsProgramRuntimeError jit_execute_equal(const CubsProgram* program, const InterpreterFramePointer* frame, const Bytecode* bytecode) {
+    (void)program;
+    execute_equal(frame, *bytecode);
+    return cubsProgramRuntimeErrorNone;
+}
+
+static CubsProgramRuntimeError jit_execute_not_equal(const CubsProgram* program, const InterpreterFramePointer* frame, const Bytecode* bytecode) {
+    (void)program;
+    execute_not_equal(frame, *bytecode);
+    return cubsProgramRuntimeErrorNone;
+}
+
+static CubsProgramRuntimeError jit_execute_less(const CubsProgram* program, const InterpreterFramePointer* frame, const Bytecode* bytecode) {
+    (void)program;
+    execute_less(frame, *bytecode);
+    return cubsProgramRuntimeErrorNone;
+}
+
+static CubsProgramRuntimeError jit_execute_less_or_equal(const CubsProgram* program, const InterpreterFramePointer* frame, const Bytecode* bytecode) {
+    (void)program;
+    execute_less_or_equal(frame, *bytecode);
+    return cubsProgramRuntimeErrorNone;
+}
+
+static CubsProgramRuntimeError jit_execute_greater(const CubsProgram* program, const InterpreterFramePointer* frame, const Bytecode* bytecode) {
+    (void)program;
+    execute_greater(frame, *bytecode);
+    return cubsProgramRuntimeErrorNone;
+}
+
+static CubsProgramRuntimeError jit_execute_greater_or_equal(const CubsProgram* program, const InterpreterFramePointer* frame, const Bytecode* bytecode) {
+    (void)program;
+    execute_greater_or_equal(frame, *bytecode);
+    return cubsProgramRuntimeErrorNone;
+}
+
+static CubsProgramRuntimeError jit_execute_increment(const CubsProgram* program, const InterpreterFramePointer* frame, const Bytecode* bytecode) {
+    return execute_increment(program, frame, *bytecode);
+}
+
+static CubsProgramRuntimeError jit_execute_add(const CubsProgram* program, const InterpreterFramePointer* frame, const Bytecode* bytecode) {
+    return execute_add(program, frame, *bytecode);
+}
+
+CubsJitOperation _cubs_jit_operation(const Bytecode* bytecode)
 {
-    cubs_interpreter_push_frame(function->_stackSpaceRequired, outReturnValue, outContext);
+    const OpCode opcode = cubs_bytecode_get_opcode(*bytecode);
+    assert(opcode != OpCodeJump && opcode != OpCodeYield && "Jumps are always compiled, and yields never are");
+    switch(opcode) {
+        case OpCodeLoad: return jit_execute_load;
+        case OpCodeReturn: return jit_execute_return;
+        case OpCodeCall: {
+            if(((const OperandsCallUnknown*)bytecode)->isTailCall) {
+                return jit_execute_tail_call;
+            }
+            return execute_call_from_compiled;
+        }
+        case OpCodeDeinit: return jit_execute_deinit;
+        case OpCodeMove: return jit_execute_move;
+        case OpCodeClone: return jit_execute_clone;
+        case OpCodeDereference: return jit_execute_dereference;
+        case OpCodeEqual: return jit_execute_equal;
+        case OpCodeNotEqual: return jit_execute_not_equal;
+        case OpCodeLess: return jit_execute_less;
+        case OpCodeLessOrEqual: return jit_execute_less_or_equal;
+        case OpCodeGreater: return jit_execute_greater;
+        case OpCodeGreaterOrEqual: return jit_execute_greater_or_equal;
+        case OpCodeIncrement: return jit_execute_increment;
+        case OpCodeAdd: return jit_execute_add;
+        default: return jit_execute_operation;
+    }
+}
+
+#endif // CUBS_JIT_ENABLED
+
+/// Executes `function` in it's already pushed frame, with it's arguments set. The frame is popped
+/// by returning, or unwound and popped if an error occurs.
+static CubsProgramRuntimeError execute_pushed_function(const CubsScriptFunctionPtr* function) {
     cubs_interpreter_set_instruction_pointer(cubs_function_bytecode_start(function));
 
-    const CubsProgramRuntimeError err = interpreter_execute_continuous(function->program);
+    PROFILE_ENTER_DISPATCH(function);
+    #if CUBS_JIT_ENABLED
+    const CubsJitFunction jitCode = jit_code_for_call(function);
+    CubsProgramRuntimeError err;
+    if(jitCode != NULL) {
+        const InterpreterFramePointer frame = cubs_interpreter_current_frame_pointer();
+        err = execute_compiled(function->program, jitCode, &frame);
+    } else {
+        err = interpreter_execute_continuous(function->program, NULL);
+    }
+    #else
+    const CubsProgramRuntimeError err = interpreter_execute_continuous(function->program, NULL);
+    #endif
     if(err != cubsProgramRuntimeErrorNone) {
         /// If some error occurred, the stack frame won't automatically unwind in a return operation
         cubs_interpreter_stack_unwind_frame();
         cubs_interpreter_pop_frame();
     }
+    PROFILE_EXIT_DISPATCH();
 
     return err;
 }
+
+CubsProgramRuntimeError cubs_interpreter_execute_function(const CubsScriptFunctionPtr *function, void *outReturnValue, const CubsTypeContext **outContext)
+{
+    cubs_interpreter_push_script_frame(function, outReturnValue, outContext);
+    return execute_pushed_function(function);
+}
+
+CubsProgramRuntimeError cubs_interpreter_execute_function_batch(
+    const CubsScriptFunctionPtr* function,
+    const void* const* argArrays,
+    const size_t* argStrides,
+    size_t count,
+    void* optOutReturns,
+    size_t* optOutCompleted
+) {
+    assert(function->returnType == NULL || optOutReturns != NULL);
+    const CubsTypeContext* const* argsTypes = function->argsTypes;
+    const size_t returnSize = function->returnType == NULL ? 0 : function->returnType->sizeOfType;
+
+    if(count == 0) {
+        if(optOutCompleted != NULL) {
+            *optOutCompleted = 0;
+        }
+        return cubsProgramRuntimeErrorNone;
+    }
+
+    // Script functions always return their declared type, so the context written here is ignored
+    const CubsTypeContext* returnContext = NULL;
+    const CubsTypeContext** returnContextDst = returnSize != 0 ? &returnContext : NULL;
+
+    // The frame is pushed once. Returning pops it, but leaves it's reserved slots as is, so each
+    // following entity only re-enters it with it's own return destination, and writes it's arguments.
+    cubs_interpreter_push_script_frame(function, returnSize != 0 ? optOutReturns : NULL, returnContextDst);
+    const InterpreterStackFrame batchFrame = cubs_interpreter_current_stack_frame();
+    const InterpreterFramePointer frame = cubs_interpreter_current_frame_pointer();
+
+    CubsProgramRuntimeError err = cubsProgramRuntimeErrorNone;
+    size_t i = 0;
+    for(; i < count; i++) {
+        if(i > 0) {
+            void* returnValue = returnSize != 0 ? (void*)&((uint8_t*)optOutReturns)[i * returnSize] : NULL;
+            cubs_interpreter_reenter_frame(&batchFrame, returnValue, returnContextDst);
+        }
+
+        // Arguments are moved straight into the frame's slots, as `cubs_interpreter_push_script_call_frame(...)` does
+        size_t offset = 0;
+        for(size_t arg = 0; arg < function->argsLen; arg++) {
+            const uint8_t* src = &((const uint8_t*)argArrays[arg])[i * argStrides[arg]];
+            memcpy(cubs_frame_value_at(&frame, offset), (const void*)src, argsTypes[arg]->sizeOfType);
+            cubs_frame_set_context_at(&frame, offset, argsTypes[arg]);
+            offset += ROUND_SIZE_TO_MULTIPLE_OF_8(argsTypes[arg]->sizeOfType) / 8;
+        }
+
+        err = execute_pushed_function(function);
+        if(err != cubsProgramRuntimeErrorNone) {
+            break;
+        }
+    }
+    if(optOutCompleted != NULL) {
+        *optOutCompleted = i;
+    }
+    return err;
+}
+
+/// Runs `execution` until it completes, errors, or `budget` runs out.
+/// The executed function's frame, and `execution->_callDepth` frames on top of it, must be on the stack.
+static CubsProgramRuntimeError execute_budgeted(CubsBudgetedExecution* execution, CubsExecutionBudget budget) {
+    ExecutionBudgetState budgetState = budget_state_init(budget, execution->_callDepth);
+    const CubsProgramRuntimeError err = interpreter_execute_continuous(execution->_program, &budgetState);
+    if(budgetState.suspended) {
+        assert(err == cubsProgramRuntimeErrorNone);
+        execution->suspended = true;
+        execution->yielded = budgetState.yielded;
+        execution->_hasYieldValue = budgetState.hasYieldValue;
+        execution->_yieldSrc = budgetState.yieldSrc;
+        execution->_callDepth = budgetState.callDepth;
+        execution->_basePointerOffset = cubs_interpreter_current_stack_frame().basePointerOffset;
+        PROFILE_SUSPEND(execution);
+        return cubsProgramRuntimeErrorNone;
+    }
+
+    execution->suspended = false;
+    execution->yielded = false;
+    execution->_callDepth = 0;
+    if(err != cubsProgramRuntimeErrorNone) {
+        /// If some error occurred, the stack frame won't automatically unwind in a return operation
+        cubs_interpreter_stack_unwind_frame();
+        cubs_interpreter_pop_frame();
+    }
+    PROFILE_EXIT_DISPATCH();
+    return err;
+}
+
+CubsProgramRuntimeError cubs_interpreter_execute_function_budgeted(
+    const CubsScriptFunctionPtr *function,
+    void *outReturnValue,
+    const CubsTypeContext **outContext,
+    CubsExecutionBudget budget,
+    CubsBudgetedExecution *outExecution
+) {
+    cubs_interpreter_push_script_frame(function, outReturnValue, outContext);
+    cubs_interpreter_set_instruction_pointer(cubs_function_bytecode_start(function));
+
+    const CubsBudgetedExecution execution = {.suspended = false, ._program = function->program};
+    *outExecution = execution;
+
+    PROFILE_ENTER_DISPATCH(function);
+    return execute_budgeted(outExecution, budget);
+}
+
+CubsProgramRuntimeError cubs_interpreter_resume(CubsBudgetedExecution *execution, CubsExecutionBudget budget)
+{
+    assert(execution->suspended && "Execution is not suspended");
+    assert(cubs_interpreter_current_stack_frame().basePointerOffset == execution->_basePointerOffset
+        && "Suspended execution must be resumed on the same thread, with no other executions suspended on top of it");
+
+    if(execution->_hasYieldValue) {
+        // Not taken, and the slot may be overwritten once resumed
+        const InterpreterFramePointer frame = cubs_interpreter_current_frame_pointer();
+        cubs_context_fast_deinit(cubs_frame_value_at(&frame, execution->_yieldSrc), cubs_frame_context_at(&frame, execution->_yieldSrc));
+        cubs_frame_set_null_context_at(&frame, execution->_yieldSrc);
+        execution->_hasYieldValue = false;
+    }
+
+    PROFILE_RESUME(execution);
+    return execute_budgeted(execution, budget);
+}
+
+bool cubs_interpreter_take_yielded_value(CubsBudgetedExecution *execution, void *outValue, const CubsTypeContext **outContext)
+{
+    assert(outValue != NULL);
+    assert(outContext != NULL);
+    if(!execution->suspended || !execution->_hasYieldValue) {
+        return false;
+    }
+    assert(cubs_interpreter_current_stack_frame().basePointerOffset == execution->_basePointerOffset
+        && "Yielded value must be taken on the same thread, with no other executions suspended on top of it");
+
+    const InterpreterFramePointer frame = cubs_interpreter_current_frame_pointer();
+    const uint16_t src = execution->_yieldSrc;
+    assert(cubs_frame_is_owning_context_at(&frame, src) && "Cannot yield a non-owning value");
+    const CubsTypeContext* context = cubs_frame_context_at(&frame, src);
+    assert(context != NULL);
+    memcpy(outValue, cubs_frame_value_at(&frame, src), context->sizeOfType);
+    *outContext = context;
+    cubs_frame_set_null_context_at(&frame, src);
+    execution->_hasYieldValue = false;
+    return true;
+}
+
+void cubs_interpreter_cancel(CubsBudgetedExecution *execution)
+{
+    assert(execution->suspended && "Execution is not suspended");
+    assert(cubs_interpreter_current_stack_frame().basePointerOffset == execution->_basePointerOffset
+        && "Suspended execution must be cancelled on the same thread, with no other executions suspended on top of it");
+
+    PROFILE_RESUME(execution);
+    for(size_t i = 0; i < execution->_callDepth; i++) {
+        cubs_interpreter_stack_unwind_frame();
+        cubs_interpreter_pop_frame();
+        PROFILE_EXIT_FUNCTION();
+    }
+    cubs_interpreter_stack_unwind_frame();
+    cubs_interpreter_pop_frame();
+    PROFILE_EXIT_DISPATCH();
+
+    execution->suspended = false;
+    execution->yielded = false;
+    execution->_hasYieldValue = false;
+    execution->_callDepth = 0;
+}
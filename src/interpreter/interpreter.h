@@ -1,5 +1,8 @@
 #pragma once
 
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
 #include "../program/program_runtime_error.h"
 
 struct CubsProgram;
@@ -10,4 +13,77 @@ struct CubsTypeContext;
 CubsProgramRuntimeError cubs_interpreter_execute_operation(const struct CubsProgram* program);
 
 /// Will push and pop a frame for execution
-CubsProgramRuntimeError cubs_interpreter_execute_function(const struct CubsScriptFunctionPtr* function, void* outReturnValue, const struct CubsTypeContext** outContext);
\ No newline at end of file
+CubsProgramRuntimeError cubs_interpreter_execute_function(const struct CubsScriptFunctionPtr* function, void* outReturnValue, const struct CubsTypeContext** outContext);
+
+/// Executes `function` once for each of `count` calls, as `cubs_interpreter_execute_function(...)` does,
+/// with argument `j` of call `i` moved from `(const char*)argArrays[j] + (i * argStrides[j])`. Each argument
+/// must be of the type the function declares. The return value of call `i` is moved to `optOutReturns` at
+/// `i * function->returnType->sizeOfType`. Stops at the first error, returning it. `optOutCompleted` is set
+/// to how many calls succeeded. The arguments of the failed call are deinitialized, and of later calls untouched.
+CubsProgramRuntimeError cubs_interpreter_execute_function_batch(
+    const struct CubsScriptFunctionPtr* function,
+    const void* const* argArrays,
+    const size_t* argStrides,
+    size_t count,
+    void* optOutReturns,
+    size_t* optOutCompleted
+);
+
+/// Bounds how long `cubs_interpreter_execute_function_budgeted(...)` and `cubs_interpreter_resume(...)`
+/// run before suspending. Zero means no limit. The time budget is checked every
+/// `CUBS_BUDGET_TIME_CHECK_INTERVAL` operations, so may be overrun by up to that many operations.
+/// Script functions called from C functions run to completion, and their operations aren't counted.
+typedef struct CubsExecutionBudget {
+    uint64_t operations;
+    uint64_t nanoseconds;
+} CubsExecutionBudget;
+
+#define CUBS_BUDGET_TIME_CHECK_INTERVAL 1024
+
+/// Execution started by `cubs_interpreter_execute_function_budgeted(...)`. While suspended, the
+/// frames of all of the executing script functions remain on the calling thread's interpreter stack,
+/// so it must be resumed or cancelled on the same thread. Other scripts may execute on the thread in
+/// the meantime, as long as they run to completion, or are themselves resumed to completion or
+/// cancelled first.
+typedef struct CubsBudgetedExecution {
+    /// If true, the execution ran out of budget or yielded, and must be finished with `cubs_interpreter_resume(...)`
+    /// or `cubs_interpreter_cancel(...)`.
+    bool suspended;
+    /// If `suspended`, true if it suspended by executing `OpCodeYield`, rather than running out of budget.
+    bool yielded;
+    /// Do not access
+    bool _hasYieldValue;
+    /// Do not access. Slot of the yielded value in the current frame.
+    uint16_t _yieldSrc;
+    /// Do not access
+    const struct CubsProgram* _program;
+    /// Do not access. Script function frames pushed on top of the executed function's frame.
+    size_t _callDepth;
+    /// Do not access. Frame that was current when suspended, to validate resuming.
+    size_t _basePointerOffset;
+    /// Do not access
+    void* _profilerSuspended;
+} CubsBudgetedExecution;
+
+/// Executes `function` as `cubs_interpreter_execute_function(...)` does, but suspends once `budget`
+/// runs out, setting `outExecution->suspended`. `outReturnValue` and `outContext` are written once
+/// the execution completes, so they must remain valid until then.
+/// Only returns an error if one occurred, in which case the execution is not suspended.
+CubsProgramRuntimeError cubs_interpreter_execute_function_budgeted(
+    const struct CubsScriptFunctionPtr* function,
+    void* outReturnValue,
+    const struct CubsTypeContext** outContext,
+    CubsExecutionBudget budget,
+    CubsBudgetedExecution* outExecution
+);
+
+/// Continues a suspended execution with a new budget. May suspend again.
+CubsProgramRuntimeError cubs_interpreter_resume(CubsBudgetedExecution* execution, CubsExecutionBudget budget);
+
+/// If `execution` suspended by yielding a value, moves it to `outValue` and `outContext`, and returns true.
+/// Otherwise returns false. A yielded value that isn't taken is deinitialized when the execution
+/// is resumed or cancelled.
+bool cubs_interpreter_take_yielded_value(CubsBudgetedExecution* execution, void* outValue, const struct CubsTypeContext** outContext);
+
+/// Unwinds and pops all frames of a suspended execution, without finishing it.
+void cubs_interpreter_cancel(CubsBudgetedExecution* execution);
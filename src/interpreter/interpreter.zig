@@ -407,6 +407,158 @@ test "add assign string" {
     c.cubs_interpreter_stack_unwind_frame();
 }
 
+test "add dst int specialized" {
+    c.cubs_interpreter_push_frame(3, null, null);
+    defer c.cubs_interpreter_pop_frame();
+
+    var bytecode = c.cubs_operands_specialize(c.operands_make_add_dst(false, 2, 0, 1), &c.CUBS_INT_CONTEXT);
+    try expect(c.cubs_bytecode_get_opcode(bytecode) == c.OpCodeAddInt);
+
+    c.cubs_interpreter_stack_set_context_at(0, &c.CUBS_INT_CONTEXT);
+    @as(*i64, @ptrCast(@alignCast(c.cubs_interpreter_stack_value_at(0)))).* = 2;
+    c.cubs_interpreter_stack_set_context_at(1, &c.CUBS_INT_CONTEXT);
+    @as(*i64, @ptrCast(@alignCast(c.cubs_interpreter_stack_value_at(1)))).* = 4;
+
+    c.cubs_interpreter_set_instruction_pointer(@ptrCast(&bytecode));
+    try expect(c.cubs_interpreter_execute_operation(null) == 0);
+
+    try expect(c.cubs_interpreter_stack_context_at(2) == &c.CUBS_INT_CONTEXT);
+    try expect(@as(*i64, @ptrCast(@alignCast(c.cubs_interpreter_stack_value_at(2)))).* == 6);
+}
+
+test "add assign int specialized overflow" {
+    c.cubs_interpreter_push_frame(2, null, null);
+    defer c.cubs_interpreter_pop_frame();
+
+    var context = ScriptContextTestRuntimeError(c.cubsProgramRuntimeErrorAdditionIntegerOverflow).init(true);
+
+    var program = c.cubs_program_init(.{ .context = &context });
+    defer c.cubs_program_deinit(&program);
+
+    var bytecode = c.cubs_operands_specialize(c.operands_make_add_assign(false, 0, 1), &c.CUBS_INT_CONTEXT);
+
+    c.cubs_interpreter_stack_set_context_at(0, &c.CUBS_INT_CONTEXT);
+    @as(*i64, @ptrCast(@alignCast(c.cubs_interpreter_stack_value_at(0)))).* = std.math.maxInt(i64);
+    c.cubs_interpreter_stack_set_context_at(1, &c.CUBS_INT_CONTEXT);
+    @as(*i64, @ptrCast(@alignCast(c.cubs_interpreter_stack_value_at(1)))).* = 1;
+
+    c.cubs_interpreter_set_instruction_pointer(@ptrCast(&bytecode));
+    try expect(c.cubs_interpreter_execute_operation(&program) == c.cubsProgramRuntimeErrorAdditionIntegerOverflow);
+}
+
+test "add assign float specialized" {
+    c.cubs_interpreter_push_frame(2, null, null);
+    defer c.cubs_interpreter_pop_frame();
+
+    var bytecode = c.cubs_operands_specialize(c.operands_make_add_assign(false, 0, 1), &c.CUBS_FLOAT_CONTEXT);
+    try expect(c.cubs_bytecode_get_opcode(bytecode) == c.OpCodeAddFloat);
+
+    c.cubs_interpreter_stack_set_context_at(0, &c.CUBS_FLOAT_CONTEXT);
+    @as(*f64, @ptrCast(@alignCast(c.cubs_interpreter_stack_value_at(0)))).* = 2.5;
+    c.cubs_interpreter_stack_set_context_at(1, &c.CUBS_FLOAT_CONTEXT);
+    @as(*f64, @ptrCast(@alignCast(c.cubs_interpreter_stack_value_at(1)))).* = 4.5;
+
+    c.cubs_interpreter_set_instruction_pointer(@ptrCast(&bytecode));
+    try expect(c.cubs_interpreter_execute_operation(null) == 0);
+
+    try expect(c.cubs_interpreter_stack_context_at(0) == &c.CUBS_FLOAT_CONTEXT);
+    try expect(std.math.approxEqAbs(
+        f64,
+        @as(*f64, @ptrCast(@alignCast(c.cubs_interpreter_stack_value_at(0)))).*,
+        7.0,
+        std.math.floatEps(f64),
+    ));
+}
+
+test "increment int specialized" {
+    c.cubs_interpreter_push_frame(2, null, null);
+    defer c.cubs_interpreter_pop_frame();
+
+    c.cubs_interpreter_stack_set_context_at(0, &c.CUBS_INT_CONTEXT);
+    @as(*i64, @ptrCast(@alignCast(c.cubs_interpreter_stack_value_at(0)))).* = 9;
+
+    { // dst
+        var bytecode = c.cubs_operands_specialize(c.operands_make_increment_dst(false, 1, 0), &c.CUBS_INT_CONTEXT);
+        try expect(c.cubs_bytecode_get_opcode(bytecode) == c.OpCodeIncrementInt);
+
+        c.cubs_interpreter_set_instruction_pointer(@ptrCast(&bytecode));
+        try expect(c.cubs_interpreter_execute_operation(null) == 0);
+
+        try expect(c.cubs_interpreter_stack_context_at(1) == &c.CUBS_INT_CONTEXT);
+        try expect(@as(*i64, @ptrCast(@alignCast(c.cubs_interpreter_stack_value_at(1)))).* == 10);
+    }
+    { // assign
+        var bytecode = c.cubs_operands_specialize(c.operands_make_increment_assign(false, 0), &c.CUBS_INT_CONTEXT);
+
+        c.cubs_interpreter_set_instruction_pointer(@ptrCast(&bytecode));
+        try expect(c.cubs_interpreter_execute_operation(null) == 0);
+
+        try expect(@as(*i64, @ptrCast(@alignCast(c.cubs_interpreter_stack_value_at(0)))).* == 10);
+    }
+}
+
+test "compare specialized matches generic" {
+    const compareOps = [_]c.enum_CompareOperationType{
+        c.COMPARE_OP_EQUAL,
+        c.COMPARE_OP_NOT_EQUAL,
+        c.COMPARE_OP_LESS,
+        c.COMPARE_OP_GREATER,
+        c.COMPARE_OP_LESS_OR_EQUAL,
+        c.COMPARE_OP_GREATER_OR_EQUAL,
+    };
+    const intValues = [_]i64{ std.math.minInt(i64), -1, 0, 1, std.math.maxInt(i64) };
+    const floatValues = [_]f64{ -std.math.inf(f64), -1.5, 0.0, 1.5, std.math.nan(f64) };
+
+    c.cubs_interpreter_push_frame(3, null, null);
+    defer c.cubs_interpreter_pop_frame();
+
+    for (compareOps) |op| {
+        const generic = c.cubs_operands_make_compare(op, 2, 0, 1);
+        for (0..intValues.len) |i| {
+            for (0..intValues.len) |j| {
+                c.cubs_interpreter_stack_set_context_at(0, &c.CUBS_INT_CONTEXT);
+                @as(*i64, @ptrCast(@alignCast(c.cubs_interpreter_stack_value_at(0)))).* = intValues[i];
+                c.cubs_interpreter_stack_set_context_at(1, &c.CUBS_INT_CONTEXT);
+                @as(*i64, @ptrCast(@alignCast(c.cubs_interpreter_stack_value_at(1)))).* = intValues[j];
+
+                var bytecode = generic;
+                c.cubs_interpreter_set_instruction_pointer(@ptrCast(&bytecode));
+                try expect(c.cubs_interpreter_execute_operation(null) == 0);
+                const expected = @as(*bool, @ptrCast(@alignCast(c.cubs_interpreter_stack_value_at(2)))).*;
+
+                bytecode = c.cubs_operands_specialize(generic, &c.CUBS_INT_CONTEXT);
+                try expect(c.cubs_bytecode_get_opcode(bytecode) != c.cubs_bytecode_get_opcode(generic));
+                c.cubs_interpreter_set_instruction_pointer(@ptrCast(&bytecode));
+                try expect(c.cubs_interpreter_execute_operation(null) == 0);
+
+                try expect(c.cubs_interpreter_stack_context_at(2) == &c.CUBS_BOOL_CONTEXT);
+                try expect(@as(*bool, @ptrCast(@alignCast(c.cubs_interpreter_stack_value_at(2)))).* == expected);
+            }
+        }
+        for (0..floatValues.len) |i| {
+            for (0..floatValues.len) |j| {
+                c.cubs_interpreter_stack_set_context_at(0, &c.CUBS_FLOAT_CONTEXT);
+                @as(*f64, @ptrCast(@alignCast(c.cubs_interpreter_stack_value_at(0)))).* = floatValues[i];
+                c.cubs_interpreter_stack_set_context_at(1, &c.CUBS_FLOAT_CONTEXT);
+                @as(*f64, @ptrCast(@alignCast(c.cubs_interpreter_stack_value_at(1)))).* = floatValues[j];
+
+                var bytecode = generic;
+                c.cubs_interpreter_set_instruction_pointer(@ptrCast(&bytecode));
+                try expect(c.cubs_interpreter_execute_operation(null) == 0);
+                const expected = @as(*bool, @ptrCast(@alignCast(c.cubs_interpreter_stack_value_at(2)))).*;
+
+                // Float equality doesn't have a specialized operation, so it will be unchanged
+                bytecode = c.cubs_operands_specialize(generic, &c.CUBS_FLOAT_CONTEXT);
+                c.cubs_interpreter_set_instruction_pointer(@ptrCast(&bytecode));
+                try expect(c.cubs_interpreter_execute_operation(null) == 0);
+
+                try expect(c.cubs_interpreter_stack_context_at(2) == &c.CUBS_BOOL_CONTEXT);
+                try expect(@as(*bool, @ptrCast(@alignCast(c.cubs_interpreter_stack_value_at(2)))).* == expected);
+            }
+        }
+    }
+}
+
 test "return no value" {
     c.cubs_interpreter_push_frame(0, null, null);
     // explicitly dont pop frame, as return will
@@ -0,0 +1,344 @@
+#include "../bench.h"
+#include "interpreter.h"
+#include "coroutine.h"
+#include "bytecode.h"
+#include "operations.h"
+#include "function_definition.h"
+#include "jit.h"
+#include "stack.h"
+#include "../program/program.h"
+#include "../program/program_internal.h"
+#include "../primitives/context.h"
+#include "../primitives/function/function.h"
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static const int64_t ARITHMETIC_ITERATIONS = 10000000;
+static const int64_t CALL_ITERATIONS = 2000000;
+static const int64_t UNWIND_ITERATIONS = 200000;
+static const uint64_t BUDGET_OPERATIONS = 100000;
+static const int64_t COROUTINE_ROUNDS = 1000;
+static const int64_t ENTITY_TICKS = 200;
+#define ENTITY_COUNT 10000
+#define COROUTINE_COUNT 1000
+#define UNWIND_FRAME_LENGTH 256
+
+/// Runs `func` with no arguments, returning the int it returns.
+static int64_t run_int_function(const CubsScriptFunctionPtr* func) {
+    const CubsFunction f = {.func = {.script = func}, .funcType = cubsFunctionPtrTypeScript};
+    int64_t result = 0;
+    const CubsTypeContext* resultContext = NULL;
+    const CubsFunctionReturn ret = {.value = (void*)&result, .context = &resultContext};
+
+    const int err = cubs_function_call(cubs_function_start_call(&f), ret);
+    if(err != 0 || resultContext != &CUBS_INT_CONTEXT) {
+        fprintf(stderr, "benchmark script function failed with error %d\n", err);
+        exit(1);
+    }
+    return result;
+}
+
+/// Runs `func` with no arguments as `run_int_function(...)` does, suspending every
+/// `BUDGET_OPERATIONS` operations, as a host bounding script time per frame would.
+static int64_t run_int_function_budgeted(const CubsScriptFunctionPtr* func) {
+    int64_t result = 0;
+    const CubsTypeContext* resultContext = NULL;
+    const CubsExecutionBudget budget = {.operations = BUDGET_OPERATIONS, .nanoseconds = 0};
+    CubsBudgetedExecution execution;
+
+    CubsProgramRuntimeError err = cubs_interpreter_execute_function_budgeted(func, (void*)&result, &resultContext, budget, &execution);
+    while(err == cubsProgramRuntimeErrorNone && execution.suspended) {
+        err = cubs_interpreter_resume(&execution, budget);
+    }
+    if(err != 0 || resultContext != &CUBS_INT_CONTEXT) {
+        fprintf(stderr, "benchmark script function failed with error %d\n", err);
+        exit(1);
+    }
+    return result;
+}
+
+/// Whether script functions of `program` are compiled once called. See `jit.h`.
+static bool program_uses_jit(const CubsProgram* program) {
+    return CUBS_JIT_ENABLED && ((const ProgramInner*)program->_inner)->jitCallThreshold != 0;
+}
+
+/// Equivalent to
+/// ```
+/// fn sum() int {
+///     mut acc = 0;
+///     for(mut i = 0; i < ARITHMETIC_ITERATIONS; i += 1) { acc += i; }
+///     return acc;
+/// }
+/// ```
+/// Executes 4 operations per loop iteration.
+/// If `specialize == true`, uses the int specialized operations.
+/// If `fuse == true`, allows the loop increment, compare, and jump to be fused into a superinstruction.
+/// If `budgeted == true`, executes with an operation budget, resuming until it completes.
+static void bench_arithmetic_loop(CubsProgram* program, bool specialize, bool fuse, bool budgeted) {
+    const CubsTypeContext* specializeContext = specialize ? &CUBS_INT_CONTEXT : NULL;
+    FunctionBuilder builder = {.stackSpaceRequired = 4};
+    builder.optReturnType = &CUBS_INT_CONTEXT;
+
+    cubs_function_builder_push_bytecode(&builder, operands_make_load_immediate(LOAD_IMMEDIATE_INT, 0, 0));
+    cubs_function_builder_push_bytecode(&builder, operands_make_load_immediate(LOAD_IMMEDIATE_INT, 1, ARITHMETIC_ITERATIONS));
+    cubs_function_builder_push_bytecode(&builder, operands_make_load_immediate(LOAD_IMMEDIATE_INT, 2, 0));
+    { // loop start
+        const Bytecode loop[4] = {
+            cubs_operands_specialize(operands_make_add_assign(false, 2, 0), specializeContext),
+            cubs_operands_specialize(operands_make_increment_assign(false, 0), specializeContext),
+            cubs_operands_specialize(cubs_operands_make_compare(COMPARE_OP_LESS, 3, 0, 1), specializeContext),
+            cubs_operands_make_jump(JUMP_TYPE_IF_TRUE, -3, 3),
+        };
+        for(size_t i = 0; i < 4; i++) {
+            if(fuse) {
+                cubs_function_builder_push_bytecode(&builder, loop[i]);
+            } else {
+                // Pushing as "many" bytecode isn't considered for fusing
+                cubs_function_builder_push_bytecode_many(&builder, &loop[i], 1);
+            }
+        }
+    }
+    // loop end
+    cubs_function_builder_push_bytecode(&builder, operands_make_return(true, 2));
+
+    const CubsScriptFunctionPtr* func = cubs_function_builder_build(&builder, program);
+
+    const uint64_t start = cubs_bench_now_ns();
+    const int64_t result = budgeted ? run_int_function_budgeted(func) : run_int_function(func);
+    const uint64_t elapsed = cubs_bench_now_ns() - start;
+
+    assert(result == ((ARITHMETIC_ITERATIONS - 1) * ARITHMETIC_ITERATIONS) / 2);
+    (void)result;
+    const char* name = "interpreter arithmetic loop";
+    if(program_uses_jit(program)) {
+        name = specialize ? "jit arithmetic loop specialized fused" : "jit arithmetic loop";
+    } else if(budgeted) {
+        name = "interpreter arithmetic loop budgeted";
+    } else if(specialize && fuse) {
+        name = "interpreter arithmetic loop specialized fused";
+    } else if(specialize) {
+        name = "interpreter arithmetic loop specialized";
+    }
+    cubs_bench_report(name, (uint64_t)(ARITHMETIC_ITERATIONS * 4 + 4), elapsed);
+}
+
+/// Equivalent to
+/// ```
+/// fn addOne(x: int) int { return x + 1; }
+/// fn callMany() int {
+///     mut result = 0;
+///     for(mut i = 0; i < CALL_ITERATIONS; i += 1) { result = addOne(i); }
+///     return result;
+/// }
+/// ```
+/// Executes 7 operations per loop iteration, 4 in `callMany` and 3 in `addOne`.
+/// `addOne` reserves `calleeFrameLength` stack slots, as functions with many temporaries do,
+/// though it only uses the first 3.
+/// If `indirect == true`, calls `addOne` through a function value on the stack, rather than immediately.
+static void bench_call_loop(CubsProgram* program, size_t calleeFrameLength, bool indirect) {
+    assert(calleeFrameLength >= 3);
+    const CubsScriptFunctionPtr* addOne = NULL;
+    {
+        FunctionBuilder builder = {.stackSpaceRequired = calleeFrameLength};
+        builder.optReturnType = &CUBS_INT_CONTEXT;
+        cubs_function_builder_add_arg(&builder, &CUBS_INT_CONTEXT);
+
+        cubs_function_builder_push_bytecode(&builder, operands_make_load_immediate(LOAD_IMMEDIATE_INT, 1, 1));
+        cubs_function_builder_push_bytecode(&builder, operands_make_add_dst(false, 2, 0, 1));
+        cubs_function_builder_push_bytecode(&builder, operands_make_return(true, 2));
+
+        addOne = cubs_function_builder_build(&builder, program);
+    }
+
+    // The function value for indirect calls takes 2 slots
+    FunctionBuilder builder = {.stackSpaceRequired = 6};
+    builder.optReturnType = &CUBS_INT_CONTEXT;
+
+    const CubsFunction callee = {.func = {.script = addOne}, .funcType = cubsFunctionPtrTypeScript};
+    if(indirect) {
+        Bytecode loadBytecode[3];
+        operands_make_load_clone_from_ptr(loadBytecode, 4, (const void*)&callee, &CUBS_FUNCTION_CONTEXT);
+        cubs_function_builder_push_bytecode_many(&builder, loadBytecode, 3);
+    }
+    cubs_function_builder_push_bytecode(&builder, operands_make_load_immediate(LOAD_IMMEDIATE_INT, 0, 0));
+    cubs_function_builder_push_bytecode(&builder, operands_make_load_immediate(LOAD_IMMEDIATE_INT, 1, CALL_ITERATIONS));
+    cubs_function_builder_push_bytecode(&builder, operands_make_load_immediate(LOAD_IMMEDIATE_INT, 2, 0));
+    { // loop start
+        const uint16_t args[1] = {0};
+        Bytecode callBytecode[3];
+        if(indirect) {
+            cubs_operands_make_call_src(callBytecode, 3, 1, args, true, 2, 4);
+        } else {
+            cubs_operands_make_call_immediate(callBytecode, 3, 1, args, true, 2, callee);
+        }
+        cubs_function_builder_push_bytecode_many(&builder, callBytecode, 3);
+    }
+    cubs_function_builder_push_bytecode(&builder, operands_make_increment_assign(false, 0));
+    cubs_function_builder_push_bytecode(&builder, cubs_operands_make_compare(COMPARE_OP_LESS, 3, 0, 1));
+    cubs_function_builder_push_bytecode(&builder, cubs_operands_make_jump(JUMP_TYPE_IF_TRUE, -5, 3));
+    // loop end
+    cubs_function_builder_push_bytecode(&builder, operands_make_return(true, 2));
+
+    const CubsScriptFunctionPtr* func = cubs_function_builder_build(&builder, program);
+
+    const uint64_t start = cubs_bench_now_ns();
+    const int64_t result = run_int_function(func);
+    const uint64_t elapsed = cubs_bench_now_ns() - start;
+
+    assert(result == CALL_ITERATIONS);
+    (void)result;
+    const char* name = "interpreter call loop";
+    if(program_uses_jit(program)) {
+        name = "jit call loop";
+    } else if(indirect) {
+        name = "interpreter call loop indirect";
+    } else if(calleeFrameLength > 3) {
+        name = "interpreter call loop wide callee frame";
+    }
+    cubs_bench_report(name, (uint64_t)(CALL_ITERATIONS * 7 + 4), elapsed);
+}
+
+/// Fills every slot of a frame with an int, then unwinds it, as returning
+/// from a function with many primitive locals does.
+static void bench_stack_unwind() {
+    cubs_interpreter_push_frame(UNWIND_FRAME_LENGTH, NULL, NULL);
+
+    const uint64_t start = cubs_bench_now_ns();
+    for(int64_t i = 0; i < UNWIND_ITERATIONS; i++) {
+        for(size_t slot = 0; slot < UNWIND_FRAME_LENGTH; slot++) {
+            *(int64_t*)cubs_interpreter_stack_value_at(slot) = i;
+            cubs_interpreter_stack_set_context_at(slot, &CUBS_INT_CONTEXT);
+        }
+        cubs_interpreter_stack_unwind_frame();
+    }
+    const uint64_t elapsed = cubs_bench_now_ns() - start;
+
+    cubs_interpreter_pop_frame();
+    cubs_bench_report("interpreter stack fill and unwind (per slot)", (uint64_t)(UNWIND_ITERATIONS * UNWIND_FRAME_LENGTH), elapsed);
+}
+
+/// Resumes `COROUTINE_COUNT` coroutines in turn, as a host ticking many script tasks would, each running
+/// ```
+/// fn task() { while(true) { yield; } }
+/// ```
+static void bench_coroutine_resume(CubsProgram* program) {
+    FunctionBuilder builder = {.stackSpaceRequired = 1};
+    cubs_function_builder_push_bytecode(&builder, operands_make_yield(false, 0));
+    cubs_function_builder_push_bytecode(&builder, cubs_operands_make_jump(JUMP_TYPE_DEFAULT, -1, 0));
+    const CubsScriptFunctionPtr* task = cubs_function_builder_build(&builder, program);
+
+    static CubsCoroutine* coroutines[COROUTINE_COUNT];
+    for(size_t i = 0; i < COROUTINE_COUNT; i++) {
+        coroutines[i] = cubs_coroutine_init(task);
+    }
+
+    const CubsExecutionBudget unlimited = {0};
+    const CubsFunctionReturn noValue = {0};
+    const uint64_t start = cubs_bench_now_ns();
+    for(int64_t round = 0; round < COROUTINE_ROUNDS; round++) {
+        for(size_t i = 0; i < COROUTINE_COUNT; i++) {
+            if(cubs_coroutine_resume(coroutines[i], unlimited, noValue) != cubsProgramRuntimeErrorNone) {
+                fprintf(stderr, "benchmark coroutine failed\n");
+                exit(1);
+            }
+        }
+    }
+    const uint64_t elapsed = cubs_bench_now_ns() - start;
+
+    for(size_t i = 0; i < COROUTINE_COUNT; i++) {
+        cubs_coroutine_deinit(coroutines[i]);
+    }
+    cubs_bench_report("interpreter coroutine resume", (uint64_t)(COROUTINE_ROUNDS * COROUTINE_COUNT), elapsed);
+}
+
+typedef struct BenchEntity {
+    int64_t position;
+    int64_t velocity;
+    int64_t id;
+} BenchEntity;
+
+/// Calls
+/// ```
+/// fn step(position: int, velocity: int) int { return position + velocity; }
+/// ```
+/// for each of `ENTITY_COUNT` entities per tick, as a host updating it's entities from a script would.
+/// If `batched == true`, calls it once per tick through `cubs_function_call_batch(...)`, otherwise
+/// pushes the arguments and calls it for each entity.
+static void bench_entity_calls(CubsProgram* program, bool batched) {
+    FunctionBuilder builder = {.stackSpaceRequired = 3, .optReturnType = &CUBS_INT_CONTEXT};
+    cubs_function_builder_add_arg(&builder, &CUBS_INT_CONTEXT);
+    cubs_function_builder_add_arg(&builder, &CUBS_INT_CONTEXT);
+    cubs_function_builder_push_bytecode(&builder, cubs_operands_specialize(operands_make_add_dst(false, 2, 0, 1), &CUBS_INT_CONTEXT));
+    cubs_function_builder_push_bytecode(&builder, operands_make_return(true, 2));
+    const CubsFunction step = {.func = {.script = cubs_function_builder_build(&builder, program)}, .funcType = cubsFunctionPtrTypeScript};
+
+    static BenchEntity entities[ENTITY_COUNT];
+    static int64_t positions[ENTITY_COUNT];
+    for(size_t i = 0; i < ENTITY_COUNT; i++) {
+        const BenchEntity entity = {.position = 0, .velocity = (int64_t)i, .id = (int64_t)i};
+        entities[i] = entity;
+    }
+    const void* argArrays[2] = {(const void*)&entities[0].position, (const void*)&entities[0].velocity};
+    const size_t argStrides[2] = {sizeof(BenchEntity), sizeof(BenchEntity)};
+
+    const uint64_t start = cubs_bench_now_ns();
+    for(int64_t tick = 0; tick < ENTITY_TICKS; tick++) {
+        int err = 0;
+        if(batched) {
+            err = cubs_function_call_batch(&step, argArrays, argStrides, ENTITY_COUNT, (void*)positions, NULL);
+        } else {
+            for(size_t i = 0; i < ENTITY_COUNT && err == 0; i++) {
+                const CubsTypeContext* context = NULL;
+                const CubsFunctionReturn ret = {.value = (void*)&positions[i], .context = &context};
+                CubsFunctionCallArgs args = cubs_function_start_call(&step);
+                cubs_function_push_arg(&args, (void*)&entities[i].position, &CUBS_INT_CONTEXT);
+                cubs_function_push_arg(&args, (void*)&entities[i].velocity, &CUBS_INT_CONTEXT);
+                err = cubs_function_call(args, ret);
+            }
+        }
+        if(err != 0) {
+            fprintf(stderr, "benchmark script function failed with error %d\n", err);
+            exit(1);
+        }
+        for(size_t i = 0; i < ENTITY_COUNT; i++) {
+            entities[i].position = positions[i];
+        }
+    }
+    const uint64_t elapsed = cubs_bench_now_ns() - start;
+
+    // Every entity moved by it's velocity each tick
+    assert(entities[ENTITY_COUNT - 1].position == (ENTITY_COUNT - 1) * ENTITY_TICKS);
+    cubs_bench_report(batched ? "interpreter entity calls batched" : "interpreter entity calls", (uint64_t)(ENTITY_TICKS * ENTITY_COUNT), elapsed);
+}
+
+void cubs_bench_interpreter()
+{
+    const CubsProgramInitParams params = {0};
+    CubsProgram program = cubs_program_init(params);
+
+    bench_arithmetic_loop(&program, false, false, false);
+    bench_arithmetic_loop(&program, true, false, false);
+    bench_arithmetic_loop(&program, true, true, false);
+    bench_arithmetic_loop(&program, false, false, true);
+    bench_call_loop(&program, 3, false);
+    bench_call_loop(&program, 256, false);
+    bench_call_loop(&program, 3, true);
+    bench_stack_unwind();
+    bench_coroutine_resume(&program);
+    bench_entity_calls(&program, false);
+    bench_entity_calls(&program, true);
+
+    cubs_program_deinit(&program);
+
+    if(CUBS_JIT_ENABLED) {
+        const CubsProgramInitParams jitParams = {.context = NULL, .jitCallThreshold = 1};
+        CubsProgram jitProgram = cubs_program_init(jitParams);
+
+        bench_arithmetic_loop(&jitProgram, false, false, false);
+        bench_arithmetic_loop(&jitProgram, true, true, false);
+        bench_call_loop(&jitProgram, 3, false);
+
+        cubs_program_deinit(&jitProgram);
+    }
+}
@@ -0,0 +1,715 @@
+#include "jit.h"
+#include "bytecode.h"
+#include "operations.h"
+#include "stack.h"
+#include "verifier.h"
+#include "function_definition.h"
+#include "../program/program_internal.h"
+#include "../platform/mem.h"
+#include "../sync/atomic.h"
+#include "../sync/locks.h"
+#include "../util/unreachable.h"
+#include <assert.h>
+#include <string.h>
+
+#if CUBS_JIT_ENABLED
+
+#pragma region Emit
+
+typedef struct CodeBuffer {
+    uint8_t* bytes;
+    size_t len;
+    size_t capacity;
+} CodeBuffer;
+
+static void code_buffer_deinit(CodeBuffer* self) {
+    if(self->bytes != NULL) {
+        FREE_TYPE_ARRAY(uint8_t, self->bytes, self->capacity);
+    }
+    const CodeBuffer zeroed = {0};
+    *self = zeroed;
+}
+
+static void emit_bytes(CodeBuffer* self, const uint8_t* bytes, size_t count) {
+    if(self->len + count > self->capacity) {
+        size_t newCapacity = self->capacity == 0 ? 256 : self->capacity * 2;
+        while(newCapacity < self->len + count) {
+            newCapacity *= 2;
+        }
+        uint8_t* newBytes = MALLOC_TYPE_ARRAY(uint8_t, newCapacity);
+        if(self->bytes != NULL) {
+            memcpy((void*)newBytes, (const void*)self->bytes, self->len);
+            FREE_TYPE_ARRAY(uint8_t, self->bytes, self->capacity);
+        }
+        self->bytes = newBytes;
+        self->capacity = newCapacity;
+    }
+    memcpy((void*)&self->bytes[self->len], (const void*)bytes, count);
+    self->len += count;
+}
+
+static void emit_u8(CodeBuffer* self, uint8_t byte) {
+    emit_bytes(self, &byte, 1);
+}
+
+static void emit_u32(CodeBuffer* self, uint32_t value) {
+    const uint8_t bytes[4] = {(uint8_t)value, (uint8_t)(value >> 8), (uint8_t)(value >> 16), (uint8_t)(value >> 24)};
+    emit_bytes(self, bytes, 4);
+}
+
+static void emit_u64(CodeBuffer* self, uint64_t value) {
+    emit_u32(self, (uint32_t)value);
+    emit_u32(self, (uint32_t)(value >> 32));
+}
+
+static void patch_u32(CodeBuffer* self, size_t offset, uint32_t value) {
+    assert(offset + 4 <= self->len);
+    const uint8_t bytes[4] = {(uint8_t)value, (uint8_t)(value >> 8), (uint8_t)(value >> 16), (uint8_t)(value >> 24)};
+    memcpy((void*)&self->bytes[offset], (const void*)bytes, 4);
+}
+
+/*
+Registers that hold the same value for the whole function. All are callee saved, so they are
+preserved across calls into the interpreter.
+rbx: `frame->values`
+rbp: `frame->tags`
+r12: `frame`
+r13: `program`
+Everything else is a scratch register within a single operation's template.
+*/
+
+enum Reg {
+    REG_RAX = 0,
+    REG_RBX = 3,
+    REG_RBP = 5,
+};
+
+enum XmmReg {
+    XMM0 = 0,
+    XMM1 = 1,
+};
+
+/// Condition codes, as the low nibble of `jcc` and `setcc`.
+enum Condition {
+    CC_OVERFLOW = 0x0,
+    CC_NO_OVERFLOW = 0x1,
+    CC_BELOW = 0x2,
+    CC_ABOVE_OR_EQUAL = 0x3,
+    CC_EQUAL = 0x4,
+    CC_NOT_EQUAL = 0x5,
+    CC_BELOW_OR_EQUAL = 0x6,
+    CC_ABOVE = 0x7,
+    CC_LESS = 0xC,
+    CC_GREATER_OR_EQUAL = 0xD,
+    CC_LESS_OR_EQUAL = 0xE,
+    CC_GREATER = 0xF,
+};
+
+/// Emits `prefixAndOpcode`, followed by a ModRM addressing `[base + disp32]`, with `reg` as the register operand.
+static void emit_mem_operand(CodeBuffer* self, const uint8_t* prefixAndOpcode, size_t len, uint8_t reg, enum Reg base, uint32_t disp) {
+    emit_bytes(self, prefixAndOpcode, len);
+    emit_u8(self, (uint8_t)(0x80 | ((reg & 7) << 3) | base));
+    emit_u32(self, disp);
+}
+
+/// `[rbx + slot * 8]`
+static uint32_t value_disp(size_t slot) {
+    assert(slot <= MAX_FRAME_LENGTH);
+    return (uint32_t)(slot * sizeof(size_t));
+}
+
+/// mov rax, [value]
+static void emit_load_int(CodeBuffer* self, size_t slot) {
+    const uint8_t op[] = {0x48, 0x8B};
+    emit_mem_operand(self, op, sizeof(op), REG_RAX, REG_RBX, value_disp(slot));
+}
+
+/// mov [value], rax
+static void emit_store_int(CodeBuffer* self, size_t slot) {
+    const uint8_t op[] = {0x48, 0x89};
+    emit_mem_operand(self, op, sizeof(op), REG_RAX, REG_RBX, value_disp(slot));
+}
+
+/// add rax, [value]
+static void emit_add_int(CodeBuffer* self, size_t slot) {
+    const uint8_t op[] = {0x48, 0x03};
+    emit_mem_operand(self, op, sizeof(op), REG_RAX, REG_RBX, value_disp(slot));
+}
+
+/// add rax, 1
+static void emit_increment_int(CodeBuffer* self) {
+    const uint8_t op[] = {0x48, 0x83, 0xC0, 0x01};
+    emit_bytes(self, op, sizeof(op));
+}
+
+/// cmp rax, [value]
+static void emit_compare_int(CodeBuffer* self, size_t slot) {
+    const uint8_t op[] = {0x48, 0x3B};
+    emit_mem_operand(self, op, sizeof(op), REG_RAX, REG_RBX, value_disp(slot));
+}
+
+/// Stores a 64 bit immediate in the slot's value.
+static void emit_store_immediate_int(CodeBuffer* self, size_t slot, int64_t immediate) {
+    if(immediate >= INT32_MIN && immediate <= INT32_MAX) {
+        // mov qword [value], imm32 (sign extended)
+        const uint8_t op[] = {0x48, 0xC7};
+        emit_mem_operand(self, op, sizeof(op), 0, REG_RBX, value_disp(slot));
+        emit_u32(self, (uint32_t)(int32_t)immediate);
+    } else {
+        // mov rax, imm64
+        const uint8_t op[] = {0x48, 0xB8};
+        emit_bytes(self, op, sizeof(op));
+        emit_u64(self, (uint64_t)immediate);
+        emit_store_int(self, slot);
+    }
+}
+
+/// mov byte [value], imm8
+static void emit_store_immediate_bool(CodeBuffer* self, size_t slot, bool immediate) {
+    const uint8_t op[] = {0xC6};
+    emit_mem_operand(self, op, sizeof(op), 0, REG_RBX, value_disp(slot));
+    emit_u8(self, immediate ? 1 : 0);
+}
+
+/// setcc al, then mov byte [value], al
+static void emit_store_condition(CodeBuffer* self, enum Condition condition, size_t slot) {
+    const uint8_t setcc[] = {0x0F, (uint8_t)(0x90 | condition), 0xC0};
+    emit_bytes(self, setcc, sizeof(setcc));
+    const uint8_t op[] = {0x88};
+    emit_mem_operand(self, op, sizeof(op), REG_RAX, REG_RBX, value_disp(slot));
+}
+
+/// mov byte [tag], imm8
+static void emit_set_tag(CodeBuffer* self, size_t slot, enum InterpreterSlotTag tag) {
+    assert(slot <= MAX_FRAME_LENGTH);
+    const uint8_t op[] = {0xC6};
+    emit_mem_operand(self, op, sizeof(op), 0, REG_RBP, (uint32_t)slot);
+    emit_u8(self, (uint8_t)tag);
+}
+
+/// movsd xmm, [value]
+static void emit_load_float(CodeBuffer* self, enum XmmReg xmm, size_t slot) {
+    const uint8_t op[] = {0xF2, 0x0F, 0x10};
+    emit_mem_operand(self, op, sizeof(op), (uint8_t)xmm, REG_RBX, value_disp(slot));
+}
+
+/// movsd [value], xmm0
+static void emit_store_float(CodeBuffer* self, size_t slot) {
+    const uint8_t op[] = {0xF2, 0x0F, 0x11};
+    emit_mem_operand(self, op, sizeof(op), XMM0, REG_RBX, value_disp(slot));
+}
+
+/// addsd xmm0, [value]
+static void emit_add_float(CodeBuffer* self, size_t slot) {
+    const uint8_t op[] = {0xF2, 0x0F, 0x58};
+    emit_mem_operand(self, op, sizeof(op), XMM0, REG_RBX, value_disp(slot));
+}
+
+/// Returns the offset of the 8 bit displacement to patch with `patch_short_jump(...)`.
+static size_t emit_short_jump_if(CodeBuffer* self, enum Condition condition) {
+    const uint8_t op[] = {(uint8_t)(0x70 | condition), 0x00};
+    emit_bytes(self, op, sizeof(op));
+    return self->len - 1;
+}
+
+/// Makes the short jump at `dispOffset` jump to the end of the code so far.
+static void patch_short_jump(CodeBuffer* self, size_t dispOffset) {
+    const size_t distance = self->len - (dispOffset + 1);
+    assert(distance <= INT8_MAX);
+    self->bytes[dispOffset] = (uint8_t)distance;
+}
+
+#pragma endregion
+
+#pragma region Compile
+
+/// Jump to resolve once every operation's code offset is known.
+typedef struct BranchFixup {
+    /// Offset of the 32 bit displacement, which is relative to the end of it.
+    size_t dispOffset;
+    /// Index of the bytecode jumped to, or the bytecode length for the function's exit.
+    size_t target;
+} BranchFixup;
+
+typedef struct JitCompiler {
+    const CubsScriptFunctionPtr* function;
+    const Bytecode* bytecode;
+    size_t len;
+    CodeBuffer code;
+    /// Code offset of each bytecode that starts an operation.
+    size_t* offsets;
+    BranchFixup* fixups;
+    size_t fixupsLen;
+    size_t fixupsCapacity;
+} JitCompiler;
+
+/// Number of bytecodes of the operation starting at `bytecode`.
+static size_t operation_len(const Bytecode* bytecode) {
+    switch(cubs_bytecode_get_opcode(*bytecode)) {
+        case OpCodeLoad: {
+            const OperandsLoadUnknown unknownOperands = *(const OperandsLoadUnknown*)bytecode;
+            switch(unknownOperands.loadType) {
+                case LOAD_TYPE_IMMEDIATE: return 1;
+                case LOAD_TYPE_IMMEDIATE_LONG: return 2;
+                case LOAD_TYPE_DEFAULT: {
+                    const OperandsLoadDefault operands = *(const OperandsLoadDefault*)bytecode;
+                    switch(operands.tag) {
+                        case cubsValueTagArray:
+                        case cubsValueTagSet:
+                        case cubsValueTagOption:
+                            return 2;
+                        case cubsValueTagMap:
+                            return 3;
+                        default:
+                            return 1;
+                    }
+                }
+                case LOAD_TYPE_CLONE_FROM_PTR: return 3;
+                default: unreachable();
+            }
+        }
+        case OpCodeCall: {
+            const OperandsCallUnknown operands = *(const OperandsCallUnknown*)bytecode;
+            return 2 + ((operands.argCount + 3) / 4);
+        }
+        case OpCodeSync: {
+            const OperandsSync operands = *(const OperandsSync*)bytecode;
+            if(operands.opType == SYNC_TYPE_UNSYNC) {
+                return 1;
+            }
+            return cubs_operands_sync_bytecode_required(operands.num);
+        }
+        default: {
+            return 1;
+        }
+    }
+}
+
+static void emit_branch(JitCompiler* self, const uint8_t* op, size_t opLen, size_t target) {
+    emit_bytes(&self->code, op, opLen);
+    if(self->fixupsLen == self->fixupsCapacity) {
+        const size_t newCapacity = self->fixupsCapacity == 0 ? 16 : self->fixupsCapacity * 2;
+        BranchFixup* newFixups = MALLOC_TYPE_ARRAY(BranchFixup, newCapacity);
+        if(self->fixups != NULL) {
+            memcpy((void*)newFixups, (const void*)self->fixups, sizeof(BranchFixup) * self->fixupsLen);
+            FREE_TYPE_ARRAY(BranchFixup, self->fixups, self->fixupsCapacity);
+        }
+        self->fixups = newFixups;
+        self->fixupsCapacity = newCapacity;
+    }
+    const BranchFixup fixup = {.dispOffset = self->code.len, .target = target};
+    self->fixups[self->fixupsLen] = fixup;
+    self->fixupsLen += 1;
+    emit_u32(&self->code, 0);
+}
+
+/// jmp to the operation at `target`, or the exit if `target == self->len`.
+static void emit_jump(JitCompiler* self, size_t target) {
+    const uint8_t op[] = {0xE9};
+    emit_branch(self, op, sizeof(op), target);
+}
+
+static void emit_jump_if(JitCompiler* self, enum Condition condition, size_t target) {
+    const uint8_t op[] = {0x0F, (uint8_t)(0x80 | condition)};
+    emit_branch(self, op, sizeof(op), target);
+}
+
+/// Calls the interpreter's implementation of the operation at `index`. See `_cubs_jit_operation(...)`.
+static void emit_execute_operation(JitCompiler* self, size_t index) {
+    const uint8_t args[] = {
+        0x4C, 0x89, 0xEF, // mov rdi, r13
+        0x4C, 0x89, 0xE6, // mov rsi, r12
+        0x48, 0xBA,       // mov rdx, imm64
+    };
+    emit_bytes(&self->code, args, sizeof(args));
+    emit_u64(&self->code, (uint64_t)(uintptr_t)&self->bytecode[index]);
+    const uint8_t func[] = {0x48, 0xB8}; // mov rax, imm64
+    emit_bytes(&self->code, func, sizeof(func));
+    emit_u64(&self->code, (uint64_t)(uintptr_t)_cubs_jit_operation(&self->bytecode[index]));
+    const uint8_t call[] = {0xFF, 0xD0}; // call rax
+    emit_bytes(&self->code, call, sizeof(call));
+}
+
+/// Executes the operation through the interpreter, exiting with it's error if it has one.
+static void emit_interpreted_operation(JitCompiler* self, size_t index) {
+    emit_execute_operation(self, index);
+    const uint8_t test[] = {0x85, 0xC0}; // test eax, eax
+    emit_bytes(&self->code, test, sizeof(test));
+    emit_jump_if(self, CC_NOT_EQUAL, self->len);
+}
+
+/// Following an int add that set the overflow flag, has the interpreter execute the operation at
+/// `index` again, which reports the overflow, and exits with it's error. Values are only written
+/// after checking for overflow, so executing it again is the same as executing it once.
+static void emit_overflow_check(JitCompiler* self, size_t index) {
+    const size_t skip = emit_short_jump_if(&self->code, CC_NO_OVERFLOW);
+    emit_execute_operation(self, index);
+    emit_jump(self, self->len);
+    patch_short_jump(&self->code, skip);
+}
+
+/// `OpCodeAddInt` at `index`, with overflow reported by re-executing `errorIndex`.
+static void compile_add_int(JitCompiler* self, size_t index, size_t errorIndex) {
+    const OperandsAddUnknown operands = *(const OperandsAddUnknown*)&self->bytecode[index];
+    emit_load_int(&self->code, operands.src1);
+    emit_add_int(&self->code, operands.src2);
+    emit_overflow_check(self, errorIndex);
+    if(operands.opType == MATH_TYPE_DST) {
+        const OperandsAddDst dstOperands = *(const OperandsAddDst*)&self->bytecode[index];
+        emit_store_int(&self->code, dstOperands.dst);
+        emit_set_tag(&self->code, dstOperands.dst, SLOT_TAG_INT);
+    } else {
+        emit_store_int(&self->code, operands.src1);
+    }
+}
+
+static void compile_add_float(JitCompiler* self, size_t index) {
+    const OperandsAddUnknown operands = *(const OperandsAddUnknown*)&self->bytecode[index];
+    emit_load_float(&self->code, XMM0, operands.src1);
+    emit_add_float(&self->code, operands.src2);
+    if(operands.opType == MATH_TYPE_DST) {
+        const OperandsAddDst dstOperands = *(const OperandsAddDst*)&self->bytecode[index];
+        emit_store_float(&self->code, dstOperands.dst);
+        emit_set_tag(&self->code, dstOperands.dst, SLOT_TAG_FLOAT);
+    } else {
+        emit_store_float(&self->code, operands.src1);
+    }
+}
+
+static void compile_increment_int(JitCompiler* self, size_t index) {
+    const OperandsIncrementUnknown operands = *(const OperandsIncrementUnknown*)&self->bytecode[index];
+    emit_load_int(&self->code, operands.src);
+    emit_increment_int(&self->code);
+    emit_overflow_check(self, index);
+    if(operands.opType == MATH_TYPE_DST) {
+        const OperandsIncrementDst dstOperands = *(const OperandsIncrementDst*)&self->bytecode[index];
+        emit_store_int(&self->code, dstOperands.dst);
+        emit_set_tag(&self->code, dstOperands.dst, SLOT_TAG_INT);
+    } else {
+        emit_store_int(&self->code, operands.src);
+    }
+}
+
+static void compile_compare_int(JitCompiler* self, size_t index, enum Condition condition) {
+    const OperandsUnknownCompare operands = *(const OperandsUnknownCompare*)&self->bytecode[index];
+    emit_load_int(&self->code, operands.src1);
+    emit_compare_int(&self->code, operands.src2);
+    emit_store_condition(&self->code, condition, operands.dst);
+    emit_set_tag(&self->code, operands.dst, SLOT_TAG_BOOL);
+}
+
+/// `condition` is of `src2` compared to `src1`, which is unordered if either is NaN.
+static void compile_compare_float(JitCompiler* self, size_t index, enum Condition condition) {
+    const OperandsUnknownCompare operands = *(const OperandsUnknownCompare*)&self->bytecode[index];
+    emit_load_float(&self->code, XMM0, operands.src1);
+    emit_load_float(&self->code, XMM1, operands.src2);
+    const uint8_t ucomisd[] = {0x66, 0x0F, 0x2E, 0xC8}; // ucomisd xmm1, xmm0
+    emit_bytes(&self->code, ucomisd, sizeof(ucomisd));
+    emit_store_condition(&self->code, condition, operands.dst);
+    emit_set_tag(&self->code, operands.dst, SLOT_TAG_BOOL);
+}
+
+/// Index of the bytecode jumped to by the jump at `index`.
+static size_t jump_target(const JitCompiler* self, size_t index) {
+    const OperandsJump operands = *(const OperandsJump*)&self->bytecode[index];
+    return (size_t)((int64_t)index + (int64_t)operands.jumpAmount);
+}
+
+static void compile_jump(JitCompiler* self, size_t index) {
+    const OperandsJump operands = *(const OperandsJump*)&self->bytecode[index];
+    const size_t target = jump_target(self, index);
+    if(operands.opType == JUMP_TYPE_DEFAULT) {
+        emit_jump(self, target);
+        return;
+    }
+    // cmp byte [value], 0
+    const uint8_t op[] = {0x80};
+    emit_mem_operand(&self->code, op, sizeof(op), 7, REG_RBX, value_disp(operands.optSrc));
+    emit_u8(&self->code, 0);
+    emit_jump_if(self, operands.opType == JUMP_TYPE_IF_TRUE ? CC_NOT_EQUAL : CC_EQUAL, target);
+}
+
+/// Matches `execute_increment_less_int_jump(...)`. The fused operations following it are
+/// compiled on their own too, as they may be jumped to.
+static void compile_increment_less_int_jump(JitCompiler* self, size_t index) {
+    const OperandsIncrementLessIntJump operands = *(const OperandsIncrementLessIntJump*)&self->bytecode[index];
+    const OperandsJump jump = *(const OperandsJump*)&self->bytecode[index + 2];
+
+    emit_load_int(&self->code, operands.src);
+    emit_increment_int(&self->code);
+    emit_overflow_check(self, index);
+    emit_store_int(&self->code, operands.src);
+    // `compareSrc2` may be the same as `src`, so it's read after storing
+    emit_compare_int(&self->code, operands.compareSrc2);
+    emit_store_condition(&self->code, CC_LESS, operands.compareDst);
+    emit_set_tag(&self->code, operands.compareDst, SLOT_TAG_BOOL);
+
+    const uint8_t test[] = {0x84, 0xC0}; // test al, al
+    emit_bytes(&self->code, test, sizeof(test));
+    emit_jump_if(self, jump.opType == JUMP_TYPE_IF_TRUE ? CC_NOT_EQUAL : CC_EQUAL, jump_target(self, index + 2));
+    emit_jump(self, index + 3);
+}
+
+/// Matches `execute_load_immediate_add_int(...)`.
+static void compile_load_immediate_add_int(JitCompiler* self, size_t index) {
+    const OperandsAddUnknown addOperands = *(const OperandsAddUnknown*)&self->bytecode[index + 1];
+    if(addOperands.canOverflow) {
+        // Same as a lone `OpCodeAddInt`
+        emit_interpreted_operation(self, index);
+        emit_jump(self, index + 2);
+        return;
+    }
+    const OperandsLoadImmediateAddInt operands = *(const OperandsLoadImmediateAddInt*)&self->bytecode[index];
+    emit_store_immediate_int(&self->code, operands.dst, (int64_t)operands.immediate);
+    emit_set_tag(&self->code, operands.dst, SLOT_TAG_INT);
+    compile_add_int(self, index + 1, index + 1);
+    emit_jump(self, index + 2);
+}
+
+/// Returns false if the operation can't be compiled.
+static bool compile_operation(JitCompiler* self, size_t index) {
+    const Bytecode bytecode = self->bytecode[index];
+    switch(cubs_bytecode_get_opcode(bytecode)) {
+        case OpCodeLoad: {
+            const OperandsLoadUnknown unknownOperands = *(const OperandsLoadUnknown*)&bytecode;
+            if(unknownOperands.loadType != LOAD_TYPE_IMMEDIATE) {
+                emit_interpreted_operation(self, index);
+                break;
+            }
+            const OperandsLoadImmediate operands = *(const OperandsLoadImmediate*)&bytecode;
+            if(operands.immediateType == LOAD_IMMEDIATE_BOOL) {
+                emit_store_immediate_bool(&self->code, operands.dst, operands.immediate != 0);
+                emit_set_tag(&self->code, operands.dst, SLOT_TAG_BOOL);
+            } else {
+                emit_store_immediate_int(&self->code, operands.dst, (int64_t)operands.immediate);
+                emit_set_tag(&self->code, operands.dst, SLOT_TAG_INT);
+            }
+        } break;
+        case OpCodeReturn: {
+            // Unwinds and pops the frame, so nothing else can access it
+            emit_execute_operation(self, index);
+            emit_jump(self, self->len);
+        } break;
+        case OpCodeCall: {
+            const OperandsCallUnknown operands = *(const OperandsCallUnknown*)&bytecode;
+            if(!operands.isTailCall) {
+                emit_interpreted_operation(self, index);
+                break;
+            }
+            // Replaces or pops the frame, same as a return. The callee executes after exiting.
+            emit_execute_operation(self, index);
+            emit_jump(self, self->len);
+        } break;
+        case OpCodeJump: {
+            compile_jump(self, index);
+        } break;
+        case OpCodeYield: {
+            return false;
+        }
+        case OpCodeIncrementInt: {
+            const OperandsIncrementUnknown operands = *(const OperandsIncrementUnknown*)&bytecode;
+            if(operands.canOverflow) {
+                emit_interpreted_operation(self, index);
+            } else {
+                compile_increment_int(self, index);
+            }
+        } break;
+        case OpCodeAddInt: {
+            const OperandsAddUnknown operands = *(const OperandsAddUnknown*)&bytecode;
+            if(operands.canOverflow) {
+                emit_interpreted_operation(self, index);
+            } else {
+                compile_add_int(self, index, index);
+            }
+        } break;
+        case OpCodeAddFloat: {
+            compile_add_float(self, index);
+        } break;
+        case OpCodeEqualInt: {
+            compile_compare_int(self, index, CC_EQUAL);
+        } break;
+        case OpCodeNotEqualInt: {
+            compile_compare_int(self, index, CC_NOT_EQUAL);
+        } break;
+        case OpCodeLessInt: {
+            compile_compare_int(self, index, CC_LESS);
+        } break;
+        case OpCodeGreaterInt: {
+            compile_compare_int(self, index, CC_GREATER);
+        } break;
+        case OpCodeLessOrEqualInt: {
+            compile_compare_int(self, index, CC_LESS_OR_EQUAL);
+        } break;
+        case OpCodeGreaterOrEqualInt: {
+            compile_compare_int(self, index, CC_GREATER_OR_EQUAL);
+        } break;
+        // Float compares match `cubs_context_fast_compare(...)`, where NaN compares as greater
+        case OpCodeLessFloat: {
+            compile_compare_float(self, index, CC_ABOVE);
+        } break;
+        case OpCodeGreaterFloat: {
+            compile_compare_float(self, index, CC_BELOW);
+        } break;
+        case OpCodeLessOrEqualFloat: {
+            compile_compare_float(self, index, CC_ABOVE_OR_EQUAL);
+        } break;
+        case OpCodeGreaterOrEqualFloat: {
+            compile_compare_float(self, index, CC_BELOW_OR_EQUAL);
+        } break;
+        case OpCodeIncrementLessIntJump: {
+            compile_increment_less_int_jump(self, index);
+        } break;
+        case OpCodeLoadImmediateAddInt: {
+            compile_load_immediate_add_int(self, index);
+        } break;
+        default: {
+            emit_interpreted_operation(self, index);
+        } break;
+    }
+    return true;
+}
+
+static void emit_prologue(CodeBuffer* self) {
+    _Static_assert(offsetof(InterpreterFramePointer, values) < 128, "Frame values must be addressable with an 8 bit displacement");
+    _Static_assert(offsetof(InterpreterFramePointer, tags) < 128, "Frame tags must be addressable with an 8 bit displacement");
+    const uint8_t prologue[] = {
+        0x55,             // push rbp
+        0x53,             // push rbx
+        0x41, 0x54,       // push r12
+        0x41, 0x55,       // push r13
+        0x41, 0x56,       // push r14, only to keep the stack 16 byte aligned for calls
+        0x49, 0x89, 0xFC, // mov r12, rdi
+        0x49, 0x89, 0xF5, // mov r13, rsi
+        0x49, 0x8B, 0x5C, 0x24, (uint8_t)offsetof(InterpreterFramePointer, values), // mov rbx, [r12 + values]
+        0x49, 0x8B, 0x6C, 0x24, (uint8_t)offsetof(InterpreterFramePointer, tags),   // mov rbp, [r12 + tags]
+    };
+    emit_bytes(self, prologue, sizeof(prologue));
+}
+
+/// Returns eax as is, which holds the error, if any.
+static void emit_epilogue(CodeBuffer* self) {
+    const uint8_t epilogue[] = {
+        0x41, 0x5E, // pop r14
+        0x41, 0x5D, // pop r13
+        0x41, 0x5C, // pop r12
+        0x5B,       // pop rbx
+        0x5D,       // pop rbp
+        0xC3,       // ret
+    };
+    emit_bytes(self, epilogue, sizeof(epilogue));
+}
+
+static void jit_compiler_deinit(JitCompiler* self) {
+    code_buffer_deinit(&self->code);
+    FREE_TYPE_ARRAY(size_t, self->offsets, self->len);
+    if(self->fixups != NULL) {
+        FREE_TYPE_ARRAY(BranchFixup, self->fixups, self->fixupsCapacity);
+    }
+}
+
+/// Returns NULL if `function` can't be compiled.
+static JitCode* compile_function(const CubsScriptFunctionPtr* function) {
+    // The templates rely on the operand types the verifier proves
+    if(cubs_function_verify(function, NULL) != cubsBytecodeVerifyErrorNone) {
+        return NULL;
+    }
+
+    const size_t len = function->_bytecodeCount;
+    JitCompiler compiler = {
+        .function = function,
+        .bytecode = cubs_function_bytecode_start(function),
+        .len = len,
+        .code = {0},
+        .offsets = MALLOC_TYPE_ARRAY(size_t, len),
+        .fixups = NULL,
+        .fixupsLen = 0,
+        .fixupsCapacity = 0,
+    };
+
+    emit_prologue(&compiler.code);
+    size_t i = 0;
+    while(i < len) {
+        compiler.offsets[i] = compiler.code.len;
+        if(!compile_operation(&compiler, i)) {
+            jit_compiler_deinit(&compiler);
+            return NULL;
+        }
+        i += operation_len(&compiler.bytecode[i]);
+    }
+    const size_t exitOffset = compiler.code.len;
+    emit_epilogue(&compiler.code);
+
+    for(size_t j = 0; j < compiler.fixupsLen; j++) {
+        const BranchFixup fixup = compiler.fixups[j];
+        // Verified, so every jump lands on an operation, which has it's offset set
+        const size_t targetOffset = fixup.target == len ? exitOffset : compiler.offsets[fixup.target];
+        const int64_t displacement = (int64_t)targetOffset - (int64_t)(fixup.dispOffset + 4);
+        patch_u32(&compiler.code, fixup.dispOffset, (uint32_t)(int32_t)displacement);
+    }
+
+    // Never writable and executable at the same time
+    void* pages = _cubs_os_malloc_pages(compiler.code.len);
+    if(pages == NULL) {
+        jit_compiler_deinit(&compiler);
+        return NULL;
+    }
+    memcpy(pages, (const void*)compiler.code.bytes, compiler.code.len);
+    if(!_cubs_os_protect_pages_executable(pages, compiler.code.len)) {
+        _cubs_os_free_pages(pages, compiler.code.len);
+        jit_compiler_deinit(&compiler);
+        return NULL;
+    }
+
+    JitCode* code = MALLOC_TYPE(JitCode);
+    const JitCode codeData = {.pages = pages, .len = compiler.code.len, .next = NULL};
+    *code = codeData;
+    jit_compiler_deinit(&compiler);
+    return code;
+}
+
+#pragma endregion
+
+bool cubs_jit_compile(const CubsScriptFunctionPtr* function)
+{
+    // The call count and compiled code are the only parts of a function written to after it's built
+    CubsScriptFunctionPtr* mutFunction = (CubsScriptFunctionPtr*)function;
+    ProgramInner* inner = (ProgramInner*)function->program->_inner;
+
+    cubs_mutex_lock(&inner->jitMutex);
+    // Whether or not it compiles, calls no longer need to be counted
+    cubs_atomic_store_64(&mutFunction->_jitCallsUntilCompile, 0);
+    bool compiled = cubs_atomic_load_64(&function->_jitCode) != 0;
+    if(!compiled) {
+        JitCode* code = compile_function(function);
+        if(code != NULL) {
+            code->next = inner->jitCode;
+            inner->jitCode = code;
+            cubs_atomic_store_64(&mutFunction->_jitCode, (uintptr_t)code->pages);
+            compiled = true;
+        }
+    }
+    cubs_mutex_unlock(&inner->jitMutex);
+    return compiled;
+}
+
+void _cubs_jit_code_free(JitCode* code)
+{
+    _cubs_os_free_pages(code->pages, code->len);
+    FREE_TYPE(JitCode, code);
+}
+
+#else // CUBS_JIT_ENABLED
+
+bool cubs_jit_compile(const CubsScriptFunctionPtr* function)
+{
+    (void)function;
+    return false;
+}
+
+void _cubs_jit_code_free(JitCode* code)
+{
+    (void)code;
+    unreachable();
+}
+
+#endif // CUBS_JIT_ENABLED
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "../platform/architecture.h"
+#include "../program/program_runtime_error.h"
+#include "bytecode.h"
+
+struct CubsProgram;
+struct CubsScriptFunctionPtr;
+
+/*
+Baseline JIT. Once a script function has been called `CubsProgramInitParams.jitCallThreshold` times,
+it's bytecode is translated to machine code one operation at a time, using a fixed template per opcode.
+Int and float math, the type specialized compares, jumps, and the superinstructions are inlined. All other
+operations call back into the interpreter's implementation of them, so there is only one implementation
+of anything complex, and the interpreter remains the reference that the JIT is tested against.
+
+Only functions that pass `cubs_function_verify(...)` are compiled, as the templates rely on the types the
+verifier proves, rather than checking them. Functions that yield are never compiled, as compiled code
+can't suspend. The machine code is written to pages that are made executable, and no longer writable,
+before any of it runs.
+
+Compiled functions only run when there is no execution budget, so budgeted executions and coroutines
+are always interpreted. Calls between compiled functions recurse on the native stack, up to
+`CUBS_JIT_MAX_NATIVE_DEPTH` calls deep, past which functions are interpreted, as the interpreter
+doesn't recurse for script calls. Tail calls exit the compiled code first, so they never recurse.
+
+Supported on x86-64 Linux. Can be compiled out by defining `CUBS_INTERPRETER_NO_JIT`. The profiler
+counts every interpreted operation, so the JIT is also compiled out with `CUBS_INTERPRETER_PROFILE`.
+*/
+
+#if CUBS_ARCH_X86_64 && defined(__linux__) && !defined(CUBS_INTERPRETER_NO_JIT) && !defined(CUBS_INTERPRETER_PROFILE)
+#define CUBS_JIT_ENABLED 1
+#else
+#define CUBS_JIT_ENABLED 0
+#endif
+
+#ifndef CUBS_JIT_MAX_NATIVE_DEPTH
+/// How many compiled functions may be executing on a thread's native stack at once.
+#define CUBS_JIT_MAX_NATIVE_DEPTH 256
+#endif
+
+struct InterpreterFramePointer;
+
+/// Signature of compiled functions. Executes the function in the already pushed frame `frame`,
+/// popping it when returning. If an error occurs, the frame is left pushed.
+typedef CubsProgramRuntimeError (*CubsJitFunction)(const struct InterpreterFramePointer* frame, const struct CubsProgram* program);
+
+/// Executes the single operation at `bytecode` in `frame`, for compiled code to call for the
+/// operations it doesn't inline. Returns are executed as `OpCodeReturn`, popping the frame.
+typedef CubsProgramRuntimeError (*CubsJitOperation)(const struct CubsProgram* program, const struct InterpreterFramePointer* frame, const struct Bytecode* bytecode);
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Compiles `function` to machine code, regardless of how many times it's been called.
+/// Returns true if it's compiled, or already was. Returns false if the JIT isn't supported,
+/// or the function can't be compiled, in which case it continues to be interpreted.
+bool cubs_jit_compile(const struct CubsScriptFunctionPtr* function);
+
+/// Returns the interpreter's implementation of the operation at `bytecode`, which compiled code calls
+/// directly, rather than going through one shared branch on the opcode. Never jumps or yields. Tail calls
+/// leave the callee to execute after the compiled code exits. Defined in `interpreter.c`.
+CubsJitOperation _cubs_jit_operation(const struct Bytecode* bytecode);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
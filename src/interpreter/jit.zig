@@ -0,0 +1,238 @@
+const std = @import("std");
+const expect = std.testing.expect;
+const CubsFunction = @import("../primitives/function/function.zig").CubsFunction;
+const TypeContext = @import("../primitives/script_value.zig").TypeContext;
+
+const c = @cImport({
+    @cInclude("interpreter/jit.h");
+    @cInclude("interpreter/function_definition.h");
+    @cInclude("interpreter/bytecode.h");
+    @cInclude("interpreter/operations.h");
+    @cInclude("primitives/context.h");
+    @cInclude("program/program.h");
+    @cInclude("program/program_internal.h");
+});
+
+/// Builds `fn(n: int) int` with `stackSpaceRequired` stack slots from `bytecode`.
+fn build(program: *c.CubsProgram, stackSpaceRequired: usize, bytecode: []const c.Bytecode) *const c.CubsScriptFunctionPtr {
+    var builder = c.FunctionBuilder{ .stackSpaceRequired = stackSpaceRequired, .optReturnType = &c.CUBS_INT_CONTEXT };
+    defer c.cubs_function_builder_deinit(&builder);
+    c.cubs_function_builder_add_arg(&builder, &c.CUBS_INT_CONTEXT);
+    c.cubs_function_builder_push_bytecode_many(&builder, bytecode.ptr, bytecode.len);
+    return c.cubs_function_builder_build(&builder, program);
+}
+
+const CallResult = struct {
+    err: c_int,
+    value: i64,
+};
+
+fn call(func: *const c.CubsScriptFunctionPtr, n: i64) CallResult {
+    const f = CubsFunction{ .func = .{ .script = @ptrCast(func) }, .funcType = .Script };
+    var args = CubsFunction.cubs_function_start_call(&f);
+    var arg = n;
+    args.cubs_function_push_arg(@ptrCast(&arg), TypeContext.auto(i64));
+
+    var value: i64 = 0;
+    var context: ?*const TypeContext = null;
+    const err = args.cubs_function_call(.{ .value = @ptrCast(&value), .context = @ptrCast(&context) });
+    return .{ .err = err, .value = value };
+}
+
+/// Calls `func` interpreted, then compiled, expecting the same result from both.
+fn expectSameCompiled(func: *const c.CubsScriptFunctionPtr, n: i64) !CallResult {
+    const interpreted = call(func, n);
+    try expect(c.cubs_jit_compile(func));
+    const compiled = call(func, n);
+    try expect(interpreted.err == compiled.err);
+    if (interpreted.err == 0) {
+        try expect(interpreted.value == compiled.value);
+    }
+    return compiled;
+}
+
+test "loop" {
+    if (c.CUBS_JIT_ENABLED == 0) return error.SkipZigTest;
+
+    var program = c.cubs_program_init(.{});
+    defer c.cubs_program_deinit(&program);
+
+    // mut i = 0; mut acc = 0; do { acc += i; i += 1; } while(i < n); return acc;
+    for ([_]?*const c.CubsTypeContext{ null, &c.CUBS_INT_CONTEXT }) |specializeContext| {
+        const func = build(&program, 5, &[_]c.Bytecode{
+            c.operands_make_load_immediate(c.LOAD_IMMEDIATE_INT, 1, 0),
+            c.operands_make_load_immediate(c.LOAD_IMMEDIATE_INT, 2, 0),
+            c.cubs_operands_specialize(c.operands_make_add_assign(false, 2, 1), specializeContext),
+            c.cubs_operands_specialize(c.operands_make_increment_assign(false, 1), specializeContext),
+            c.cubs_operands_specialize(c.cubs_operands_make_compare(c.COMPARE_OP_LESS, 3, 1, 0), specializeContext),
+            c.cubs_operands_make_jump(c.JUMP_TYPE_IF_TRUE, -3, 3),
+            c.operands_make_return(true, 2),
+        });
+        const result = try expectSameCompiled(func, 1000);
+        try expect(result.value == 499500);
+        try expect(call(func, 1).value == 0);
+    }
+}
+
+test "fused loop" {
+    if (c.CUBS_JIT_ENABLED == 0) return error.SkipZigTest;
+
+    var program = c.cubs_program_init(.{});
+    defer c.cubs_program_deinit(&program);
+
+    // Pushed one at a time, so the builder fuses the increment, compare, and jump
+    var builder = c.FunctionBuilder{ .stackSpaceRequired = 5, .optReturnType = &c.CUBS_INT_CONTEXT };
+    defer c.cubs_function_builder_deinit(&builder);
+    c.cubs_function_builder_add_arg(&builder, &c.CUBS_INT_CONTEXT);
+    c.cubs_function_builder_push_bytecode(&builder, c.operands_make_load_immediate(c.LOAD_IMMEDIATE_INT, 1, 0));
+    c.cubs_function_builder_push_bytecode(&builder, c.operands_make_load_immediate(c.LOAD_IMMEDIATE_INT, 2, 0));
+    c.cubs_function_builder_push_bytecode(&builder, c.operands_make_load_immediate(c.LOAD_IMMEDIATE_INT, 4, 3));
+    c.cubs_function_builder_push_bytecode(&builder, c.cubs_operands_specialize(c.operands_make_add_assign(false, 2, 4), &c.CUBS_INT_CONTEXT));
+    c.cubs_function_builder_push_bytecode(&builder, c.cubs_operands_specialize(c.operands_make_increment_assign(false, 1), &c.CUBS_INT_CONTEXT));
+    c.cubs_function_builder_push_bytecode(&builder, c.cubs_operands_specialize(c.cubs_operands_make_compare(c.COMPARE_OP_LESS, 3, 1, 0), &c.CUBS_INT_CONTEXT));
+    c.cubs_function_builder_push_bytecode(&builder, c.cubs_operands_make_jump(c.JUMP_TYPE_IF_TRUE, -4, 3));
+    c.cubs_function_builder_push_bytecode(&builder, c.operands_make_return(true, 2));
+    const func = c.cubs_function_builder_build(&builder, &program);
+
+    const bytecode = c.cubs_function_bytecode_start(func);
+    try expect(c.cubs_bytecode_get_opcode(bytecode[3]) == c.OpCodeLoadImmediateAddInt);
+    try expect(c.cubs_bytecode_get_opcode(bytecode[5]) == c.OpCodeIncrementLessIntJump);
+
+    const result = try expectSameCompiled(func, 100);
+    try expect(result.value == 300);
+}
+
+test "overflow" {
+    if (c.CUBS_JIT_ENABLED == 0) return error.SkipZigTest;
+
+    var program = c.cubs_program_init(.{});
+    defer c.cubs_program_deinit(&program);
+
+    const func = build(&program, 3, &[_]c.Bytecode{
+        c.operands_make_load_immediate(c.LOAD_IMMEDIATE_INT, 1, 1),
+        c.cubs_operands_specialize(c.operands_make_add_dst(false, 2, 0, 1), &c.CUBS_INT_CONTEXT),
+        c.operands_make_return(true, 2),
+    });
+    const result = try expectSameCompiled(func, std.math.maxInt(i64));
+    try expect(result.err == c.cubsProgramRuntimeErrorAdditionIntegerOverflow);
+    try expect(call(func, 1).value == 2);
+}
+
+test "float compare with NaN" {
+    if (c.CUBS_JIT_ENABLED == 0) return error.SkipZigTest;
+
+    var program = c.cubs_program_init(.{});
+    defer c.cubs_program_deinit(&program);
+
+    const values = [_]f64{ -1.5, 2.0, std.math.nan(f64) };
+    const compares = [_]c_int{ c.COMPARE_OP_LESS, c.COMPARE_OP_GREATER, c.COMPARE_OP_LESS_OR_EQUAL, c.COMPARE_OP_GREATER_OR_EQUAL };
+    for (values) |a| {
+        for (values) |b| {
+            for (compares) |compare| {
+                var loadA: [2]c.Bytecode = undefined;
+                var loadB: [2]c.Bytecode = undefined;
+                c.operands_make_load_immediate_long(&loadA, c.cubsValueTagFloat, 1, @bitCast(a));
+                c.operands_make_load_immediate_long(&loadB, c.cubsValueTagFloat, 2, @bitCast(b));
+                // return if(a compare b) 1 else 0
+                const func = build(&program, 5, &[_]c.Bytecode{
+                    loadA[0],
+                    loadA[1],
+                    loadB[0],
+                    loadB[1],
+                    c.cubs_operands_specialize(c.cubs_operands_make_compare(@intCast(compare), 3, 1, 2), &c.CUBS_FLOAT_CONTEXT),
+                    c.operands_make_load_immediate(c.LOAD_IMMEDIATE_INT, 4, 0),
+                    c.cubs_operands_make_jump(c.JUMP_TYPE_IF_FALSE, 2, 3),
+                    c.operands_make_load_immediate(c.LOAD_IMMEDIATE_INT, 4, 1),
+                    c.operands_make_return(true, 4),
+                });
+                _ = try expectSameCompiled(func, 0);
+            }
+        }
+    }
+}
+
+test "compile after call threshold" {
+    if (c.CUBS_JIT_ENABLED == 0) return error.SkipZigTest;
+
+    var program = c.cubs_program_init(.{ .jitCallThreshold = 2 });
+    defer c.cubs_program_deinit(&program);
+
+    const func = build(&program, 3, &[_]c.Bytecode{
+        c.operands_make_load_immediate(c.LOAD_IMMEDIATE_INT, 1, 1),
+        c.cubs_operands_specialize(c.operands_make_add_dst(false, 2, 0, 1), &c.CUBS_INT_CONTEXT),
+        c.operands_make_return(true, 2),
+    });
+    try expect(call(func, 1).value == 2);
+    try expect(func._jitCode == null);
+    try expect(call(func, 2).value == 3);
+    try expect(func._jitCode != null);
+    try expect(call(func, 3).value == 4);
+}
+
+test "recursive calls past native depth" {
+    if (c.CUBS_JIT_ENABLED == 0) return error.SkipZigTest;
+
+    var program = c.cubs_program_init(.{ .jitCallThreshold = 1 });
+    defer c.cubs_program_deinit(&program);
+
+    // fn count(n: int) int { if(n < 1) { return 0; } return count(n + -1) + 1; }
+    const args = [_]u16{3};
+    var callBytecode: [3]c.Bytecode = undefined;
+    const placeholder = build(&program, 1, &[_]c.Bytecode{c.operands_make_return(true, 0)});
+    c.cubs_operands_make_call_immediate(&callBytecode, 3, 1, &args, true, 4, .{ .func = .{ .script = placeholder }, .funcType = c.cubsFunctionPtrTypeScript });
+    const func = build(&program, 5, &[_]c.Bytecode{
+        c.operands_make_load_immediate(c.LOAD_IMMEDIATE_INT, 1, 1),
+        c.cubs_operands_specialize(c.cubs_operands_make_compare(c.COMPARE_OP_LESS, 2, 0, 1), &c.CUBS_INT_CONTEXT),
+        c.cubs_operands_make_jump(c.JUMP_TYPE_IF_FALSE, 3, 2),
+        c.operands_make_load_immediate(c.LOAD_IMMEDIATE_INT, 3, 0),
+        c.operands_make_return(true, 3),
+        c.operands_make_load_immediate(c.LOAD_IMMEDIATE_INT, 1, -1),
+        c.cubs_operands_specialize(c.operands_make_add_dst(false, 3, 0, 1), &c.CUBS_INT_CONTEXT),
+        callBytecode[0],
+        callBytecode[1],
+        callBytecode[2],
+        c.cubs_operands_specialize(c.operands_make_increment_assign(false, 4), &c.CUBS_INT_CONTEXT),
+        c.operands_make_return(true, 4),
+    });
+    // Recursive calls can only be set after the function is built
+    const bytecode: [*]c.Bytecode = @constCast(c.cubs_function_bytecode_start(func));
+    c.cubs_operands_make_call_immediate(&bytecode[7], 3, 1, &args, true, 4, .{ .func = .{ .script = func }, .funcType = c.cubsFunctionPtrTypeScript });
+
+    const result = call(func, c.CUBS_JIT_MAX_NATIVE_DEPTH * 4);
+    try expect(result.err == 0);
+    try expect(result.value == c.CUBS_JIT_MAX_NATIVE_DEPTH * 4);
+    try expect(func._jitCode != null);
+}
+
+test "compiled tail recursion" {
+    if (c.CUBS_JIT_ENABLED == 0) return error.SkipZigTest;
+
+    var program = c.cubs_program_init(.{});
+    defer c.cubs_program_deinit(&program);
+
+    // fn count(n: int) int { if(n < 1) { return n; } return count(n + -1); }
+    const args = [_]u16{3};
+    var callBytecode: [3]c.Bytecode = undefined;
+    const placeholder = build(&program, 1, &[_]c.Bytecode{c.operands_make_return(true, 0)});
+    c.cubs_operands_make_call_immediate(&callBytecode, 3, 1, &args, true, 4, .{ .func = .{ .script = placeholder }, .funcType = c.cubsFunctionPtrTypeScript });
+    const func = build(&program, 5, &[_]c.Bytecode{
+        c.operands_make_load_immediate(c.LOAD_IMMEDIATE_INT, 1, 1),
+        c.cubs_operands_specialize(c.cubs_operands_make_compare(c.COMPARE_OP_LESS, 2, 0, 1), &c.CUBS_INT_CONTEXT),
+        c.cubs_operands_make_jump(c.JUMP_TYPE_IF_FALSE, 2, 2),
+        c.operands_make_return(true, 0),
+        c.operands_make_load_immediate(c.LOAD_IMMEDIATE_INT, 1, -1),
+        c.cubs_operands_specialize(c.operands_make_add_dst(false, 3, 0, 1), &c.CUBS_INT_CONTEXT),
+        callBytecode[0],
+        callBytecode[1],
+        callBytecode[2],
+        c.operands_make_return(true, 4),
+    });
+    const bytecode: [*]c.Bytecode = @constCast(c.cubs_function_bytecode_start(func));
+    bytecode[7].value = @intFromPtr(func);
+
+    // Each tail call exits the compiled code before the next executes, so the native stack doesn't
+    // grow, and compiled code keeps executing past the native depth limit.
+    const result = try expectSameCompiled(func, c.CUBS_JIT_MAX_NATIVE_DEPTH * 1000);
+    try expect(result.err == 0);
+    try expect(result.value == 0);
+}
@@ -1,4 +1,5 @@
 #include "operations.h"
+#include "../primitives/context.h"
 
 #define BYTECODE_ALIGN _Alignas(_Alignof(Bytecode))
 
@@ -47,6 +48,15 @@ Bytecode operands_make_return(bool hasReturn, uint16_t returnSrc)
     return *(const Bytecode*)&ret;
 }
 
+Bytecode operands_make_yield(bool hasValue, uint16_t src)
+{
+    if(hasValue) {
+        assert(src <= MAX_FRAME_LENGTH);
+    }
+    BYTECODE_ALIGN const OperandsYield operands = {.reserveOpcode = OpCodeYield, .hasValue = hasValue, .src = src};
+    return *(const Bytecode*)&operands;
+}
+
 #include <stdio.h>
 
 void cubs_operands_make_call_immediate(Bytecode *bytecodeArr, size_t availableBytecode, uint16_t argCount, const uint16_t *args, bool hasReturn, uint16_t returnSrc, CubsFunction func)
@@ -97,8 +107,8 @@ void cubs_operands_make_call_src(Bytecode *bytecodeArr, size_t availableBytecode
             assert(args[i] <= MAX_FRAME_LENGTH);
         }
 
-        /// Initial bytecode
-        size_t requiredBytecode = 1;
+        /// Initial bytecode + inline cache
+        size_t requiredBytecode = 1 + 1;
         if((argCount % 4) == 0) {
             requiredBytecode += (argCount / 4);
         } else {
@@ -109,7 +119,7 @@ void cubs_operands_make_call_src(Bytecode *bytecodeArr, size_t availableBytecode
 
     BYTECODE_ALIGN const OperandsCallSrc operands = {
         .reserveOpcode = OpCodeCall, 
-        .opType = CALL_TYPE_IMMEDIATE, 
+        .opType = CALL_TYPE_SRC, 
         .argCount = argCount,
         .hasReturn = hasReturn,
         .returnDst = returnSrc,
@@ -117,12 +127,33 @@ void cubs_operands_make_call_src(Bytecode *bytecodeArr, size_t availableBytecode
     };
 
     bytecodeArr[0] = *(const Bytecode*)&operands;
-    uint16_t* bytecodeArgs = (uint16_t*)&bytecodeArr[1];
+    bytecodeArr[1].value = 0; // empty inline cache
+    uint16_t* bytecodeArgs = (uint16_t*)&bytecodeArr[2];
     for(uint16_t i = 0; i < argCount; i++) {
         bytecodeArgs[i] = args[i];
     }
 }
 
+void cubs_operands_make_tail_call(Bytecode *callBytecode)
+{
+    assert(cubs_bytecode_get_opcode(*callBytecode) == OpCodeCall);
+    // Through the full operands of the call type, so the bits following the common ones are kept
+    const OperandsCallUnknown unknownOperands = *(const OperandsCallUnknown*)callBytecode;
+    if(unknownOperands.opType == CALL_TYPE_IMMEDIATE) {
+        OperandsCallImmediate operands = *(const OperandsCallImmediate*)callBytecode;
+        operands.hasReturn = false;
+        operands.returnDst = 0;
+        operands.isTailCall = true;
+        *(OperandsCallImmediate*)callBytecode = operands;
+    } else {
+        OperandsCallSrc operands = *(const OperandsCallSrc*)callBytecode;
+        operands.hasReturn = false;
+        operands.returnDst = 0;
+        operands.isTailCall = true;
+        *(OperandsCallSrc*)callBytecode = operands;
+    }
+}
+
 Bytecode cubs_operands_make_jump(enum JumpType jumpType, int32_t jumpAmount, uint16_t jumpSrc)
 {
     assert(jumpSrc <= MAX_FRAME_LENGTH);
@@ -335,7 +366,7 @@ Bytecode operands_make_increment_dst(bool canOverflow, uint16_t dst, uint16_t sr
     assert(dst <= MAX_FRAME_LENGTH);
     assert(src <= MAX_FRAME_LENGTH);
 
-    BYTECODE_ALIGN const OperandsIncrementDst operands = {.reserveOpcode = OpCodeAdd, .opType = MATH_TYPE_DST, .canOverflow = canOverflow, .dst = dst, .src = src};    
+    BYTECODE_ALIGN const OperandsIncrementDst operands = {.reserveOpcode = OpCodeIncrement, .opType = MATH_TYPE_DST, .canOverflow = canOverflow, .dst = dst, .src = src};    
     const Bytecode b = *(const Bytecode*)&operands;
     return b;
 }
@@ -344,7 +375,7 @@ Bytecode operands_make_increment_assign(bool canOverflow, uint16_t src)
 {
     assert(src <= MAX_FRAME_LENGTH);    
     
-    BYTECODE_ALIGN const OperandsIncrementAssign operands = {.reserveOpcode = OpCodeAdd, .opType = MATH_TYPE_DST, .canOverflow = canOverflow, .src = src};    
+    BYTECODE_ALIGN const OperandsIncrementAssign operands = {.reserveOpcode = OpCodeIncrement, .opType = MATH_TYPE_SRC_ASSIGN, .canOverflow = canOverflow, .src = src};    
     const Bytecode b = *(const Bytecode*)&operands;
     return b;
 }
@@ -369,3 +400,90 @@ Bytecode operands_make_add_assign(bool canOverflow, uint16_t src1, uint16_t src2
     const Bytecode b = *(const Bytecode*)&operands;
     return b;
 }
+
+Bytecode cubs_operands_specialize(Bytecode bytecode, const CubsTypeContext *context)
+{
+    const OpCode opcode = cubs_bytecode_get_opcode(bytecode);
+    OpCode specialized = opcode;
+    if(context == &CUBS_INT_CONTEXT) {
+        switch(opcode) {
+            case OpCodeIncrement: specialized = OpCodeIncrementInt; break;
+            case OpCodeAdd: specialized = OpCodeAddInt; break;
+            case OpCodeEqual: specialized = OpCodeEqualInt; break;
+            case OpCodeNotEqual: specialized = OpCodeNotEqualInt; break;
+            case OpCodeLess: specialized = OpCodeLessInt; break;
+            case OpCodeGreater: specialized = OpCodeGreaterInt; break;
+            case OpCodeLessOrEqual: specialized = OpCodeLessOrEqualInt; break;
+            case OpCodeGreaterOrEqual: specialized = OpCodeGreaterOrEqualInt; break;
+            default: break;
+        }
+    } else if(context == &CUBS_FLOAT_CONTEXT) {
+        switch(opcode) {
+            case OpCodeAdd: specialized = OpCodeAddFloat; break;
+            case OpCodeLess: specialized = OpCodeLessFloat; break;
+            case OpCodeGreater: specialized = OpCodeGreaterFloat; break;
+            case OpCodeLessOrEqual: specialized = OpCodeLessOrEqualFloat; break;
+            case OpCodeGreaterOrEqual: specialized = OpCodeGreaterOrEqualFloat; break;
+            default: break;
+        }
+    }
+
+    const Bytecode b = {.value = (bytecode.value & ~((uint64_t)OPCODE_USED_BITMASK)) | (uint64_t)specialized};
+    return b;
+}
+
+bool cubs_operands_try_fuse(const Bytecode *bytecode, size_t len, Bytecode *outFused, size_t *outFusedIndex)
+{
+    if(len >= 3) { // increment + less + jump
+        const Bytecode incrementBytecode = bytecode[len - 3];
+        const Bytecode lessBytecode = bytecode[len - 2];
+        const Bytecode jumpBytecode = bytecode[len - 1];
+        if(cubs_bytecode_get_opcode(incrementBytecode) == OpCodeIncrementInt
+            && cubs_bytecode_get_opcode(lessBytecode) == OpCodeLessInt
+            && cubs_bytecode_get_opcode(jumpBytecode) == OpCodeJump
+        ) {
+            const OperandsIncrementUnknown increment = *(const OperandsIncrementUnknown*)&incrementBytecode;
+            const OperandsLess less = *(const OperandsLess*)&lessBytecode;
+            const OperandsJump jump = *(const OperandsJump*)&jumpBytecode;
+            if(increment.opType == MATH_TYPE_SRC_ASSIGN 
+                && !increment.canOverflow 
+                && less.src1 == increment.src
+                && jump.opType != JUMP_TYPE_DEFAULT
+                && jump.optSrc == less.dst
+            ) {
+                BYTECODE_ALIGN const OperandsIncrementLessIntJump operands = {
+                    .reserveOpcode = OpCodeIncrementLessIntJump, 
+                    .src = increment.src, 
+                    .compareSrc2 = less.src2,
+                    .compareDst = less.dst,
+                };
+                *outFused = *(const Bytecode*)&operands;
+                *outFusedIndex = len - 3;
+                return true;
+            }
+        }
+    }
+    if(len >= 2) { // load immediate + add
+        const Bytecode loadBytecode = bytecode[len - 2];
+        const Bytecode addBytecode = bytecode[len - 1];
+        if(cubs_bytecode_get_opcode(loadBytecode) == OpCodeLoad
+            && cubs_bytecode_get_opcode(addBytecode) == OpCodeAddInt
+        ) {
+            const OperandsLoadUnknown load = *(const OperandsLoadUnknown*)&loadBytecode;
+            const OperandsLoadImmediate loadImmediate = *(const OperandsLoadImmediate*)&loadBytecode;
+            const OperandsAddUnknown add = *(const OperandsAddUnknown*)&addBytecode;
+            if(load.loadType == LOAD_TYPE_IMMEDIATE
+                && loadImmediate.immediateType == LOAD_IMMEDIATE_INT
+                && !add.canOverflow
+                && (add.src1 == loadImmediate.dst || add.src2 == loadImmediate.dst)
+            ) {
+                BYTECODE_ALIGN OperandsLoadImmediateAddInt operands = loadImmediate;
+                operands.reserveOpcode = OpCodeLoadImmediateAddInt;
+                *outFused = *(const Bytecode*)&operands;
+                *outFusedIndex = len - 2;
+                return true;
+            }
+        }
+    }
+    return false;
+}
@@ -77,6 +77,19 @@ Bytecode operands_make_return(bool hasReturn, uint16_t returnSrc);
 
 #pragma endregion Return
 
+#pragma region Yield
+
+typedef struct {
+    uint64_t reserveOpcode: OPCODE_USED_BITS;
+    uint64_t hasValue: 1;
+    uint64_t src: BITS_PER_STACK_OPERAND;
+} OperandsYield;
+VALIDATE_SIZE_ALIGN_OPERANDS(OperandsYield);
+/// If `hasValue == false`, `src` is ignored.
+Bytecode operands_make_yield(bool hasValue, uint16_t src);
+
+#pragma endregion Yield
+
 #pragma region Call
 
 enum CallType {
@@ -92,6 +105,8 @@ typedef struct {
     uint64_t argCount: BITS_PER_STACK_OPERAND;
     /// Boolean flag
     uint64_t hasReturn: 1;
+    /// Boolean flag. See `cubs_operands_make_tail_call(...)`.
+    uint64_t isTailCall: 1;
     uint64_t returnDst: BITS_PER_STACK_OPERAND;
 } OperandsCallUnknown;
 VALIDATE_SIZE_ALIGN_OPERANDS(OperandsCallUnknown);
@@ -102,6 +117,8 @@ typedef struct {
     uint64_t argCount: BITS_PER_STACK_OPERAND;
     /// Boolean flag
     uint64_t hasReturn: 1;
+    /// Boolean flag. See `cubs_operands_make_tail_call(...)`.
+    uint64_t isTailCall: 1;
     uint64_t returnDst: BITS_PER_STACK_OPERAND;
     uint64_t funcType: _CUBS_FUNCTION_PTR_TYPE_USED_BITS;
 } OperandsCallImmediate;
@@ -116,14 +133,33 @@ typedef struct {
     uint64_t argCount: BITS_PER_STACK_OPERAND;
     /// Boolean flag
     uint64_t hasReturn: 1;
+    /// Boolean flag. See `cubs_operands_make_tail_call(...)`.
+    uint64_t isTailCall: 1;
     uint64_t returnDst: BITS_PER_STACK_OPERAND;
     uint64_t funcSrc: BITS_PER_STACK_OPERAND;
 } OperandsCallSrc;
 VALIDATE_SIZE_ALIGN_OPERANDS(OperandsCallSrc);
 
+/// Set in the low bit of a `CALL_TYPE_SRC` inline cache holding a script function.
+/// Script functions are at least 8 byte aligned, so the bit is otherwise always 0.
+#define CALL_INLINE_CACHE_SCRIPT_TAG ((uintptr_t)1)
+
 /// If hasReturn == false, returnSrc is ignored.
+/// Has the same layout as `cubs_operands_make_call_immediate(...)`, but the second bytecode is
+/// a monomorphic inline cache rather than the function. The interpreter stores the last script
+/// function called through it there, so repeated calls to the same one skip checking the
+/// function type. It's the only bytecode written to during execution. The cached function is
+/// tagged with `CALL_INLINE_CACHE_SCRIPT_TAG`, so it can't match a C function at the same address.
 void cubs_operands_make_call_src(Bytecode* bytecodeArr, size_t availableBytecode, uint16_t argCount, const uint16_t* args, bool hasReturn, uint16_t returnSrc, uint16_t funcSrc);
 
+/// Makes the call of either type at `callBytecode` a tail call, which returns whatever the callee
+/// returns from the calling function, as a call followed by returning it's result would. The caller's
+/// stack frame is unwound and replaced by the callee's, with the arguments moved into it, so recursion
+/// through tail calls executes in constant interpreter stack space. The callee must return the same
+/// type as the calling function, and can't take references to the caller's stack slots, as they no
+/// longer exist once it executes. Execution doesn't continue past a tail call.
+void cubs_operands_make_tail_call(Bytecode* callBytecode);
+
 #pragma endregion
 
 #pragma region Jump
@@ -401,4 +437,40 @@ typedef struct {
     uint64_t src2: BITS_PER_STACK_OPERAND;
 } OperandsAddAssign;
 VALIDATE_SIZE_ALIGN_OPERANDS(OperandsAddAssign);
-Bytecode operands_make_add_assign(bool canOverflow, uint16_t src1, uint16_t src2);
\ No newline at end of file
+Bytecode operands_make_add_assign(bool canOverflow, uint16_t src1, uint16_t src2);
+#pragma endregion Add
+
+#pragma region Superinstructions
+
+typedef struct {
+    uint64_t reserveOpcode: OPCODE_USED_BITS;
+    /// The int to increment, and the left hand side of the less than compare
+    uint64_t src: BITS_PER_STACK_OPERAND;
+    /// The right hand side of the less than compare
+    uint64_t compareSrc2: BITS_PER_STACK_OPERAND;
+    /// Where the bool compare result is stored, and the jump condition
+    uint64_t compareDst: BITS_PER_STACK_OPERAND;
+} OperandsIncrementLessIntJump;
+VALIDATE_SIZE_ALIGN_OPERANDS(OperandsIncrementLessIntJump);
+
+/// Same layout as `OperandsLoadImmediate` with `LOAD_IMMEDIATE_INT`, so the
+/// load's operands can be reused as is.
+typedef OperandsLoadImmediate OperandsLoadImmediateAddInt;
+
+/// Checks if the trailing bytecodes of `bytecode`, ending at `bytecode[len - 1]`, form a
+/// sequence that can be fused into a superinstruction. If so, returns true, writing the
+/// superinstruction to `outFused`, and the index of the bytecode it should replace to
+/// `outFusedIndex`. All `len` bytecodes must be single bytecode operations.
+bool cubs_operands_try_fuse(const Bytecode* bytecode, size_t len, Bytecode* outFused, size_t* outFusedIndex);
+
+#pragma endregion
+
+#pragma region Specialize
+
+/// Converts a generic increment, add, or compare bytecode into it's type specialized
+/// counterpart for sources of type `context`, for example `OpCodeAdd` into `OpCodeAddInt`.
+/// The operands are unchanged. If no specialized operation exists, returns `bytecode` as is.
+/// It is up to the caller to guarantee that the sources will always be of type `context`.
+Bytecode cubs_operands_specialize(Bytecode bytecode, const CubsTypeContext* context);
+
+#pragma endregion
@@ -0,0 +1,480 @@
+#include "profiler.h"
+#include "../program/function_call_args.h"
+#include "../platform/architecture.h"
+#include "../platform/mem.h"
+#include "../platform/clock.h"
+#include <assert.h>
+#include <string.h>
+#include <stdio.h>
+
+#if CUBS_ARCH_X86_64
+#if _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#endif
+
+uint64_t cubs_profiler_ticks()
+{
+    #if CUBS_ARCH_X86_64
+    return (uint64_t)__rdtsc();
+    #else
+    return _cubs_os_monotonic_ns();
+    #endif
+}
+
+#ifdef CUBS_INTERPRETER_PROFILE
+
+#define OPCODE_SLOTS (1 << OPCODE_USED_BITS)
+#define ROOT_NODE 0
+
+/// A node per distinct call stack. Children are kept as a linked list, as most
+/// functions only call a few others.
+typedef struct CallTreeNode {
+    /// NULL for the root node.
+    const CubsScriptFunctionPtr* function;
+    uint32_t parent;
+    uint32_t firstChild;
+    uint32_t nextSibling;
+    uint32_t functionIndex;
+    uint64_t exclusiveTicks;
+} CallTreeNode;
+
+typedef struct FunctionRecord {
+    CubsProfilerFunctionStats stats;
+    /// How many calls of this function are currently executing. Inclusive ticks are
+    /// only added by the outermost one.
+    size_t activeCalls;
+} FunctionRecord;
+
+typedef struct ActiveCall {
+    uint32_t node;
+    /// If true, this call was entered from outside the dispatch loop, and `pausedOpcode`
+    /// is the operation that was executing in the loop below it, if there was one.
+    bool isDispatch;
+    bool hasPausedOpcode;
+    OpCode pausedOpcode;
+    uint64_t start;
+    /// When the call last started or resumed executing. Only differs from `start` for the outermost
+    /// call of a resumed execution, which only adds the ticks since then to it's caller's `childTicks`.
+    uint64_t sliceStart;
+    /// Inclusive ticks of the script functions this call called.
+    uint64_t childTicks;
+} ActiveCall;
+
+/// The calls of a suspended execution, moved off of the call stack, so executions can suspend and
+/// resume in any order. Nodes are found again on resume, under whatever call resumed it.
+typedef struct SuspendedCall {
+    const CubsScriptFunctionPtr* function;
+    uint64_t start;
+    uint64_t childTicks;
+} SuspendedCall;
+
+typedef struct SuspendedCalls {
+    uint64_t suspendedAt;
+    size_t count;
+    SuspendedCall calls[];
+} SuspendedCalls;
+
+typedef struct ProfilerState {
+    CubsProfilerOpcodeStats opcodes[OPCODE_SLOTS];
+    bool hasCurrentOpcode;
+    OpCode currentOpcode;
+    uint64_t opcodeStart;
+    CallTreeNode* nodes;
+    size_t nodeCount;
+    size_t nodeCapacity;
+    FunctionRecord* functions;
+    size_t functionCount;
+    size_t functionCapacity;
+    ActiveCall* calls;
+    size_t callCount;
+    size_t callCapacity;
+} ProfilerState;
+
+static _Thread_local ProfilerState threadLocalProfiler = {0};
+
+/// Grows `*buffer` to fit at least `required` elements of `elementSize`, keeping it's contents.
+static void ensure_capacity(void** buffer, size_t* capacity, size_t required, size_t elementSize, size_t align) {
+    if(required <= *capacity) {
+        return;
+    }
+    size_t newCapacity = *capacity == 0 ? 64 : *capacity * 2;
+    while(newCapacity < required) {
+        newCapacity *= 2;
+    }
+    void* newBuffer = cubs_malloc(newCapacity * elementSize, align);
+    if(*buffer != NULL) {
+        memcpy(newBuffer, *buffer, *capacity * elementSize);
+        cubs_free(*buffer, *capacity * elementSize, align);
+    }
+    *buffer = newBuffer;
+    *capacity = newCapacity;
+}
+
+static uint32_t find_or_add_function(ProfilerState* state, const CubsScriptFunctionPtr* function) {
+    for(size_t i = 0; i < state->functionCount; i++) {
+        if(state->functions[i].stats.function == function) {
+            return (uint32_t)i;
+        }
+    }
+    ensure_capacity((void**)&state->functions, &state->functionCapacity, state->functionCount + 1, sizeof(FunctionRecord), _Alignof(FunctionRecord));
+    const FunctionRecord record = {.stats = {.function = function}, .activeCalls = 0};
+    state->functions[state->functionCount] = record;
+    state->functionCount += 1;
+    return (uint32_t)(state->functionCount - 1);
+}
+
+/// Direct recursion reuses the parent's node, so deep recursion doesn't create a node per call.
+static uint32_t find_or_add_node(ProfilerState* state, uint32_t parent, const CubsScriptFunctionPtr* function) {
+    if(state->nodeCount == 0) {
+        ensure_capacity((void**)&state->nodes, &state->nodeCapacity, 1, sizeof(CallTreeNode), _Alignof(CallTreeNode));
+        const CallTreeNode root = {0};
+        state->nodes[ROOT_NODE] = root;
+        state->nodeCount = 1;
+    }
+
+    if(parent != ROOT_NODE && state->nodes[parent].function == function) {
+        return parent;
+    }
+    for(uint32_t child = state->nodes[parent].firstChild; child != ROOT_NODE; child = state->nodes[child].nextSibling) {
+        if(state->nodes[child].function == function) {
+            return child;
+        }
+    }
+
+    ensure_capacity((void**)&state->nodes, &state->nodeCapacity, state->nodeCount + 1, sizeof(CallTreeNode), _Alignof(CallTreeNode));
+    const uint32_t node = (uint32_t)state->nodeCount;
+    const CallTreeNode newNode = {
+        .function = function,
+        .parent = parent,
+        .firstChild = ROOT_NODE,
+        .nextSibling = state->nodes[parent].firstChild,
+        .functionIndex = find_or_add_function(state, function),
+        .exclusiveTicks = 0,
+    };
+    state->nodes[node] = newNode;
+    state->nodes[parent].firstChild = node;
+    state->nodeCount += 1;
+    return node;
+}
+
+/// Adds the ticks of the currently executing operation, if there is one.
+static void flush_opcode(ProfilerState* state, uint64_t now) {
+    if(state->hasCurrentOpcode) {
+        state->opcodes[state->currentOpcode].ticks += now - state->opcodeStart;
+    }
+}
+
+void _cubs_profiler_enter_function(const CubsScriptFunctionPtr *function)
+{
+    ProfilerState* state = &threadLocalProfiler;
+    const uint32_t parent = state->callCount == 0 ? ROOT_NODE : state->calls[state->callCount - 1].node;
+    const uint32_t node = find_or_add_node(state, parent, function);
+
+    FunctionRecord* record = &state->functions[state->nodes[node].functionIndex];
+    record->stats.calls += 1;
+    record->activeCalls += 1;
+
+    ensure_capacity((void**)&state->calls, &state->callCapacity, state->callCount + 1, sizeof(ActiveCall), _Alignof(ActiveCall));
+    const uint64_t now = cubs_profiler_ticks();
+    const ActiveCall call = {.node = node, .isDispatch = false, .start = now, .sliceStart = now, .childTicks = 0};
+    state->calls[state->callCount] = call;
+    state->callCount += 1;
+}
+
+void _cubs_profiler_exit_function()
+{
+    ProfilerState* state = &threadLocalProfiler;
+    if(state->callCount == 0) { // reset while executing
+        return;
+    }
+
+    state->callCount -= 1;
+    const ActiveCall* call = &state->calls[state->callCount];
+    const uint64_t now = cubs_profiler_ticks();
+    const uint64_t elapsed = now - call->start;
+    const uint64_t exclusive = elapsed - call->childTicks;
+
+    CallTreeNode* node = &state->nodes[call->node];
+    node->exclusiveTicks += exclusive;
+
+    FunctionRecord* record = &state->functions[node->functionIndex];
+    record->stats.exclusiveTicks += exclusive;
+    record->activeCalls -= 1;
+    if(record->activeCalls == 0) {
+        record->stats.inclusiveTicks += elapsed;
+    }
+
+    if(state->callCount > 0) {
+        state->calls[state->callCount - 1].childTicks += now - call->sliceStart;
+    }
+}
+
+void _cubs_profiler_tail_call(const CubsScriptFunctionPtr *function)
+{
+    ProfilerState* state = &threadLocalProfiler;
+    if(state->callCount == 0) { // reset while executing
+        return;
+    }
+
+    // The callee takes the caller's place, including how it was entered
+    const ActiveCall caller = state->calls[state->callCount - 1];
+    _cubs_profiler_exit_function();
+    _cubs_profiler_enter_function(function);
+    ActiveCall* call = &state->calls[state->callCount - 1];
+    call->isDispatch = caller.isDispatch;
+    call->hasPausedOpcode = caller.hasPausedOpcode;
+    call->pausedOpcode = caller.pausedOpcode;
+}
+
+void _cubs_profiler_enter_dispatch(const CubsScriptFunctionPtr *function)
+{
+    ProfilerState* state = &threadLocalProfiler;
+    flush_opcode(state, cubs_profiler_ticks());
+    const bool hadOpcode = state->hasCurrentOpcode;
+    const OpCode opcode = state->currentOpcode;
+    state->hasCurrentOpcode = false;
+
+    _cubs_profiler_enter_function(function);
+    ActiveCall* call = &state->calls[state->callCount - 1];
+    call->isDispatch = true;
+    call->hasPausedOpcode = hadOpcode;
+    call->pausedOpcode = opcode;
+}
+
+void _cubs_profiler_exit_dispatch()
+{
+    ProfilerState* state = &threadLocalProfiler;
+    flush_opcode(state, cubs_profiler_ticks());
+    state->hasCurrentOpcode = false;
+    if(state->callCount == 0) { // reset while executing
+        return;
+    }
+
+    const ActiveCall call = state->calls[state->callCount - 1];
+    assert(call.isDispatch);
+    _cubs_profiler_exit_function();
+
+    state->hasCurrentOpcode = call.hasPausedOpcode;
+    state->currentOpcode = call.pausedOpcode;
+    state->opcodeStart = cubs_profiler_ticks();
+}
+
+static size_t suspended_calls_size(size_t count) {
+    return sizeof(SuspendedCalls) + (count * sizeof(SuspendedCall));
+}
+
+void _cubs_profiler_suspend(size_t callDepth, void** outSuspended)
+{
+    ProfilerState* state = &threadLocalProfiler;
+    const uint64_t now = cubs_profiler_ticks();
+    flush_opcode(state, now);
+    if(state->hasCurrentOpcode) {
+        // Suspending happens after dispatching the next operation, but before executing it
+        state->opcodes[state->currentOpcode].count -= 1;
+    }
+    state->hasCurrentOpcode = false;
+    *outSuspended = NULL;
+    if(state->callCount <= callDepth) { // reset while executing
+        return;
+    }
+
+    const size_t count = callDepth + 1;
+    const size_t first = state->callCount - count;
+    SuspendedCalls* suspended = (SuspendedCalls*)cubs_malloc(suspended_calls_size(count), _Alignof(SuspendedCalls));
+    suspended->suspendedAt = now;
+    suspended->count = count;
+    for(size_t i = 0; i < count; i++) {
+        const ActiveCall* call = &state->calls[first + i];
+        const SuspendedCall suspendedCall = {.function = state->nodes[call->node].function, .start = call->start, .childTicks = call->childTicks};
+        suspended->calls[i] = suspendedCall;
+        // Calls to the same functions while suspended add their own inclusive ticks
+        state->functions[state->nodes[call->node].functionIndex].activeCalls -= 1;
+    }
+
+    const ActiveCall outermost = state->calls[first];
+    assert(outermost.isDispatch);
+    state->callCount = first;
+    if(state->callCount > 0) {
+        state->calls[state->callCount - 1].childTicks += now - outermost.sliceStart;
+    }
+    state->hasCurrentOpcode = outermost.hasPausedOpcode;
+    state->currentOpcode = outermost.pausedOpcode;
+    state->opcodeStart = now;
+    *outSuspended = (void*)suspended;
+}
+
+void _cubs_profiler_resume(void* suspended)
+{
+    if(suspended == NULL) {
+        return;
+    }
+    SuspendedCalls* calls = (SuspendedCalls*)suspended;
+    ProfilerState* state = &threadLocalProfiler;
+    const uint64_t now = cubs_profiler_ticks();
+    flush_opcode(state, now);
+    const bool hadOpcode = state->hasCurrentOpcode;
+    const OpCode opcode = state->currentOpcode;
+    state->hasCurrentOpcode = false;
+
+    // The suspended time isn't counted at all
+    const uint64_t suspendedFor = now - calls->suspendedAt;
+    ensure_capacity((void**)&state->calls, &state->callCapacity, state->callCount + calls->count, sizeof(ActiveCall), _Alignof(ActiveCall));
+    for(size_t i = 0; i < calls->count; i++) {
+        const uint32_t parent = state->callCount == 0 ? ROOT_NODE : state->calls[state->callCount - 1].node;
+        const uint32_t node = find_or_add_node(state, parent, calls->calls[i].function);
+        state->functions[state->nodes[node].functionIndex].activeCalls += 1;
+
+        const uint64_t start = calls->calls[i].start + suspendedFor;
+        const ActiveCall call = {
+            .node = node,
+            .isDispatch = i == 0,
+            .hasPausedOpcode = i == 0 && hadOpcode,
+            .pausedOpcode = opcode,
+            .start = start,
+            .sliceStart = i == 0 ? now : start,
+            .childTicks = calls->calls[i].childTicks,
+        };
+        state->calls[state->callCount] = call;
+        state->callCount += 1;
+    }
+    cubs_free(suspended, suspended_calls_size(calls->count), _Alignof(SuspendedCalls));
+}
+
+void _cubs_profiler_dispatch_op(OpCode opcode)
+{
+    ProfilerState* state = &threadLocalProfiler;
+    const uint64_t now = cubs_profiler_ticks();
+    flush_opcode(state, now);
+    state->opcodes[opcode].count += 1;
+    state->hasCurrentOpcode = true;
+    state->currentOpcode = opcode;
+    state->opcodeStart = now;
+}
+
+bool cubs_profiler_is_enabled()
+{
+    return true;
+}
+
+CubsProfilerOpcodeStats cubs_profiler_opcode_stats(OpCode opcode)
+{
+    assert(opcode < OPCODE_SLOTS);
+    return threadLocalProfiler.opcodes[opcode];
+}
+
+size_t cubs_profiler_function_count()
+{
+    return threadLocalProfiler.functionCount;
+}
+
+CubsProfilerFunctionStats cubs_profiler_function_stats(size_t index)
+{
+    assert(index < threadLocalProfiler.functionCount);
+    return threadLocalProfiler.functions[index].stats;
+}
+
+static void write_function_name(FILE* file, const CubsScriptFunctionPtr* function) {
+    CubsStringSlice name = cubs_string_as_slice(&function->fullyQualifiedName);
+    if(name.len == 0) {
+        name = cubs_string_as_slice(&function->name);
+    }
+    if(name.len == 0) {
+        fprintf(file, "%p", (const void*)function);
+    } else {
+        fwrite(name.str, 1, name.len, file);
+    }
+}
+
+bool cubs_profiler_write_folded(const char *path)
+{
+    const ProfilerState* state = &threadLocalProfiler;
+    FILE* file = fopen(path, "w");
+    if(file == NULL) {
+        return false;
+    }
+
+    uint32_t* stack = NULL;
+    if(state->nodeCount > 0) {
+        stack = MALLOC_TYPE_ARRAY(uint32_t, state->nodeCount);
+    }
+    for(size_t i = ROOT_NODE + 1; i < state->nodeCount; i++) {
+        if(state->nodes[i].exclusiveTicks == 0) {
+            continue;
+        }
+
+        size_t depth = 0;
+        for(uint32_t node = (uint32_t)i; node != ROOT_NODE; node = state->nodes[node].parent) {
+            stack[depth] = node;
+            depth += 1;
+        }
+        for(size_t frame = depth; frame > 0; frame--) {
+            write_function_name(file, state->nodes[stack[frame - 1]].function);
+            fputc(frame == 1 ? ' ' : ';', file);
+        }
+        fprintf(file, "%llu\n", (unsigned long long)state->nodes[i].exclusiveTicks);
+    }
+    if(stack != NULL) {
+        FREE_TYPE_ARRAY(uint32_t, stack, state->nodeCount);
+    }
+
+    const bool failed = ferror(file) != 0;
+    return (fclose(file) == 0) && !failed;
+}
+
+void cubs_profiler_reset()
+{
+    ProfilerState* state = &threadLocalProfiler;
+    if(state->nodes != NULL) {
+        FREE_TYPE_ARRAY(CallTreeNode, state->nodes, state->nodeCapacity);
+    }
+    if(state->functions != NULL) {
+        FREE_TYPE_ARRAY(FunctionRecord, state->functions, state->functionCapacity);
+    }
+    if(state->calls != NULL) {
+        FREE_TYPE_ARRAY(ActiveCall, state->calls, state->callCapacity);
+    }
+    memset((void*)state, 0, sizeof(ProfilerState));
+}
+
+#else // CUBS_INTERPRETER_PROFILE
+
+bool cubs_profiler_is_enabled()
+{
+    return false;
+}
+
+CubsProfilerOpcodeStats cubs_profiler_opcode_stats(OpCode opcode)
+{
+    (void)opcode;
+    const CubsProfilerOpcodeStats stats = {0};
+    return stats;
+}
+
+size_t cubs_profiler_function_count()
+{
+    return 0;
+}
+
+CubsProfilerFunctionStats cubs_profiler_function_stats(size_t index)
+{
+    (void)index;
+    assert(false && "Profiler is not enabled, so no functions were recorded");
+    const CubsProfilerFunctionStats stats = {0};
+    return stats;
+}
+
+bool cubs_profiler_write_folded(const char *path)
+{
+    FILE* file = fopen(path, "w");
+    if(file == NULL) {
+        return false;
+    }
+    return fclose(file) == 0;
+}
+
+void cubs_profiler_reset() {}
+
+#endif // CUBS_INTERPRETER_PROFILE
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "bytecode.h"
+
+struct CubsScriptFunctionPtr;
+
+/*
+Optional interpreter profiler, recording per operation counts and ticks, and per script function
+call counts, and inclusive and exclusive ticks. Only compiled in when `CUBS_INTERPRETER_PROFILE`
+is defined (CMake option `CUBS_INTERPRETER_PROFILE`, or `zig build -Dprofile=true`). Otherwise
+the interpreter has no profiling hooks at all, and the functions below report nothing.
+
+Ticks are TSC cycles on x86-64, and nanoseconds elsewhere. See `cubs_profiler_ticks()`.
+Results are recorded per thread, and only accessible from the thread that recorded them.
+*/
+
+typedef struct CubsProfilerOpcodeStats {
+    /// How many times operations with the opcode were dispatched.
+    uint64_t count;
+    /// Total ticks spent executing operations with the opcode. Script functions called from
+    /// C functions are not included in the call operation's ticks.
+    uint64_t ticks;
+} CubsProfilerOpcodeStats;
+
+typedef struct CubsProfilerFunctionStats {
+    const struct CubsScriptFunctionPtr* function;
+    uint64_t calls;
+    /// Ticks from entering the function until returning from it, including it's callees.
+    /// Recursive calls are only counted once, by the outermost call.
+    uint64_t inclusiveTicks;
+    /// Ticks spent executing the function itself, excluding the script functions it calls.
+    /// C functions it calls are included.
+    uint64_t exclusiveTicks;
+} CubsProfilerFunctionStats;
+
+/// Returns true if the profiler is compiled in.
+bool cubs_profiler_is_enabled();
+
+/// The profiler's current timestamp.
+uint64_t cubs_profiler_ticks();
+
+CubsProfilerOpcodeStats cubs_profiler_opcode_stats(OpCode opcode);
+
+/// Number of distinct script functions called on this thread since the last reset.
+size_t cubs_profiler_function_count();
+
+/// `index` must be less than `cubs_profiler_function_count()`.
+/// Functions are in the order they were first called.
+CubsProfilerFunctionStats cubs_profiler_function_stats(size_t index);
+
+/// Writes each distinct script call stack, and the exclusive ticks spent within it, to the file
+/// at `path` in the folded stack format used by flamegraph tools, with one `outer;inner ticks`
+/// line per stack. Functions are named by their fully qualified name. Direct recursion is folded
+/// into a single frame. Returns false if the file couldn't be written.
+bool cubs_profiler_write_folded(const char* path);
+
+/// Discards everything recorded on this thread, and frees the profiler's memory.
+/// Must not be called while this thread is executing script code.
+void cubs_profiler_reset();
+
+#ifdef CUBS_INTERPRETER_PROFILE
+
+/// Called by the interpreter before executing a script function from outside of the dispatch loop.
+void _cubs_profiler_enter_dispatch(const struct CubsScriptFunctionPtr* function);
+
+/// Called by the interpreter once a function entered with `_cubs_profiler_enter_dispatch(...)` returns.
+void _cubs_profiler_exit_dispatch();
+
+/// Called by the interpreter when calling a script function within the dispatch loop.
+void _cubs_profiler_enter_function(const struct CubsScriptFunctionPtr* function);
+
+/// Called by the interpreter once a function entered with `_cubs_profiler_enter_function(...)` returns.
+void _cubs_profiler_exit_function();
+
+/// Called by the interpreter when the current script function tail calls `function`, which
+/// replaces it on the call stack, as if it was called by the current function's caller.
+void _cubs_profiler_tail_call(const struct CubsScriptFunctionPtr* function);
+
+/// Called by the interpreter when a budgeted execution suspends, after dispatching it's next operation,
+/// with `callDepth` script function frames on top of the executed function's frame. Moves the
+/// suspended calls off of this thread's call stack into `*outSuspended`, so suspended executions may
+/// resume in any order. Time until `_cubs_profiler_resume(...)` isn't counted.
+void _cubs_profiler_suspend(size_t callDepth, void** outSuspended);
+
+/// Called by the interpreter when resuming or cancelling a suspended execution, with what
+/// `_cubs_profiler_suspend(...)` output. The calls are recorded under the call that resumed them.
+void _cubs_profiler_resume(void* suspended);
+
+/// Called by the interpreter before dispatching each operation.
+void _cubs_profiler_dispatch_op(OpCode opcode);
+
+#endif
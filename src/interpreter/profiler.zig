@@ -0,0 +1,85 @@
+const std = @import("std");
+const expect = std.testing.expect;
+
+const c = @cImport({
+    @cInclude("interpreter/interpreter.h");
+    @cInclude("interpreter/function_definition.h");
+    @cInclude("interpreter/bytecode.h");
+    @cInclude("interpreter/operations.h");
+    @cInclude("interpreter/profiler.h");
+    @cInclude("primitives/context.h");
+    @cInclude("program/program.h");
+    @cInclude("program/program_internal.h");
+});
+
+test "disabled profiler records nothing" {
+    if (c.cubs_profiler_is_enabled()) {
+        return error.SkipZigTest;
+    }
+
+    var program = c.cubs_program_init(.{});
+    defer c.cubs_program_deinit(&program);
+
+    var builder = c.FunctionBuilder{ .stackSpaceRequired = 1, .optReturnType = &c.CUBS_INT_CONTEXT };
+    defer c.cubs_function_builder_deinit(&builder);
+    c.cubs_function_builder_push_bytecode(&builder, c.operands_make_load_immediate(c.LOAD_IMMEDIATE_INT, 0, 1));
+    c.cubs_function_builder_push_bytecode(&builder, c.operands_make_return(true, 0));
+    const func = c.cubs_function_builder_build(&builder, &program);
+
+    var result: i64 = undefined;
+    var retContext: *const c.CubsTypeContext = undefined;
+    try expect(c.cubs_interpreter_execute_function(func, @ptrCast(&result), @ptrCast(&retContext)) == 0);
+
+    try expect(c.cubs_profiler_function_count() == 0);
+    try expect(c.cubs_profiler_opcode_stats(c.OpCodeReturn).count == 0);
+}
+
+test "function and opcode stats" {
+    if (!c.cubs_profiler_is_enabled()) {
+        return error.SkipZigTest;
+    }
+    c.cubs_profiler_reset();
+    defer c.cubs_profiler_reset();
+
+    var program = c.cubs_program_init(.{});
+    defer c.cubs_program_deinit(&program);
+
+    // fn one() int { return 1; }
+    const one = blk: {
+        var builder = c.FunctionBuilder{ .stackSpaceRequired = 1, .optReturnType = &c.CUBS_INT_CONTEXT };
+        defer c.cubs_function_builder_deinit(&builder);
+        c.cubs_function_builder_push_bytecode(&builder, c.operands_make_load_immediate(c.LOAD_IMMEDIATE_INT, 0, 1));
+        c.cubs_function_builder_push_bytecode(&builder, c.operands_make_return(true, 0));
+        break :blk c.cubs_function_builder_build(&builder, &program);
+    };
+
+    // fn callOneTwice() int { one(); return one(); }
+    var builder = c.FunctionBuilder{ .stackSpaceRequired = 1, .optReturnType = &c.CUBS_INT_CONTEXT };
+    defer c.cubs_function_builder_deinit(&builder);
+    for (0..2) |_| {
+        var call: [2]c.Bytecode = undefined;
+        c.cubs_operands_make_call_immediate(&call, 2, 0, null, true, 0, .{ .func = .{ .script = one }, .funcType = c.cubsFunctionPtrTypeScript });
+        c.cubs_function_builder_push_bytecode_many(&builder, &call, 2);
+    }
+    c.cubs_function_builder_push_bytecode(&builder, c.operands_make_return(true, 0));
+    const callOneTwice = c.cubs_function_builder_build(&builder, &program);
+
+    var result: i64 = undefined;
+    var retContext: *const c.CubsTypeContext = undefined;
+    try expect(c.cubs_interpreter_execute_function(callOneTwice, @ptrCast(&result), @ptrCast(&retContext)) == 0);
+    try expect(result == 1);
+
+    try expect(c.cubs_profiler_opcode_stats(c.OpCodeCall).count == 2);
+    try expect(c.cubs_profiler_opcode_stats(c.OpCodeLoad).count == 2);
+    try expect(c.cubs_profiler_opcode_stats(c.OpCodeReturn).count == 3);
+
+    try expect(c.cubs_profiler_function_count() == 2);
+    const outerStats = c.cubs_profiler_function_stats(0);
+    const innerStats = c.cubs_profiler_function_stats(1);
+    try expect(outerStats.function == callOneTwice);
+    try expect(outerStats.calls == 1);
+    try expect(innerStats.function == one);
+    try expect(innerStats.calls == 2);
+    try expect(innerStats.inclusiveTicks == innerStats.exclusiveTicks);
+    try expect(outerStats.inclusiveTicks == outerStats.exclusiveTicks + innerStats.inclusiveTicks);
+}
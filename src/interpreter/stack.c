@@ -5,37 +5,238 @@
 #include "../util/unreachable.h"
 #include <assert.h>
 #include "../util/context_size_round.h"
+#include "../util/panic.h"
+#include "../platform/mem.h"
+#include "../util/bitwise.h"
 #include <string.h>
-
-static bool ptr_is_aligned(const void* p, size_t alignment) {
-    return (((uintptr_t)p) % alignment) == 0;
-}
+#include <stdio.h>
+
+#if defined(_WIN32) || defined(WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+const CubsTypeContext* const _CUBS_SLOT_TAG_CONTEXTS[SLOT_TAG_CHAR + 1] = {
+    [SLOT_TAG_NONE] = NULL,
+    [SLOT_TAG_BOOL] = &CUBS_BOOL_CONTEXT,
+    [SLOT_TAG_INT] = &CUBS_INT_CONTEXT,
+    [SLOT_TAG_FLOAT] = &CUBS_FLOAT_CONTEXT,
+    [SLOT_TAG_CHAR] = &CUBS_CHAR_CONTEXT,
+};
+
+/// The stack grows by committing this many slots at a time. 512KB for values and
+/// contexts each, and 64KB for tags, keeping every region page aligned.
+#define STACK_COMMIT_SLOTS ((size_t)65536)
+
+/// Separately created stacks grow by this many slots at a time instead. The smallest chunk that
+/// keeps the tags page aligned with pages up to 16KB.
+#define STACK_STATE_COMMIT_SLOTS ((size_t)16384)
+
+/// Bytes per slot across values, contexts, and tags.
+#define STACK_BYTES_PER_SLOT ((2 * sizeof(size_t)) + sizeof(uint8_t))
 
 typedef struct InterpreterStackState {
     const Bytecode* instructionPointer;
     /// Offset from `stack` and `tags` indicated where the next frame should start
     size_t nextBaseOffset;
     InterpreterStackFrame frame;
-    size_t stack[CUBS_STACK_SLOTS];
-    uintptr_t contexts[CUBS_STACK_SLOTS];
+    /// Reserved on first use. `contexts` and `tags` follow it within the same reservation.
+    /// None move once reserved, so pointers into the stack remain valid as it grows.
+    size_t* stack;
+    uintptr_t* contexts;
+    /// See `enum InterpreterSlotTag`.
+    uint8_t* tags;
+    /// How many slots `stack`, `contexts`, and `tags` can grow to.
+    size_t reservedSlots;
+    /// How many slots of `stack`, `contexts`, and `tags` are usable. Never exceeds the limit.
+    size_t committedSlots;
+    /// If 0, uses `CUBS_STACK_SLOTS`.
+    size_t limitSlots;
+    /// How many slots are committed at a time. If 0, uses `STACK_COMMIT_SLOTS`.
+    size_t commitSlots;
 } InterpreterStackState;
 
 static _Thread_local InterpreterStackState threadLocalStack = {0};
 
-void cubs_interpreter_push_frame(size_t frameLength, void* returnValueDst, const CubsTypeContext** returnContextDst) {
+static void stack_state_release(InterpreterStackState* state) {
+    assert(state->nextBaseOffset == 0 && "Cannot release the interpreter stack while it's in use");
+    if(state->stack == NULL) {
+        return;
+    }
+    _cubs_os_free_pages((void*)state->stack, state->reservedSlots * STACK_BYTES_PER_SLOT);
+    state->stack = NULL;
+    state->contexts = NULL;
+    state->tags = NULL;
+    state->reservedSlots = 0;
+    state->committedSlots = 0;
+}
+
+#if defined(_WIN32) || defined(WIN32)
+static DWORD threadExitFlsIndex = FLS_OUT_OF_INDEXES;
+static INIT_ONCE threadExitFlsOnce = INIT_ONCE_STATIC_INIT;
+
+static VOID WINAPI thread_exit_release_stack(PVOID state) {
+    if(state != NULL) {
+        stack_state_release((InterpreterStackState*)state);
+    }
+}
+
+static BOOL CALLBACK thread_exit_fls_init(PINIT_ONCE initOnce, PVOID param, PVOID* context) {
+    threadExitFlsIndex = FlsAlloc(&thread_exit_release_stack);
+    return TRUE;
+}
+
+/// Releases the calling thread's stack when it exits.
+static void register_thread_exit_release() {
+    (void)InitOnceExecuteOnce(&threadExitFlsOnce, &thread_exit_fls_init, NULL, NULL);
+    if(threadExitFlsIndex != FLS_OUT_OF_INDEXES) {
+        (void)FlsSetValue(threadExitFlsIndex, (PVOID)&threadLocalStack);
+    }
+}
+#else
+static pthread_key_t threadExitKey;
+static pthread_once_t threadExitKeyOnce = PTHREAD_ONCE_INIT;
+
+static void thread_exit_release_stack(void* state) {
+    stack_state_release((InterpreterStackState*)state);
+}
+
+static void thread_exit_key_init() {
+    (void)pthread_key_create(&threadExitKey, &thread_exit_release_stack);
+}
+
+/// Releases the calling thread's stack when it exits.
+static void register_thread_exit_release() {
+    (void)pthread_once(&threadExitKeyOnce, &thread_exit_key_init);
+    (void)pthread_setspecific(threadExitKey, (const void*)&threadLocalStack);
+}
+#endif
+
+static void stack_overflow_panic(size_t requiredSlots) {
+    char errBuf[256];
+    #if defined(_WIN32) || defined(WIN32)
+    const int len = sprintf_s(errBuf, 256, "Interpreter stack overflow. Requires %zu slots, but the limit is %zu. See cubs_interpreter_set_stack_limit(...)\n", requiredSlots, cubs_interpreter_stack_limit());
+    #else
+    const int len = sprintf(errBuf, "Interpreter stack overflow. Requires %zu slots, but the limit is %zu. See cubs_interpreter_set_stack_limit(...)\n", requiredSlots, cubs_interpreter_stack_limit());
+    #endif
+    assert(len >= 0);
+    cubs_panic(errBuf);
+}
+
+static void stack_grow(size_t requiredSlots) {
+    const size_t commitSlots = threadLocalStack.commitSlots == 0 ? STACK_COMMIT_SLOTS : threadLocalStack.commitSlots;
+    if(threadLocalStack.stack == NULL) {
+        const size_t limit = cubs_interpreter_stack_limit();
+        const size_t reservedSlots = ((limit + commitSlots - 1) / commitSlots) * commitSlots;
+        size_t* mem = (size_t*)_cubs_os_reserve_pages(reservedSlots * STACK_BYTES_PER_SLOT);
+        if(mem == NULL) {
+            cubs_panic("Failed to reserve interpreter stack memory");
+        }
+        threadLocalStack.stack = mem;
+        threadLocalStack.contexts = (uintptr_t*)&mem[reservedSlots];
+        threadLocalStack.tags = (uint8_t*)&mem[reservedSlots * 2];
+        threadLocalStack.reservedSlots = reservedSlots;
+        threadLocalStack.committedSlots = 0;
+        register_thread_exit_release();
+    }
+
+    if(requiredSlots > cubs_interpreter_stack_limit()) {
+        stack_overflow_panic(requiredSlots);
+    }
+
+    // Commit whole chunks, but only consider slots up to the limit usable
+    const size_t oldCommitted = ((threadLocalStack.committedSlots + commitSlots - 1) / commitSlots) * commitSlots;
+    const size_t newCommitted = ((requiredSlots + commitSlots - 1) / commitSlots) * commitSlots;
+    assert(newCommitted <= threadLocalStack.reservedSlots);
+    if(newCommitted > oldCommitted) {
+        const size_t growBytes = (newCommitted - oldCommitted) * sizeof(size_t);
+        if(!_cubs_os_commit_pages((void*)&threadLocalStack.stack[oldCommitted], growBytes)
+            || !_cubs_os_commit_pages((void*)&threadLocalStack.contexts[oldCommitted], growBytes)
+            || !_cubs_os_commit_pages((void*)&threadLocalStack.tags[oldCommitted], newCommitted - oldCommitted)) 
+        {
+            cubs_panic("Failed to commit interpreter stack memory");
+        }
+    }
+    const size_t limit = cubs_interpreter_stack_limit();
+    threadLocalStack.committedSlots = newCommitted < limit ? newCommitted : limit;
+}
+
+/// Makes sure the first `requiredSlots` slots of the stack are usable, reserving the
+/// stack on first use, and growing it if necessary.
+static void stack_ensure_slots(size_t requiredSlots) {
+    if(requiredSlots > threadLocalStack.committedSlots) {
+        stack_grow(requiredSlots);
+    }
+}
+
+void cubs_interpreter_set_stack_limit(size_t slots)
+{
+    assert(slots > 0);
+    if(slots == cubs_interpreter_stack_limit()) {
+        return;
+    }
+    if(threadLocalStack.nextBaseOffset != 0) {
+        cubs_panic("Cannot change the interpreter stack limit while it's in use");
+    }
+    stack_state_release(&threadLocalStack);
+    threadLocalStack.limitSlots = slots;
+}
+
+size_t cubs_interpreter_stack_limit()
+{
+    if(threadLocalStack.limitSlots == 0) {
+        return CUBS_STACK_SLOTS;
+    }
+    return threadLocalStack.limitSlots;
+}
+
+void cubs_interpreter_stack_release()
+{
+    stack_state_release(&threadLocalStack);
+}
+
+InterpreterStackState* cubs_interpreter_stack_state_create(size_t limitSlots)
+{
+    assert(limitSlots > 0);
+    InterpreterStackState* state = MALLOC_TYPE(InterpreterStackState);
+    const InterpreterStackState newState = {.limitSlots = limitSlots, .commitSlots = STACK_STATE_COMMIT_SLOTS};
+    *state = newState;
+    return state;
+}
+
+void cubs_interpreter_stack_state_destroy(InterpreterStackState* state)
+{
+    assert(state != &threadLocalStack);
+    stack_state_release(state);
+    FREE_TYPE(InterpreterStackState, state);
+}
+
+void cubs_interpreter_stack_state_swap(InterpreterStackState* state)
+{
+    const InterpreterStackState temp = threadLocalStack;
+    threadLocalStack = *state;
+    *state = temp;
+}
+
+static void push_frame(size_t frameLength, const uint64_t* optDestructorSlots, void* returnValueDst, const CubsTypeContext** returnContextDst) {
     assert(frameLength <= MAX_FRAME_LENGTH);
-    { // store previous instruction pointer, frame length, return dst, and return tag dst
+    stack_ensure_slots(threadLocalStack.nextBaseOffset + RESERVED_SLOTS + frameLength);
+    { // store previous instruction pointer, frame length, return dst, return tag dst, and destructor slots
         size_t* basePointer = &((size_t*)threadLocalStack.stack)[threadLocalStack.nextBaseOffset];
         if(threadLocalStack.nextBaseOffset == 0) {
             basePointer[OLD_INSTRUCTION_POINTER]    = 0;
             basePointer[OLD_FRAME_LENGTH]           = 0;
             basePointer[OLD_RETURN_VALUE_DST]       = 0;
             basePointer[OLD_RETURN_CONTEXT_DST]     = 0;
+            basePointer[OLD_DESTRUCTOR_SLOTS]       = 0;
         } else {
             basePointer[OLD_INSTRUCTION_POINTER]    = (size_t)((const void*)threadLocalStack.instructionPointer); // cast ptr to size_t
             basePointer[OLD_FRAME_LENGTH]           = threadLocalStack.frame.frameLength;
             basePointer[OLD_RETURN_VALUE_DST]       = (size_t)threadLocalStack.frame.returnValueDst;
             basePointer[OLD_RETURN_CONTEXT_DST]     = (size_t)threadLocalStack.frame.returnContextDst;
+            basePointer[OLD_DESTRUCTOR_SLOTS]       = (size_t)threadLocalStack.frame.optDestructorSlots;
         }
     }
 
@@ -43,12 +244,103 @@ void cubs_interpreter_push_frame(size_t frameLength, void* returnValueDst, const
         .basePointerOffset = threadLocalStack.nextBaseOffset,
         .frameLength = frameLength,
         .returnValueDst = returnValueDst,
-        .returnContextDst = returnContextDst
+        .returnContextDst = returnContextDst,
+        .optDestructorSlots = optDestructorSlots,
     };
     threadLocalStack.frame = newFrame;
     threadLocalStack.nextBaseOffset += frameLength + RESERVED_SLOTS;  
 }
 
+void cubs_interpreter_push_frame(size_t frameLength, void* returnValueDst, const CubsTypeContext** returnContextDst) {
+    push_frame(frameLength, NULL, returnValueDst, returnContextDst);
+}
+
+void cubs_interpreter_push_script_frame(const CubsScriptFunctionPtr* function, void* returnValueDst, const CubsTypeContext** returnContextDst) {
+    assert(function->_destructorSlots != NULL);
+    push_frame(function->_stackSpaceRequired, function->_destructorSlots, returnValueDst, returnContextDst);
+}
+
+InterpreterFramePointer cubs_interpreter_push_script_call_frame(
+    const CubsScriptFunctionPtr* function,
+    const InterpreterFramePointer* callerFrame,
+    const uint16_t* argsSrcs,
+    size_t argCount,
+    void* returnValueDst,
+    const CubsTypeContext** returnContextDst,
+    const Bytecode* callerInstructionPointer
+) {
+    assert(argCount == function->argsLen);
+    threadLocalStack.instructionPointer = callerInstructionPointer;
+    push_frame(function->_stackSpaceRequired, function->_destructorSlots, returnValueDst, returnContextDst);
+
+    const InterpreterFramePointer frame = cubs_interpreter_current_frame_pointer();
+    size_t offset = 0;
+    for(size_t i = 0; i < argCount; i++) {
+        const CubsTypeContext* context = cubs_frame_context_at(callerFrame, argsSrcs[i]);
+        assert(context == function->argsTypes[i]);
+        memcpy(cubs_frame_value_at(&frame, offset), cubs_frame_value_at(callerFrame, argsSrcs[i]), context->sizeOfType);
+        cubs_frame_set_context_at(&frame, offset, context);
+        offset += ROUND_SIZE_TO_MULTIPLE_OF_8(context->sizeOfType) / 8;
+    }
+    return frame;
+}
+
+InterpreterFramePointer cubs_interpreter_replace_script_call_frame(
+    const CubsScriptFunctionPtr* function,
+    const InterpreterFramePointer* currentFrame,
+    const uint16_t* argsSrcs,
+    size_t argCount
+) {
+    assert(argCount == function->argsLen);
+    assert(function->_stackSpaceRequired <= MAX_FRAME_LENGTH);
+    const size_t start = threadLocalStack.frame.basePointerOffset + RESERVED_SLOTS;
+
+    size_t argSlots = 0;
+    for(size_t i = 0; i < argCount; i++) {
+        argSlots += ROUND_SIZE_TO_MULTIPLE_OF_8(function->argsTypes[i]->sizeOfType) / 8;
+    }
+    // The arguments are staged past both the current frame, and where they end up in the new one
+    const size_t scratchStart = start + (threadLocalStack.frame.frameLength > argSlots ? threadLocalStack.frame.frameLength : argSlots);
+    const size_t newNextBaseOffset = start + function->_stackSpaceRequired;
+    stack_ensure_slots(scratchStart + argSlots > newNextBaseOffset ? scratchStart + argSlots : newNextBaseOffset);
+
+    const InterpreterFramePointer scratch = {
+        .values = &threadLocalStack.stack[scratchStart],
+        .contexts = &threadLocalStack.contexts[scratchStart],
+        .tags = &threadLocalStack.tags[scratchStart],
+        #ifndef NDEBUG
+        .frameLength = argSlots,
+        #endif
+    };
+    size_t offset = 0;
+    for(size_t i = 0; i < argCount; i++) {
+        const CubsTypeContext* context = cubs_frame_context_at(currentFrame, argsSrcs[i]);
+        assert(context == function->argsTypes[i]);
+        memcpy(cubs_frame_value_at(&scratch, offset), cubs_frame_value_at(currentFrame, argsSrcs[i]), context->sizeOfType);
+        cubs_frame_set_context_at(&scratch, offset, context);
+        offset += ROUND_SIZE_TO_MULTIPLE_OF_8(context->sizeOfType) / 8;
+    }
+    // Moved, so unwinding doesn't deinitialize them. Only after every argument is read, as the
+    // same slot may be passed more than once.
+    for(size_t i = 0; i < argCount; i++) {
+        cubs_frame_set_null_context_at(currentFrame, argsSrcs[i]);
+    }
+    cubs_interpreter_stack_unwind_frame();
+
+    // The reserved slots holding the previous frame's state are left as is
+    threadLocalStack.frame.frameLength = function->_stackSpaceRequired;
+    threadLocalStack.frame.optDestructorSlots = function->_destructorSlots;
+    threadLocalStack.nextBaseOffset = newNextBaseOffset;
+
+    const InterpreterFramePointer frame = cubs_interpreter_current_frame_pointer();
+    memcpy((void*)frame.values, (const void*)scratch.values, argSlots * sizeof(size_t));
+    memcpy((void*)frame.contexts, (const void*)scratch.contexts, argSlots * sizeof(uintptr_t));
+    memcpy((void*)frame.tags, (const void*)scratch.tags, argSlots);
+    // Slots past the top frame never hold a value that could be unwound
+    memset((void*)scratch.tags, SLOT_TAG_NONE, argSlots);
+    return frame;
+}
+
 void cubs_interpreter_pop_frame()
 {
     assert(threadLocalStack.nextBaseOffset != 0 && "No more frames to pop!");
@@ -65,14 +357,26 @@ void cubs_interpreter_pop_frame()
     const size_t oldFrameLength = basePointer[OLD_FRAME_LENGTH];
     void* const oldReturnValueDst = (void*)basePointer[OLD_RETURN_VALUE_DST];
     const CubsTypeContext** const oldReturnTagDst = (const CubsTypeContext**)basePointer[OLD_RETURN_CONTEXT_DST];
+    const uint64_t* const oldDestructorSlots = (const uint64_t*)basePointer[OLD_DESTRUCTOR_SLOTS];
 
     const InterpreterStackFrame newFrame = {
         .basePointerOffset = threadLocalStack.nextBaseOffset - oldFrameLength - RESERVED_SLOTS,
         .frameLength = oldFrameLength,
         .returnValueDst = oldReturnValueDst,
-        .returnContextDst = oldReturnTagDst
+        .returnContextDst = oldReturnTagDst,
+        .optDestructorSlots = oldDestructorSlots,
     };   
     threadLocalStack.frame = newFrame;
+    threadLocalStack.instructionPointer = (const Bytecode*)oldInstructionPointer;
+}
+
+void cubs_interpreter_reenter_frame(const InterpreterStackFrame* frame, void* returnValueDst, const CubsTypeContext** returnContextDst) {
+    assert(threadLocalStack.nextBaseOffset == frame->basePointerOffset && "Only the most recently popped frame can be re-entered");
+    InterpreterStackFrame reentered = *frame;
+    reentered.returnValueDst = returnValueDst;
+    reentered.returnContextDst = returnContextDst;
+    threadLocalStack.frame = reentered;
+    threadLocalStack.nextBaseOffset = frame->basePointerOffset + RESERVED_SLOTS + frame->frameLength;
 }
 
 InterpreterStackFrame cubs_interpreter_current_stack_frame()
@@ -85,81 +389,106 @@ const Bytecode *cubs_interpreter_get_instruction_pointer()
     return threadLocalStack.instructionPointer;
 }
 
-void *cubs_interpreter_stack_value_at(size_t offset)
+InterpreterFramePointer cubs_interpreter_current_frame_pointer()
 {
-    assert(offset < threadLocalStack.frame.frameLength);
-    return (void*)(&threadLocalStack.stack[threadLocalStack.frame.basePointerOffset + offset + RESERVED_SLOTS]);
+    const size_t start = threadLocalStack.frame.basePointerOffset + RESERVED_SLOTS;
+    const InterpreterFramePointer frame = {
+        .values = &threadLocalStack.stack[start],
+        .contexts = &threadLocalStack.contexts[start],
+        .tags = &threadLocalStack.tags[start],
+        #ifndef NDEBUG
+        .frameLength = threadLocalStack.frame.frameLength,
+        #endif
+    };
+    return frame;
 }
 
-const CubsTypeContext* cubs_interpreter_stack_context_at(size_t offset)
+void *cubs_interpreter_stack_value_at(size_t offset)
 {
-    assert(offset < threadLocalStack.frame.frameLength);
-    uintptr_t contextPtr = threadLocalStack.contexts[threadLocalStack.frame.basePointerOffset + offset + RESERVED_SLOTS];
-    // Mask away the ref tag bit
-    const CubsTypeContext* context = (const CubsTypeContext*)(contextPtr & ~(1ULL));
-    return context;
+    const InterpreterFramePointer frame = cubs_interpreter_current_frame_pointer();
+    return cubs_frame_value_at(&frame, offset);
 }
 
-const CubsTypeContext** cubs_interpreter_stack_context_ptr_at(size_t offset) 
+const CubsTypeContext* cubs_interpreter_stack_context_at(size_t offset)
 {
-    assert(offset < threadLocalStack.frame.frameLength);
-    return (const CubsTypeContext**)&threadLocalStack.contexts[threadLocalStack.frame.basePointerOffset + offset + RESERVED_SLOTS];
+    const InterpreterFramePointer frame = cubs_interpreter_current_frame_pointer();
+    return cubs_frame_context_at(&frame, offset);
 }
 
 bool cubs_is_owning_context_at(size_t offset) {
-    assert(offset < threadLocalStack.frame.frameLength);
-    uintptr_t contextPtr = threadLocalStack.contexts[threadLocalStack.frame.basePointerOffset + offset + RESERVED_SLOTS];
-
-    return (contextPtr & 1ULL) == 0;
+    const InterpreterFramePointer frame = cubs_interpreter_current_frame_pointer();
+    return cubs_frame_is_owning_context_at(&frame, offset);
 }
 
-static void stack_set_context_at(size_t offset, const CubsTypeContext* context, bool isReference) {
-    _Static_assert(_Alignof(CubsTypeContext) > 1, "Bottom bit needs to be free for internal use");
-    assert(ptr_is_aligned(context, _Alignof(CubsTypeContext)));
-    assert(offset < threadLocalStack.frame.frameLength);
-    assert((offset + context->sizeOfType) < ((threadLocalStack.frame.frameLength + 1) * sizeof(size_t)));
-
-    uintptr_t contextPtr = (uintptr_t)context;
-    uintptr_t refTag = (uintptr_t)isReference;
-    
-    threadLocalStack.contexts[threadLocalStack.frame.basePointerOffset + offset + RESERVED_SLOTS] = contextPtr | refTag;
-    if(context->sizeOfType > 8) {
-        for(size_t i = 1; i < (context->sizeOfType / 8); i++) {
-            threadLocalStack.contexts[threadLocalStack.frame.basePointerOffset + offset  + RESERVED_SLOTS + i] = (uintptr_t)NULL;
-        }
-    }
+static void unwind_slot(const InterpreterFramePointer* frame, size_t offset) {
+    cubs_context_fast_deinit(cubs_frame_value_at(frame, offset), cubs_frame_context_at(frame, offset));
+    cubs_frame_set_null_context_at(frame, offset);
 }
 
 void cubs_interpreter_stack_unwind_frame() {
-    uintptr_t* start = &threadLocalStack.contexts[threadLocalStack.frame.basePointerOffset + RESERVED_SLOTS];
-    for(size_t i = 0; i < threadLocalStack.frame.frameLength; i++) {
-        const CubsTypeContext* context = cubs_interpreter_stack_context_at(i);
-        const bool isOwningContext = cubs_is_owning_context_at(i);        
-        if(context == NULL || !isOwningContext) {
-            continue;
+    const InterpreterFramePointer frame = cubs_interpreter_current_frame_pointer();
+    const uint64_t* destructorSlots = threadLocalStack.frame.optDestructorSlots;
+
+    if(destructorSlots != NULL) {
+        // Only the slots the function could ever store an owned value with a full context in are checked.
+        // For functions that only use primitives, `destructorSlots[0]` is 0, so nothing is checked.
+        const uint64_t words = destructorSlots[0];
+        for(uint64_t word = 0; word < words; word++) {
+            uint64_t bits = destructorSlots[1 + word];
+            uint32_t bitIndex;
+            while(countTrailingZeroes64(&bitIndex, bits)) {
+                const size_t offset = (size_t)(word * 64) + bitIndex;
+                if(frame.tags[offset] == SLOT_TAG_CONTEXT) {
+                    unwind_slot(&frame, offset);
+                }
+                bits &= bits - 1;
+            }
         }
+        return;
+    }
 
-        cubs_context_fast_deinit(cubs_interpreter_stack_value_at(i), context);
-
-        // While technically it makes the most sense to set to NULL earlier, since nothing gets executed if the type has no destructor,
-        // leaving a previous context for a "dumb" type, such as an integer, is fine.
-        cubs_interpreter_stack_set_null_context_at(i); // set context to NULL
+    const size_t frameLength = threadLocalStack.frame.frameLength;
+
+    // Only owned values with a full context may need deinitializing, which are exactly the slots
+    // tagged `SLOT_TAG_CONTEXT`. Primitives, references, and empty slots are skipped 8 at a time.
+    const uint64_t ones = 0x0101010101010101ULL;
+    const uint64_t lowSevenBits = 0x7F7F7F7F7F7F7F7FULL;
+    size_t i = 0;
+    for(; (i + 8) <= frameLength; i += 8) {
+        uint64_t chunk;
+        memcpy((void*)&chunk, (const void*)&frame.tags[i], sizeof(uint64_t));
+        const uint64_t diff = chunk ^ (ones * SLOT_TAG_CONTEXT);
+        // High bit set in exactly the bytes of `diff` that are zero
+        uint64_t matches = ~(((diff & lowSevenBits) + lowSevenBits) | diff | lowSevenBits);
+        uint32_t bitIndex;
+        while(countTrailingZeroes64(&bitIndex, matches)) {
+            unwind_slot(&frame, i + (bitIndex / 8));
+            matches &= matches - 1;
+        }
+    }
+    for(; i < frameLength; i++) {
+        if(frame.tags[i] == SLOT_TAG_CONTEXT) {
+            unwind_slot(&frame, i);
+        }
     }
 }
 
 void cubs_interpreter_stack_set_context_at(size_t offset, const CubsTypeContext* context)
 {
-    stack_set_context_at(offset, context, false);
+    const InterpreterFramePointer frame = cubs_interpreter_current_frame_pointer();
+    cubs_frame_set_context_at(&frame, offset, context);
 }
 
 void cubs_interpreter_stack_set_reference_context_at(size_t offset, const CubsTypeContext *context)
 {
-    stack_set_context_at(offset, context, true);
+    const InterpreterFramePointer frame = cubs_interpreter_current_frame_pointer();
+    cubs_frame_set_reference_context_at(&frame, offset, context);
 }
 
 void cubs_interpreter_stack_set_null_context_at(size_t offset)
 {
-    threadLocalStack.contexts[threadLocalStack.frame.basePointerOffset + offset + RESERVED_SLOTS] = 0;
+    const InterpreterFramePointer frame = cubs_interpreter_current_frame_pointer();
+    cubs_frame_set_null_context_at(&frame, offset);
 }
 
 void cubs_interpreter_set_instruction_pointer(const Bytecode *newIp)
@@ -168,17 +497,27 @@ void cubs_interpreter_set_instruction_pointer(const Bytecode *newIp)
     threadLocalStack.instructionPointer = newIp;
 }
 
+/// Sets the context of an argument for a frame that hasn't been pushed yet.
+/// `actualOffset` is relative to the start of the whole stack.
+static void stack_set_arg_context(size_t actualOffset, const CubsTypeContext* context) {
+    const InterpreterFramePointer argSlots = {
+        .values = &threadLocalStack.stack[actualOffset],
+        .contexts = &threadLocalStack.contexts[actualOffset],
+        .tags = &threadLocalStack.tags[actualOffset],
+        #ifndef NDEBUG
+        .frameLength = ROUND_SIZE_TO_MULTIPLE_OF_8(context->sizeOfType) / 8,
+        #endif
+    };
+    cubs_frame_set_context_at(&argSlots, 0, context);
+}
+
 void cubs_interpreter_push_script_function_arg(const void *arg, const CubsTypeContext *context, size_t offset)
 {
     const size_t actualOffset = threadLocalStack.nextBaseOffset + RESERVED_SLOTS + offset;
+    stack_ensure_slots(actualOffset + (ROUND_SIZE_TO_MULTIPLE_OF_8(context->sizeOfType) / 8));
 
     memcpy((void*)&threadLocalStack.stack[actualOffset], arg, context->sizeOfType);
-    threadLocalStack.contexts[actualOffset] = (uintptr_t)context;
-    if(context->sizeOfType > 8) {
-        for(size_t i = 1; i < (context->sizeOfType / 8); i++) {
-            threadLocalStack.contexts[actualOffset + i] = (uintptr_t)NULL;
-        }
-    }
+    stack_set_arg_context(actualOffset, context);
 }
 
 void cubs_interpreter_push_c_function_arg(const void* arg, const struct CubsTypeContext* context, size_t offset, size_t currentArgCount, size_t argTrackOffset)
@@ -189,6 +528,8 @@ void cubs_interpreter_push_c_function_arg(const void* arg, const struct CubsType
     // otherwise it will be pushed further
     const size_t newArgTrackOffset = actualOffset + 
     (ROUND_SIZE_TO_MULTIPLE_OF_8(context->sizeOfType) / 8);
+    // argument count, followed by the uint16_t offsets array
+    stack_ensure_slots(newArgTrackOffset + 1 + (((currentArgCount + 1) * sizeof(uint16_t)) + sizeof(size_t) - 1) / sizeof(size_t));
     if(argTrackOffset > 0) { // with an offset other than 0, it means args have already been pushed.
         const size_t bytesToMove = sizeof(size_t) + (sizeof(size_t) * (1 + (currentArgCount / 4)));
         memmove((void*)&threadLocalStack.stack[newArgTrackOffset], (const void*)&threadLocalStack.stack[threadLocalStack.nextBaseOffset + RESERVED_SLOTS + argTrackOffset], bytesToMove); // `offset`
@@ -200,12 +541,7 @@ void cubs_interpreter_push_c_function_arg(const void* arg, const struct CubsType
     uint16_t* offsetsArrayStart = (uint16_t*)&threadLocalStack.stack[newArgTrackOffset + 1]; // one after the argument count tracker
     offsetsArrayStart[currentArgCount] = offset;
 
-    threadLocalStack.contexts[actualOffset] = (uintptr_t)context;
-    if(context->sizeOfType > 8) {
-        for(size_t i = 1; i < (context->sizeOfType / 8); i++) {
-            threadLocalStack.contexts[actualOffset + i] = (uintptr_t)NULL;
-        }
-    }
+    stack_set_arg_context(actualOffset, context);
 }
 
 CubsFunctionReturn cubs_interpreter_return_dst()
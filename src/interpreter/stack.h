@@ -3,6 +3,7 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <stddef.h>
+#include <assert.h>
 #include "value_tag.h"
 
 struct Bytecode;
@@ -11,8 +12,15 @@ struct CubsTypeContext;
 struct CubsScriptFunctionPtr;
 
 #ifndef CUBS_STACK_SLOTS
-/// 1 MB default (slots * 8 bytes per slot)
-#define CUBS_STACK_SLOTS (1 << 17)
+/// Default per-thread stack limit. Each slot is 8 bytes for the value, and 8 bytes for the context.
+/// The stack is only reserved on a thread's first use, and grows on demand up to the limit,
+/// so the limit costs address space, rather than memory. See `cubs_interpreter_set_stack_limit(...)`.
+#define CUBS_STACK_SLOTS (1 << 20)
+#endif
+
+#ifndef CUBS_COROUTINE_STACK_SLOTS
+/// Default stack limit of each coroutine's separate interpreter stack. See `coroutine.h`.
+#define CUBS_COROUTINE_STACK_SLOTS (1 << 16)
 #endif
 
 #define BITS_PER_STACK_OPERAND 13
@@ -24,6 +32,9 @@ typedef struct {
     /// Determines if `returnValueDst` and `returnTagDst` are pointers, or stack offsets
     void* returnValueDst;
     const CubsTypeContext** returnContextDst;
+    /// If NULL, unwinding checks every slot's tag. Otherwise, only the slots set in this
+    /// bitmap are checked. See `CubsScriptFunctionPtr._destructorSlots`.
+    const uint64_t* optDestructorSlots;
 } InterpreterStackFrame;
 
 enum InterpreterFrameReservedSlots {
@@ -31,33 +42,192 @@ enum InterpreterFrameReservedSlots {
     OLD_FRAME_LENGTH = 1,
     OLD_RETURN_VALUE_DST = 2,
     OLD_RETURN_CONTEXT_DST = 3,
-    RESERVED_SLOTS = 4,
+    OLD_DESTRUCTOR_SLOTS = 4,
+    RESERVED_SLOTS = 5,
 };
 
+/// Sets the calling thread's stack limit in slots. Panics if the thread is currently using
+/// it's stack. Defaults to `CUBS_STACK_SLOTS`.
+void cubs_interpreter_set_stack_limit(size_t slots);
+
+/// Gets the calling thread's stack limit in slots.
+size_t cubs_interpreter_stack_limit();
+
+/// Frees the calling thread's stack memory, which will be reserved again on next use.
+/// Happens automatically when a thread exits. Must not be called while the thread is using it's stack.
+void cubs_interpreter_stack_release();
+
+/// An interpreter stack, along with the frame and instruction pointer state of it's top frame.
+typedef struct InterpreterStackState InterpreterStackState;
+
+/// Creates an interpreter stack separate from any thread's, limited to `limitSlots`. Like thread stacks,
+/// it's only reserved on first use, but it grows in smaller steps, so many of them can be kept around cheaply.
+/// Executing on it requires swapping it in with `cubs_interpreter_stack_state_swap(...)`.
+InterpreterStackState* cubs_interpreter_stack_state_create(size_t limitSlots);
+
+/// Frees `state`. It must not have any frames on it, and must not be swapped in.
+void cubs_interpreter_stack_state_destroy(InterpreterStackState* state);
+
+/// Exchanges the calling thread's interpreter stack with `state`, so the thread executes on it.
+/// Calling it again with the same `state` swaps them back. Neither stack moves in memory, so
+/// frames on the swapped out stack, and pointers into them, remain valid until it's swapped back.
+void cubs_interpreter_stack_state_swap(InterpreterStackState* state);
+
 void cubs_interpreter_push_frame(size_t frameLength, void* returnValueDst, const struct CubsTypeContext** returnContextDst);
 
+/// Pushes a frame for executing `function`. Unlike `cubs_interpreter_push_frame(...)`, unwinding
+/// the frame only checks the slots in the function's destructor slots bitmap, rather than every slot.
+void cubs_interpreter_push_script_frame(const struct CubsScriptFunctionPtr* function, void* returnValueDst, const struct CubsTypeContext** returnContextDst);
+
 /// Operates on the calling thread's interpreter stack.
 void cubs_interpreter_pop_frame();
 
+/// Pushes `frame` again after it was popped, with a new return destination, such as to execute the same
+/// function many times. Nothing may have been pushed since it was popped. It's reserved slots are
+/// still as they were when it was first pushed, so only the frame state is restored, without writing them.
+void cubs_interpreter_reenter_frame(const InterpreterStackFrame* frame, void* returnValueDst, const struct CubsTypeContext** returnContextDst);
+
 /// Unwinds the current stack frame, deinitializing all objects.
 /// Does not pop the frame.
 void cubs_interpreter_stack_unwind_frame();
 
 InterpreterStackFrame cubs_interpreter_current_stack_frame();
- 
+
+/// Every stack slot has a 1 byte tag. Primitive types that don't need a destructor store
+/// their `CubsValueTag` as the tag, and never touch the slot's full context. All other
+/// types store `SLOT_TAG_CONTEXT`, with the full context pointer alongside it.
+/// The trailing slots of a multi-slot value, and slots without a value, are `SLOT_TAG_NONE`.
+enum InterpreterSlotTag {
+    SLOT_TAG_NONE = 0,
+    SLOT_TAG_BOOL = cubsValueTagBool,
+    SLOT_TAG_INT = cubsValueTagInt,
+    SLOT_TAG_FLOAT = cubsValueTagFloat,
+    SLOT_TAG_CHAR = cubsValueTagChar,
+    SLOT_TAG_CONTEXT = 0x7F,
+    /// Flags the value as non-owning (a reference), so it will not be deinitialized on unwind.
+    SLOT_TAG_REFERENCE_BIT = 0x80,
+    SLOT_TAG_KIND_MASK = 0x7F,
+};
+
+/// Indexed by the tag kinds below `SLOT_TAG_CONTEXT`.
+extern const struct CubsTypeContext* const _CUBS_SLOT_TAG_CONTEXTS[SLOT_TAG_CHAR + 1];
+
+/// Direct pointers into the current stack frame's values, contexts, and tags, past the reserved slots.
+/// The interpreter fetches this once per frame and passes a pointer to it to each operation,
+/// rather than recomputing the thread local stack address for every operand.
+/// Remains valid until the frame it was taken from is popped. Pushing and popping
+/// nested frames on top of it does not invalidate it.
+typedef struct InterpreterFramePointer {
+    size_t* values;
+    /// Only valid for slots tagged `SLOT_TAG_CONTEXT`.
+    uintptr_t* contexts;
+    /// See `enum InterpreterSlotTag`.
+    uint8_t* tags;
+    #ifndef NDEBUG
+    size_t frameLength;
+    #endif
+} InterpreterFramePointer;
+
+/// Operates on the calling thread's interpreter stack.
+InterpreterFramePointer cubs_interpreter_current_frame_pointer();
+
+/// Pushes a frame for executing `function` as `cubs_interpreter_push_script_frame(...)` does, copying
+/// the arguments at `argsSrcs` in `callerFrame` directly into it's slots, rather than through
+/// `cubs_interpreter_push_script_function_arg(...)`. `callerInstructionPointer` is restored when the
+/// frame is popped. Returns the new frame's frame pointer.
+InterpreterFramePointer cubs_interpreter_push_script_call_frame(
+    const struct CubsScriptFunctionPtr* function,
+    const InterpreterFramePointer* callerFrame,
+    const uint16_t* argsSrcs,
+    size_t argCount,
+    void* returnValueDst,
+    const struct CubsTypeContext** returnContextDst,
+    const struct Bytecode* callerInstructionPointer
+);
+
+/// Replaces the current frame with a frame for executing `function`, for a tail call from it. The
+/// arguments at `argsSrcs` in the current frame are moved into the new frame's first slots, then the
+/// rest of the current frame is unwound. The new frame returns to wherever the current frame would have,
+/// with the same return destination. Returns the new frame's frame pointer.
+InterpreterFramePointer cubs_interpreter_replace_script_call_frame(
+    const struct CubsScriptFunctionPtr* function,
+    const InterpreterFramePointer* currentFrame,
+    const uint16_t* argsSrcs,
+    size_t argCount
+);
+
+/// Equivalent to `cubs_interpreter_stack_value_at(...)`, without accessing the thread local stack.
+static inline void* cubs_frame_value_at(const InterpreterFramePointer* frame, size_t offset) {
+    assert(offset < frame->frameLength);
+    return (void*)&frame->values[offset];
+}
+
+/// Equivalent to `cubs_interpreter_stack_context_at(...)`, without accessing the thread local stack.
+static inline const struct CubsTypeContext* cubs_frame_context_at(const InterpreterFramePointer* frame, size_t offset) {
+    assert(offset < frame->frameLength);
+    const uint8_t kind = frame->tags[offset] & SLOT_TAG_KIND_MASK;
+    if(kind == SLOT_TAG_CONTEXT) {
+        return (const struct CubsTypeContext*)frame->contexts[offset];
+    }
+    assert(kind <= SLOT_TAG_CHAR);
+    return _CUBS_SLOT_TAG_CONTEXTS[kind];
+}
+
+/// Equivalent to `cubs_is_owning_context_at(...)`, without accessing the thread local stack.
+static inline bool cubs_frame_is_owning_context_at(const InterpreterFramePointer* frame, size_t offset) {
+    assert(offset < frame->frameLength);
+    return (frame->tags[offset] & SLOT_TAG_REFERENCE_BIT) == 0;
+}
+
+static inline void _cubs_frame_set_context_at(const InterpreterFramePointer* frame, size_t offset, const struct CubsTypeContext* context, bool isReference) {
+    assert(context != NULL);
+    assert(offset < frame->frameLength);
+    assert((offset + context->sizeOfType) < ((frame->frameLength + 1) * sizeof(size_t)));
+
+    const uint8_t refBit = isReference ? SLOT_TAG_REFERENCE_BIT : 0;
+    if(context == &CUBS_INT_CONTEXT) {
+        frame->tags[offset] = SLOT_TAG_INT | refBit;
+    } else if(context == &CUBS_BOOL_CONTEXT) {
+        frame->tags[offset] = SLOT_TAG_BOOL | refBit;
+    } else if(context == &CUBS_FLOAT_CONTEXT) {
+        frame->tags[offset] = SLOT_TAG_FLOAT | refBit;
+    } else if(context == &CUBS_CHAR_CONTEXT) {
+        frame->tags[offset] = SLOT_TAG_CHAR | refBit;
+    } else {
+        frame->contexts[offset] = (uintptr_t)context;
+        frame->tags[offset] = SLOT_TAG_CONTEXT | refBit;
+        if(context->sizeOfType > 8) {
+            for(size_t i = 1; i < (context->sizeOfType / 8); i++) {
+                frame->tags[offset + i] = SLOT_TAG_NONE;
+            }
+        }
+    }
+}
+
+/// Equivalent to `cubs_interpreter_stack_set_context_at(...)`, without accessing the thread local stack.
+static inline void cubs_frame_set_context_at(const InterpreterFramePointer* frame, size_t offset, const struct CubsTypeContext* context) {
+    _cubs_frame_set_context_at(frame, offset, context, false);
+}
+
+/// Equivalent to `cubs_interpreter_stack_set_reference_context_at(...)`, without accessing the thread local stack.
+static inline void cubs_frame_set_reference_context_at(const InterpreterFramePointer* frame, size_t offset, const struct CubsTypeContext* context) {
+    _cubs_frame_set_context_at(frame, offset, context, true);
+}
+
+/// Equivalent to `cubs_interpreter_stack_set_null_context_at(...)`, without accessing the thread local stack.
+static inline void cubs_frame_set_null_context_at(const InterpreterFramePointer* frame, size_t offset) {
+    assert(offset < frame->frameLength);
+    frame->tags[offset] = SLOT_TAG_NONE;
+}
+
 /// `offset` is an offset from the start of the current stack frame (excluding reserved slots) from as intervals of 8 bytes
 void* cubs_interpreter_stack_value_at(size_t offset);
 
 /// `offset` is an offset from the start of the current stack frame 
-/// (excluding reserved slots) from as intervals of 8 bytes. Masks away the 
-/// bit flag for if this is a non-owning context (reference).
+/// (excluding reserved slots) from as intervals of 8 bytes. Returns NULL if
+/// there is no value at `offset`.
 const struct CubsTypeContext* cubs_interpreter_stack_context_at(size_t offset);
 
-/// Gets the pointer to the actual place in the interpreter stack where the context at `offset` should be.
-/// It is up to the programmer to correct set the ref tag bit if necessary, or mask it away. The bit specifically is `0b01`.
-/// `offset` is an offset from the start of the current stack frame (excluding reserved slots) from as intervals of 8 bytes
-const struct CubsTypeContext** cubs_interpreter_stack_context_ptr_at(size_t offset);
-
 /// Gets if the context at `offset` is an owned value, meaning not a 
 /// TEMPORARY reference. Value instances of `CubsConstRef` and related for
 /// example will return true, as they are owned. However, when performing the
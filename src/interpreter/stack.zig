@@ -121,3 +121,46 @@ test "push function arg" {
         c.cubs_interpreter_stack_unwind_frame();
     }
 }
+
+test "stack grows on demand" {
+    const frameLength = 1000;
+    const frameCount = 30; // more than one commit chunk
+
+    var frameStarts: [frameCount][*]i64 = undefined;
+    for (0..frameCount) |i| {
+        c.cubs_interpreter_push_frame(frameLength, null, null);
+        frameStarts[i] = @ptrCast(@alignCast(c.cubs_interpreter_stack_value_at(0)));
+        for (0..frameLength) |j| {
+            @as(*i64, @ptrCast(@alignCast(c.cubs_interpreter_stack_value_at(j)))).* = @intCast((i * frameLength) + j);
+            c.cubs_interpreter_stack_set_context_at(j, &c.CUBS_INT_CONTEXT);
+        }
+    }
+    defer {
+        for (0..frameCount) |_| {
+            c.cubs_interpreter_stack_unwind_frame();
+            c.cubs_interpreter_pop_frame();
+        }
+    }
+
+    // Growing doesn't move earlier frames
+    for (0..frameCount) |i| {
+        for (0..frameLength) |j| {
+            try expect(frameStarts[i][j] == @as(i64, @intCast((i * frameLength) + j)));
+        }
+    }
+}
+
+test "stack limit" {
+    const defaultLimit = c.cubs_interpreter_stack_limit();
+    try expect(defaultLimit == c.CUBS_STACK_SLOTS);
+    defer c.cubs_interpreter_set_stack_limit(defaultLimit);
+
+    c.cubs_interpreter_set_stack_limit(100);
+    try expect(c.cubs_interpreter_stack_limit() == 100);
+
+    c.cubs_interpreter_push_frame(100 - 5, null, null);
+    defer c.cubs_interpreter_pop_frame();
+
+    const frame = c.cubs_interpreter_current_stack_frame();
+    try expect(frame.frameLength == 100 - 5);
+}
@@ -0,0 +1,876 @@
+#include "verifier.h"
+#include "bytecode.h"
+#include "operations.h"
+#include "function_definition.h"
+#include "value_tag.h"
+#include "../primitives/context.h"
+#include "../program/function_call_args.h"
+#include "../platform/mem.h"
+#include "../util/context_size_round.h"
+#include <assert.h>
+#include <string.h>
+
+/// The type of a slot that holds some value on every path, but not the same type on all of them,
+/// or one that can't be known ahead of time. A slot with no value is `NULL`.
+static const CubsTypeContext UNKNOWN_TYPE = {0};
+/// The state of a slot that holds a value on some paths, but not on others. Like a slot with no value,
+/// it can't be read until it's written, as the path taken at runtime may be one where it's uninitialized.
+static const CubsTypeContext MAYBE_UNINITIALIZED = {0};
+/// The state of the slots after the first of a multi slot value, on at least one path. The value's
+/// first slot is the nearest one before that isn't a tail. They can't be read, and writing to one
+/// would corrupt the value it's within.
+static const CubsTypeContext VALUE_TAIL = {0};
+
+typedef struct Verifier {
+    const CubsScriptFunctionPtr* function;
+    const Bytecode* bytecode;
+    size_t len;
+    size_t slotCount;
+    /// For each bytecode, the number of bytecodes of the operation starting there,
+    /// or 0 if it's within another operation.
+    size_t* operationLens;
+    /// For each bytecode, the index into `entryStates` if execution can continue to it
+    /// from anything other than the preceding operation, otherwise `SIZE_MAX`.
+    size_t* leaderIndices;
+    size_t leaderCount;
+    /// For each leader, the types of every slot on entry, merged from every path to it.
+    const CubsTypeContext** entryStates;
+    /// For each leader, if any path reaches it yet.
+    bool* reached;
+    /// Leaders whose entry state changed, and that need to be walked again.
+    size_t* pending;
+    size_t pendingLen;
+    bool* isPending;
+    size_t errorIndex;
+} Verifier;
+
+/// Up to 2 operations execution may continue to after one.
+typedef struct Successors {
+    size_t indices[2];
+    size_t len;
+} Successors;
+
+static size_t call_args_bytecode_required(size_t argCount) {
+    if((argCount % 4) == 0) {
+        return argCount / 4;
+    }
+    return (argCount / 4) + 1;
+}
+
+/// @return The number of bytecodes of the operation at `bytecode`, or 0 if it isn't valid.
+static size_t operation_len(const Bytecode* bytecode) {
+    const OpCode opcode = cubs_bytecode_get_opcode(*bytecode);
+    switch(opcode) {
+        case OpCodeLoad: {
+            const OperandsLoadUnknown unknownOperands = *(const OperandsLoadUnknown*)bytecode;
+            switch(unknownOperands.loadType) {
+                case LOAD_TYPE_IMMEDIATE: return 1;
+                case LOAD_TYPE_IMMEDIATE_LONG: return 2;
+                case LOAD_TYPE_DEFAULT: {
+                    const OperandsLoadDefault operands = *(const OperandsLoadDefault*)bytecode;
+                    // See `execute_load(...)`
+                    switch(operands.tag) {
+                        case cubsValueTagBool:
+                        case cubsValueTagInt:
+                        case cubsValueTagFloat:
+                        case cubsValueTagString:
+                            return 1;
+                        case cubsValueTagArray:
+                        case cubsValueTagSet:
+                        case cubsValueTagOption:
+                            return 2;
+                        case cubsValueTagMap:
+                            return 3;
+                        default:
+                            return 0;
+                    }
+                }
+                case LOAD_TYPE_CLONE_FROM_PTR: return 3;
+                default: return 0;
+            }
+        }
+        case OpCodeCall: {
+            const OperandsCallUnknown operands = *(const OperandsCallUnknown*)bytecode;
+            return 2 + call_args_bytecode_required(operands.argCount);
+        }
+        case OpCodeSync: {
+            const OperandsSync operands = *(const OperandsSync*)bytecode;
+            if(operands.opType == SYNC_TYPE_UNSYNC) {
+                return 1;
+            }
+            if(operands.num == 0) {
+                return 0;
+            }
+            return cubs_operands_sync_bytecode_required(operands.num);
+        }
+        case OpCodeCast: {
+            return 0;
+        }
+        default: {
+            if(opcode > OpCodeLoadImmediateAddInt) {
+                return 0;
+            }
+            return 1;
+        }
+    }
+}
+
+static size_t slots_for_type(const CubsTypeContext* context) {
+    return ROUND_SIZE_TO_MULTIPLE_OF_8(context->sizeOfType) / 8;
+}
+
+static bool is_known(const CubsTypeContext* type) {
+    return type != NULL && type != &UNKNOWN_TYPE && type != &MAYBE_UNINITIALIZED && type != &VALUE_TAIL;
+}
+
+static bool is_reference_type(const CubsTypeContext* type) {
+    return type == &CUBS_CONST_REF_CONTEXT
+    || type == &CUBS_MUT_REF_CONTEXT
+    || type == &CUBS_UNIQUE_CONTEXT
+    || type == &CUBS_SHARED_CONTEXT
+    || type == &CUBS_WEAK_CONTEXT;
+}
+
+#pragma region Slots
+
+static CubsBytecodeVerifyError check_slot(const Verifier* self, size_t slot) {
+    if(slot >= self->slotCount) {
+        return cubsBytecodeVerifyErrorSlotOutOfBounds;
+    }
+    return cubsBytecodeVerifyErrorNone;
+}
+
+/// Gets the type at `slot`, which must hold a value on every path.
+static CubsBytecodeVerifyError read_slot(const Verifier* self, const CubsTypeContext** state, size_t slot, const CubsTypeContext** outType) {
+    const CubsBytecodeVerifyError err = check_slot(self, slot);
+    if(err != cubsBytecodeVerifyErrorNone) {
+        return err;
+    }
+    if(state[slot] == NULL || state[slot] == &MAYBE_UNINITIALIZED || state[slot] == &VALUE_TAIL) {
+        return cubsBytecodeVerifyErrorUninitializedSlot;
+    }
+    *outType = state[slot];
+    return cubsBytecodeVerifyErrorNone;
+}
+
+/// `slot` must hold a value of exactly `expected` on every path.
+static CubsBytecodeVerifyError read_slot_expect(const Verifier* self, const CubsTypeContext** state, size_t slot, const CubsTypeContext* expected) {
+    const CubsTypeContext* type = NULL;
+    const CubsBytecodeVerifyError err = read_slot(self, state, slot, &type);
+    if(err != cubsBytecodeVerifyErrorNone) {
+        return err;
+    }
+    if(type != expected) {
+        return cubsBytecodeVerifyErrorTypeMismatch;
+    }
+    return cubsBytecodeVerifyErrorNone;
+}
+
+/// Both slots must hold a value, of the same type if it's known for both.
+static CubsBytecodeVerifyError read_slots_same_type(const Verifier* self, const CubsTypeContext** state, size_t slot1, size_t slot2, const CubsTypeContext** outType) {
+    const CubsTypeContext* type1 = NULL;
+    const CubsTypeContext* type2 = NULL;
+    CubsBytecodeVerifyError err = read_slot(self, state, slot1, &type1);
+    if(err != cubsBytecodeVerifyErrorNone) {
+        return err;
+    }
+    err = read_slot(self, state, slot2, &type2);
+    if(err != cubsBytecodeVerifyErrorNone) {
+        return err;
+    }
+    if(is_known(type1) && is_known(type2) && type1 != type2) {
+        return cubsBytecodeVerifyErrorTypeMismatch;
+    }
+    *outType = type1;
+    return cubsBytecodeVerifyErrorNone;
+}
+
+/// Clears the tails following `slot`, left behind when the value there is removed or overwritten.
+static void clear_tails(const Verifier* self, const CubsTypeContext** state, size_t slot) {
+    for(size_t i = slot + 1; i < self->slotCount && state[i] == &VALUE_TAIL; i++) {
+        state[i] = NULL;
+    }
+}
+
+/// Removes the value at `slot`, along with the rest of the slots it occupies.
+static void clear_slot(const Verifier* self, const CubsTypeContext** state, size_t slot) {
+    state[slot] = NULL;
+    clear_tails(self, state, slot);
+}
+
+/// Stores a value of `type` at `slot`, which must fit within the stack frame. Values starting within
+/// the slots it occupies are overwritten, as the interpreter clears their tags. A value it starts
+/// within keeps its tag however, so it would be read, or unwound, corrupted. That's rejected if the
+/// value may need its destructor run, and otherwise leaves it unreadable until it's written again.
+/// Values of unknown type are only tracked by their first slot, see `verifier.h`.
+static CubsBytecodeVerifyError write_slot(const Verifier* self, const CubsTypeContext** state, size_t slot, const CubsTypeContext* type) {
+    assert(type != NULL);
+    size_t slotsUsed = 1;
+    if(is_known(type)) {
+        slotsUsed = slots_for_type(type);
+        if(slotsUsed == 0) {
+            slotsUsed = 1;
+        }
+    }
+    if(slot >= self->slotCount || slotsUsed > (self->slotCount - slot)) {
+        return cubsBytecodeVerifyErrorSlotOutOfBounds;
+    }
+    if(state[slot] == &VALUE_TAIL) {
+        size_t start = slot;
+        while(state[start] == &VALUE_TAIL) {
+            assert(start > 0 && "A value tail must follow the value's first slot");
+            start -= 1;
+        }
+        const CubsTypeContext* overlapped = state[start];
+        if(!is_known(overlapped) || overlapped->destructor.func.externC != NULL) {
+            return cubsBytecodeVerifyErrorOverlappingValue;
+        }
+        state[start] = &MAYBE_UNINITIALIZED;
+        clear_tails(self, state, start);
+    }
+    clear_tails(self, state, slot + slotsUsed - 1);
+    state[slot] = type;
+    for(size_t i = 1; i < slotsUsed; i++) {
+        state[slot + i] = &VALUE_TAIL;
+    }
+    return cubsBytecodeVerifyErrorNone;
+}
+
+#pragma endregion
+
+#pragma region Operations
+
+#define TRY(expr) do { \
+    const CubsBytecodeVerifyError _err = (expr); \
+    if(_err != cubsBytecodeVerifyErrorNone) { \
+        return _err; \
+    } \
+} while(0)
+
+static CubsBytecodeVerifyError verify_load(const Verifier* self, const CubsTypeContext** state, const Bytecode* bytecode) {
+    const OperandsLoadUnknown unknownOperands = *(const OperandsLoadUnknown*)bytecode;
+    switch(unknownOperands.loadType) {
+        case LOAD_TYPE_IMMEDIATE: {
+            const OperandsLoadImmediate operands = *(const OperandsLoadImmediate*)bytecode;
+            const CubsTypeContext* type = operands.immediateType == LOAD_IMMEDIATE_BOOL ? &CUBS_BOOL_CONTEXT : &CUBS_INT_CONTEXT;
+            return write_slot(self, state, operands.dst, type);
+        }
+        case LOAD_TYPE_IMMEDIATE_LONG: {
+            const OperandsLoadImmediateLong operands = *(const OperandsLoadImmediateLong*)bytecode;
+            // The immediate is copied as is, which is only valid for 64 bit primitives
+            switch(operands.immediateValueTag) {
+                case cubsValueTagInt: return write_slot(self, state, operands.dst, &CUBS_INT_CONTEXT);
+                case cubsValueTagFloat: return write_slot(self, state, operands.dst, &CUBS_FLOAT_CONTEXT);
+                default: return cubsBytecodeVerifyErrorInvalidOperation;
+            }
+        }
+        case LOAD_TYPE_DEFAULT: {
+            const OperandsLoadDefault operands = *(const OperandsLoadDefault*)bytecode;
+            switch(operands.tag) {
+                case cubsValueTagBool: return write_slot(self, state, operands.dst, &CUBS_BOOL_CONTEXT);
+                case cubsValueTagInt: return write_slot(self, state, operands.dst, &CUBS_INT_CONTEXT);
+                case cubsValueTagFloat: return write_slot(self, state, operands.dst, &CUBS_FLOAT_CONTEXT);
+                case cubsValueTagString: return write_slot(self, state, operands.dst, &CUBS_STRING_CONTEXT);
+                case cubsValueTagArray: return write_slot(self, state, operands.dst, &CUBS_ARRAY_CONTEXT);
+                case cubsValueTagSet: return write_slot(self, state, operands.dst, &CUBS_SET_CONTEXT);
+                case cubsValueTagMap: return write_slot(self, state, operands.dst, &CUBS_MAP_CONTEXT);
+                case cubsValueTagOption: {
+                    TRY(write_slot(self, state, operands.dst, &CUBS_OPTION_CONTEXT));
+                    // `execute_load(...)` tags it as a set
+                    state[operands.dst] = &UNKNOWN_TYPE;
+                    return cubsBytecodeVerifyErrorNone;
+                }
+                default: return cubsBytecodeVerifyErrorInvalidOperation;
+            }
+        }
+        case LOAD_TYPE_CLONE_FROM_PTR: {
+            const OperandsLoadCloneFromPtr operands = *(const OperandsLoadCloneFromPtr*)bytecode;
+            const CubsTypeContext* context = (const CubsTypeContext*)bytecode[2].value;
+            if(bytecode[1].value == 0 || context == NULL || context->clone.func.externC == NULL) {
+                return cubsBytecodeVerifyErrorInvalidOperation;
+            }
+            return write_slot(self, state, operands.dst, context);
+        }
+        default: {
+            unreachable();
+        }
+    }
+}
+
+static CubsBytecodeVerifyError verify_call(const Verifier* self, const CubsTypeContext** state, const Bytecode* bytecode) {
+    const OperandsCallUnknown operands = *(const OperandsCallUnknown*)bytecode;
+    const uint16_t* argsSrcs = (const uint16_t*)&bytecode[2];
+
+    const CubsScriptFunctionPtr* callee = NULL;
+    if(operands.opType == CALL_TYPE_IMMEDIATE) {
+        const OperandsCallImmediate immediateOperands = *(const OperandsCallImmediate*)bytecode;
+        if(bytecode[1].value == 0) {
+            return cubsBytecodeVerifyErrorInvalidOperation;
+        }
+        if(immediateOperands.funcType == cubsFunctionPtrTypeScript) {
+            callee = (const CubsScriptFunctionPtr*)bytecode[1].value;
+        } else if(immediateOperands.funcType != cubsFunctionPtrTypeC) {
+            return cubsBytecodeVerifyErrorInvalidOperation;
+        }
+    } else {
+        const OperandsCallSrc srcOperands = *(const OperandsCallSrc*)bytecode;
+        TRY(read_slot_expect(self, state, srcOperands.funcSrc, &CUBS_FUNCTION_CONTEXT));
+    }
+
+    if(callee != NULL && callee->argsLen != operands.argCount) {
+        return cubsBytecodeVerifyErrorTypeMismatch;
+    }
+    for(size_t i = 0; i < operands.argCount; i++) {
+        const CubsTypeContext* argType = NULL;
+        TRY(read_slot(self, state, argsSrcs[i], &argType));
+        if(callee != NULL && is_known(argType) && argType != callee->argsTypes[i]) {
+            return cubsBytecodeVerifyErrorTypeMismatch;
+        }
+    }
+
+    if(operands.isTailCall) {
+        // Whatever the callee returns is returned in place of this function, rather than stored
+        if(operands.hasReturn) {
+            return cubsBytecodeVerifyErrorInvalidOperation;
+        }
+        if(callee != NULL && callee->returnType != self->function->returnType) {
+            return cubsBytecodeVerifyErrorTypeMismatch;
+        }
+        return cubsBytecodeVerifyErrorNone;
+    }
+    if(operands.hasReturn) {
+        if(callee == NULL) {
+            // C functions may return anything, or nothing
+            TRY(write_slot(self, state, operands.returnDst, &UNKNOWN_TYPE));
+        } else if(callee->returnType != NULL) {
+            TRY(write_slot(self, state, operands.returnDst, callee->returnType));
+        } else {
+            // Nothing is returned, leaving the slot as is
+            TRY(check_slot(self, operands.returnDst));
+        }
+    }
+    return cubsBytecodeVerifyErrorNone;
+}
+
+static CubsBytecodeVerifyError verify_sync(const Verifier* self, const CubsTypeContext** state, const Bytecode* bytecode) {
+    const OperandsSync operands = *(const OperandsSync*)bytecode;
+    if(operands.opType == SYNC_TYPE_UNSYNC) {
+        return cubsBytecodeVerifyErrorNone;
+    }
+    const CubsTypeContext* type = NULL;
+    TRY(read_slot(self, state, operands.src1.src, &type));
+    if(operands.num > 1) {
+        TRY(read_slot(self, state, operands.src2.src, &type));
+        const OperandsSyncLockSource* sources = (const OperandsSyncLockSource*)&bytecode[1];
+        for(size_t i = 0; i < (size_t)(operands.num - 2); i++) {
+            TRY(read_slot(self, state, sources[i].src, &type));
+        }
+    }
+    return cubsBytecodeVerifyErrorNone;
+}
+
+/// Applies the increment, `OpCodeIncrement` or `OpCodeIncrementInt`, at `bytecode`.
+static CubsBytecodeVerifyError verify_increment(const Verifier* self, const CubsTypeContext** state, Bytecode bytecode) {
+    const OperandsIncrementUnknown unknownOperands = *(const OperandsIncrementUnknown*)&bytecode;
+    // Only ints can be incremented, see `execute_increment(...)`
+    TRY(read_slot_expect(self, state, unknownOperands.src, &CUBS_INT_CONTEXT));
+    if(unknownOperands.opType == MATH_TYPE_DST) {
+        const OperandsIncrementDst operands = *(const OperandsIncrementDst*)&bytecode;
+        return write_slot(self, state, operands.dst, &CUBS_INT_CONTEXT);
+    }
+    return cubsBytecodeVerifyErrorNone;
+}
+
+/// Applies the add at `bytecode`, where both sources must be `expected`, or the same type if it's NULL.
+static CubsBytecodeVerifyError verify_add(const Verifier* self, const CubsTypeContext** state, Bytecode bytecode, const CubsTypeContext* expected) {
+    const OperandsAddUnknown unknownOperands = *(const OperandsAddUnknown*)&bytecode;
+    const CubsTypeContext* type = expected;
+    if(expected != NULL) {
+        TRY(read_slot_expect(self, state, unknownOperands.src1, expected));
+        TRY(read_slot_expect(self, state, unknownOperands.src2, expected));
+    } else {
+        TRY(read_slots_same_type(self, state, unknownOperands.src1, unknownOperands.src2, &type));
+    }
+    if(unknownOperands.opType == MATH_TYPE_DST) {
+        const OperandsAddDst operands = *(const OperandsAddDst*)&bytecode;
+        return write_slot(self, state, operands.dst, type);
+    }
+    return cubsBytecodeVerifyErrorNone;
+}
+
+/// Applies the compare at `bytecode`, where both sources must be `expected`, or the same type if it's NULL.
+static CubsBytecodeVerifyError verify_compare(const Verifier* self, const CubsTypeContext** state, Bytecode bytecode, const CubsTypeContext* expected) {
+    const OperandsUnknownCompare operands = *(const OperandsUnknownCompare*)&bytecode;
+    if(expected != NULL) {
+        TRY(read_slot_expect(self, state, operands.src1, expected));
+        TRY(read_slot_expect(self, state, operands.src2, expected));
+    } else {
+        const CubsTypeContext* type = NULL;
+        TRY(read_slots_same_type(self, state, operands.src1, operands.src2, &type));
+    }
+    return write_slot(self, state, operands.dst, &CUBS_BOOL_CONTEXT);
+}
+
+/// Target of the jump at `index`, which must be the start of an operation.
+static CubsBytecodeVerifyError jump_target(const Verifier* self, size_t index, size_t* outTarget) {
+    const OperandsJump operands = *(const OperandsJump*)&self->bytecode[index];
+    const int64_t target = (int64_t)index + (int64_t)operands.jumpAmount;
+    if(target < 0 || target >= (int64_t)self->len || self->operationLens[target] == 0) {
+        return cubsBytecodeVerifyErrorInvalidJumpTarget;
+    }
+    *outTarget = (size_t)target;
+    return cubsBytecodeVerifyErrorNone;
+}
+
+/// Applies the effects of the operation at `index` to `state`, and finds where execution may continue.
+static CubsBytecodeVerifyError verify_operation(const Verifier* self, const CubsTypeContext** state, size_t index, Successors* outSuccessors) {
+    const Bytecode* bytecode = &self->bytecode[index];
+    const size_t len = self->operationLens[index];
+    outSuccessors->indices[0] = index + len;
+    outSuccessors->len = 1;
+
+    const OpCode opcode = cubs_bytecode_get_opcode(*bytecode);
+    switch(opcode) {
+        case OpCodeNop: {
+            return cubsBytecodeVerifyErrorNone;
+        }
+        case OpCodeLoad: {
+            return verify_load(self, state, bytecode);
+        }
+        case OpCodeReturn: {
+            outSuccessors->len = 0;
+            const OperandsReturn operands = *(const OperandsReturn*)bytecode;
+            if(operands.hasReturn != (self->function->returnType != NULL)) {
+                return cubsBytecodeVerifyErrorTypeMismatch;
+            }
+            if(operands.hasReturn) {
+                const CubsTypeContext* type = NULL;
+                TRY(read_slot(self, state, operands.returnSrc, &type));
+                if(is_known(type) && type != self->function->returnType) {
+                    return cubsBytecodeVerifyErrorTypeMismatch;
+                }
+            }
+            return cubsBytecodeVerifyErrorNone;
+        }
+        case OpCodeCall: {
+            if(((const OperandsCallUnknown*)bytecode)->isTailCall) {
+                outSuccessors->len = 0;
+            }
+            return verify_call(self, state, bytecode);
+        }
+        case OpCodeJump: {
+            const OperandsJump operands = *(const OperandsJump*)bytecode;
+            size_t target = 0;
+            TRY(jump_target(self, index, &target));
+            switch(operands.opType) {
+                case JUMP_TYPE_DEFAULT: {
+                    outSuccessors->indices[0] = target;
+                } break;
+                case JUMP_TYPE_IF_TRUE:
+                case JUMP_TYPE_IF_FALSE: {
+                    TRY(read_slot_expect(self, state, operands.optSrc, &CUBS_BOOL_CONTEXT));
+                    outSuccessors->indices[1] = target;
+                    outSuccessors->len = 2;
+                } break;
+                default: {
+                    return cubsBytecodeVerifyErrorInvalidOperation;
+                }
+            }
+            return cubsBytecodeVerifyErrorNone;
+        }
+        case OpCodeDeinit: {
+            const OperandsDeinit operands = *(const OperandsDeinit*)bytecode;
+            const CubsTypeContext* type = NULL;
+            TRY(read_slot(self, state, operands.src, &type));
+            clear_slot(self, state, operands.src);
+            return cubsBytecodeVerifyErrorNone;
+        }
+        case OpCodeSync: {
+            return verify_sync(self, state, bytecode);
+        }
+        case OpCodeMove: {
+            const OperandsMove operands = *(const OperandsMove*)bytecode;
+            const CubsTypeContext* type = NULL;
+            TRY(read_slot(self, state, operands.src, &type));
+            clear_slot(self, state, operands.src);
+            return write_slot(self, state, operands.dst, type);
+        }
+        case OpCodeClone: {
+            const OperandsClone operands = *(const OperandsClone*)bytecode;
+            const CubsTypeContext* type = NULL;
+            TRY(read_slot(self, state, operands.src, &type));
+            if(is_known(type) && type->clone.func.externC == NULL) {
+                return cubsBytecodeVerifyErrorTypeMismatch;
+            }
+            return write_slot(self, state, operands.dst, type);
+        }
+        case OpCodeDereference: {
+            const OperandsDereference operands = *(const OperandsDereference*)bytecode;
+            const CubsTypeContext* type = NULL;
+            TRY(read_slot(self, state, operands.src, &type));
+            if(is_known(type) && !is_reference_type(type)) {
+                return cubsBytecodeVerifyErrorTypeMismatch;
+            }
+            return write_slot(self, state, operands.dst, &UNKNOWN_TYPE);
+        }
+        case OpCodeSetReference: {
+            const OperandsSetReference operands = *(const OperandsSetReference*)bytecode;
+            const CubsTypeContext* type = NULL;
+            TRY(read_slot(self, state, operands.dst, &type));
+            if(is_known(type) && (!is_reference_type(type) || type == &CUBS_CONST_REF_CONTEXT)) {
+                return cubsBytecodeVerifyErrorTypeMismatch;
+            }
+            return read_slot(self, state, operands.src, &type);
+        }
+        case OpCodeMakeReference: {
+            const OperandsMakeReference operands = *(const OperandsMakeReference*)bytecode;
+            const CubsTypeContext* type = NULL;
+            TRY(read_slot(self, state, operands.src, &type));
+            return write_slot(self, state, operands.dst, operands.mutable ? &CUBS_MUT_REF_CONTEXT : &CUBS_CONST_REF_CONTEXT);
+        }
+        case OpCodeGetMember: {
+            const OperandsGetMember operands = *(const OperandsGetMember*)bytecode;
+            const CubsTypeContext* type = NULL;
+            TRY(read_slot(self, state, operands.src, &type));
+            if(!is_known(type) || is_reference_type(type)) {
+                return write_slot(self, state, operands.dst, &UNKNOWN_TYPE);
+            }
+            if(operands.memberIndex >= type->membersLen) {
+                return cubsBytecodeVerifyErrorTypeMismatch;
+            }
+            return write_slot(self, state, operands.dst, type->members[operands.memberIndex].context);
+        }
+        case OpCodeSetMember: {
+            const OperandsSetMember operands = *(const OperandsSetMember*)bytecode;
+            const CubsTypeContext* dstType = NULL;
+            const CubsTypeContext* srcType = NULL;
+            TRY(read_slot(self, state, operands.dst, &dstType));
+            TRY(read_slot(self, state, operands.src, &srcType));
+            if(!is_known(dstType) || is_reference_type(dstType)) {
+                return cubsBytecodeVerifyErrorNone;
+            }
+            if(operands.memberIndex >= dstType->membersLen) {
+                return cubsBytecodeVerifyErrorTypeMismatch;
+            }
+            if(is_known(srcType) && srcType != dstType->members[operands.memberIndex].context) {
+                return cubsBytecodeVerifyErrorTypeMismatch;
+            }
+            return cubsBytecodeVerifyErrorNone;
+        }
+        case OpCodeEqual:
+        case OpCodeNotEqual:
+        case OpCodeLess:
+        case OpCodeGreater:
+        case OpCodeLessOrEqual:
+        case OpCodeGreaterOrEqual: {
+            return verify_compare(self, state, *bytecode, NULL);
+        }
+        case OpCodeEqualInt:
+        case OpCodeNotEqualInt:
+        case OpCodeLessInt:
+        case OpCodeGreaterInt:
+        case OpCodeLessOrEqualInt:
+        case OpCodeGreaterOrEqualInt: {
+            return verify_compare(self, state, *bytecode, &CUBS_INT_CONTEXT);
+        }
+        case OpCodeLessFloat:
+        case OpCodeGreaterFloat:
+        case OpCodeLessOrEqualFloat:
+        case OpCodeGreaterOrEqualFloat: {
+            return verify_compare(self, state, *bytecode, &CUBS_FLOAT_CONTEXT);
+        }
+        case OpCodeIncrement:
+        case OpCodeIncrementInt: {
+            return verify_increment(self, state, *bytecode);
+        }
+        case OpCodeAdd: {
+            return verify_add(self, state, *bytecode, NULL);
+        }
+        case OpCodeAddInt: {
+            return verify_add(self, state, *bytecode, &CUBS_INT_CONTEXT);
+        }
+        case OpCodeAddFloat: {
+            return verify_add(self, state, *bytecode, &CUBS_FLOAT_CONTEXT);
+        }
+        case OpCodeYield: {
+            const OperandsYield operands = *(const OperandsYield*)bytecode;
+            if(operands.hasValue) {
+                const CubsTypeContext* type = NULL;
+                TRY(read_slot(self, state, operands.src, &type));
+                clear_slot(self, state, operands.src);
+            }
+            return cubsBytecodeVerifyErrorNone;
+        }
+        case OpCodeIncrementLessIntJump: {
+            // The jump is read from the original jump 2 bytecodes later, see `execute_increment_less_int_jump(...)`
+            const OperandsIncrementLessIntJump operands = *(const OperandsIncrementLessIntJump*)bytecode;
+            if((index + 2) >= self->len || cubs_bytecode_get_opcode(bytecode[2]) != OpCodeJump) {
+                return cubsBytecodeVerifyErrorTruncated;
+            }
+            const OperandsJump jump = *(const OperandsJump*)&bytecode[2];
+            if(jump.opType == JUMP_TYPE_DEFAULT) {
+                return cubsBytecodeVerifyErrorInvalidOperation;
+            }
+            TRY(read_slot_expect(self, state, operands.src, &CUBS_INT_CONTEXT));
+            TRY(read_slot_expect(self, state, operands.compareSrc2, &CUBS_INT_CONTEXT));
+            TRY(write_slot(self, state, operands.compareDst, &CUBS_BOOL_CONTEXT));
+            outSuccessors->indices[0] = index + 3;
+            TRY(jump_target(self, index + 2, &outSuccessors->indices[1]));
+            outSuccessors->len = 2;
+            return cubsBytecodeVerifyErrorNone;
+        }
+        case OpCodeLoadImmediateAddInt: {
+            // Also executes the add that follows, see `execute_load_immediate_add_int(...)`
+            const OperandsLoadImmediateAddInt operands = *(const OperandsLoadImmediateAddInt*)bytecode;
+            if((index + 1) >= self->len || cubs_bytecode_get_opcode(bytecode[1]) != OpCodeAddInt) {
+                return cubsBytecodeVerifyErrorTruncated;
+            }
+            TRY(write_slot(self, state, operands.dst, &CUBS_INT_CONTEXT));
+            TRY(verify_add(self, state, bytecode[1], &CUBS_INT_CONTEXT));
+            outSuccessors->indices[0] = index + 2;
+            return cubsBytecodeVerifyErrorNone;
+        }
+        default: {
+            // Invalid opcodes are rejected when finding the operations
+            unreachable();
+        }
+    }
+}
+
+#pragma endregion
+
+#pragma region Control Flow
+
+static void mark_leader(Verifier* self, size_t index) {
+    if(index < self->len && self->leaderIndices[index] == SIZE_MAX) {
+        self->leaderIndices[index] = self->leaderCount;
+        self->leaderCount += 1;
+    }
+}
+
+/// Finds the start of every operation, and every operation execution may continue to from
+/// anything other than the operation before it.
+static CubsBytecodeVerifyError find_operations(Verifier* self) {
+    size_t i = 0;
+    while(i < self->len) {
+        const size_t len = operation_len(&self->bytecode[i]);
+        if(len == 0) {
+            self->errorIndex = i;
+            return cubsBytecodeVerifyErrorInvalidOperation;
+        }
+        if(len > (self->len - i)) {
+            self->errorIndex = i;
+            return cubsBytecodeVerifyErrorTruncated;
+        }
+        self->operationLens[i] = len;
+        i += len;
+    }
+
+    mark_leader(self, 0);
+    i = 0;
+    while(i < self->len) {
+        switch(cubs_bytecode_get_opcode(self->bytecode[i])) {
+            case OpCodeJump: {
+                size_t target = 0;
+                const CubsBytecodeVerifyError err = jump_target(self, i, &target);
+                if(err != cubsBytecodeVerifyErrorNone) {
+                    self->errorIndex = i;
+                    return err;
+                }
+                mark_leader(self, target);
+                mark_leader(self, i + 1);
+            } break;
+            case OpCodeIncrementLessIntJump: {
+                // It's jump is also found on it's own
+                mark_leader(self, i + 3);
+            } break;
+            case OpCodeLoadImmediateAddInt: {
+                mark_leader(self, i + 2);
+            } break;
+            default: break;
+        }
+        i += self->operationLens[i];
+    }
+    return cubsBytecodeVerifyErrorNone;
+}
+
+/// The state of a slot where two paths join. Only ever moves from no value or a known type, to
+/// `UNKNOWN_TYPE`, to `MAYBE_UNINITIALIZED`, so walking the paths always ends. A tail on one path
+/// stays one if the other has no value there, as the value it's within may still be unwound.
+/// @return NULL with `outOverlapping` set if one path has a value within another path's value.
+static const CubsTypeContext* merge_slot(const CubsTypeContext* lhs, const CubsTypeContext* rhs, bool* outOverlapping) {
+    if(lhs == rhs) {
+        return lhs;
+    }
+    if(lhs == &VALUE_TAIL || rhs == &VALUE_TAIL) {
+        if(lhs == NULL || rhs == NULL) {
+            return &VALUE_TAIL;
+        }
+        *outOverlapping = true;
+        return NULL;
+    }
+    if(lhs == NULL || rhs == NULL || lhs == &MAYBE_UNINITIALIZED || rhs == &MAYBE_UNINITIALIZED) {
+        return &MAYBE_UNINITIALIZED;
+    }
+    return &UNKNOWN_TYPE;
+}
+
+/// Merges `state` into the entry state of the leader at `index`, queueing it to be walked if it changed.
+static CubsBytecodeVerifyError merge_into_leader(Verifier* self, const CubsTypeContext** state, size_t index) {
+    const size_t leader = self->leaderIndices[index];
+    assert(leader != SIZE_MAX);
+    const CubsTypeContext** entry = &self->entryStates[leader * self->slotCount];
+
+    bool changed = false;
+    if(!self->reached[leader]) {
+        self->reached[leader] = true;
+        if(self->slotCount > 0) {
+            memcpy((void*)entry, (const void*)state, sizeof(const CubsTypeContext*) * self->slotCount);
+        }
+        changed = true;
+    } else {
+        for(size_t slot = 0; slot < self->slotCount; slot++) {
+            bool overlapping = false;
+            const CubsTypeContext* merged = merge_slot(entry[slot], state[slot], &overlapping);
+            if(overlapping) {
+                return cubsBytecodeVerifyErrorOverlappingValue;
+            }
+            if(merged != entry[slot]) {
+                entry[slot] = merged;
+                changed = true;
+            }
+        }
+    }
+
+    if(changed && !self->isPending[leader]) {
+        self->isPending[leader] = true;
+        self->pending[self->pendingLen] = index;
+        self->pendingLen += 1;
+    }
+    return cubsBytecodeVerifyErrorNone;
+}
+
+/// Walks every path from the leader at `index`, until it reaches another leader.
+static CubsBytecodeVerifyError walk_from(Verifier* self, const CubsTypeContext** state, size_t index) {
+    const size_t leader = self->leaderIndices[index];
+    self->isPending[leader] = false;
+    if(self->slotCount > 0) {
+        memcpy((void*)state, (const void*)&self->entryStates[leader * self->slotCount], sizeof(const CubsTypeContext*) * self->slotCount);
+    }
+
+    size_t i = index;
+    while(true) {
+        Successors successors;
+        const CubsBytecodeVerifyError err = verify_operation(self, state, i, &successors);
+        if(err != cubsBytecodeVerifyErrorNone) {
+            self->errorIndex = i;
+            return err;
+        }
+        for(size_t s = 0; s < successors.len; s++) {
+            if(successors.indices[s] >= self->len) {
+                self->errorIndex = i;
+                return cubsBytecodeVerifyErrorTruncated;
+            }
+        }
+
+        if(successors.len == 1 && successors.indices[0] == (i + self->operationLens[i]) && self->leaderIndices[successors.indices[0]] == SIZE_MAX) {
+            i = successors.indices[0];
+            continue;
+        }
+        for(size_t s = 0; s < successors.len; s++) {
+            const CubsBytecodeVerifyError mergeErr = merge_into_leader(self, state, successors.indices[s]);
+            if(mergeErr != cubsBytecodeVerifyErrorNone) {
+                self->errorIndex = i;
+                return mergeErr;
+            }
+        }
+        return cubsBytecodeVerifyErrorNone;
+    }
+}
+
+#pragma endregion
+
+CubsBytecodeVerifyError cubs_function_verify(const CubsScriptFunctionPtr* function, size_t* outErrorIndex)
+{
+    assert(function != NULL);
+
+    Verifier self = {
+        .function = function,
+        .bytecode = cubs_function_bytecode_start(function),
+        .len = function->_bytecodeCount,
+        .slotCount = function->_stackSpaceRequired,
+        .errorIndex = 0,
+    };
+    if(self.len == 0) {
+        if(outErrorIndex != NULL) {
+            *outErrorIndex = 0;
+        }
+        return cubsBytecodeVerifyErrorTruncated;
+    }
+
+    // The entry state has the arguments, laid out as `cubs_interpreter_push_script_function_arg(...)` does
+    const size_t stateLen = self.slotCount > 0 ? self.slotCount : 1;
+    const CubsTypeContext** state = MALLOC_TYPE_ARRAY(const CubsTypeContext*, stateLen);
+    for(size_t i = 0; i < stateLen; i++) {
+        state[i] = NULL;
+    }
+    CubsBytecodeVerifyError err = cubsBytecodeVerifyErrorNone;
+    {
+        size_t offset = 0;
+        for(size_t i = 0; i < function->argsLen; i++) {
+            err = write_slot(&self, state, offset, function->argsTypes[i]);
+            if(err != cubsBytecodeVerifyErrorNone) {
+                break;
+            }
+            offset += slots_for_type(function->argsTypes[i]);
+        }
+    }
+    if(err != cubsBytecodeVerifyErrorNone) {
+        FREE_TYPE_ARRAY(const CubsTypeContext*, state, stateLen);
+        if(outErrorIndex != NULL) {
+            *outErrorIndex = 0;
+        }
+        return err;
+    }
+
+    self.operationLens = MALLOC_TYPE_ARRAY(size_t, self.len);
+    self.leaderIndices = MALLOC_TYPE_ARRAY(size_t, self.len);
+    for(size_t i = 0; i < self.len; i++) {
+        self.operationLens[i] = 0;
+        self.leaderIndices[i] = SIZE_MAX;
+    }
+    self.leaderCount = 0;
+
+    err = find_operations(&self);
+    if(err == cubsBytecodeVerifyErrorNone) {
+        const size_t statesLen = self.leaderCount * stateLen;
+        self.entryStates = MALLOC_TYPE_ARRAY(const CubsTypeContext*, statesLen);
+        self.reached = MALLOC_TYPE_ARRAY(bool, self.leaderCount);
+        self.isPending = MALLOC_TYPE_ARRAY(bool, self.leaderCount);
+        self.pending = MALLOC_TYPE_ARRAY(size_t, self.leaderCount);
+        self.pendingLen = 0;
+        for(size_t i = 0; i < self.leaderCount; i++) {
+            self.reached[i] = false;
+            self.isPending[i] = false;
+        }
+
+        err = merge_into_leader(&self, state, 0);
+        while(self.pendingLen > 0 && err == cubsBytecodeVerifyErrorNone) {
+            self.pendingLen -= 1;
+            err = walk_from(&self, state, self.pending[self.pendingLen]);
+        }
+
+        FREE_TYPE_ARRAY(const CubsTypeContext*, self.entryStates, statesLen);
+        FREE_TYPE_ARRAY(bool, self.reached, self.leaderCount);
+        FREE_TYPE_ARRAY(bool, self.isPending, self.leaderCount);
+        FREE_TYPE_ARRAY(size_t, self.pending, self.leaderCount);
+    }
+
+    FREE_TYPE_ARRAY(size_t, self.operationLens, self.len);
+    FREE_TYPE_ARRAY(size_t, self.leaderIndices, self.len);
+    FREE_TYPE_ARRAY(const CubsTypeContext*, state, stateLen);
+    if(err != cubsBytecodeVerifyErrorNone && outErrorIndex != NULL) {
+        *outErrorIndex = self.errorIndex;
+    }
+    return err;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <stddef.h>
+
+struct CubsScriptFunctionPtr;
+
+/*
+Bytecode verification. Verifying a script function once, after it's built, proves the properties that
+the interpreter otherwise only asserts per operation: every operand slot is within the function's stack
+frame, every multi bytecode operation is complete, every jump lands on the start of an operation, execution
+can't continue past the end, no slot is read unless it's written on every path to the read, no write lands
+within a value that may still be read or unwound, and operands of the type specialized operations, conditional
+jumps, and immediate calls always hold the type they expect.
+
+Types are tracked per slot through every path, merging where paths join, so a slot holding different types
+on different paths is only accepted by the generic operations, which branch on the type at runtime. Values
+accessed through references, or returned by C functions, are of unknown type, and only bounds checked by
+their first slot. Their size isn't known, so writes into the slots after the first of one aren't caught.
+The interpreter's checks are compiled out without asserts, so release builds rely on verification alone,
+and bytecode using values of unknown type must still be trusted not to overlap them.
+
+Functions compiled from scripts are always valid. Bytecode from anywhere else, such as a mod's program
+image, should be verified before any of it executes. See `cubs_program_load_image(...)`, which does so.
+*/
+
+typedef enum CubsBytecodeVerifyError {
+    cubsBytecodeVerifyErrorNone = 0,
+    /// An opcode or operation type that doesn't exist or can't be executed, such as loading a
+    /// type without a default value, or an immediate call to a NULL function.
+    cubsBytecodeVerifyErrorInvalidOperation = 1,
+    /// An operation extends past the end of the bytecode, or execution can continue past it.
+    cubsBytecodeVerifyErrorTruncated = 2,
+    /// An operand slot, or part of the value stored there, is outside of the stack frame.
+    cubsBytecodeVerifyErrorSlotOutOfBounds = 3,
+    /// A jump to outside of the bytecode, or into the middle of a multi bytecode operation.
+    cubsBytecodeVerifyErrorInvalidJumpTarget = 4,
+    /// A slot is read before any value is written to it, or after it was moved out of.
+    cubsBytecodeVerifyErrorUninitializedSlot = 5,
+    /// An operand may hold a different type than the operation requires.
+    cubsBytecodeVerifyErrorTypeMismatch = 6,
+    /// A write starts within a value that may need its destructor run, or paths join where one
+    /// has a value within the slots of another's.
+    cubsBytecodeVerifyErrorOverlappingValue = 7,
+
+    _CUBS_BYTECODE_VERIFY_ERROR_MAX_VALUE = 0x7FFFFFFF,
+} CubsBytecodeVerifyError;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Verifies the bytecode of `function`. Immediate calls to script functions must be set, including
+/// recursive calls, which can only be set after the function is built.
+/// @param outErrorIndex If not NULL, on error, is set to the index of the bytecode where it was found.
+CubsBytecodeVerifyError cubs_function_verify(const struct CubsScriptFunctionPtr* function, size_t* outErrorIndex);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
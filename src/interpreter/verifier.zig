@@ -0,0 +1,219 @@
+const std = @import("std");
+const expect = std.testing.expect;
+
+const c = @cImport({
+    @cInclude("interpreter/verifier.h");
+    @cInclude("interpreter/function_definition.h");
+    @cInclude("interpreter/bytecode.h");
+    @cInclude("interpreter/operations.h");
+    @cInclude("primitives/context.h");
+    @cInclude("program/program.h");
+    @cInclude("program/program_internal.h");
+});
+
+/// Builds `fn(n: int) int` with 3 stack slots from `bytecode`.
+fn build(program: *c.CubsProgram, bytecode: []const c.Bytecode) *const c.CubsScriptFunctionPtr {
+    var builder = c.FunctionBuilder{ .stackSpaceRequired = 3, .optReturnType = &c.CUBS_INT_CONTEXT };
+    defer c.cubs_function_builder_deinit(&builder);
+    c.cubs_function_builder_add_arg(&builder, &c.CUBS_INT_CONTEXT);
+    c.cubs_function_builder_push_bytecode_many(&builder, bytecode.ptr, bytecode.len);
+    return c.cubs_function_builder_build(&builder, program);
+}
+
+test "valid loop" {
+    var program = c.cubs_program_init(.{});
+    defer c.cubs_program_deinit(&program);
+
+    // mut i = 0; do { i += 1; } while(i < n); return i;
+    const func = build(&program, &[_]c.Bytecode{
+        c.operands_make_load_immediate(c.LOAD_IMMEDIATE_INT, 1, 0),
+        c.operands_make_increment_assign(false, 1),
+        c.cubs_operands_make_compare(c.COMPARE_OP_LESS, 2, 1, 0),
+        c.cubs_operands_make_jump(c.JUMP_TYPE_IF_TRUE, -2, 2),
+        c.operands_make_return(true, 1),
+    });
+    try expect(c.cubs_function_verify(func, null) == c.cubsBytecodeVerifyErrorNone);
+}
+
+test "invalid slots and jumps" {
+    var program = c.cubs_program_init(.{});
+    defer c.cubs_program_deinit(&program);
+
+    var errorIndex: usize = undefined;
+    {
+        const func = build(&program, &[_]c.Bytecode{
+            c.operands_make_load_immediate(c.LOAD_IMMEDIATE_INT, 3, 0),
+            c.operands_make_return(true, 3),
+        });
+        try expect(c.cubs_function_verify(func, &errorIndex) == c.cubsBytecodeVerifyErrorSlotOutOfBounds);
+        try expect(errorIndex == 0);
+    }
+    {
+        const func = build(&program, &[_]c.Bytecode{
+            c.cubs_operands_make_jump(c.JUMP_TYPE_DEFAULT, 5, 0),
+            c.operands_make_return(true, 0),
+        });
+        try expect(c.cubs_function_verify(func, &errorIndex) == c.cubsBytecodeVerifyErrorInvalidJumpTarget);
+        try expect(errorIndex == 0);
+    }
+    {
+        // Falls off the end without returning
+        const func = build(&program, &[_]c.Bytecode{
+            c.operands_make_load_immediate(c.LOAD_IMMEDIATE_INT, 1, 0),
+        });
+        try expect(c.cubs_function_verify(func, &errorIndex) == c.cubsBytecodeVerifyErrorTruncated);
+    }
+}
+
+test "uninitialized slots" {
+    var program = c.cubs_program_init(.{});
+    defer c.cubs_program_deinit(&program);
+
+    var errorIndex: usize = undefined;
+    {
+        const func = build(&program, &[_]c.Bytecode{
+            c.operands_make_add_dst(false, 2, 0, 1),
+            c.operands_make_return(true, 2),
+        });
+        try expect(c.cubs_function_verify(func, &errorIndex) == c.cubsBytecodeVerifyErrorUninitializedSlot);
+        try expect(errorIndex == 0);
+    }
+    {
+        // Moved out of
+        const func = build(&program, &[_]c.Bytecode{
+            c.cubs_operands_make_move(1, 0),
+            c.operands_make_return(true, 0),
+        });
+        try expect(c.cubs_function_verify(func, &errorIndex) == c.cubsBytecodeVerifyErrorUninitializedSlot);
+        try expect(errorIndex == 1);
+    }
+    {
+        // Slot 1 is only written when the jump isn't taken
+        const func = build(&program, &[_]c.Bytecode{
+            c.operands_make_load_immediate(c.LOAD_IMMEDIATE_BOOL, 2, 1),
+            c.cubs_operands_make_jump(c.JUMP_TYPE_IF_TRUE, 2, 2),
+            c.operands_make_load_immediate(c.LOAD_IMMEDIATE_INT, 1, 5),
+            c.operands_make_return(true, 1),
+        });
+        try expect(c.cubs_function_verify(func, &errorIndex) == c.cubsBytecodeVerifyErrorUninitializedSlot);
+        try expect(errorIndex == 3);
+    }
+}
+
+/// Builds `fn() string` with 8 stack slots from `bytecode`.
+fn buildString(program: *c.CubsProgram, bytecode: []const c.Bytecode) *const c.CubsScriptFunctionPtr {
+    var builder = c.FunctionBuilder{ .stackSpaceRequired = 8, .optReturnType = &c.CUBS_STRING_CONTEXT };
+    defer c.cubs_function_builder_deinit(&builder);
+    c.cubs_function_builder_push_bytecode_many(&builder, bytecode.ptr, bytecode.len);
+    return c.cubs_function_builder_build(&builder, program);
+}
+
+test "overlapping values" {
+    var program = c.cubs_program_init(.{});
+    defer c.cubs_program_deinit(&program);
+
+    // A string occupies slots 1 to 4
+    var loadString: [1]c.Bytecode = undefined;
+    c.operands_make_load_default(&loadString, c.cubsValueTagString, 1, null, null);
+
+    var errorIndex: usize = undefined;
+    for ([_]u16{ 2, 4 }) |within| {
+        // Would leave the string's first slot corrupted, which is still returned, or unwound
+        const func = buildString(&program, &[_]c.Bytecode{
+            loadString[0],
+            c.operands_make_load_immediate(c.LOAD_IMMEDIATE_INT, within, 5),
+            c.operands_make_return(true, 1),
+        });
+        try expect(c.cubs_function_verify(func, &errorIndex) == c.cubsBytecodeVerifyErrorOverlappingValue);
+        try expect(errorIndex == 1);
+    }
+    {
+        // After the string, or once it's gone
+        const func = buildString(&program, &[_]c.Bytecode{
+            loadString[0],
+            c.operands_make_load_immediate(c.LOAD_IMMEDIATE_INT, 5, 5),
+            c.cubs_operands_make_deinit(1),
+            c.operands_make_load_immediate(c.LOAD_IMMEDIATE_INT, 3, 5),
+            loadString[0],
+            c.operands_make_return(true, 1),
+        });
+        try expect(c.cubs_function_verify(func, null) == c.cubsBytecodeVerifyErrorNone);
+    }
+    {
+        // One path has an int within the string the other path still holds
+        const func = buildString(&program, &[_]c.Bytecode{
+            loadString[0],
+            c.operands_make_load_immediate(c.LOAD_IMMEDIATE_BOOL, 0, 1),
+            c.cubs_operands_make_jump(c.JUMP_TYPE_IF_TRUE, 3, 0),
+            c.cubs_operands_make_deinit(1),
+            c.operands_make_load_immediate(c.LOAD_IMMEDIATE_INT, 2, 5),
+            c.operands_make_return(true, 1),
+        });
+        try expect(c.cubs_function_verify(func, null) == c.cubsBytecodeVerifyErrorOverlappingValue);
+    }
+}
+
+test "type mismatch" {
+    var program = c.cubs_program_init(.{});
+    defer c.cubs_program_deinit(&program);
+
+    var errorIndex: usize = undefined;
+    {
+        const func = build(&program, &[_]c.Bytecode{
+            c.operands_make_load_immediate(c.LOAD_IMMEDIATE_BOOL, 1, 1),
+            c.operands_make_add_dst(false, 2, 0, 1),
+            c.operands_make_return(true, 2),
+        });
+        try expect(c.cubs_function_verify(func, &errorIndex) == c.cubsBytecodeVerifyErrorTypeMismatch);
+        try expect(errorIndex == 1);
+    }
+    {
+        // Slot 1 is an int on one path, and a bool on the other. The generic add would
+        // branch on the type, but the specialized one can't.
+        const func = build(&program, &[_]c.Bytecode{
+            c.operands_make_load_immediate(c.LOAD_IMMEDIATE_BOOL, 2, 1),
+            c.operands_make_load_immediate(c.LOAD_IMMEDIATE_INT, 1, 0),
+            c.cubs_operands_make_jump(c.JUMP_TYPE_IF_TRUE, 2, 2),
+            c.operands_make_load_immediate(c.LOAD_IMMEDIATE_BOOL, 1, 0),
+            c.cubs_operands_specialize(c.operands_make_add_dst(false, 1, 0, 1), &c.CUBS_INT_CONTEXT),
+            c.operands_make_return(true, 1),
+        });
+        try expect(c.cubs_function_verify(func, &errorIndex) == c.cubsBytecodeVerifyErrorTypeMismatch);
+        try expect(errorIndex == 4);
+    }
+}
+
+test "tail calls" {
+    var program = c.cubs_program_init(.{});
+    defer c.cubs_program_deinit(&program);
+
+    // fn isZero(n: int) bool
+    var calleeBuilder = c.FunctionBuilder{ .stackSpaceRequired = 3, .optReturnType = &c.CUBS_BOOL_CONTEXT };
+    c.cubs_function_builder_add_arg(&calleeBuilder, &c.CUBS_INT_CONTEXT);
+    c.cubs_function_builder_push_bytecode(&calleeBuilder, c.operands_make_load_immediate(c.LOAD_IMMEDIATE_INT, 1, 0));
+    c.cubs_function_builder_push_bytecode(&calleeBuilder, c.cubs_operands_make_compare(c.COMPARE_OP_EQUAL, 2, 0, 1));
+    c.cubs_function_builder_push_bytecode(&calleeBuilder, c.operands_make_return(true, 2));
+    const isZero = c.cubs_function_builder_build(&calleeBuilder, &program);
+
+    const args = [_]u16{0};
+    var errorIndex: usize = undefined;
+    {
+        // Returns whatever the callee returns, so nothing after it needs to be reachable
+        var call: [3]c.Bytecode = undefined;
+        c.cubs_operands_make_call_immediate(&call, 3, 1, &args, false, 0, .{ .func = .{ .script = build(&program, &[_]c.Bytecode{
+            c.operands_make_return(true, 0),
+        }) }, .funcType = c.cubsFunctionPtrTypeScript });
+        c.cubs_operands_make_tail_call(&call);
+        const func = build(&program, &call);
+        try expect(c.cubs_function_verify(func, null) == c.cubsBytecodeVerifyErrorNone);
+    }
+    {
+        // An int function can't return the callee's bool
+        var call: [3]c.Bytecode = undefined;
+        c.cubs_operands_make_call_immediate(&call, 3, 1, &args, false, 0, .{ .func = .{ .script = isZero }, .funcType = c.cubsFunctionPtrTypeScript });
+        c.cubs_operands_make_tail_call(&call);
+        const func = build(&program, &call);
+        try expect(c.cubs_function_verify(func, &errorIndex) == c.cubsBytecodeVerifyErrorTypeMismatch);
+        try expect(errorIndex == 0);
+    }
+}
@@ -0,0 +1,33 @@
+#if !defined(_WIN32) && !defined(WIN32) && !defined(_POSIX_C_SOURCE)
+// Required for `clock_gettime(...)` when compiling as strict C11
+#define _POSIX_C_SOURCE 199309L
+#endif
+
+#include "clock.h"
+
+#if defined(_WIN32) || defined(WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+uint64_t _cubs_os_monotonic_ns() {
+    #if defined(_WIN32) || defined(WIN32)
+    static LARGE_INTEGER frequency = {0};
+    if(frequency.QuadPart == 0) {
+        // Fixed at boot, so racing threads store the same value
+        (void)QueryPerformanceFrequency(&frequency);
+    }
+    LARGE_INTEGER counter;
+    (void)QueryPerformanceCounter(&counter);
+    const uint64_t ticks = (uint64_t)counter.QuadPart;
+    const uint64_t hz = (uint64_t)frequency.QuadPart;
+    // Split to avoid overflowing the multiplication
+    return ((ticks / hz) * 1000000000ULL) + (((ticks % hz) * 1000000000ULL) / hz);
+    #else
+    struct timespec ts;
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+    #endif
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+#include <stdint.h>
+
+/// Nanoseconds from an arbitrary fixed point, only meaningful relative to other calls.
+/// Unlike the wall clock, it never jumps when the system time is changed, such as by NTP,
+/// so it's suitable for measuring elapsed time, and for deadlines.
+extern uint64_t _cubs_os_monotonic_ns();
@@ -1,3 +1,4 @@
+#include "mem.h"
 #include <assert.h>
 
 #if defined(_WIN32) || defined(WIN32)
@@ -7,8 +8,10 @@
 #include <memoryapi.h>
 #elif __GNUC__
 #include <stdlib.h>
-#include "mem.h"
 #include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
 #endif
 
 void* _cubs_raw_aligned_malloc(size_t len, size_t align) {
@@ -39,12 +42,105 @@ void* _cubs_os_malloc_pages(size_t len) {
 
 void _cubs_os_free_pages(void *pagesStart, size_t len) {
     #if defined(_WIN32) || defined(WIN32)
-    VirtualFree(pagesStart, len, MEM_DECOMMIT | MEM_RELEASE);
+    // MEM_RELEASE requires a length of 0, releasing the whole allocation
+    (void)len;
+    VirtualFree(pagesStart, 0, MEM_RELEASE);
     #elif __GNUC__
     munmap(pagesStart, len);
     #endif
 }
 
+void* _cubs_os_reserve_pages(size_t len) {
+    #if defined(_WIN32) || defined(WIN32)
+    return VirtualAlloc(NULL, len, MEM_RESERVE, PAGE_NOACCESS);
+    #elif __GNUC__
+    #ifdef MAP_NORESERVE
+    const int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE;
+    #else
+    const int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+    #endif
+    void* mem = mmap(NULL, len, PROT_NONE, flags, -1, 0);
+    if(mem == MAP_FAILED) {
+        return NULL;
+    }
+    return mem;
+    #endif
+}
+
+bool _cubs_os_commit_pages(void* pagesStart, size_t len) {
+    #if defined(_WIN32) || defined(WIN32)
+    return VirtualAlloc(pagesStart, len, MEM_COMMIT, PAGE_READWRITE) != NULL;
+    #elif __GNUC__
+    return mprotect(pagesStart, len, PROT_READ | PROT_WRITE) == 0;
+    #endif
+}
+
+bool _cubs_os_protect_pages_executable(void* pagesStart, size_t len) {
+    #if defined(_WIN32) || defined(WIN32)
+    DWORD oldProtect;
+    if(!VirtualProtect(pagesStart, len, PAGE_EXECUTE_READ, &oldProtect)) {
+        return false;
+    }
+    return FlushInstructionCache(GetCurrentProcess(), pagesStart, len) != 0;
+    #elif __GNUC__
+    return mprotect(pagesStart, len, PROT_READ | PROT_EXEC) == 0;
+    #endif
+}
+
+void* _cubs_os_map_file_private(const char* path, size_t* outLen) {
+    #if defined(_WIN32) || defined(WIN32)
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if(file == INVALID_HANDLE_VALUE) {
+        return NULL;
+    }
+    LARGE_INTEGER fileSize;
+    if(!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+        CloseHandle(file);
+        return NULL;
+    }
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+    CloseHandle(file);
+    if(mapping == NULL) {
+        return NULL;
+    }
+    // The view keeps the mapping alive
+    void* view = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+    CloseHandle(mapping);
+    if(view == NULL) {
+        return NULL;
+    }
+    *outLen = (size_t)fileSize.QuadPart;
+    return view;
+    #elif __GNUC__
+    const int fd = open(path, O_RDONLY);
+    if(fd < 0) {
+        return NULL;
+    }
+    struct stat fileStat;
+    if(fstat(fd, &fileStat) != 0 || fileStat.st_size <= 0) {
+        close(fd);
+        return NULL;
+    }
+    // The mapping keeps the file alive
+    void* mem = mmap(NULL, (size_t)fileStat.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(mem == MAP_FAILED) {
+        return NULL;
+    }
+    *outLen = (size_t)fileStat.st_size;
+    return mem;
+    #endif
+}
+
+void _cubs_os_unmap_file(void* mapping, size_t len) {
+    #if defined(_WIN32) || defined(WIN32)
+    (void)len;
+    UnmapViewOfFile(mapping);
+    #elif __GNUC__
+    munmap(mapping, len);
+    #endif
+}
+
 #ifndef CUBS_USING_ZIG_ALLOCATOR
 
 void *cubs_malloc(size_t len, size_t align) {
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <stddef.h>
+#include <stdbool.h>
 
 /// Will always return a valid pointer.
 /// When compiled with c/c++, using OS specific allocation. See `global_allocator.c`.
@@ -21,6 +22,28 @@ extern void* _cubs_os_malloc_pages(size_t len);
 
 extern void _cubs_os_free_pages(void* pagesStart, size_t len);
 
+/// Reserves `len` bytes of address space without making it usable. Commit ranges of it with
+/// `_cubs_os_commit_pages(...)` before accessing them, and free it with `_cubs_os_free_pages(...)`.
+/// Returns NULL on failure.
+extern void* _cubs_os_reserve_pages(size_t len);
+
+/// Makes `len` bytes of reserved address space starting at `pagesStart` readable and writable.
+/// `pagesStart` and `len` must be page aligned. Returns false on failure.
+extern bool _cubs_os_commit_pages(void* pagesStart, size_t len);
+
+/// Makes `len` bytes of pages starting at `pagesStart` readable and executable, and no longer writable,
+/// such as for machine code written to pages from `_cubs_os_malloc_pages(...)`. `pagesStart` must be
+/// page aligned. Returns false on failure.
+extern bool _cubs_os_protect_pages_executable(void* pagesStart, size_t len);
+
+/// Maps the whole file at `path` copy-on-write, so it's readable and writable, but writes stay private
+/// to the mapping, never reaching the file. Pages that aren't written to are shared with the OS file cache.
+/// Stores the file length in `outLen`. Free with `_cubs_os_unmap_file(...)`. Returns NULL on failure,
+/// or if the file is empty.
+extern void* _cubs_os_map_file_private(const char* path, size_t* outLen);
+
+extern void _cubs_os_unmap_file(void* mapping, size_t len);
+
 #define MALLOC_TYPE(T) ((T*)cubs_malloc(sizeof(T), _Alignof(T)))
 
 #define FREE_TYPE(T, ptr) (cubs_free((void*)ptr, sizeof(T), _Alignof(T)))
@@ -7,10 +7,13 @@
 #include "../primitives/error/error.h"
 #include "../primitives/result/result.h"
 #include "../primitives/sync_ptr/sync_ptr.h"
+#include "../primitives/sync_map/sync_map.h"
 #include "../primitives/function/function.h"
 #include "../primitives/reference/reference.h"
 #include "../util/panic.h"
+#include "../util/hash.h"
 #include <assert.h>
+#include <string.h>
 
 /*
 const CubsTypeContext CUBS__CONTEXT = {
@@ -88,7 +91,7 @@ static int bool_hash(CubsCFunctionHandler handler) {
     cubs_function_take_arg(&handler, 0, (void*)&self, &context);
     assert(context == &CUBS_CONST_REF_CONTEXT || context == &CUBS_MUT_REF_CONTEXT);
     assert(self.context == &CUBS_BOOL_CONTEXT);
-    int64_t hashed = *(const int64_t*)self.ref;
+    int64_t hashed = (int64_t)cubs_hash_u64((uint64_t)(*(const bool*)self.ref));
     cubs_function_return_set_value(handler, (void*)&hashed, &CUBS_INT_CONTEXT);
     return 0;
 }
@@ -170,7 +173,7 @@ static int int_hash(CubsCFunctionHandler handler) {
     cubs_function_take_arg(&handler, 0, (void*)&self, &context);
     assert(context == &CUBS_CONST_REF_CONTEXT || context == &CUBS_MUT_REF_CONTEXT);
     assert(self.context == &CUBS_INT_CONTEXT);
-    int64_t hashed = *(const int64_t*)self.ref;
+    int64_t hashed = (int64_t)cubs_hash_u64((uint64_t)(*(const int64_t*)self.ref));
     cubs_function_return_set_value(handler, (void*)&hashed, &CUBS_INT_CONTEXT);
     return 0;
 }
@@ -246,13 +249,23 @@ static CubsOrdering float_compare(CubsCFunctionHandler handler) {
     return 0;
 }
 
+/// Floats that compare equal must hash equally, so positive and negative zero are the same.
+static size_t float_hash_code(double value) {
+    if(value == 0.0) {
+        return cubs_hash_u64(0);
+    }
+    uint64_t bits;
+    memcpy((void*)&bits, (const void*)&value, sizeof(double));
+    return cubs_hash_u64(bits);
+}
+
 static int float_hash(CubsCFunctionHandler handler) {
     CubsConstRef self;
     const CubsTypeContext* context;
     cubs_function_take_arg(&handler, 0, (void*)&self, &context);
     assert(context == &CUBS_CONST_REF_CONTEXT || context == &CUBS_MUT_REF_CONTEXT);
     assert(self.context == &CUBS_FLOAT_CONTEXT);
-    int64_t hashed = (int64_t)(*(const double*)self.ref); // cast to integer cause silly float representation nonsense
+    int64_t hashed = (int64_t)float_hash_code(*(const double*)self.ref);
     cubs_function_return_set_value(handler, (void*)&hashed, &CUBS_INT_CONTEXT);
     return 0;
 }
@@ -334,7 +347,7 @@ static int char_hash(CubsCFunctionHandler handler) {
     cubs_function_take_arg(&handler, 0, (void*)&self, &context);
     assert(context == &CUBS_CONST_REF_CONTEXT || context == &CUBS_MUT_REF_CONTEXT);
     assert(self.context == &CUBS_CHAR_CONTEXT);
-    int64_t hashed = (int64_t)*(const CubsChar*)self.ref;
+    int64_t hashed = (int64_t)cubs_hash_u64((uint64_t)*(const CubsChar*)self.ref);
     cubs_function_return_set_value(handler, (void*)&hashed, &CUBS_INT_CONTEXT);
     return 0;
 }
@@ -946,6 +959,72 @@ const CubsTypeContext CUBS_WEAK_CONTEXT = {
 
 #pragma endregion
 
+#pragma region SyncMap
+
+static int sync_map_deinit(CubsCFunctionHandler handler) {
+    CubsSyncMap self;
+    const CubsTypeContext* context;
+    cubs_function_take_arg(&handler, 0, (void*)&self, &context);
+    assert(context == &CUBS_SYNC_MAP_CONTEXT);
+    cubs_sync_map_deinit(&self);
+    return 0;
+}
+
+static int sync_map_clone(CubsCFunctionHandler handler) {
+    CubsConstRef self;
+    const CubsTypeContext* context;
+    cubs_function_take_arg(&handler, 0, (void*)&self, &context);
+    assert(context == &CUBS_CONST_REF_CONTEXT || context == &CUBS_MUT_REF_CONTEXT);
+    assert(self.context == &CUBS_SYNC_MAP_CONTEXT);
+    CubsSyncMap clone = cubs_sync_map_clone((const CubsSyncMap*)self.ref);
+    cubs_function_return_set_value(handler, (void*)&clone, &CUBS_SYNC_MAP_CONTEXT); // explicitly const cast
+    return 0;
+}
+
+static int sync_map_eql(CubsCFunctionHandler handler) {
+    CubsConstRef lhs;
+    const CubsTypeContext* lhsContext;
+    CubsConstRef rhs;
+    const CubsTypeContext* rhsContext;
+
+    cubs_function_take_arg(&handler, 0, (void*)&lhs, &lhsContext);
+    cubs_function_take_arg(&handler, 1, (void*)&rhs, &rhsContext);
+
+    assert(lhsContext == &CUBS_CONST_REF_CONTEXT || lhsContext == &CUBS_MUT_REF_CONTEXT);
+    assert(lhs.context == &CUBS_SYNC_MAP_CONTEXT);
+    assert(rhsContext == &CUBS_CONST_REF_CONTEXT || rhsContext == &CUBS_MUT_REF_CONTEXT);
+    assert(rhs.context == &CUBS_SYNC_MAP_CONTEXT);
+
+    bool result = cubs_sync_map_eql((const CubsSyncMap*)lhs.ref, (const CubsSyncMap*)rhs.ref);
+    cubs_function_return_set_value(handler, (void*)&result, &CUBS_BOOL_CONTEXT);
+    return 0;
+}
+
+static int sync_map_hash(CubsCFunctionHandler handler) {
+    CubsConstRef self;
+    const CubsTypeContext* context;
+    cubs_function_take_arg(&handler, 0, (void*)&self, &context);
+    assert(context == &CUBS_CONST_REF_CONTEXT || context == &CUBS_MUT_REF_CONTEXT);
+    assert(self.context == &CUBS_SYNC_MAP_CONTEXT);
+    size_t hashed = cubs_sync_map_hash((const CubsSyncMap*)self.ref);
+    cubs_function_return_set_value(handler, (void*)&hashed, &CUBS_INT_CONTEXT);
+    return 0;
+}
+
+const CubsTypeContext CUBS_SYNC_MAP_CONTEXT = {
+    .sizeOfType = sizeof(CubsSyncMap),
+    .destructor = {.func = {.externC = &sync_map_deinit}, .funcType = cubsFunctionPtrTypeC},
+    .clone = {.func = {.externC = &sync_map_clone}, .funcType = cubsFunctionPtrTypeC},
+    .eql = {.func = {.externC = &sync_map_eql}, .funcType = cubsFunctionPtrTypeC},
+    .hash = {.func = {.externC = &sync_map_hash}, .funcType = cubsFunctionPtrTypeC},
+    .name = "sync_map",
+    .nameLength = 8,
+    .members = NULL,
+    .membersLen = 0,
+};
+
+#pragma endregion
+
 #pragma region Function
 
 static int function_clone(CubsCFunctionHandler handler) {
@@ -1144,6 +1223,8 @@ void cubs_context_fast_deinit(void *value, const CubsTypeContext *context)
         cubs_shared_deinit((CubsShared*)value);
     } else if (context == &CUBS_WEAK_CONTEXT) {
         cubs_weak_deinit((CubsWeak*)value);
+    } else if (context == &CUBS_SYNC_MAP_CONTEXT) {
+        cubs_sync_map_deinit((CubsSyncMap*)value);
     } else {
         CubsFunctionCallArgs args = cubs_function_start_call(&context->destructor);
         cubs_function_push_arg(&args, value, context);
@@ -1189,6 +1270,9 @@ void cubs_context_fast_clone(void *out, const void *value, const CubsTypeContext
     } else if(context == &CUBS_WEAK_CONTEXT) {
         const CubsWeak ret = cubs_weak_clone((const CubsWeak*)value);
         *(CubsWeak*)out = ret;
+    } else if(context == &CUBS_SYNC_MAP_CONTEXT) {
+        const CubsSyncMap ret = cubs_sync_map_clone((const CubsSyncMap*)value);
+        *(CubsSyncMap*)out = ret;
     } else if(context == &CUBS_FUNCTION_CONTEXT) {
         const CubsFunction ret = *(const CubsFunction*)value;
         *(CubsFunction*)out = ret;
@@ -1238,6 +1322,8 @@ bool cubs_context_fast_eql(const void *lhs, const void *rhs, const CubsTypeConte
         return cubs_shared_eql((const CubsShared*)lhs, (const CubsShared*)rhs);
     } else if(context == &CUBS_WEAK_CONTEXT) {
         return cubs_weak_eql((const CubsWeak*)lhs, (const CubsWeak*)rhs);
+    } else if(context == &CUBS_SYNC_MAP_CONTEXT) {
+        return cubs_sync_map_eql((const CubsSyncMap*)lhs, (const CubsSyncMap*)rhs);
     } else if(context == &CUBS_WEAK_CONTEXT) {
         return cubs_function_eql((const CubsFunction*)lhs, (const CubsFunction*)rhs);
     } else if(context == &CUBS_CONST_REF_CONTEXT) {
@@ -1316,13 +1402,13 @@ size_t cubs_context_fast_hash(const void *value, const CubsTypeContext *context)
 {
     assert(context->hash.func.externC != NULL && "Cannot do hash on type that doesn't have a valid externC or script function");
     if(context == &CUBS_BOOL_CONTEXT) {
-        return (size_t)(*(const bool*)value);
+        return cubs_hash_u64((uint64_t)(*(const bool*)value));
     } else if(context == &CUBS_INT_CONTEXT) {
-        return (size_t)(*(const int64_t*)value);
+        return cubs_hash_u64((uint64_t)(*(const int64_t*)value));
     } else if(context == &CUBS_FLOAT_CONTEXT) {
-        return (size_t)(int64_t)(*(const double*)value);
+        return float_hash_code(*(const double*)value);
     } else if(context == &CUBS_CHAR_CONTEXT) {
-        return (size_t)(int64_t)(*(const CubsChar*)value);
+        return cubs_hash_u64((uint64_t)(*(const CubsChar*)value));
     } else if(context == &CUBS_STRING_CONTEXT) {
         return cubs_string_hash((const CubsString*)value);
     } else if(context == &CUBS_SET_CONTEXT) {
@@ -1333,6 +1419,8 @@ size_t cubs_context_fast_hash(const void *value, const CubsTypeContext *context)
         return cubs_option_hash((const CubsOption*)value);
     } else if(context == &CUBS_ERROR_CONTEXT) {
         return cubs_error_hash((const CubsError*)value);
+    } else if(context == &CUBS_SYNC_MAP_CONTEXT) {
+        return cubs_sync_map_hash((const CubsSyncMap*)value);
     } else if(context == &CUBS_FUNCTION_CONTEXT) {
         return cubs_function_hash((const CubsFunction*)value);
     } else if(context == &CUBS_CONST_REF_CONTEXT) {
@@ -60,6 +60,7 @@ extern const CubsTypeContext CUBS_WEAK_CONTEXT;
 extern const CubsTypeContext CUBS_FUNCTION_CONTEXT;
 extern const CubsTypeContext CUBS_CONST_REF_CONTEXT;
 extern const CubsTypeContext CUBS_MUT_REF_CONTEXT;
+extern const CubsTypeContext CUBS_SYNC_MAP_CONTEXT;
 
 void cubs_context_fast_deinit(void* value, const CubsTypeContext* context);
 
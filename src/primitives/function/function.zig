@@ -194,6 +194,7 @@ pub const CubsFunction = extern struct {
 
     pub extern fn cubs_function_init_c(func: CubsCFunctionPtr) Self;
     pub extern fn cubs_function_start_call(self: *const Self) CubsFunctionCallArgs;
+    pub extern fn cubs_function_call_batch(self: *const Self, argArrays: [*]const *const anyopaque, argStrides: [*]const usize, count: usize, outReturns: ?*anyopaque, optOutCompleted: ?*usize) callconv(.C) c_int;
 };
 
 pub const CubsCFunctionPtr = *const fn (CubsCFunctionHandler) callconv(.C) c_int;
@@ -210,6 +211,14 @@ pub const CubsScriptFunctionPtr = extern struct {
     argsLen: usize,
     _stackSpaceRequired: usize,
     _bytecodeCount: usize,
+    /// Bitmap of the stack slots that may ever hold an owned value that isn't a primitive,
+    /// meaning it could need a destructor. Unwinding skips all other slots.
+    /// `_destructorSlots[0]` is the number of bitmap words that follow.
+    _destructorSlots: [*]const u64,
+    /// Calls left until the JIT compiles the function, or 0 if it never will. See `jit.h`.
+    _jitCallsUntilCompile: usize,
+    /// Machine code the JIT compiled the function to, or NULL if it's interpreted. See `jit.h`.
+    _jitCode: ?*const anyopaque,
 };
 
 pub const CubsFunctionPtr = extern union { externC: CubsCFunctionPtr, script: *const CubsScriptFunctionPtr };
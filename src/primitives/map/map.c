@@ -14,85 +14,94 @@
 
 static const size_t GROUP_ALLOC_SIZE = 32;
 static const size_t ALIGNMENT = 32;
+/// The hash code stored in an erased entry. Keys that actually hash to this value are stored with
+/// a hash code of 1 instead. See `map_normalize_hash_code(...)`.
+static const size_t ERASED_HASH_CODE = 0;
 
-typedef struct PairHeader PairHeader;
+/*
+The key/value pairs are stored inline within a single contiguous entry buffer, in insertion order.
+Each entry is an `EntryHeader`, followed by the key, followed by the value, with the key and value
+both rounded up to a multiple of 8 bytes. Entries are never individually allocated.
 
-typedef struct PairHeader {
+The groups hold the SIMD scanned hash masks, along with the index of the entry that each hash mask refers to.
+Growing the groups or the entry buffer only moves these indices and the entry memory, so no per-pair fixup is needed.
+
+Erasing a pair leaves behind an entry with `ERASED_HASH_CODE`, preserving the insertion order of the rest.
+These holes are skipped during iteration, and compacted away once the entry buffer is full.
+*/
+
+typedef struct EntryHeader {
     size_t hashCode;
-    PairHeader* iterBefore;
-    PairHeader* iterAfter;
-} PairHeader;
+} EntryHeader;
 
 typedef struct {
-    /// The actual pairs start at `&hashMasks[capacity]`
+    /// The entry indices start at `&hashMasks[capacity]`
     uint8_t* hashMasks;
-    uint32_t pairCount; 
+    uint32_t pairCount;
     uint32_t capacity;
     // Use uint32_t to save 8 bytes in total. If a map has more than 4.29 billion entires in a single group,
     // then the load balancing and/or hashing implementation is poor.
     // uint16_t is not viable here because of forced alignment and padding.
 } Group;
 
-static size_t group_allocation_size(size_t requiredCapacity) {
-    assert(requiredCapacity % 32 == 0);
+typedef struct {
+    Group* groupsArray;
+    size_t groupCount;
+    size_t available;
+    /// Contiguous buffer of `entryCapacity` entries, each `map_entry_stride(...)` bytes.
+    uint8_t* entries;
+    /// Includes erased entries.
+    uint32_t entryCount;
+    uint32_t entryCapacity;
+} Metadata;
 
-    return requiredCapacity + (sizeof(void*) * requiredCapacity);
-}
+_Static_assert(sizeof(Metadata) <= sizeof(((CubsMap*)0)->_metadata), "Map metadata must fit within CubsMap._metadata");
 
-static const PairHeader** group_pair_buf_start(const Group* group) {
-    const PairHeader** bufStart = (const PairHeader**)&group->hashMasks[group->capacity];
-    return bufStart;
+/// Get the size in bytes of each entry, including it's header.
+static size_t map_entry_stride(const CubsTypeContext* keyContext, const CubsTypeContext* valueContext) {
+    return sizeof(EntryHeader) + ROUND_SIZE_TO_MULTIPLE_OF_8(keyContext->sizeOfType) + ROUND_SIZE_TO_MULTIPLE_OF_8(valueContext->sizeOfType);
 }
 
-static PairHeader** group_pair_buf_start_mut(Group* group) {
-    PairHeader** bufStart = (PairHeader**)&group->hashMasks[group->capacity];
-    return bufStart;
+/// Get the memory of the key of `entry`.
+static const void* entry_key(const EntryHeader* entry) {
+    return (const void*)(&entry[1]);
 }
 
-/// Get the memory of the key of `pair`.
-static const void* pair_key(const PairHeader* pair) {
-    return (const void*)(&pair[1]);
+/// Get the memory of the key of `entry`.
+static void* entry_key_mut(EntryHeader* entry) {
+    return (void*)(&entry[1]);
 }
 
-/// Get the memory of the key of `pair`.
-static void* pair_key_mut(PairHeader* pair) {
-    return (void*)(&pair[1]);
+/// Get the memory of the value of `entry`.
+static const void* entry_value(const EntryHeader* entry, const CubsTypeContext* keyContext) {
+    const char* keyByteStart = (const char*)(&entry[1]);
+    return (const void*)&(keyByteStart[ROUND_SIZE_TO_MULTIPLE_OF_8(keyContext->sizeOfType)]);
 }
 
-/// Get the memory of the value of `pair`.
-static const void* pair_value(const PairHeader* pair, size_t powOf8Size) {
-    const char* keyByteStart = (const char*)(&pair[1]);
-    return (const void*)&(keyByteStart[powOf8Size]);
+/// Get the memory of the value of `entry`.
+static void* entry_value_mut(EntryHeader* entry, const CubsTypeContext* keyContext) {
+    char* keyByteStart = (char*)(&entry[1]);
+    return (void*)&(keyByteStart[ROUND_SIZE_TO_MULTIPLE_OF_8(keyContext->sizeOfType)]);
 }
 
-/// Get the memory of the value of `pair`.
-static void* pair_value_mut(PairHeader* pair, size_t powOf8Size) {
-    char* keyByteStart = (char*)(&pair[1]);
-    return (void*)&(keyByteStart[powOf8Size]);
+static bool entry_is_erased(const EntryHeader* entry) {
+    return entry->hashCode == ERASED_HASH_CODE;
 }
 
-static void pair_deinit(PairHeader* pair, const CubsTypeContext* keyContext, const CubsTypeContext* valueContext, PairHeader** iterFirst, PairHeader** iterLast) {
-    // Change iterator doubly-linked list
-    PairHeader* before = pair->iterBefore;
-    PairHeader* after = pair->iterAfter;
-    if(before != NULL) { // If isn't first iter element
-        before->iterAfter = after; // If after is NULL this is still correct
-    } else {
-        *iterFirst = after; // If after is NULL this is still correct
-    }
-    if(after != NULL) { // If isn't last iter element
-        after->iterBefore = before; // If before is NULL this is still correct
-    } else {
-        *iterLast = before;
-    }
+static size_t group_allocation_size(size_t requiredCapacity) {
+    assert(requiredCapacity % 32 == 0);
 
-    const size_t keyRound8Size = ROUND_SIZE_TO_MULTIPLE_OF_8(keyContext->sizeOfType);
-    const size_t valueRound8Size = ROUND_SIZE_TO_MULTIPLE_OF_8(valueContext->sizeOfType);
-    
-    cubs_context_fast_deinit(pair_key_mut(pair), keyContext);
-    cubs_context_fast_deinit(pair_value_mut(pair, keyRound8Size), valueContext);
+    return requiredCapacity + (sizeof(uint32_t) * requiredCapacity);
+}
 
-    cubs_free((void*)pair, sizeof(PairHeader) + keyRound8Size + valueRound8Size, _Alignof(size_t));
+static const uint32_t* group_entry_indices(const Group* group) {
+    const uint32_t* bufStart = (const uint32_t*)&group->hashMasks[group->capacity];
+    return bufStart;
+}
+
+static uint32_t* group_entry_indices_mut(Group* group) {
+    uint32_t* bufStart = (uint32_t*)&group->hashMasks[group->capacity];
+    return bufStart;
 }
 
 static Group group_init() {
@@ -104,27 +113,12 @@ static Group group_init() {
     return group;
 }
 
-/// Free the group memory without deinitializing the pairs
+/// Free the group memory. The group does not own the entries.
 static void group_free(Group* self) {
     const size_t currentAllocationSize = group_allocation_size(self->capacity);
     cubs_free((void*)self->hashMasks, currentAllocationSize, ALIGNMENT);
 }
 
-/// Deinitialize the pairs, and free the group
-static void group_deinit(Group* self, const CubsTypeContext* keyContext, const CubsTypeContext* valueContext, PairHeader** iterFirst, PairHeader** iterLast) {
-    if(self->pairCount != 0) {
-        for(uint32_t i = 0; i < self->capacity; i++) {
-            if(self->hashMasks[i] == 0) {
-                continue;
-            }
-            
-            pair_deinit(group_pair_buf_start_mut(self)[i], keyContext, valueContext, iterFirst, iterLast);
-        }
-    }
-
-    group_free(self);
-}
-
 static void group_ensure_total_capacity(Group* self, size_t minCapacity) {
     if(minCapacity <= self->capacity) {
         return;
@@ -138,7 +132,7 @@ static void group_ensure_total_capacity(Group* self, size_t minCapacity) {
     memset(mem, 0, mallocCapacity);
 
     uint8_t* newHashMaskStart = (uint8_t*)mem;
-    void** newPairStart = (void**)&((uint8_t*)mem)[pairAllocCapacity];
+    uint32_t* newIndicesStart = (uint32_t*)&((uint8_t*)mem)[pairAllocCapacity];
     size_t moveIter = 0;
     for(uint32_t i = 0; i < self->capacity; i++) {
         if(self->hashMasks[i] == 0) {
@@ -146,8 +140,7 @@ static void group_ensure_total_capacity(Group* self, size_t minCapacity) {
         }
 
         newHashMaskStart[moveIter] = self->hashMasks[i];
-        // Copy over the pointer to the pair info, transferring ownership
-        newPairStart[moveIter] = group_pair_buf_start_mut(self)[i]; 
+        newIndicesStart[moveIter] = group_entry_indices(self)[i];
         moveIter += 1;
     }
 
@@ -158,8 +151,23 @@ static void group_ensure_total_capacity(Group* self, size_t minCapacity) {
     return;
 }
 
-/// Returns -1 if not found
-static size_t group_find(const Group* self, const void* key, const CubsTypeContext* keyContext, CubsHashPairBitmask pairMask) {   
+/// Checks if the key of an entry is equal to the key being searched for, which may not be the same type as the entry's key.
+typedef bool (*KeyEqlFn)(const void* entryKey, const void* key, const CubsTypeContext* keyContext);
+
+static bool key_eql(const void* entryKey, const void* key, const CubsTypeContext* keyContext) {
+    assert(keyContext->eql.func.externC != NULL);
+    return cubs_context_fast_eql(entryKey, key, keyContext);
+}
+
+/// `key` is a `CubsStringSlice`, and the entry keys are `CubsString`.
+static bool key_eql_slice(const void* entryKey, const void* key, const CubsTypeContext* keyContext) {
+    assert(keyContext == &CUBS_STRING_CONTEXT);
+    return cubs_string_eql_slice((const CubsString*)entryKey, *(const CubsStringSlice*)key);
+}
+
+/// Returns -1 if not found. Otherwise returns the index of the hash mask and entry index within `self`.
+static size_t group_find(const Group* self, const void* key, const CubsTypeContext* keyContext, KeyEqlFn eql, size_t hashCode, const uint8_t* entries, size_t entryStride) {
+    const CubsHashPairBitmask pairMask = cubs_hash_pair_bitmask_init(hashCode);
     uint32_t i = 0;
     while(i < self->capacity) {
         uint32_t resultMask = _cubs_simd_cmpeq_mask_8bit_32wide_aligned(pairMask.value, &self->hashMasks[i]);
@@ -171,13 +179,11 @@ static size_t group_find(const Group* self, const void* key, const CubsTypeConte
             }
 
             const size_t actualIndex = index + i;
-            const void* pair = group_pair_buf_start(self)[actualIndex];
-            const void* pairKey = pair_key(pair);
-
-            assert(keyContext->eql.func.externC != NULL);
+            const EntryHeader* entry = (const EntryHeader*)&entries[group_entry_indices(self)[actualIndex] * entryStride];
 
+            // Comparing the full hash code first avoids most calls to the equality function.
             /// Because of C union alignment, and the sizes and alignments of the union members, this is valid.
-            if(!cubs_context_fast_eql(pairKey, key, keyContext)) {
+            if(entry->hashCode != hashCode || !eql(entry_key(entry), key, keyContext)) {
                 resultMask = (resultMask & ~(1U << index));
                 continue;
             }
@@ -188,31 +194,10 @@ static size_t group_find(const Group* self, const void* key, const CubsTypeConte
     return -1;
 }
 
-/// If the entry already exists, overrides the existing value.
-static void group_insert(Group* self, void* key, void* value, const CubsTypeContext* keyContext, const CubsTypeContext* valueContext, size_t hashCode, PairHeader** iterFirst, PairHeader** iterLast) {
-    #if _DEBUG
-    if(*iterLast != NULL) {
-        assert((*iterLast)->iterAfter == NULL);
-    }
-    #endif
-    
-    const CubsHashPairBitmask pairMask = cubs_hash_pair_bitmask_init(hashCode);
-    const size_t existingIndex = group_find(self, &key, keyContext, pairMask);
-    
-    if(existingIndex != -1) {
-        void* pair = group_pair_buf_start_mut(self)[existingIndex];
-        void* pairValue = pair_value_mut(pair, keyContext->sizeOfType);
-
-        cubs_context_fast_deinit(pairValue, valueContext);
-        memcpy(pairValue, value, valueContext->sizeOfType);
-
-        cubs_context_fast_deinit(key, keyContext);
-
-        return;
-    }
-
+/// Does not check if an entry with the same key already exists.
+static void group_insert_index(Group* self, CubsHashPairBitmask pairMask, uint32_t entryIndex) {
     group_ensure_total_capacity(self, self->pairCount + 1);
-  
+
     uint32_t i = 0;
     while(i < self->capacity) {
         size_t index;
@@ -221,31 +206,9 @@ static void group_insert(Group* self, void* key, void* value, const CubsTypeCont
             continue;
         }
 
-        const size_t keyRound8Size = ROUND_SIZE_TO_MULTIPLE_OF_8(keyContext->sizeOfType);
-        const size_t valueRound8Size = ROUND_SIZE_TO_MULTIPLE_OF_8(valueContext->sizeOfType);
-
-        PairHeader* newPair = (PairHeader*)cubs_malloc(sizeof(PairHeader) + keyRound8Size + valueRound8Size, _Alignof(size_t));
-        newPair->hashCode = hashCode;
-        newPair->iterBefore = *iterLast;
-        newPair->iterAfter = NULL;
-
-        if(*iterFirst == NULL) { // This is the first element in the map
-            *iterFirst = newPair;
-        }
-        if(*iterLast == NULL) {
-            *iterLast = newPair;
-        } else {
-            (*iterLast)->iterAfter = newPair;
-            (*iterLast) = newPair;
-        }
-
-
-        memcpy(pair_key_mut(newPair), key, keyContext->sizeOfType);
-        memcpy(pair_value_mut(newPair, keyRound8Size), value, valueContext->sizeOfType);
-    
         const size_t actualIndex = index + i;
         self->hashMasks[actualIndex] = pairMask.value;
-        group_pair_buf_start_mut(self)[actualIndex] = newPair;
+        group_entry_indices_mut(self)[actualIndex] = entryIndex;
 
         self->pairCount += 1;
         return;
@@ -254,28 +217,6 @@ static void group_insert(Group* self, void* key, void* value, const CubsTypeCont
     unreachable();
 }
 
-static bool group_erase(Group* self, const void* key, const CubsTypeContext* keyContext, const CubsTypeContext* valueContext, CubsHashPairBitmask pairMask, PairHeader** iterFirst, PairHeader** iterLast) {
-    const size_t found = group_find(self, key, keyContext, pairMask);
-    if(found == -1) {
-        return false;
-    }
-
-    self->hashMasks[found] = 0;
-    PairHeader* pair = group_pair_buf_start_mut(self)[found];
-    pair_deinit(pair, keyContext, valueContext, iterFirst, iterLast);
-    self->pairCount -= 1;
-
-    return true;
-}
-
-typedef struct {
-    Group* groupsArray;
-    size_t groupCount;
-    size_t available;
-    PairHeader* iterFirst;
-    PairHeader* iterLast;
-} Metadata;
-
 /// May return NULL
 static const Metadata* map_metadata(const CubsMap* self) {
     return (const Metadata*)&self->_metadata;
@@ -286,67 +227,252 @@ static Metadata* map_metadata_mut(CubsMap* self) {
     return (Metadata*)&self->_metadata;
 }
 
-static void map_ensure_total_capacity(CubsMap* self) {
-    Metadata* metadata = map_metadata_mut(self);
+/// Keeps real hash codes from being confused with erased entries.
+static size_t map_normalize_hash_code(size_t hashCode) {
+    if(hashCode == ERASED_HASH_CODE) {
+        return 1;
+    }
+    return hashCode;
+}
 
-    size_t newGroupCount;
-    {
-        if(metadata->groupCount == 0) {
-            newGroupCount = 1;
-        } else {
-            if(metadata->available != 0) {
-                return;
-            }
-            assert(metadata->groupCount != 0);
-            newGroupCount = metadata->groupCount << 1;
+static size_t map_hash_code(const void* key, const CubsTypeContext* keyContext) {
+    assert(keyContext->hash.func.externC != NULL);
+    return map_normalize_hash_code(cubs_context_fast_hash(key, keyContext));
+}
+
+static const Group* map_group_for(const Metadata* metadata, size_t hashCode) {
+    const CubsHashGroupBitmask groupBitmask = cubs_hash_group_bitmask_init(hashCode);
+    return &metadata->groupsArray[groupBitmask.value % metadata->groupCount];
+}
+
+static Group* map_group_for_mut(Metadata* metadata, size_t hashCode) {
+    const CubsHashGroupBitmask groupBitmask = cubs_hash_group_bitmask_init(hashCode);
+    return &metadata->groupsArray[groupBitmask.value % metadata->groupCount];
+}
+
+static const EntryHeader* map_entry_at(const Metadata* metadata, size_t entryIndex, size_t entryStride) {
+    return (const EntryHeader*)&metadata->entries[entryIndex * entryStride];
+}
+
+static EntryHeader* map_entry_at_mut(Metadata* metadata, size_t entryIndex, size_t entryStride) {
+    return (EntryHeader*)&metadata->entries[entryIndex * entryStride];
+}
+
+/// Places every non-erased entry of `metadata` into it's group. All of the groups must be empty.
+static void map_fill_groups_from_entries(Metadata* metadata, size_t entryStride) {
+    for(uint32_t i = 0; i < metadata->entryCount; i++) {
+        const EntryHeader* entry = map_entry_at(metadata, i, entryStride);
+        if(entry_is_erased(entry)) {
+            continue;
         }
+
+        Group* group = map_group_for_mut(metadata, entry->hashCode);
+        group_ensure_total_capacity(group, group->pairCount + 1);
+        // The groups are empty, so the pairs are packed at the start
+        group->hashMasks[group->pairCount] = cubs_hash_pair_bitmask_init(entry->hashCode).value;
+        group_entry_indices_mut(group)[group->pairCount] = i;
+        group->pairCount += 1;
     }
+}
+
+/// Replaces the groups with `newGroupCount` empty groups, and redistributes every pair into them.
+static void map_reallocate_groups(CubsMap* self, size_t newGroupCount) {
+    Metadata* metadata = map_metadata_mut(self);
 
     Group* newGroups = (Group*)cubs_malloc(sizeof(Group) * newGroupCount, _Alignof(Group));
     for(size_t i = 0; i < newGroupCount; i++) {
         newGroups[i] = group_init();
     }
 
+    const size_t availableEntries = GROUP_ALLOC_SIZE * newGroupCount;
+    const size_t newAvailable = ((availableEntries * 4) / 5) - self->len; // * 0.8 for load factor
+
+    if(metadata->groupCount != 0) {
+        for(size_t oldGroupCount = 0; oldGroupCount < metadata->groupCount; oldGroupCount++) {
+            group_free(&metadata->groupsArray[oldGroupCount]);
+        }
+        cubs_free((void*)metadata->groupsArray, sizeof(Group) * metadata->groupCount, _Alignof(Group));
+    }
+
+    metadata->available = newAvailable;
+    metadata->groupCount = newGroupCount;
+    metadata->groupsArray = newGroups;
+    // The entries store their hash codes, so they can be redistributed without rehashing any keys
+    map_fill_groups_from_entries(metadata, map_entry_stride(self->keyContext, self->valueContext));
+}
+
+/// Get the number of groups required to hold `capacity` pairs within the load factor.
+static size_t map_group_count_for_capacity(size_t capacity) {
+    size_t groupCount = 1;
+    while(((GROUP_ALLOC_SIZE * groupCount * 4) / 5) < capacity) { // * 0.8 for load factor
+        groupCount <<= 1;
+    }
+    return groupCount;
+}
+
+static void map_ensure_total_capacity(CubsMap* self) {
+    Metadata* metadata = map_metadata_mut(self);
     if(metadata->groupCount == 0) {
-        const size_t DEFAULT_AVAILABLE = (size_t)(((float)GROUP_ALLOC_SIZE) * 0.8f);
-        const Metadata newMetadata = {.available = DEFAULT_AVAILABLE, .groupCount = newGroupCount, .iterFirst = NULL, .iterLast = NULL, .groupsArray = newGroups};
-        *metadata = newMetadata;
+        map_reallocate_groups(self, 1);
+    } else if(metadata->available == 0) {
+        map_reallocate_groups(self, metadata->groupCount << 1);
+    }
+}
+
+/// Moves the non-erased entries to the front of the entry buffer, preserving their order.
+static void map_compact_entries(CubsMap* self, size_t entryStride) {
+    Metadata* metadata = map_metadata_mut(self);
+
+    uint32_t moveIter = 0;
+    for(uint32_t i = 0; i < metadata->entryCount; i++) {
+        const EntryHeader* entry = map_entry_at(metadata, i, entryStride);
+        if(entry_is_erased(entry)) {
+            continue;
+        }
+        if(moveIter != i) {
+            memcpy((void*)map_entry_at_mut(metadata, moveIter, entryStride), (const void*)entry, entryStride);
+        }
+        moveIter += 1;
+    }
+    assert(moveIter == self->len);
+    metadata->entryCount = moveIter;
+
+    // Every entry index has potentially changed
+    for(size_t i = 0; i < metadata->groupCount; i++) {
+        Group* group = &metadata->groupsArray[i];
+        memset((void*)group->hashMasks, 0, group->capacity);
+        group->pairCount = 0;
+    }
+    map_fill_groups_from_entries(metadata, entryStride);
+}
+
+static void map_reallocate_entries(CubsMap* self, size_t newCapacity, size_t entryStride) {
+    Metadata* metadata = map_metadata_mut(self);
+    assert(newCapacity >= metadata->entryCount);
+    if(newCapacity > UINT32_MAX) {
+        cubs_panic("CubicScript map exceeded the maximum number of entries");
+    }
+
+    uint8_t* newEntries = (uint8_t*)cubs_malloc(newCapacity * entryStride, _Alignof(size_t));
+    if(metadata->entries != NULL) {
+        memcpy((void*)newEntries, (const void*)metadata->entries, metadata->entryCount * entryStride);
+        cubs_free((void*)metadata->entries, metadata->entryCapacity * entryStride, _Alignof(size_t));
+    }
+    metadata->entries = newEntries;
+    metadata->entryCapacity = (uint32_t)newCapacity;
+}
+
+/// Ensures there is space in the entry buffer for at least one more entry.
+static void map_ensure_entry_capacity(CubsMap* self, size_t entryStride) {
+    Metadata* metadata = map_metadata_mut(self);
+    if(metadata->entryCount < metadata->entryCapacity) {
         return;
-    } else {
-        const size_t availableEntries = GROUP_ALLOC_SIZE * newGroupCount;
-        const size_t newAvailable = (availableEntries * 4) / 5; // * 0.8 for load factor
+    }
 
-        for(size_t oldGroupCount = 0; oldGroupCount < metadata->groupCount; oldGroupCount++) {
-            Group* oldGroup = &metadata->groupsArray[oldGroupCount];
-            if(oldGroup->pairCount != 0) {
-                for(uint32_t hashMaskIter = 0; hashMaskIter < oldGroup->capacity; hashMaskIter++) {
-                    if(oldGroup->hashMasks[hashMaskIter] == 0) {
-                        continue;
-                    }
-
-                    PairHeader* pair = group_pair_buf_start_mut(oldGroup)[hashMaskIter];
-                    const CubsHashGroupBitmask groupBitmask = cubs_hash_group_bitmask_init(pair->hashCode);
-                    const size_t groupIndex = groupBitmask.value % newGroupCount;
-
-                    Group* newGroup = &newGroups[groupIndex];
-                    group_ensure_total_capacity(newGroup, newGroup->pairCount + 1);
-                        
-                    newGroup->hashMasks[newGroup->pairCount] = oldGroup->hashMasks[hashMaskIter];
-                    group_pair_buf_start_mut(newGroup)[newGroup->pairCount] = pair; // Move pair to new group
-                    newGroup->pairCount += 1;
-                }
-            }
+    // If a sizeable portion of the entries have been erased, reclaim them rather than growing.
+    const size_t erasedCount = metadata->entryCount - self->len;
+    if(erasedCount != 0 && erasedCount >= (metadata->entryCount / 4)) {
+        map_compact_entries(self, entryStride);
+        return;
+    }
+
+    const size_t newCapacity = metadata->entryCapacity == 0 ? GROUP_ALLOC_SIZE : ((size_t)metadata->entryCapacity) << 1;
+    map_reallocate_entries(self, newCapacity, entryStride);
+}
 
-            group_free(oldGroup);
+/// Inserts `key` and `value`, where `hashCode` is the result of `map_hash_code(key, ...)`.
+/// The groups must already be able to hold another pair. See `map_ensure_total_capacity(...)`.
+static void map_insert_hashed(CubsMap* self, void* key, void* value, size_t hashCode, size_t entryStride) {
+    Metadata* metadata = map_metadata_mut(self);
+    assert(metadata->groupCount != 0);
+    Group* group = map_group_for_mut(metadata, hashCode);
+
+    const size_t existingIndex = group_find(group, key, self->keyContext, key_eql, hashCode, metadata->entries, entryStride);
+    if(existingIndex != -1) {
+        EntryHeader* entry = map_entry_at_mut(metadata, group_entry_indices(group)[existingIndex], entryStride);
+        void* entryValue = entry_value_mut(entry, self->keyContext);
+
+        cubs_context_fast_deinit(entryValue, self->valueContext);
+        memcpy(entryValue, value, self->valueContext->sizeOfType);
+
+        cubs_context_fast_deinit(key, self->keyContext);
+        return;
+    }
+
+    assert(metadata->available != 0);
+
+    // May compact the entries, which rewrites the groups' entry indices, but not which group a pair belongs to.
+    map_ensure_entry_capacity(self, entryStride);
+
+    const uint32_t entryIndex = metadata->entryCount;
+    EntryHeader* newEntry = map_entry_at_mut(metadata, entryIndex, entryStride);
+    newEntry->hashCode = hashCode;
+    memcpy(entry_key_mut(newEntry), key, self->keyContext->sizeOfType);
+    memcpy(entry_value_mut(newEntry, self->keyContext), value, self->valueContext->sizeOfType);
+    metadata->entryCount += 1;
+
+    group_insert_index(group, cubs_hash_pair_bitmask_init(hashCode), entryIndex);
+    self->len += 1;
+    metadata->available -= 1;
+}
+
+/// Returns NULL if `key` is not in the map. `hashCode` must already be normalized by `map_normalize_hash_code(...)`.
+static const EntryHeader* map_find_entry(const CubsMap* self, const void* key, KeyEqlFn eql, size_t hashCode) {
+    if(self->len == 0) {
+        return NULL;
+    }
+    const Metadata* metadata = map_metadata(self);
+
+    const Group* group = map_group_for(metadata, hashCode);
+    const size_t entryStride = map_entry_stride(self->keyContext, self->valueContext);
+
+    const size_t found = group_find(group, key, self->keyContext, eql, hashCode, metadata->entries, entryStride);
+    if(found == -1) {
+        return NULL;
+    }
+    return map_entry_at(metadata, group_entry_indices(group)[found], entryStride);
+}
+
+/// Returns the first non-erased entry starting at `entry`, or NULL if there are none.
+static const EntryHeader* map_live_entry_from(const Metadata* metadata, const uint8_t* entry, size_t entryStride) {
+    const uint8_t* entriesEnd = &metadata->entries[metadata->entryCount * entryStride];
+    while(entry < entriesEnd) {
+        if(!entry_is_erased((const EntryHeader*)entry)) {
+            return (const EntryHeader*)entry;
         }
+        entry = &entry[entryStride];
+    }
+    return NULL;
+}
 
-        if(metadata->groupCount > 0) {
-            cubs_free((void*)metadata->groupsArray, sizeof(Group) * metadata->groupCount, _Alignof(Group));
-        }     
+/// Returns the last non-erased entry before `entry`, or NULL if there are none.
+static const EntryHeader* map_live_entry_before(const Metadata* metadata, const uint8_t* entry, size_t entryStride) {
+    while(entry > metadata->entries) {
+        entry = entry - entryStride;
+        if(!entry_is_erased((const EntryHeader*)entry)) {
+            return (const EntryHeader*)entry;
+        }
+    }
+    return NULL;
+}
 
-        const Metadata newMetadata = {.available = newAvailable, .groupCount = newGroupCount, .iterFirst = metadata->iterFirst, .iterLast = metadata->iterLast, .groupsArray = newGroups};    
-        *metadata = newMetadata;     
+/// Returns the first non-erased entry, or NULL if there are none.
+static const EntryHeader* map_first_entry(const CubsMap* self) {
+    const Metadata* metadata = map_metadata(self);
+    if(self->len == 0) {
+        return NULL;
     }
+    return map_live_entry_from(metadata, metadata->entries, map_entry_stride(self->keyContext, self->valueContext));
+}
+
+/// Returns the last non-erased entry, or NULL if there are none.
+static const EntryHeader* map_last_entry(const CubsMap* self) {
+    const Metadata* metadata = map_metadata(self);
+    if(self->len == 0) {
+        return NULL;
+    }
+    const size_t entryStride = map_entry_stride(self->keyContext, self->valueContext);
+    return map_live_entry_before(metadata, &metadata->entries[metadata->entryCount * entryStride], entryStride);
 }
 
 // CubsMap cubs_map_init_primitives(CubsValueTag keyTag, CubsValueTag valueTag)
@@ -374,12 +500,29 @@ void cubs_map_deinit(CubsMap *self)
         return;
     }
 
-    for(size_t i = 0; i < metadata->groupCount; i++) {
-        group_deinit(&metadata->groupsArray[i], self->keyContext, self->valueContext, &metadata->iterFirst, &metadata->iterLast);
+    const size_t entryStride = map_entry_stride(self->keyContext, self->valueContext);
+    if(self->len != 0) {
+        for(uint32_t i = 0; i < metadata->entryCount; i++) {
+            EntryHeader* entry = map_entry_at_mut(metadata, i, entryStride);
+            if(entry_is_erased(entry)) {
+                continue;
+            }
+            cubs_context_fast_deinit(entry_key_mut(entry), self->keyContext);
+            cubs_context_fast_deinit(entry_value_mut(entry, self->keyContext), self->valueContext);
+        }
+    }
+    if(metadata->entries != NULL) {
+        cubs_free((void*)metadata->entries, metadata->entryCapacity * entryStride, _Alignof(size_t));
     }
 
+    for(size_t i = 0; i < metadata->groupCount; i++) {
+        group_free(&metadata->groupsArray[i]);
+    }
     cubs_free((void*)metadata->groupsArray, sizeof(Group) * metadata->groupCount, _Alignof(Group));
-    metadata->groupsArray = NULL;
+
+    const Metadata zeroed = {0};
+    *metadata = zeroed;
+    self->len = 0;
 }
 
 CubsMap cubs_map_clone(const CubsMap *self)
@@ -390,43 +533,43 @@ CubsMap cubs_map_clone(const CubsMap *self)
     }
 
     const Metadata* selfMetadata = map_metadata(self);
-    const size_t newGroupCount = selfMetadata->groupCount; // there probably is a more optimal way to do this
+    const size_t entryStride = map_entry_stride(self->keyContext, self->valueContext);
+
+    // The clone has the exact same layout, so the groups can be copied verbatim.
+    Group* newGroups = (Group*)cubs_malloc(sizeof(Group) * selfMetadata->groupCount, _Alignof(Group));
+    for(size_t i = 0; i < selfMetadata->groupCount; i++) {
+        const Group* group = &selfMetadata->groupsArray[i];
+        const size_t allocationSize = group_allocation_size(group->capacity);
+        void* mem = cubs_malloc(allocationSize, ALIGNMENT);
+        memcpy(mem, (const void*)group->hashMasks, allocationSize);
+
+        const Group newGroup = {.hashMasks = (uint8_t*)mem, .capacity = group->capacity, .pairCount = group->pairCount};
+        newGroups[i] = newGroup;
+    }
 
-    Group* newGroups = (Group*)cubs_malloc(sizeof(Group) * newGroupCount, _Alignof(Group));
-    for(size_t i = 0; i < newGroupCount; i++) {
-        newGroups[i] = group_init();
+    uint8_t* newEntries = (uint8_t*)cubs_malloc(selfMetadata->entryCapacity * entryStride, _Alignof(size_t));
+    for(uint32_t i = 0; i < selfMetadata->entryCount; i++) {
+        const EntryHeader* entry = map_entry_at(selfMetadata, i, entryStride);
+        EntryHeader* newEntry = (EntryHeader*)&newEntries[i * entryStride];
+        newEntry->hashCode = entry->hashCode;
+        if(entry_is_erased(entry)) {
+            continue;
+        }
+        cubs_context_fast_clone(entry_key_mut(newEntry), entry_key(entry), self->keyContext);
+        cubs_context_fast_clone(entry_value_mut(newEntry, self->keyContext), entry_value(entry, self->keyContext), self->valueContext);
     }
 
     CubsMap newSelf = cubs_map_init(self->keyContext, self->valueContext);
     newSelf.len = self->len;
     const Metadata newMetadataData = {
-        .available = ((GROUP_ALLOC_SIZE * newGroupCount * 4) / 5) - self->len, // * 0.8 for load factor
-        .groupCount = newGroupCount,
         .groupsArray = newGroups,
-        .iterFirst = NULL,
-        .iterLast = NULL,
+        .groupCount = selfMetadata->groupCount,
+        .available = selfMetadata->available,
+        .entries = newEntries,
+        .entryCount = selfMetadata->entryCount,
+        .entryCapacity = selfMetadata->entryCapacity,
     };
-    Metadata* newMetadata = map_metadata_mut(&newSelf);
-    *newMetadata = newMetadataData;
-
-    void* keyTempStorage = cubs_malloc(self->keyContext->sizeOfType, _Alignof(size_t));
-    void* valueTempStorage = cubs_malloc(self->valueContext->sizeOfType, _Alignof(size_t));
-
-    CubsMapConstIter iter = cubs_map_const_iter_begin(self);
-    size_t hashCode = ((PairHeader*)iter._nextIter)->hashCode;
-    while(cubs_map_const_iter_next(&iter)) {   
-        const CubsHashGroupBitmask groupBitmask = cubs_hash_group_bitmask_init(hashCode);
-        const size_t groupIndex = groupBitmask.value % newMetadata->groupCount;
-
-        cubs_context_fast_clone(keyTempStorage, iter.key, self->keyContext);
-        cubs_context_fast_clone(valueTempStorage, iter.value, self->valueContext);
-
-        group_insert(&newMetadata->groupsArray[groupIndex], keyTempStorage, valueTempStorage, self->keyContext, self->valueContext, hashCode, &newMetadata->iterFirst, &newMetadata->iterLast); 
-    }
-
-    cubs_free(keyTempStorage, self->keyContext->sizeOfType, _Alignof(size_t));
-    cubs_free(valueTempStorage, self->valueContext->sizeOfType, _Alignof(size_t));
-
+    *map_metadata_mut(&newSelf) = newMetadataData;
     return newSelf;
 }
 
@@ -435,22 +578,11 @@ const void* cubs_map_find(const CubsMap *self, const void *key)
     if(self->len == 0) {
         return NULL;
     }
-    const Metadata* metadata = map_metadata(self);
-
-    assert(self->keyContext->hash.func.externC != NULL);
-    const size_t hashCode = cubs_context_fast_hash(key, self->keyContext);
-    const CubsHashGroupBitmask groupBitmask = cubs_hash_group_bitmask_init(hashCode);
-    const size_t groupIndex = groupBitmask.value % metadata->groupCount;
-    const Group* group = &metadata->groupsArray[groupIndex];
-
-    const size_t found = group_find(group, key, self->keyContext, cubs_hash_pair_bitmask_init(hashCode));
-    if(found == -1) {
+    const EntryHeader* entry = map_find_entry(self, key, key_eql, map_hash_code(key, self->keyContext));
+    if(entry == NULL) {
         return NULL;
     }
-
-    const size_t round8Size = ROUND_SIZE_TO_MULTIPLE_OF_8(self->keyContext->sizeOfType);
-
-    return pair_value(group_pair_buf_start(group)[found], round8Size);
+    return entry_value(entry, self->keyContext);
 }
 
 void* cubs_map_find_mut(CubsMap *self, const void *key)
@@ -458,63 +590,181 @@ void* cubs_map_find_mut(CubsMap *self, const void *key)
     if(self->len == 0) {
         return NULL;
     }
-    Metadata* metadata = map_metadata_mut(self);
+    EntryHeader* entry = (EntryHeader*)map_find_entry(self, key, key_eql, map_hash_code(key, self->keyContext));
+    if(entry == NULL) {
+        return NULL;
+    }
+    return entry_value_mut(entry, self->keyContext);
+}
 
-    assert(self->keyContext->hash.func.externC != NULL);
-    const size_t hashCode = cubs_context_fast_hash(key, self->keyContext);
-    const CubsHashGroupBitmask groupBitmask = cubs_hash_group_bitmask_init(hashCode);
-    const size_t groupIndex = groupBitmask.value % metadata->groupCount;
-    Group* group = &metadata->groupsArray[groupIndex];
+const void* cubs_map_find_prehashed(const CubsMap *self, const void *key, size_t hashCode)
+{
+    assert(hashCode == cubs_context_fast_hash(key, self->keyContext) && "Precomputed hash code does not match the key");
+    const EntryHeader* entry = map_find_entry(self, key, key_eql, map_normalize_hash_code(hashCode));
+    if(entry == NULL) {
+        return NULL;
+    }
+    return entry_value(entry, self->keyContext);
+}
 
-    const size_t found = group_find(group, key, self->keyContext, cubs_hash_pair_bitmask_init(hashCode));
-    if(found == -1) {
+void* cubs_map_find_prehashed_mut(CubsMap *self, const void *key, size_t hashCode)
+{
+    assert(hashCode == cubs_context_fast_hash(key, self->keyContext) && "Precomputed hash code does not match the key");
+    EntryHeader* entry = (EntryHeader*)map_find_entry(self, key, key_eql, map_normalize_hash_code(hashCode));
+    if(entry == NULL) {
         return NULL;
     }
+    return entry_value_mut(entry, self->keyContext);
+}
 
-    const size_t round8Size = ROUND_SIZE_TO_MULTIPLE_OF_8(self->keyContext->sizeOfType);
+const void* cubs_map_find_slice(const CubsMap *self, CubsStringSlice key)
+{
+    assert(self->keyContext == &CUBS_STRING_CONTEXT && "Can only find a string slice in a map with string keys");
+    if(self->len == 0) {
+        return NULL;
+    }
+    const EntryHeader* entry = map_find_entry(self, (const void*)&key, key_eql_slice, map_normalize_hash_code(cubs_string_slice_hash(key)));
+    if(entry == NULL) {
+        return NULL;
+    }
+    return entry_value(entry, self->keyContext);
+}
 
-    return pair_value_mut(group_pair_buf_start_mut(group)[found], round8Size);
+void* cubs_map_find_slice_mut(CubsMap *self, CubsStringSlice key)
+{
+    assert(self->keyContext == &CUBS_STRING_CONTEXT && "Can only find a string slice in a map with string keys");
+    if(self->len == 0) {
+        return NULL;
+    }
+    EntryHeader* entry = (EntryHeader*)map_find_entry(self, (const void*)&key, key_eql_slice, map_normalize_hash_code(cubs_string_slice_hash(key)));
+    if(entry == NULL) {
+        return NULL;
+    }
+    return entry_value_mut(entry, self->keyContext);
 }
 
 void cubs_map_insert(CubsMap *self, void* key, void* value)
 {
     map_ensure_total_capacity(self);
-    
+
+    const size_t hashCode = map_hash_code(key, self->keyContext);
+    map_insert_hashed(self, key, value, hashCode, map_entry_stride(self->keyContext, self->valueContext));
+}
+
+void cubs_map_insert_prehashed(CubsMap *self, void* key, void* value, size_t hashCode)
+{
+    assert(hashCode == cubs_context_fast_hash(key, self->keyContext) && "Precomputed hash code does not match the key");
+    map_ensure_total_capacity(self);
+
+    map_insert_hashed(self, key, value, map_normalize_hash_code(hashCode), map_entry_stride(self->keyContext, self->valueContext));
+}
+
+void cubs_map_reserve(CubsMap *self, size_t minCapacity)
+{
+    if(minCapacity == 0) {
+        return;
+    }
+
     Metadata* metadata = map_metadata_mut(self);
-    
-    assert(self->keyContext->hash.func.externC != NULL);
-    const size_t hashCode = cubs_context_fast_hash(key, self->keyContext);
-    const CubsHashGroupBitmask groupBitmask = cubs_hash_group_bitmask_init(hashCode);
-    const size_t groupIndex = groupBitmask.value % metadata->groupCount;
 
-    group_insert(&metadata->groupsArray[groupIndex], key, value, self->keyContext, self->valueContext, hashCode, &metadata->iterFirst, &metadata->iterLast);
-    self->len += 1;
-    metadata->available -= 1;
+    const size_t newGroupCount = map_group_count_for_capacity(minCapacity);
+    if(newGroupCount > metadata->groupCount) {
+        map_reallocate_groups(self, newGroupCount);
+    }
+
+    const size_t entryStride = map_entry_stride(self->keyContext, self->valueContext);
+    // Erased entries still take up space in the buffer until they are compacted
+    if((minCapacity + (metadata->entryCount - self->len)) > metadata->entryCapacity) {
+        if(metadata->entryCount != self->len) {
+            map_compact_entries(self, entryStride);
+        }
+        if(minCapacity > metadata->entryCapacity) {
+            map_reallocate_entries(self, minCapacity, entryStride);
+        }
+    }
 }
 
-bool cubs_map_erase(CubsMap *self, const void *key)
+/// The number of keys hashed at once by `cubs_map_insert_many(...)`.
+#define INSERT_MANY_BATCH_SIZE 64
+
+void cubs_map_insert_many(CubsMap *self, void *keys, void *values, size_t count)
 {
-    if(self->len == 0) {
-        return false;
+    if(count == 0) {
+        return;
     }
 
+    // Presizing for every pair means the groups are redistributed at most once, rather than each time they fill up.
+    cubs_map_reserve(self, self->len + count);
+
+    const size_t entryStride = map_entry_stride(self->keyContext, self->valueContext);
+    const size_t keySize = self->keyContext->sizeOfType;
+    const size_t valueSize = self->valueContext->sizeOfType;
+    uint8_t* keyBytes = (uint8_t*)keys;
+    uint8_t* valueBytes = (uint8_t*)values;
+
+    size_t hashCodes[INSERT_MANY_BATCH_SIZE];
+    for(size_t batchStart = 0; batchStart < count; batchStart += INSERT_MANY_BATCH_SIZE) {
+        const size_t remaining = count - batchStart;
+        const size_t batchLen = remaining < INSERT_MANY_BATCH_SIZE ? remaining : INSERT_MANY_BATCH_SIZE;
+
+        // Hash the whole batch before touching any groups, so the hashing isn't stalled behind group lookups.
+        for(size_t i = 0; i < batchLen; i++) {
+            hashCodes[i] = map_hash_code((const void*)&keyBytes[(batchStart + i) * keySize], self->keyContext);
+        }
+        for(size_t i = 0; i < batchLen; i++) {
+            const size_t pairIndex = batchStart + i;
+            map_insert_hashed(self, (void*)&keyBytes[pairIndex * keySize], (void*)&valueBytes[pairIndex * valueSize], hashCodes[i], entryStride);
+        }
+    }
+}
+
+static bool map_erase_hashed(CubsMap *self, const void *key, size_t hashCode) {
     Metadata* metadata = map_metadata_mut(self);
+    const size_t entryStride = map_entry_stride(self->keyContext, self->valueContext);
 
-    assert(self->keyContext->hash.func.externC != NULL);
-    const size_t hashCode = cubs_context_fast_hash(key, self->keyContext);
-    const CubsHashGroupBitmask groupBitmask = cubs_hash_group_bitmask_init(hashCode);
-    const size_t groupIndex = groupBitmask.value % metadata->groupCount;
+    Group* group = map_group_for_mut(metadata, hashCode);
+
+    const size_t found = group_find(group, key, self->keyContext, key_eql, hashCode, metadata->entries, entryStride);
+    if(found == -1) {
+        return false;
+    }
+
+    EntryHeader* entry = map_entry_at_mut(metadata, group_entry_indices(group)[found], entryStride);
+    cubs_context_fast_deinit(entry_key_mut(entry), self->keyContext);
+    cubs_context_fast_deinit(entry_value_mut(entry, self->keyContext), self->valueContext);
+    entry->hashCode = ERASED_HASH_CODE;
+
+    group->hashMasks[found] = 0;
+    group->pairCount -= 1;
+
+    self->len -= 1;
+    metadata->available += 1;
+    if(self->len == 0) {
+        // Every entry is erased, so the buffer can be reused from the start
+        metadata->entryCount = 0;
+    }
+    return true;
+}
+
+bool cubs_map_erase(CubsMap *self, const void *key)
+{
+    if(self->len == 0) {
+        return false;
+    }
+    return map_erase_hashed(self, key, map_hash_code(key, self->keyContext));
+}
 
-    const bool result = group_erase(&metadata->groupsArray[groupIndex], key, self->keyContext, self->valueContext, cubs_hash_pair_bitmask_init(hashCode), &metadata->iterFirst, &metadata->iterLast);
-    if(result) {
-        self->len -= 1;
-        metadata->available += 1; 
+bool cubs_map_erase_prehashed(CubsMap *self, const void *key, size_t hashCode)
+{
+    assert(hashCode == cubs_context_fast_hash(key, self->keyContext) && "Precomputed hash code does not match the key");
+    if(self->len == 0) {
+        return false;
     }
-    return result;
+    return map_erase_hashed(self, key, map_normalize_hash_code(hashCode));
 }
 
 bool cubs_map_eql(const CubsMap *self, const CubsMap *other)
-{   
+{
     assert(self->keyContext->sizeOfType == other->keyContext->sizeOfType);
     assert(self->keyContext->eql.func.externC != NULL);
     assert(other->keyContext->eql.func.externC != NULL);
@@ -558,7 +808,7 @@ size_t cubs_map_hash(const CubsMap *self)
     assert(self->valueContext->hash.func.externC != NULL);
 
     CubsMapConstIter selfIter = cubs_map_const_iter_begin(self);
-    
+
     const size_t globalHashSeed = cubs_hash_seed();
     size_t h = globalHashSeed;
 
@@ -574,10 +824,9 @@ size_t cubs_map_hash(const CubsMap *self)
 
 CubsMapConstIter cubs_map_const_iter_begin(const CubsMap* self)
 {
-    const Metadata* metadata = map_metadata(self);
     const CubsMapConstIter iter = {
         ._map = self,
-        ._nextIter = (const void*)metadata->iterFirst, // If `iterFirst == NULL`, means an 0 length iterator
+        ._nextIter = (const void*)map_first_entry(self), // If NULL, means an 0 length iterator
         .key = NULL, 
         .value = NULL,
     };
@@ -603,35 +852,24 @@ bool cubs_map_const_iter_next(CubsMapConstIter *iter)
         return false;
     }
 
-    const Metadata* metadata = map_metadata(iter->_map);
-    PairHeader* currentPair = ((PairHeader*)iter->_nextIter);
-    if(currentPair == metadata->iterLast) {
-        const CubsMapConstIter newIter = {
-            ._map = iter->_map,
-            ._nextIter = NULL,
-            .key = pair_key(currentPair),
-            .value = pair_value(currentPair, iter->_map->keyContext->sizeOfType),
-        };
-        *iter = newIter;
-    } else {
-        assert(currentPair->iterAfter != NULL);
-        const CubsMapConstIter newIter = {
-            ._map = iter->_map,
-            ._nextIter = (const void*)currentPair->iterAfter,
-            .key = pair_key(currentPair),
-            .value = pair_value(currentPair, iter->_map->keyContext->sizeOfType),
-        };
-        *iter = newIter;
-    }    
+    const CubsMap* map = iter->_map;
+    const size_t entryStride = map_entry_stride(map->keyContext, map->valueContext);
+    const EntryHeader* currentEntry = (const EntryHeader*)iter->_nextIter;
+    const CubsMapConstIter newIter = {
+        ._map = map,
+        ._nextIter = (const void*)map_live_entry_from(map_metadata(map), &((const uint8_t*)currentEntry)[entryStride], entryStride),
+        .key = entry_key(currentEntry),
+        .value = entry_value(currentEntry, map->keyContext),
+    };
+    *iter = newIter;
     return true;
 }
 
 CubsMapMutIter cubs_map_mut_iter_begin(CubsMap *self)
 {
-    Metadata* metadata = map_metadata_mut(self);
     const CubsMapMutIter iter = {
         ._map = self,
-        ._nextIter = (void*)metadata->iterFirst, // If `iterFirst == NULL`, means an 0 length iterator
+        ._nextIter = (void*)map_first_entry(self), // If NULL, means an 0 length iterator
         .key = NULL, 
         .value = NULL,
     };
@@ -656,38 +894,25 @@ bool cubs_map_mut_iter_next(CubsMapMutIter *iter)
         iter->value = NULL;
         return false;
     }
-    
-    const size_t round8Size = ROUND_SIZE_TO_MULTIPLE_OF_8(iter->_map->keyContext->sizeOfType);
-
-    Metadata* metadata = map_metadata_mut(iter->_map);
-    PairHeader* currentPair = ((PairHeader*)iter->_nextIter);
-    if(currentPair == metadata->iterLast) {
-        const CubsMapMutIter newIter = {
-            ._map = iter->_map,
-            ._nextIter = NULL,
-            .key = pair_key(currentPair),
-            .value = pair_value_mut(currentPair, round8Size),
-        };
-        *iter = newIter;
-    } else {
-        assert(currentPair->iterAfter != NULL);
-        const CubsMapMutIter newIter = {
-            ._map = iter->_map,
-            ._nextIter = (void*)currentPair->iterAfter,
-            .key = pair_key(currentPair),
-            .value = pair_value_mut(currentPair, round8Size),
-        };
-        *iter = newIter;
-    }    
+
+    CubsMap* map = iter->_map;
+    const size_t entryStride = map_entry_stride(map->keyContext, map->valueContext);
+    EntryHeader* currentEntry = (EntryHeader*)iter->_nextIter;
+    const CubsMapMutIter newIter = {
+        ._map = map,
+        ._nextIter = (void*)map_live_entry_from(map_metadata(map), &((const uint8_t*)currentEntry)[entryStride], entryStride),
+        .key = entry_key(currentEntry),
+        .value = entry_value_mut(currentEntry, map->keyContext),
+    };
+    *iter = newIter;
     return true;
 }
 
 CubsMapReverseConstIter cubs_map_reverse_const_iter_begin(const CubsMap *self)
 {
-    const Metadata* metadata = map_metadata(self);
     const CubsMapReverseConstIter iter = {
         ._map = self,
-        ._nextIter = (const void*)metadata->iterLast, // If `iterLast == NULL`, means an 0 length iterator
+        ._nextIter = (const void*)map_last_entry(self), // If NULL, means an 0 length iterator
         .key = NULL, 
         .value = NULL,
     };
@@ -713,34 +938,23 @@ bool cubs_map_reverse_const_iter_next(CubsMapReverseConstIter *iter)
         return false;
     }
 
-    const Metadata* metadata = map_metadata(iter->_map);
-    PairHeader* currentPair = ((PairHeader*)iter->_nextIter);
-    if(currentPair == metadata->iterFirst) {
-        const CubsMapReverseConstIter newIter = {
-            ._map = iter->_map,
-            ._nextIter = NULL,
-            .key = pair_key(currentPair),
-            .value = pair_value(currentPair, iter->_map->keyContext->sizeOfType),
-        };
-        *iter = newIter;
-    } else {
-        assert(currentPair->iterBefore != NULL);
-        const CubsMapReverseConstIter newIter = {
-            ._map = iter->_map,
-            ._nextIter = (const void*)currentPair->iterBefore,
-            .key = pair_key(currentPair),
-            .value = pair_value(currentPair, iter->_map->keyContext->sizeOfType),
-        };
-        *iter = newIter;
-    }    
+    const CubsMap* map = iter->_map;
+    const size_t entryStride = map_entry_stride(map->keyContext, map->valueContext);
+    const EntryHeader* currentEntry = (const EntryHeader*)iter->_nextIter;
+    const CubsMapReverseConstIter newIter = {
+        ._map = map,
+        ._nextIter = (const void*)map_live_entry_before(map_metadata(map), (const uint8_t*)currentEntry, entryStride),
+        .key = entry_key(currentEntry),
+        .value = entry_value(currentEntry, map->keyContext),
+    };
+    *iter = newIter;
     return true;
 }
 
 CubsMapReverseMutIter cubs_map_reverse_mut_iter_begin(CubsMap* self) {
-    Metadata* metadata = map_metadata_mut(self);
     const CubsMapReverseMutIter iter = {
         ._map = self,
-        ._nextIter = (void*)metadata->iterLast, // If `iterLast == NULL`, means an 0 length iterator
+        ._nextIter = (void*)map_last_entry(self), // If NULL, means an 0 length iterator
         .key = NULL, 
         .value = NULL,
     };
@@ -764,27 +978,15 @@ bool cubs_map_reverse_mut_iter_next(CubsMapReverseMutIter* iter) {
         return false;
     }
 
-    const size_t round8Size = ROUND_SIZE_TO_MULTIPLE_OF_8(iter->_map->keyContext->sizeOfType);
-
-    Metadata* metadata = map_metadata_mut(iter->_map);
-    PairHeader* currentPair = ((PairHeader*)iter->_nextIter);
-    if(currentPair == metadata->iterFirst) {
-        const CubsMapReverseMutIter newIter = {
-            ._map = iter->_map,
-            ._nextIter = NULL,
-            .key = pair_key(currentPair),
-            .value = pair_value_mut(currentPair, round8Size),
-        };
-        *iter = newIter;
-    } else {
-        assert(currentPair->iterBefore != NULL);
-        const CubsMapReverseMutIter newIter = {
-            ._map = iter->_map,
-            ._nextIter = (void*)currentPair->iterBefore,
-            .key = pair_key(currentPair),
-            .value = pair_value_mut(currentPair, round8Size),
-        };
-        *iter = newIter;
-    }    
+    CubsMap* map = iter->_map;
+    const size_t entryStride = map_entry_stride(map->keyContext, map->valueContext);
+    EntryHeader* currentEntry = (EntryHeader*)iter->_nextIter;
+    const CubsMapReverseMutIter newIter = {
+        ._map = map,
+        ._nextIter = (void*)map_live_entry_before(map_metadata(map), (const uint8_t*)currentEntry, entryStride),
+        .key = entry_key(currentEntry),
+        .value = entry_value_mut(currentEntry, map->keyContext),
+    };
+    *iter = newIter;
     return true;
-}
\ No newline at end of file
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../../c_basic_types.h"
+#include "../string/string_slice.h"
 
 struct CubsTypeContext;
 
@@ -79,13 +80,52 @@ const void* cubs_map_find(const CubsMap* self, const void* key);
 /// Mutation operations on this map may make the returned memory invalid.
 void* cubs_map_find_mut(CubsMap* self, const void* key);
 
+/// Same as `cubs_map_find(...)`, but uses `hashCode` rather than hashing `key` again.
+/// `hashCode` must be the result of `cubs_context_fast_hash(key, self->keyContext)`. Hash codes are seeded
+/// per process, so they can be cached alongside a key for as long as the program runs.
+const void* cubs_map_find_prehashed(const CubsMap* self, const void* key, size_t hashCode);
+
+/// Same as `cubs_map_find_mut(...)`, but uses `hashCode` rather than hashing `key` again.
+/// See `cubs_map_find_prehashed(...)`.
+void* cubs_map_find_prehashed_mut(CubsMap* self, const void* key, size_t hashCode);
+
+/// Find a string key by `key` within the map `self`, without needing to create a `CubsString`.
+/// Asserts that the map's keys are strings. If it doesn't exist, returns `NULL`, otherwise
+/// returns an immutable reference to the value in the key/value pair.
+/// Mutation operations on this map may make the returned memory invalid.
+const void* cubs_map_find_slice(const CubsMap* self, CubsStringSlice key);
+
+/// Find a string key by `key` within the map `self`, without needing to create a `CubsString`.
+/// Asserts that the map's keys are strings. If it doesn't exist, returns `NULL`, otherwise
+/// returns a mutable reference to the value in the key/value pair.
+/// Mutation operations on this map may make the returned memory invalid.
+void* cubs_map_find_slice_mut(CubsMap* self, CubsStringSlice key);
+
 void cubs_map_insert(CubsMap* self, void* key, void* value);
 
+/// Same as `cubs_map_insert(...)`, but uses `hashCode` rather than hashing `key` again.
+/// See `cubs_map_find_prehashed(...)`.
+void cubs_map_insert_prehashed(CubsMap* self, void* key, void* value, size_t hashCode);
+
+/// Ensures that the map can hold at least `minCapacity` key/value pairs in total without growing.
+/// Useful before inserting a large number of pairs, to avoid repeatedly redistributing the existing ones.
+void cubs_map_reserve(CubsMap* self, size_t minCapacity);
+
+/// Inserts `count` key/value pairs, taking ownership of each key and value, as `cubs_map_insert(...)` does.
+/// `keys` and `values` are tightly packed arrays of `count` elements, of `keyContext->sizeOfType` and
+/// `valueContext->sizeOfType` bytes each. If a key is in `keys` multiple times, the last value is kept.
+/// Reserves space for all of the pairs up front.
+void cubs_map_insert_many(CubsMap* self, void* keys, void* values, size_t count);
+
 /// Returns true if the entry `key` exists, and thus was successfully deleted and cleaned up,
 /// and returns false if the entry doesn't exist.
 /// Assumes that `key` is the correct type that this map holds.
 bool cubs_map_erase(CubsMap* self, const void* key);
 
+/// Same as `cubs_map_erase(...)`, but uses `hashCode` rather than hashing `key` again.
+/// See `cubs_map_find_prehashed(...)`.
+bool cubs_map_erase_prehashed(CubsMap* self, const void* key, size_t hashCode);
+
 bool cubs_map_eql(const CubsMap* self, const CubsMap* other);
 
 size_t cubs_map_hash(const CubsMap* self);
@@ -7,6 +7,7 @@ const CTaggedValue = script_value.CTaggedValue;
 const TaggedValue = script_value.TaggedValue;
 const String = script_value.String;
 const TypeContext = script_value.TypeContext;
+const CubsStringSlice = @import("../string/string.zig").CubsString.CubsStringSlice;
 
 pub fn Map(comptime K: type, comptime V: type) type {
     return extern struct {
@@ -35,16 +36,62 @@ pub fn Map(comptime K: type, comptime V: type) type {
             return @ptrCast(@alignCast(CubsMap.cubs_map_find_mut(self.asRawMut(), @ptrCast(key))));
         }
 
+        /// `hashCode` must be the hash of `key` using `keyContext`, such as `String.hash()` for string keys.
+        pub fn findPrehashed(self: *const Self, key: *const K, hashCode: usize) ?*const V {
+            return @ptrCast(@alignCast(CubsMap.cubs_map_find_prehashed(self.asRaw(), @ptrCast(key), hashCode)));
+        }
+
+        /// `hashCode` must be the hash of `key` using `keyContext`, such as `String.hash()` for string keys.
+        pub fn findPrehashedMut(self: *Self, key: *const K, hashCode: usize) ?*V {
+            return @ptrCast(@alignCast(CubsMap.cubs_map_find_prehashed_mut(self.asRawMut(), @ptrCast(key), hashCode)));
+        }
+
+        pub fn findSlice(self: *const Self, key: []const u8) ?*const V {
+            if (K != String) {
+                @compileError("findSlice requires string keys");
+            }
+            return @ptrCast(@alignCast(CubsMap.cubs_map_find_slice(self.asRaw(), CubsStringSlice.fromLiteral(key))));
+        }
+
+        pub fn findSliceMut(self: *Self, key: []const u8) ?*V {
+            if (K != String) {
+                @compileError("findSliceMut requires string keys");
+            }
+            return @ptrCast(@alignCast(CubsMap.cubs_map_find_slice_mut(self.asRawMut(), CubsStringSlice.fromLiteral(key))));
+        }
+
         pub fn insert(self: *Self, key: K, value: V) void {
             var mutKey = key;
             var mutValue = value;
             CubsMap.cubs_map_insert(self.asRawMut(), @ptrCast(&mutKey), @ptrCast(&mutValue));
         }
 
+        /// `hashCode` must be the hash of `key` using `keyContext`, such as `String.hash()` for string keys.
+        pub fn insertPrehashed(self: *Self, key: K, value: V, hashCode: usize) void {
+            var mutKey = key;
+            var mutValue = value;
+            CubsMap.cubs_map_insert_prehashed(self.asRawMut(), @ptrCast(&mutKey), @ptrCast(&mutValue), hashCode);
+        }
+
+        pub fn reserve(self: *Self, minCapacity: usize) void {
+            CubsMap.cubs_map_reserve(self.asRawMut(), minCapacity);
+        }
+
+        /// Takes ownership of every key in `keys` and value in `values`.
+        pub fn insertMany(self: *Self, keys: []K, values: []V) void {
+            std.debug.assert(keys.len == values.len);
+            CubsMap.cubs_map_insert_many(self.asRawMut(), @ptrCast(keys.ptr), @ptrCast(values.ptr), keys.len);
+        }
+
         pub fn erase(self: *Self, key: *const K) bool {
             return CubsMap.cubs_map_erase(self.asRawMut(), @ptrCast(key));
         }
 
+        /// `hashCode` must be the hash of `key` using `keyContext`, such as `String.hash()` for string keys.
+        pub fn erasePrehashed(self: *Self, key: *const K, hashCode: usize) bool {
+            return CubsMap.cubs_map_erase_prehashed(self.asRawMut(), @ptrCast(key), hashCode);
+        }
+
         pub fn eql(self: *const Self, other: *const Self) bool {
             return CubsMap.cubs_map_eql(self.asRaw(), other.asRaw());
         }
@@ -150,8 +197,16 @@ pub const CubsMap = extern struct {
     pub extern fn cubs_map_clone(self: *const CubsMap) callconv(.C) CubsMap;
     pub extern fn cubs_map_find(self: *const CubsMap, key: *const anyopaque) callconv(.C) ?*const anyopaque;
     pub extern fn cubs_map_find_mut(self: *CubsMap, key: *const anyopaque) callconv(.C) ?*anyopaque;
+    pub extern fn cubs_map_find_prehashed(self: *const CubsMap, key: *const anyopaque, hashCode: usize) callconv(.C) ?*const anyopaque;
+    pub extern fn cubs_map_find_prehashed_mut(self: *CubsMap, key: *const anyopaque, hashCode: usize) callconv(.C) ?*anyopaque;
+    pub extern fn cubs_map_find_slice(self: *const CubsMap, key: CubsStringSlice) callconv(.C) ?*const anyopaque;
+    pub extern fn cubs_map_find_slice_mut(self: *CubsMap, key: CubsStringSlice) callconv(.C) ?*anyopaque;
     pub extern fn cubs_map_insert(self: *CubsMap, key: *anyopaque, value: *anyopaque) callconv(.C) void;
+    pub extern fn cubs_map_insert_prehashed(self: *CubsMap, key: *anyopaque, value: *anyopaque, hashCode: usize) callconv(.C) void;
+    pub extern fn cubs_map_reserve(self: *CubsMap, minCapacity: usize) callconv(.C) void;
+    pub extern fn cubs_map_insert_many(self: *CubsMap, keys: *anyopaque, values: *anyopaque, count: usize) callconv(.C) void;
     pub extern fn cubs_map_erase(self: *CubsMap, key: *const anyopaque) callconv(.C) bool;
+    pub extern fn cubs_map_erase_prehashed(self: *CubsMap, key: *const anyopaque, hashCode: usize) callconv(.C) bool;
     pub extern fn cubs_map_eql(self: *const CubsMap, other: *const CubsMap) callconv(.C) bool;
     pub extern fn cubs_map_hash(self: *const CubsMap) callconv(.C) usize;
 };
@@ -253,6 +308,61 @@ test "insert" {
     }
 }
 
+test "insertMany" {
+    {
+        var map = Map(i64, i64){};
+        defer map.deinit();
+
+        map.reserve(1000);
+        try expect(map.len == 0);
+
+        var keys: [1000]i64 = undefined;
+        var values: [1000]i64 = undefined;
+        for (0..1000) |i| {
+            keys[i] = @intCast(i);
+            values[i] = @intCast(i * 2);
+        }
+        map.insertMany(&keys, &values);
+        try expect(map.len == 1000);
+
+        // Existing keys have their values replaced
+        for (0..500) |i| {
+            values[i] = -1;
+        }
+        map.insertMany(keys[0..500], values[0..500]);
+        try expect(map.len == 1000);
+
+        for (0..1000) |i| {
+            const expected: i64 = if (i < 500) -1 else @intCast(i * 2);
+            try expect(map.find(&@as(i64, @intCast(i))).?.* == expected);
+        }
+
+        var iter = map.iter();
+        var expectedKey: i64 = 0;
+        while (iter.next()) |pair| {
+            try expect(pair.key.* == expectedKey);
+            expectedKey += 1;
+        }
+    }
+    {
+        var map = Map(String, String){};
+        defer map.deinit();
+
+        var keys: [100]String = undefined;
+        var values: [100]String = undefined;
+        for (0..100) |i| {
+            keys[i] = String.fromInt(@intCast(i));
+            values[i] = String.initUnchecked("wuh");
+        }
+        map.insertMany(&keys, &values);
+        try expect(map.len == 100);
+
+        var findVal = String.initUnchecked("42");
+        defer findVal.deinit();
+        try expect(map.find(&findVal).?.eqlSlice("wuh"));
+    }
+}
+
 test "find" {
     var map = Map(String, String){};
     defer map.deinit();
@@ -372,6 +482,96 @@ test "findMut" {
     }
 }
 
+test "findPrehashed" {
+    var map = Map(String, i64){};
+    defer map.deinit();
+
+    var keys: [100]String = undefined;
+    var hashCodes: [100]usize = undefined;
+    for (0..100) |i| {
+        keys[i] = String.fromInt(@intCast(i));
+        hashCodes[i] = keys[i].hash();
+        map.insert(keys[i].clone(), @intCast(i));
+    }
+    defer {
+        for (&keys) |*key| {
+            key.deinit();
+        }
+    }
+
+    for (0..100) |i| {
+        if (map.findPrehashed(&keys[i], hashCodes[i])) |found| {
+            try expect(found.* == @as(i64, @intCast(i)));
+        } else {
+            try expect(false);
+        }
+
+        if (map.findPrehashedMut(&keys[i], hashCodes[i])) |found| {
+            found.* += 1;
+        } else {
+            try expect(false);
+        }
+    }
+
+    for (0..100) |i| {
+        try expect(map.find(&keys[i]).?.* == @as(i64, @intCast(i + 1)));
+    }
+
+    var missing = String.initUnchecked("missing");
+    defer missing.deinit();
+    try expect(map.findPrehashed(&missing, missing.hash()) == null);
+}
+
+test "insertPrehashed erasePrehashed" {
+    var map = Map(String, i64){};
+    defer map.deinit();
+
+    for (0..100) |i| {
+        const key = String.fromInt(@intCast(i));
+        const hashCode = key.hash();
+        map.insertPrehashed(key, @intCast(i), hashCode);
+    }
+    try expect(map.len == 100);
+
+    for (0..100) |i| {
+        var key = String.fromInt(@intCast(i));
+        defer key.deinit();
+        try expect(map.find(&key).?.* == @as(i64, @intCast(i)));
+        if (i % 2 == 0) {
+            try expect(map.erasePrehashed(&key, key.hash()));
+            try expect(!map.erasePrehashed(&key, key.hash()));
+        }
+    }
+    try expect(map.len == 50);
+}
+
+test "findSlice" {
+    var map = Map(String, i64){};
+    defer map.deinit();
+
+    try expect(map.findSlice("erm") == null);
+
+    map.insert(String.initUnchecked("erm"), 1);
+    map.insert(String.initUnchecked("a string long enough to not be stored inline"), 2);
+
+    for (0..99) |i| {
+        map.insert(String.fromInt(@intCast(i)), @intCast(i + 10));
+    }
+
+    try expect(map.findSlice("erm").?.* == 1);
+    try expect(map.findSlice("a string long enough to not be stored inline").?.* == 2);
+    try expect(map.findSlice("50").?.* == 60);
+    try expect(map.findSlice("a string long enough to not be stored") == null);
+    try expect(map.findSlice("100") == null);
+
+    if (map.findSliceMut("erm")) |found| {
+        found.* = 5;
+    } else {
+        try expect(false);
+    }
+    try expect(map.findSlice("erm").?.* == 5);
+}
+
 test "erase" {
     {
         var map = Map(String, String){};
@@ -424,6 +624,68 @@ test "erase" {
     }
 }
 
+test "insert existing key" {
+    var map = Map(String, String){};
+    defer map.deinit();
+
+    map.insert(String.initUnchecked("erm"), String.initUnchecked("wuh"));
+    map.insert(String.initUnchecked("erm"), String.initUnchecked("holy moly"));
+
+    try expect(map.len == 1);
+
+    var findVal = String.initUnchecked("erm");
+    defer findVal.deinit();
+
+    if (map.find(&findVal)) |found| {
+        try expect(found.eqlSlice("holy moly"));
+    } else {
+        try expect(false);
+    }
+}
+
+test "erase keeps insertion order" {
+    var map = Map(i64, i64){};
+    defer map.deinit();
+
+    for (0..1000) |i| {
+        map.insert(@intCast(i), @intCast(i));
+    }
+    for (0..1000) |i| {
+        if (i % 3 == 0) {
+            try expect(map.erase(&@as(i64, @intCast(i))));
+        }
+    }
+    // Enough inserts to fill, and then compact, the erased entries
+    for (1000..3000) |i| {
+        map.insert(@intCast(i), @intCast(i));
+    }
+
+    {
+        var iter = map.iter();
+        var count: usize = 0;
+        var previous: i64 = -1;
+        while (iter.next()) |pair| {
+            try expect(pair.key.* > previous);
+            try expect(pair.key.* >= 1000 or @mod(pair.key.*, 3) != 0);
+            try expect(pair.value.* == pair.key.*);
+            previous = pair.key.*;
+            count += 1;
+        }
+        try expect(count == map.len);
+    }
+    {
+        var iter = map.reverseIter();
+        var count: usize = 0;
+        var previous: i64 = 3000;
+        while (iter.next()) |pair| {
+            try expect(pair.key.* < previous);
+            previous = pair.key.*;
+            count += 1;
+        }
+        try expect(count == map.len);
+    }
+}
+
 test "iter" {
     var map = Map(i64, f64){};
     defer map.deinit();
@@ -751,7 +1013,7 @@ test "hash" {
         defer twoMap.deinit();
 
         twoMap.insert(1, 1.5);
-        twoMap.insert(1, 1.5);
+        twoMap.insert(2, 1.5);
 
         var manyMap = Map(i64, f64){};
         defer manyMap.deinit();
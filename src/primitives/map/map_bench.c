@@ -0,0 +1,205 @@
+#include "../../bench.h"
+#include "map.h"
+#include "../context.h"
+#include "../string/string.h"
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define INT_ENTRY_COUNT 1000000
+#define STRING_ENTRY_COUNT 200000
+#define BULK_ENTRY_COUNT 500000
+#define PATTERN_ENTRY_COUNT 50000
+
+static void bench_int_map() {
+    CubsMap map = cubs_map_init(&CUBS_INT_CONTEXT, &CUBS_INT_CONTEXT);
+
+    uint64_t start = cubs_bench_now_ns();
+    for(int64_t i = 0; i < INT_ENTRY_COUNT; i++) {
+        int64_t key = i;
+        int64_t value = i * 2;
+        cubs_map_insert(&map, (void*)&key, (void*)&value);
+    }
+    cubs_bench_report("map int insert", INT_ENTRY_COUNT, cubs_bench_now_ns() - start);
+    assert(map.len == INT_ENTRY_COUNT);
+
+    start = cubs_bench_now_ns();
+    int64_t found = 0;
+    for(int64_t i = 0; i < INT_ENTRY_COUNT; i++) {
+        const int64_t* value = (const int64_t*)cubs_map_find(&map, (const void*)&i);
+        found += *value;
+    }
+    cubs_bench_report("map int find", INT_ENTRY_COUNT, cubs_bench_now_ns() - start);
+
+    start = cubs_bench_now_ns();
+    int64_t missed = 0;
+    for(int64_t i = INT_ENTRY_COUNT; i < INT_ENTRY_COUNT * 2; i++) {
+        missed += cubs_map_find(&map, (const void*)&i) == NULL;
+    }
+    cubs_bench_report("map int find missing", INT_ENTRY_COUNT, cubs_bench_now_ns() - start);
+    assert(missed == INT_ENTRY_COUNT);
+
+    start = cubs_bench_now_ns();
+    int64_t iterated = 0;
+    CubsMapConstIter iter = cubs_map_const_iter_begin(&map);
+    while(cubs_map_const_iter_next(&iter)) {
+        iterated += *(const int64_t*)iter.value;
+    }
+    cubs_bench_report("map int iterate", INT_ENTRY_COUNT, cubs_bench_now_ns() - start);
+    assert(iterated == found);
+
+    start = cubs_bench_now_ns();
+    for(int64_t i = 0; i < INT_ENTRY_COUNT; i += 2) {
+        const bool erased = cubs_map_erase(&map, (const void*)&i);
+        assert(erased);
+        (void)erased;
+    }
+    cubs_bench_report("map int erase", INT_ENTRY_COUNT / 2, cubs_bench_now_ns() - start);
+
+    start = cubs_bench_now_ns();
+    cubs_map_deinit(&map);
+    cubs_bench_report("map int deinit", INT_ENTRY_COUNT / 2, cubs_bench_now_ns() - start);
+}
+
+/// Loads `BULK_ENTRY_COUNT` pairs into an empty map, either one at a time, one at a time after reserving, or all at once.
+static void bench_int_bulk_load(int mode) {
+    int64_t* keys = (int64_t*)malloc(sizeof(int64_t) * BULK_ENTRY_COUNT);
+    int64_t* values = (int64_t*)malloc(sizeof(int64_t) * BULK_ENTRY_COUNT);
+    for(int64_t i = 0; i < BULK_ENTRY_COUNT; i++) {
+        keys[i] = i * 7919;
+        values[i] = i;
+    }
+
+    CubsMap map = cubs_map_init(&CUBS_INT_CONTEXT, &CUBS_INT_CONTEXT);
+
+    const uint64_t start = cubs_bench_now_ns();
+    if(mode == 2) {
+        cubs_map_insert_many(&map, (void*)keys, (void*)values, BULK_ENTRY_COUNT);
+    } else {
+        if(mode == 1) {
+            cubs_map_reserve(&map, BULK_ENTRY_COUNT);
+        }
+        for(int64_t i = 0; i < BULK_ENTRY_COUNT; i++) {
+            cubs_map_insert(&map, (void*)&keys[i], (void*)&values[i]);
+        }
+    }
+    const uint64_t elapsed = cubs_bench_now_ns() - start;
+    assert(map.len == BULK_ENTRY_COUNT);
+
+    const char* names[3] = {"map int bulk load", "map int bulk load reserved", "map int bulk load insert_many"};
+    cubs_bench_report(names[mode], BULK_ENTRY_COUNT, elapsed);
+
+    cubs_map_deinit(&map);
+    free((void*)keys);
+    free((void*)values);
+}
+
+/// Inserts and finds keys that only differ in some of their bits, which a weak hash may not spread across groups.
+static void bench_int_key_pattern(const char* name, int shift) {
+    CubsMap map = cubs_map_init(&CUBS_INT_CONTEXT, &CUBS_INT_CONTEXT);
+    for(int64_t i = 0; i < PATTERN_ENTRY_COUNT; i++) {
+        int64_t key = i << shift;
+        int64_t value = i;
+        cubs_map_insert(&map, (void*)&key, (void*)&value);
+    }
+
+    const uint64_t start = cubs_bench_now_ns();
+    int64_t found = 0;
+    for(int64_t i = 0; i < PATTERN_ENTRY_COUNT; i++) {
+        const int64_t key = i << shift;
+        const int64_t* value = (const int64_t*)cubs_map_find(&map, (const void*)&key);
+        found += *value == i;
+    }
+    cubs_bench_report(name, PATTERN_ENTRY_COUNT, cubs_bench_now_ns() - start);
+    assert(found == PATTERN_ENTRY_COUNT);
+
+    cubs_map_deinit(&map);
+}
+
+static void bench_string_map() {
+    CubsString* keys = (CubsString*)malloc(sizeof(CubsString) * STRING_ENTRY_COUNT);
+    for(int64_t i = 0; i < STRING_ENTRY_COUNT; i++) {
+        char buf[64];
+        const int len = snprintf(buf, sizeof(buf), "entity_identifier_%lld", (long long)i);
+        const CubsStringSlice slice = {.str = buf, .len = (size_t)len};
+        keys[i] = cubs_string_init_unchecked(slice);
+    }
+
+    CubsMap map = cubs_map_init(&CUBS_STRING_CONTEXT, &CUBS_INT_CONTEXT);
+
+    uint64_t start = cubs_bench_now_ns();
+    for(int64_t i = 0; i < STRING_ENTRY_COUNT; i++) {
+        CubsString key = cubs_string_clone(&keys[i]);
+        int64_t value = i;
+        cubs_map_insert(&map, (void*)&key, (void*)&value);
+    }
+    cubs_bench_report("map string insert", STRING_ENTRY_COUNT, cubs_bench_now_ns() - start);
+    assert(map.len == STRING_ENTRY_COUNT);
+
+    start = cubs_bench_now_ns();
+    int64_t found = 0;
+    for(int64_t i = 0; i < STRING_ENTRY_COUNT; i++) {
+        const int64_t* value = (const int64_t*)cubs_map_find(&map, (const void*)&keys[i]);
+        found += *value == i;
+    }
+    cubs_bench_report("map string find", STRING_ENTRY_COUNT, cubs_bench_now_ns() - start);
+    assert(found == STRING_ENTRY_COUNT);
+
+    // Looking up by text that isn't already a `CubsString`, such as a parsed identifier.
+    start = cubs_bench_now_ns();
+    found = 0;
+    for(int64_t i = 0; i < STRING_ENTRY_COUNT; i++) {
+        char buf[64];
+        const int len = snprintf(buf, sizeof(buf), "entity_identifier_%lld", (long long)i);
+        const CubsStringSlice slice = {.str = buf, .len = (size_t)len};
+        CubsString key = cubs_string_init_unchecked(slice);
+        const int64_t* value = (const int64_t*)cubs_map_find(&map, (const void*)&key);
+        cubs_string_deinit(&key);
+        found += *value == i;
+    }
+    cubs_bench_report("map string find from text", STRING_ENTRY_COUNT, cubs_bench_now_ns() - start);
+    assert(found == STRING_ENTRY_COUNT);
+
+    start = cubs_bench_now_ns();
+    found = 0;
+    for(int64_t i = 0; i < STRING_ENTRY_COUNT; i++) {
+        char buf[64];
+        const int len = snprintf(buf, sizeof(buf), "entity_identifier_%lld", (long long)i);
+        const CubsStringSlice slice = {.str = buf, .len = (size_t)len};
+        const int64_t* value = (const int64_t*)cubs_map_find_slice(&map, slice);
+        found += *value == i;
+    }
+    cubs_bench_report("map string find from text by slice", STRING_ENTRY_COUNT, cubs_bench_now_ns() - start);
+    assert(found == STRING_ENTRY_COUNT);
+
+    size_t* hashCodes = (size_t*)malloc(sizeof(size_t) * STRING_ENTRY_COUNT);
+    for(int64_t i = 0; i < STRING_ENTRY_COUNT; i++) {
+        hashCodes[i] = cubs_string_hash(&keys[i]);
+    }
+    start = cubs_bench_now_ns();
+    found = 0;
+    for(int64_t i = 0; i < STRING_ENTRY_COUNT; i++) {
+        const int64_t* value = (const int64_t*)cubs_map_find_prehashed(&map, (const void*)&keys[i], hashCodes[i]);
+        found += *value == i;
+    }
+    cubs_bench_report("map string find prehashed", STRING_ENTRY_COUNT, cubs_bench_now_ns() - start);
+    assert(found == STRING_ENTRY_COUNT);
+    free((void*)hashCodes);
+
+    cubs_map_deinit(&map);
+    for(int64_t i = 0; i < STRING_ENTRY_COUNT; i++) {
+        cubs_string_deinit(&keys[i]);
+    }
+    free((void*)keys);
+}
+
+void cubs_bench_map()
+{
+    bench_int_map();
+    bench_int_bulk_load(0);
+    bench_int_bulk_load(1);
+    bench_int_bulk_load(2);
+    bench_int_key_pattern("map int find keys stride 128", 7);
+    bench_int_key_pattern("map int find keys high bits", 32);
+    bench_string_map();
+}
@@ -14,6 +14,7 @@ pub const Result = @import("result/result.zig").Result;
 pub const Unique = @import("sync_ptr/sync_ptr.zig").Unique;
 pub const Shared = @import("sync_ptr/sync_ptr.zig").Shared;
 pub const Weak = @import("sync_ptr/sync_ptr.zig").Weak;
+pub const SyncMap = @import("sync_map/sync_map.zig").SyncMap;
 pub const Function = @import("function/function.zig").Function;
 pub const Vec2i = @import("vector/vector.zig").Vec2i;
 pub const Vec3i = @import("vector/vector.zig").Vec3i;
@@ -33,6 +34,7 @@ pub const c = struct {
     pub const CubsUnique = @import("sync_ptr/sync_ptr.zig").CubsUnique;
     pub const CubsShared = @import("sync_ptr/sync_ptr.zig").CubsShared;
     pub const CubsWeak = @import("sync_ptr/sync_ptr.zig").CubsWeak;
+    pub const CubsSyncMap = @import("sync_map/sync_map.zig").CubsSyncMap;
     pub const CubsFunction = @import("function/function.zig").CubsFunction;
     pub const CubsCFunctionPtr = @import("function/function.zig").CubsCFunctionPtr;
     pub const CubsFunctionPtr = @import("function/function.zig").CubsFunctionPtr;
@@ -132,6 +134,8 @@ pub const TypeContext = extern struct {
             return @ptrCast(&primitive_context.CUBS_SHARED_CONTEXT);
         } else if (T == c.CubsWeak) {
             return @ptrCast(&primitive_context.CUBS_WEAK_CONTEXT);
+        } else if (T == c.CubsSyncMap) {
+            return @ptrCast(&primitive_context.CUBS_SYNC_MAP_CONTEXT);
         } else if (@hasDecl(T, "ValueType")) {
             if (T == Array(T.ValueType)) {
                 return @ptrCast(&primitive_context.CUBS_ARRAY_CONTEXT);
@@ -153,6 +157,8 @@ pub const TypeContext = extern struct {
                 } else if (@hasDecl(T, "KeyType")) {
                     if (T == Map(T.KeyType, T.ValueType)) {
                         return @ptrCast(&primitive_context.CUBS_MAP_CONTEXT);
+                    } else if (T == SyncMap(T.KeyType, T.ValueType)) {
+                        return @ptrCast(&primitive_context.CUBS_SYNC_MAP_CONTEXT);
                     }
                 }
             }
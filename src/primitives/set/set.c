@@ -149,8 +149,22 @@ static void group_ensure_total_capacity(Group* self, size_t minCapacity) {
     return;
 }
 
+/// Checks if a key in the set is equal to the key being searched for, which may not be the same type as the set's keys.
+typedef bool (*KeyEqlFn)(const void* setKey, const void* key, const CubsTypeContext* keyContext);
+
+static bool key_eql(const void* setKey, const void* key, const CubsTypeContext* keyContext) {
+    assert(keyContext->eql.func.externC != NULL);
+    return cubs_context_fast_eql(setKey, key, keyContext);
+}
+
+/// `key` is a `CubsStringSlice`, and the set's keys are `CubsString`.
+static bool key_eql_slice(const void* setKey, const void* key, const CubsTypeContext* keyContext) {
+    assert(keyContext == &CUBS_STRING_CONTEXT);
+    return cubs_string_eql_slice((const CubsString*)setKey, *(const CubsStringSlice*)key);
+}
+
 /// Returns -1 if not found
-static size_t group_find(const Group* self, const void* key, const CubsTypeContext* keyContext, CubsHashPairBitmask pairMask) {   
+static size_t group_find(const Group* self, const void* key, const CubsTypeContext* keyContext, KeyEqlFn eql, CubsHashPairBitmask pairMask) {   
     size_t i = 0;
     while(i < self->capacity) {
         uint32_t resultMask = _cubs_simd_cmpeq_mask_8bit_32wide_aligned(pairMask.value, &self->hashMasks[i]);
@@ -164,9 +178,8 @@ static size_t group_find(const Group* self, const void* key, const CubsTypeConte
             const size_t actualIndex = index + i;
             const void* pair = group_key_buf_start(self)[actualIndex];
             const void* pairKey = key_of_header(pair);
-            assert(keyContext->eql.func.externC != NULL);
 
-            if(!cubs_context_fast_eql(pairKey, key, keyContext)) {
+            if(!eql(pairKey, key, keyContext)) {
                 resultMask = (resultMask & ~(1U << index));
                 continue;
             }
@@ -177,8 +190,8 @@ static size_t group_find(const Group* self, const void* key, const CubsTypeConte
     return -1;
 }
 
-/// If the entry already exists, overrides the existing value.
-static void group_insert(Group* self, void* key, const CubsTypeContext* keyContext, size_t hashCode, KeyHeader** iterFirst, KeyHeader** iterLast) {
+/// If the entry already exists, deinitializes `key` and returns false. Otherwise returns true.
+static bool group_insert(Group* self, void* key, const CubsTypeContext* keyContext, size_t hashCode, KeyHeader** iterFirst, KeyHeader** iterLast) {
     #if _DEBUG
     if(*iterLast != NULL) {
         assert((*iterLast)->iterAfter == NULL);
@@ -186,11 +199,11 @@ static void group_insert(Group* self, void* key, const CubsTypeContext* keyConte
     #endif
     
     const CubsHashPairBitmask pairMask = cubs_hash_pair_bitmask_init(hashCode);
-    const size_t existingIndex = group_find(self, &key, keyContext, pairMask);
+    const size_t existingIndex = group_find(self, key, keyContext, key_eql, pairMask);
     
     if(existingIndex != -1) {
         cubs_context_fast_deinit(key, keyContext); // don't need duplicate keys
-        return;
+        return false;
     }
 
     group_ensure_total_capacity(self, self->pairCount + 1);
@@ -227,14 +240,14 @@ static void group_insert(Group* self, void* key, const CubsTypeContext* keyConte
         group_key_buf_start_mut(self)[actualIndex] = newPair;
 
         self->pairCount += 1;
-        return;
+        return true;
     }
 
     unreachable();
 }
 
 static bool group_erase(Group* self, const void* key, const CubsTypeContext* keyContext, CubsHashPairBitmask pairMask, KeyHeader** iterFirst, KeyHeader** iterLast) {
-    const size_t found = group_find(self, key, keyContext, pairMask);
+    const size_t found = group_find(self, key, keyContext, key_eql, pairMask);
     if(found == -1) {
         return false;
     }
@@ -265,66 +278,65 @@ static Metadata* map_metadata_mut(CubsSet* self) {
     return (Metadata*)&self->_metadata;
 }
 
-static void map_ensure_total_capacity(CubsSet* self) {
+/// Replaces the groups with `newGroupCount` empty groups, and moves every key into them.
+static void map_reallocate_groups(CubsSet* self, size_t newGroupCount) {
     Metadata* metadata = map_metadata_mut(self);
 
-    size_t newGroupCount;
-    {
-        if(metadata->groupCount == 0) {
-            newGroupCount = 1;
-        } else {
-            if(metadata->available != 0) {
-                return;
-            }
-            assert(metadata->groupCount != 0);
-            newGroupCount = metadata->groupCount << 1;
-        }
-    }
-
     Group* newGroups = (Group*)cubs_malloc(sizeof(Group) * newGroupCount, _Alignof(Group));
     for(size_t i = 0; i < newGroupCount; i++) {
         newGroups[i] = group_init();
     }
 
-    if(metadata->groupCount == 0) {
-        const size_t DEFAULT_AVAILABLE = (size_t)(((float)GROUP_ALLOC_SIZE) * 0.8f);
-        const Metadata newMetadata = {.available = DEFAULT_AVAILABLE, .groupCount = newGroupCount, .iterFirst = NULL, .iterLast = NULL, .groupsArray = newGroups};
-        *metadata = newMetadata;
-        return;
-    } else {
-        const size_t availableEntries = GROUP_ALLOC_SIZE * newGroupCount;
-        const size_t newAvailable = (availableEntries * 4) / 5; // * 0.8 for load factor
-
-        for(size_t oldGroupCount = 0; oldGroupCount < metadata->groupCount; oldGroupCount++) {
-            Group* oldGroup = &metadata->groupsArray[oldGroupCount];
-            if(oldGroup->pairCount != 0) {
-                for(uint32_t hashMaskIter = 0; hashMaskIter < oldGroup->capacity; hashMaskIter++) {
-                    if(oldGroup->hashMasks[hashMaskIter] == 0) {
-                        continue;
-                    }
-
-                    KeyHeader* pair = group_key_buf_start_mut(oldGroup)[hashMaskIter];
-                    const CubsHashGroupBitmask groupBitmask = cubs_hash_group_bitmask_init(pair->hashCode);
-                    const size_t groupIndex = groupBitmask.value % newGroupCount;
-
-                    Group* newGroup = &newGroups[groupIndex];
-                    group_ensure_total_capacity(newGroup, newGroup->pairCount + 1);
-                        
-                    newGroup->hashMasks[newGroup->pairCount] = oldGroup->hashMasks[hashMaskIter];
-                    group_key_buf_start_mut(newGroup)[newGroup->pairCount] = pair; // Move pair to new group
-                    newGroup->pairCount += 1;
+    const size_t availableEntries = GROUP_ALLOC_SIZE * newGroupCount;
+    const size_t newAvailable = ((availableEntries * 4) / 5) - self->len; // * 0.8 for load factor
+
+    for(size_t oldGroupCount = 0; oldGroupCount < metadata->groupCount; oldGroupCount++) {
+        Group* oldGroup = &metadata->groupsArray[oldGroupCount];
+        if(oldGroup->pairCount != 0) {
+            for(uint32_t hashMaskIter = 0; hashMaskIter < oldGroup->capacity; hashMaskIter++) {
+                if(oldGroup->hashMasks[hashMaskIter] == 0) {
+                    continue;
                 }
-            }
 
-            group_free(oldGroup);
+                KeyHeader* pair = group_key_buf_start_mut(oldGroup)[hashMaskIter];
+                const CubsHashGroupBitmask groupBitmask = cubs_hash_group_bitmask_init(pair->hashCode);
+                const size_t groupIndex = groupBitmask.value % newGroupCount;
+
+                Group* newGroup = &newGroups[groupIndex];
+                group_ensure_total_capacity(newGroup, newGroup->pairCount + 1);
+                    
+                newGroup->hashMasks[newGroup->pairCount] = oldGroup->hashMasks[hashMaskIter];
+                group_key_buf_start_mut(newGroup)[newGroup->pairCount] = pair; // Move pair to new group
+                newGroup->pairCount += 1;
+            }
         }
 
-        if(metadata->groupCount > 0) {
-            cubs_free((void*)metadata->groupsArray, sizeof(Group) * metadata->groupCount, _Alignof(Group));
-        }     
+        group_free(oldGroup);
+    }
+
+    if(metadata->groupCount > 0) {
+        cubs_free((void*)metadata->groupsArray, sizeof(Group) * metadata->groupCount, _Alignof(Group));
+    }     
+
+    const Metadata newMetadata = {.available = newAvailable, .groupCount = newGroupCount, .iterFirst = metadata->iterFirst, .iterLast = metadata->iterLast, .groupsArray = newGroups};    
+    *metadata = newMetadata;
+}
+
+/// Get the number of groups required to hold `capacity` keys within the load factor.
+static size_t map_group_count_for_capacity(size_t capacity) {
+    size_t groupCount = 1;
+    while(((GROUP_ALLOC_SIZE * groupCount * 4) / 5) < capacity) { // * 0.8 for load factor
+        groupCount <<= 1;
+    }
+    return groupCount;
+}
 
-        const Metadata newMetadata = {.available = newAvailable, .groupCount = newGroupCount, .iterFirst = metadata->iterFirst, .iterLast = metadata->iterLast, .groupsArray = newGroups};    
-        *metadata = newMetadata;     
+static void map_ensure_total_capacity(CubsSet* self) {
+    Metadata* metadata = map_metadata_mut(self);
+    if(metadata->groupCount == 0) {
+        map_reallocate_groups(self, 1);
+    } else if(metadata->available == 0) {
+        map_reallocate_groups(self, metadata->groupCount << 1);
     }
 }
 
@@ -404,23 +416,44 @@ CubsSet cubs_set_clone(const CubsSet *self)
     return newSelf;
 }
 
-bool cubs_set_contains(const CubsSet* self, const void* key)
-{
-    if(self->len == 0) {
-        return false;
-    }
+static bool map_contains_hashed(const CubsSet* self, const void* key, KeyEqlFn eql, size_t hashCode) {
     const Metadata* metadata = map_metadata(self);
 
-    assert(self->context->hash.func.externC != NULL);
-    const size_t hashCode = cubs_context_fast_hash(key, self->context);
     const CubsHashGroupBitmask groupBitmask = cubs_hash_group_bitmask_init(hashCode);
     const size_t groupIndex = groupBitmask.value % metadata->groupCount;
     const Group* group = &metadata->groupsArray[groupIndex];
 
-    const size_t found = group_find(group, key, self->context, cubs_hash_pair_bitmask_init(hashCode));
+    const size_t found = group_find(group, key, self->context, eql, cubs_hash_pair_bitmask_init(hashCode));
     return found != -1;
 }
 
+bool cubs_set_contains(const CubsSet* self, const void* key)
+{
+    if(self->len == 0) {
+        return false;
+    }
+    assert(self->context->hash.func.externC != NULL);
+    return map_contains_hashed(self, key, key_eql, cubs_context_fast_hash(key, self->context));
+}
+
+bool cubs_set_contains_prehashed(const CubsSet* self, const void* key, size_t hashCode)
+{
+    assert(hashCode == cubs_context_fast_hash(key, self->context) && "Precomputed hash code does not match the key");
+    if(self->len == 0) {
+        return false;
+    }
+    return map_contains_hashed(self, key, key_eql, hashCode);
+}
+
+bool cubs_set_contains_slice(const CubsSet* self, CubsStringSlice key)
+{
+    assert(self->context == &CUBS_STRING_CONTEXT && "Can only find a string slice in a set of strings");
+    if(self->len == 0) {
+        return false;
+    }
+    return map_contains_hashed(self, (const void*)&key, key_eql_slice, cubs_string_slice_hash(key));
+}
+
 void cubs_set_insert(CubsSet *self, void* key)
 {
     map_ensure_total_capacity(self);
@@ -432,9 +465,60 @@ void cubs_set_insert(CubsSet *self, void* key)
     const CubsHashGroupBitmask groupBitmask = cubs_hash_group_bitmask_init(hashCode);
     const size_t groupIndex = groupBitmask.value % metadata->groupCount;
 
-    group_insert(&metadata->groupsArray[groupIndex], key, self->context, hashCode, &metadata->iterFirst, &metadata->iterLast);
-    self->len += 1;
-    metadata->available -= 1;
+    if(group_insert(&metadata->groupsArray[groupIndex], key, self->context, hashCode, &metadata->iterFirst, &metadata->iterLast)) {
+        self->len += 1;
+        metadata->available -= 1;
+    }
+}
+
+void cubs_set_reserve(CubsSet *self, size_t minCapacity)
+{
+    if(minCapacity == 0) {
+        return;
+    }
+
+    const size_t newGroupCount = map_group_count_for_capacity(minCapacity);
+    if(newGroupCount > map_metadata(self)->groupCount) {
+        map_reallocate_groups(self, newGroupCount);
+    }
+}
+
+/// The number of keys hashed at once by `cubs_set_insert_many(...)`.
+#define INSERT_MANY_BATCH_SIZE 64
+
+void cubs_set_insert_many(CubsSet *self, void *keys, size_t count)
+{
+    if(count == 0) {
+        return;
+    }
+
+    // Presizing for every key means the groups are redistributed at most once, rather than each time they fill up.
+    cubs_set_reserve(self, self->len + count);
+
+    Metadata* metadata = map_metadata_mut(self);
+    const size_t keySize = self->context->sizeOfType;
+    uint8_t* keyBytes = (uint8_t*)keys;
+
+    assert(self->context->hash.func.externC != NULL);
+    size_t hashCodes[INSERT_MANY_BATCH_SIZE];
+    for(size_t batchStart = 0; batchStart < count; batchStart += INSERT_MANY_BATCH_SIZE) {
+        const size_t remaining = count - batchStart;
+        const size_t batchLen = remaining < INSERT_MANY_BATCH_SIZE ? remaining : INSERT_MANY_BATCH_SIZE;
+
+        // Hash the whole batch before touching any groups, so the hashing isn't stalled behind group lookups.
+        for(size_t i = 0; i < batchLen; i++) {
+            hashCodes[i] = cubs_context_fast_hash((const void*)&keyBytes[(batchStart + i) * keySize], self->context);
+        }
+        for(size_t i = 0; i < batchLen; i++) {
+            const CubsHashGroupBitmask groupBitmask = cubs_hash_group_bitmask_init(hashCodes[i]);
+            const size_t groupIndex = groupBitmask.value % metadata->groupCount;
+            void* key = (void*)&keyBytes[(batchStart + i) * keySize];
+            if(group_insert(&metadata->groupsArray[groupIndex], key, self->context, hashCodes[i], &metadata->iterFirst, &metadata->iterLast)) {
+                self->len += 1;
+                metadata->available -= 1;
+            }
+        }
+    }
 }
 
 bool cubs_set_erase(CubsSet *self, const void *key)
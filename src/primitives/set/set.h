@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../../c_basic_types.h"
+#include "../string/string_slice.h"
 
 struct CubsTypeContext;
 
@@ -42,8 +43,26 @@ CubsSet cubs_set_clone(const CubsSet* self);
 
 bool cubs_set_contains(const CubsSet* self, const void* key);
 
+/// Same as `cubs_set_contains(...)`, but uses `hashCode` rather than hashing `key` again.
+/// `hashCode` must be the result of `cubs_context_fast_hash(key, self->context)`. Hash codes are seeded
+/// per process, so they can be cached alongside a key for as long as the program runs.
+bool cubs_set_contains_prehashed(const CubsSet* self, const void* key, size_t hashCode);
+
+/// Checks if the string `key` is in the set `self`, without needing to create a `CubsString`.
+/// Asserts that the set holds strings.
+bool cubs_set_contains_slice(const CubsSet* self, CubsStringSlice key);
+
 void cubs_set_insert(CubsSet* self, void* key);
 
+/// Ensures that the set can hold at least `minCapacity` keys in total without growing.
+/// Useful before inserting a large number of keys, to avoid repeatedly redistributing the existing ones.
+void cubs_set_reserve(CubsSet* self, size_t minCapacity);
+
+/// Inserts `count` keys, taking ownership of each one, as `cubs_set_insert(...)` does.
+/// `keys` is a tightly packed array of `count` elements, of `context->sizeOfType` bytes each.
+/// Reserves space for all of the keys up front.
+void cubs_set_insert_many(CubsSet* self, void* keys, size_t count);
+
 /// Returns true if the entry `key` exists, and thus was successfully deleted and cleaned up,
 /// and returns false if the entry doesn't exist.
 bool cubs_set_erase(CubsSet* self, const void* key);
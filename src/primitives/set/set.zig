@@ -7,6 +7,7 @@ const CTaggedValue = script_value.CTaggedValue;
 const TaggedValue = script_value.TaggedValue;
 const String = script_value.String;
 const TypeContext = script_value.TypeContext;
+const CubsStringSlice = @import("../string/string.zig").CubsString.CubsStringSlice;
 
 pub fn Set(comptime K: type) type {
     return extern struct {
@@ -31,12 +32,34 @@ pub fn Set(comptime K: type) type {
             return CubsSet.cubs_set_contains(self.asRaw(), @ptrCast(&key));
         }
 
+        /// Does NOT take ownership of `key`. `hashCode` must be the hash of `key` using `context`,
+        /// such as `String.hash()` for a set of strings.
+        pub fn containsPrehashed(self: *const Self, key: K, hashCode: usize) bool {
+            return CubsSet.cubs_set_contains_prehashed(self.asRaw(), @ptrCast(&key), hashCode);
+        }
+
+        pub fn containsSlice(self: *const Self, key: []const u8) bool {
+            if (K != String) {
+                @compileError("containsSlice requires a set of strings");
+            }
+            return CubsSet.cubs_set_contains_slice(self.asRaw(), CubsStringSlice.fromLiteral(key));
+        }
+
         /// Takes ownership of the memory of `key`.
         pub fn insert(self: *Self, key: K) void {
             var tempKey = key;
             CubsSet.cubs_set_insert(self.asRawMut(), @ptrCast(&tempKey));
         }
 
+        pub fn reserve(self: *Self, minCapacity: usize) void {
+            CubsSet.cubs_set_reserve(self.asRawMut(), minCapacity);
+        }
+
+        /// Takes ownership of the memory of every key in `keys`.
+        pub fn insertMany(self: *Self, keys: []K) void {
+            CubsSet.cubs_set_insert_many(self.asRawMut(), @ptrCast(keys.ptr), keys.len);
+        }
+
         /// Does NOT take ownership of `key`. Zig will likely optimize this to pass by const reference in many cases,
         /// but allows to easily pass in immediate values, rather than using temporary storage.
         pub fn erase(self: *Self, key: K) bool {
@@ -102,7 +125,11 @@ pub const CubsSet = extern struct {
     pub extern fn cubs_set_deinit(self: *CubsSet) callconv(.C) void;
     pub extern fn cubs_set_clone(self: *const CubsSet) callconv(.C) CubsSet;
     pub extern fn cubs_set_contains(self: *const CubsSet, key: *const anyopaque) callconv(.C) bool;
+    pub extern fn cubs_set_contains_prehashed(self: *const CubsSet, key: *const anyopaque, hashCode: usize) callconv(.C) bool;
+    pub extern fn cubs_set_contains_slice(self: *const CubsSet, key: CubsStringSlice) callconv(.C) bool;
     pub extern fn cubs_set_insert(self: *CubsSet, key: *anyopaque) callconv(.C) void;
+    pub extern fn cubs_set_reserve(self: *CubsSet, minCapacity: usize) callconv(.C) void;
+    pub extern fn cubs_set_insert_many(self: *CubsSet, keys: *anyopaque, count: usize) callconv(.C) void;
     pub extern fn cubs_set_erase(self: *CubsSet, key: *const anyopaque) callconv(.C) bool;
     pub extern fn cubs_set_eql(self: *const CubsSet, other: *const CubsSet) callconv(.C) bool;
     pub extern fn cubs_set_hash(self: *const CubsSet) callconv(.C) usize;
@@ -183,6 +210,51 @@ test "insert" {
     }
 }
 
+test "insertMany" {
+    {
+        var set = Set(i64){};
+        defer set.deinit();
+
+        set.reserve(1000);
+        try expect(set.len == 0);
+
+        var keys: [1000]i64 = undefined;
+        for (0..1000) |i| {
+            keys[i] = @intCast(i);
+        }
+        set.insertMany(&keys);
+        try expect(set.len == 1000);
+
+        // Duplicates are ignored
+        set.insertMany(keys[0..500]);
+        try expect(set.len == 1000);
+
+        for (0..1000) |i| {
+            try expect(set.contains(@intCast(i)));
+        }
+
+        var iter = set.iter();
+        var expected: i64 = 0;
+        while (iter.next()) |key| {
+            try expect(key.* == expected);
+            expected += 1;
+        }
+    }
+    {
+        var set = Set(String){};
+        defer set.deinit();
+
+        var keys: [100]String = undefined;
+        for (0..100) |i| {
+            keys[i] = String.fromInt(@intCast(i));
+        }
+        set.insertMany(&keys);
+        try expect(set.len == 100);
+
+        try expect(set.contains(String.initUnchecked("42")));
+    }
+}
+
 test "contains" {
     var set = Set(String){};
     defer set.deinit();
@@ -219,6 +291,42 @@ test "contains" {
     }
 }
 
+test "containsPrehashed" {
+    var set = Set(String){};
+    defer set.deinit();
+
+    for (0..100) |i| {
+        set.insert(String.fromInt(@intCast(i)));
+    }
+
+    for (0..150) |i| {
+        var findVal = String.fromInt(@intCast(i));
+        defer findVal.deinit();
+
+        try expect(set.containsPrehashed(findVal, findVal.hash()) == (i < 100));
+    }
+}
+
+test "containsSlice" {
+    var set = Set(String){};
+    defer set.deinit();
+
+    try expect(set.containsSlice("erm") == false);
+
+    set.insert(String.initUnchecked("erm"));
+    set.insert(String.initUnchecked("a string long enough to not be stored inline"));
+
+    for (0..99) |i| {
+        set.insert(String.fromInt(@intCast(i)));
+    }
+
+    try expect(set.containsSlice("erm"));
+    try expect(set.containsSlice("a string long enough to not be stored inline"));
+    try expect(set.containsSlice("50"));
+    try expect(set.containsSlice("a string long enough to not be stored") == false);
+    try expect(set.containsSlice("100") == false);
+}
+
 test "erase" {
     {
         var set = Set(String){};
@@ -483,7 +591,7 @@ test "hash" {
         defer twoSet.deinit();
 
         twoSet.insert(1);
-        twoSet.insert(1);
+        twoSet.insert(2);
 
         var manySet = Set(i64){};
         defer manySet.deinit();
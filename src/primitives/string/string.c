@@ -266,6 +266,16 @@ size_t cubs_string_hash(const CubsString *self)
     }
 }
 
+size_t cubs_string_slice_hash(CubsStringSlice self)
+{
+    // The representation a string uses only depends on its length
+    if(self.len <= MAX_SSO_LEN) {
+        return _cubs_simd_string_hash_sso(self.str, self.len);
+    } else {
+        return _cubs_simd_string_hash_heap(self.str, self.len);
+    }
+}
+
 size_t cubs_string_find(const CubsString *self, CubsStringSlice slice, size_t startIndex)
 {
   const CubsStringSlice selfSlice = cubs_string_as_slice(self);
@@ -60,6 +60,11 @@ pub const String = extern struct {
         return @intCast(CubsString.cubs_string_hash(@ptrCast(self)));
     }
 
+    /// Hashes `slice` the same as `hash()` hashes a string with the same contents.
+    pub fn sliceHash(slice: []const u8) usize {
+        return @intCast(CubsString.cubs_string_slice_hash(CubsString.CubsStringSlice.fromLiteral(slice)));
+    }
+
     pub fn find(self: *const Self, literal: []const u8, startIndex: usize) ?usize {
         const result: usize = CubsString.cubs_string_find(@ptrCast(self), CubsString.CubsStringSlice.fromLiteral(literal), @intCast(startIndex));
         if (result == CubsString.CUBS_STRING_N_POS) {
@@ -699,6 +704,16 @@ pub const String = extern struct {
             return error.SkipZigTest;
         }
     }
+
+    test sliceHash {
+        const slices = [_][]const u8{ "", "a", "hello world!", "ashpdiuahspdiuahspdiuhaspdiuhapsiudhpaisuhdpaiushdpasd" };
+        for (slices) |slice| {
+            var string = String.initUnchecked(slice);
+            defer string.deinit();
+
+            try expect(string.hash() == String.sliceHash(slice));
+        }
+    }
 };
 
 pub const CubsString = extern struct {
@@ -738,6 +753,7 @@ pub const CubsString = extern struct {
     extern fn cubs_string_eql_slice(self: *const Self, slice: CubsStringSlice) callconv(.C) bool;
     extern fn cubs_string_cmp(self: *const Self, other: *const Self) callconv(.C) Ordering;
     extern fn cubs_string_hash(self: *const Self) callconv(.C) usize;
+    extern fn cubs_string_slice_hash(slice: CubsStringSlice) callconv(.C) usize;
     extern fn cubs_string_find(self: *const Self, slice: CubsStringSlice, startIndex: usize) callconv(.C) usize;
     extern fn cubs_string_rfind(self: *const Self, slice: CubsStringSlice, startIndex: usize) callconv(.C) usize;
     extern fn cubs_string_concat(self: *const Self, other: *const Self) callconv(.C) Self;
@@ -1,5 +1,4 @@
 #include "string_slice.h"
-#include "../../util/hash.h"
 
 bool cubs_string_slice_eql(CubsStringSlice lhs, CubsStringSlice rhs)
 {
@@ -15,8 +14,3 @@ bool cubs_string_slice_eql(CubsStringSlice lhs, CubsStringSlice rhs)
 
     return true;
 }
-
-size_t cubs_string_slice_hash(CubsStringSlice self)
-{
-    return bytes_hash(self.str, self.len);
-}
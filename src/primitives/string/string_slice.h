@@ -14,4 +14,6 @@ typedef struct CubsStringSlice {
 
 bool cubs_string_slice_eql(CubsStringSlice lhs, CubsStringSlice rhs);
 
+/// Hashes `self` the same as `cubs_string_hash(...)` hashes a string with the same contents.
+/// Useful for hash lookups by a string slice, without creating a string first.
 size_t cubs_string_slice_hash(CubsStringSlice self);
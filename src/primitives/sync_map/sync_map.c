@@ -0,0 +1,167 @@
+#include "sync_map.h"
+#include "../../sync/locks.h"
+#include "../../sync/atomic.h"
+#include <assert.h>
+#include "../../platform/mem.h"
+#include "../../util/hash.h"
+#include "../map/map.h"
+#include "../context.h"
+
+#define ALIGNMENT 64
+#define SHARD_BITS 6
+#define SHARD_COUNT (1 << SHARD_BITS)
+
+/*
+Each shard is its own `CubsMap`, so the groups within a shard are found and scanned exactly as usual.
+Within the shard's map, the pair bitmask is taken from the lowest 7 bits of the hash code, and the group
+from the bits above them, modulo the power of 2 group count. The shard is chosen by the highest 6 bits.
+A map would need 2^51 groups before its group index reached those, so the shards don't reduce how well
+pairs spread across groups.
+
+Hash codes are always computed before taking a shard lock, to keep the time spent holding it short.
+*/
+
+/// Aligned to the cache line, so threads locking neighbouring shards don't contend on the same line.
+typedef struct {
+    _Alignas(ALIGNMENT) CubsRwLock lock;
+    CubsMap map;
+} Shard;
+
+typedef struct {
+    _Alignas(ALIGNMENT) AtomicRefCount refCount;
+    Shard shards[SHARD_COUNT];
+} Inner;
+
+static const Inner* sync_map_inner(const CubsSyncMap* self) {
+    assert(self->_inner != NULL);
+    return (const Inner*)self->_inner;
+}
+
+static Inner* sync_map_inner_mut(CubsSyncMap* self) {
+    assert(self->_inner != NULL);
+    return (Inner*)self->_inner;
+}
+
+static size_t shard_index(size_t hashCode) {
+    return hashCode >> ((sizeof(size_t) * 8) - SHARD_BITS);
+}
+
+CubsSyncMap cubs_sync_map_init(const CubsTypeContext *keyContext, const CubsTypeContext *valueContext)
+{
+    assert(keyContext != NULL);
+    assert(valueContext != NULL);
+    assert(keyContext->eql.func.externC != NULL);
+    assert(keyContext->hash.func.externC != NULL);
+
+    Inner* inner = (Inner*)cubs_malloc(sizeof(Inner), ALIGNMENT);
+    atomic_ref_count_init(&inner->refCount);
+    for(size_t i = 0; i < SHARD_COUNT; i++) {
+        const CubsRwLock lock = CUBS_RWLOCK_INITIALIZER;
+        inner->shards[i].lock = lock;
+        inner->shards[i].map = cubs_map_init(keyContext, valueContext);
+    }
+
+    const CubsSyncMap map = {._inner = (void*)inner, .keyContext = keyContext, .valueContext = valueContext};
+    return map;
+}
+
+void cubs_sync_map_deinit(CubsSyncMap *self)
+{
+    if(self->_inner == NULL) {
+        return;
+    }
+
+    Inner* inner = sync_map_inner_mut(self);
+    self->_inner = NULL;
+
+    if(!atomic_ref_count_remove_ref(&inner->refCount)) {
+        return;
+    }
+
+    // This was the last reference, so no other thread can be accessing the shards.
+    for(size_t i = 0; i < SHARD_COUNT; i++) {
+        cubs_map_deinit(&inner->shards[i].map);
+    }
+    cubs_free((void*)inner, sizeof(Inner), ALIGNMENT);
+}
+
+CubsSyncMap cubs_sync_map_clone(const CubsSyncMap *self)
+{
+    Inner* inner = (Inner*)sync_map_inner(self); // explicitly const cast
+    atomic_ref_count_add_ref(&inner->refCount);
+    return *self;
+}
+
+size_t cubs_sync_map_len(const CubsSyncMap *self)
+{
+    const Inner* inner = sync_map_inner(self);
+    size_t len = 0;
+    for(size_t i = 0; i < SHARD_COUNT; i++) {
+        const Shard* shard = &inner->shards[i];
+        cubs_rwlock_lock_shared(&shard->lock);
+        len += shard->map.len;
+        cubs_rwlock_unlock_shared(&shard->lock);
+    }
+    return len;
+}
+
+bool cubs_sync_map_find(const CubsSyncMap *self, const void *key, void *outValue)
+{
+    assert(self->valueContext->clone.func.externC != NULL);
+
+    const size_t hashCode = cubs_context_fast_hash(key, self->keyContext);
+    const Shard* shard = &sync_map_inner(self)->shards[shard_index(hashCode)];
+
+    cubs_rwlock_lock_shared(&shard->lock);
+    const void* found = cubs_map_find_prehashed(&shard->map, key, hashCode);
+    if(found != NULL) {
+        cubs_context_fast_clone(outValue, found, self->valueContext);
+    }
+    cubs_rwlock_unlock_shared(&shard->lock);
+
+    return found != NULL;
+}
+
+bool cubs_sync_map_contains(const CubsSyncMap *self, const void *key)
+{
+    const size_t hashCode = cubs_context_fast_hash(key, self->keyContext);
+    const Shard* shard = &sync_map_inner(self)->shards[shard_index(hashCode)];
+
+    cubs_rwlock_lock_shared(&shard->lock);
+    const bool found = cubs_map_find_prehashed(&shard->map, key, hashCode) != NULL;
+    cubs_rwlock_unlock_shared(&shard->lock);
+
+    return found;
+}
+
+void cubs_sync_map_insert(CubsSyncMap *self, void *key, void *value)
+{
+    const size_t hashCode = cubs_context_fast_hash(key, self->keyContext);
+    Shard* shard = &sync_map_inner_mut(self)->shards[shard_index(hashCode)];
+
+    cubs_rwlock_lock_exclusive(&shard->lock);
+    cubs_map_insert_prehashed(&shard->map, key, value, hashCode);
+    cubs_rwlock_unlock_exclusive(&shard->lock);
+}
+
+bool cubs_sync_map_erase(CubsSyncMap *self, const void *key)
+{
+    const size_t hashCode = cubs_context_fast_hash(key, self->keyContext);
+    Shard* shard = &sync_map_inner_mut(self)->shards[shard_index(hashCode)];
+
+    cubs_rwlock_lock_exclusive(&shard->lock);
+    const bool erased = cubs_map_erase_prehashed(&shard->map, key, hashCode);
+    cubs_rwlock_unlock_exclusive(&shard->lock);
+
+    return erased;
+}
+
+bool cubs_sync_map_eql(const CubsSyncMap *self, const CubsSyncMap *other)
+{
+    return self->_inner == other->_inner;
+}
+
+size_t cubs_sync_map_hash(const CubsSyncMap *self)
+{
+    return cubs_hash_u64((uint64_t)(uintptr_t)self->_inner);
+}
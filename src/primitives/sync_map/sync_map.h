@@ -0,0 +1,65 @@
+#pragma once
+
+#include "../../c_basic_types.h"
+
+struct CubsTypeContext;
+
+/// A hashmap that can be shared and accessed between threads without any external locking.
+/// The key/value pairs are split across a fixed number of shards by the high bits of each key's hash code,
+/// where each shard is a `CubsMap` with its own rwlock. Threads only contend when they access the same shard,
+/// and finds within the same shard run in parallel.
+/// Like `CubsShared`, cloning shares the same underlying map rather than copying it.
+typedef struct CubsSyncMap {
+    /// Accessing this is unsafe
+    void* _inner;
+    /// Requires equality and hash function pointers
+    const struct CubsTypeContext* keyContext;
+    /// Requires a clone function pointer to use `cubs_sync_map_find(...)`
+    const struct CubsTypeContext* valueContext;
+} CubsSyncMap;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+CubsSyncMap cubs_sync_map_init(const struct CubsTypeContext* keyContext, const struct CubsTypeContext* valueContext);
+
+/// Releases this reference to the map. The key/value pairs are only deinitialized
+/// once every clone has also been deinitialized.
+void cubs_sync_map_deinit(CubsSyncMap* self);
+
+/// Does not copy the key/value pairs. The returned map refers to the same pairs as `self`.
+CubsSyncMap cubs_sync_map_clone(const CubsSyncMap* self);
+
+/// The total number of key/value pairs across every shard.
+/// Other threads may insert or erase while this is counting, so the result is only a snapshot.
+size_t cubs_sync_map_len(const CubsSyncMap* self);
+
+/// Find `key` within the map `self`. If it exists, clones the value into `outValue` and returns true,
+/// otherwise returns false and leaves `outValue` unmodified.
+/// The value is cloned, rather than referenced, as another thread may erase the pair once this returns.
+/// Assumes that `key` is the correct type that this map holds.
+bool cubs_sync_map_find(const CubsSyncMap* self, const void* key, void* outValue);
+
+/// Returns true if `key` exists within the map `self`.
+/// Assumes that `key` is the correct type that this map holds.
+bool cubs_sync_map_contains(const CubsSyncMap* self, const void* key);
+
+/// Takes ownership of `key` and `value`. If `key` already exists, its value is replaced.
+/// Only locks the shard that `key` belongs to.
+void cubs_sync_map_insert(CubsSyncMap* self, void* key, void* value);
+
+/// Returns true if the entry `key` exists, and thus was successfully deleted and cleaned up,
+/// and returns false if the entry doesn't exist.
+/// Assumes that `key` is the correct type that this map holds.
+bool cubs_sync_map_erase(CubsSyncMap* self, const void* key);
+
+/// Returns true if `self` and `other` refer to the same map.
+bool cubs_sync_map_eql(const CubsSyncMap* self, const CubsSyncMap* other);
+
+/// Hashes the identity of the map, not its key/value pairs, consistent with `cubs_sync_map_eql(...)`.
+size_t cubs_sync_map_hash(const CubsSyncMap* self);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
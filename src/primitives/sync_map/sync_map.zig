@@ -0,0 +1,199 @@
+const std = @import("std");
+const expect = std.testing.expect;
+const script_value = @import("../script_value.zig");
+const String = script_value.String;
+const TypeContext = script_value.TypeContext;
+
+/// Can be shared between threads without any external locking. See `src/primitives/sync_map/sync_map.h`.
+pub fn SyncMap(comptime K: type, comptime V: type) type {
+    return extern struct {
+        const Self = @This();
+        pub const KeyType = K;
+        pub const ValueType = V;
+
+        _inner: *anyopaque,
+        keyContext: *const TypeContext,
+        valueContext: *const TypeContext,
+
+        pub fn init() Self {
+            return @bitCast(CubsSyncMap.cubs_sync_map_init(TypeContext.auto(K), TypeContext.auto(V)));
+        }
+
+        pub fn deinit(self: *Self) void {
+            CubsSyncMap.cubs_sync_map_deinit(self.asRawMut());
+        }
+
+        /// Refers to the same key/value pairs as `self`.
+        pub fn clone(self: *const Self) Self {
+            return @bitCast(CubsSyncMap.cubs_sync_map_clone(self.asRaw()));
+        }
+
+        pub fn len(self: *const Self) usize {
+            return CubsSyncMap.cubs_sync_map_len(self.asRaw());
+        }
+
+        /// Returns a clone of the value, which must be deinitialized.
+        pub fn find(self: *const Self, key: *const K) ?V {
+            var out: V = undefined;
+            if (CubsSyncMap.cubs_sync_map_find(self.asRaw(), @ptrCast(key), @ptrCast(&out))) {
+                return out;
+            }
+            return null;
+        }
+
+        pub fn contains(self: *const Self, key: *const K) bool {
+            return CubsSyncMap.cubs_sync_map_contains(self.asRaw(), @ptrCast(key));
+        }
+
+        pub fn insert(self: *Self, key: K, value: V) void {
+            var mutKey = key;
+            var mutValue = value;
+            CubsSyncMap.cubs_sync_map_insert(self.asRawMut(), @ptrCast(&mutKey), @ptrCast(&mutValue));
+        }
+
+        pub fn erase(self: *Self, key: *const K) bool {
+            return CubsSyncMap.cubs_sync_map_erase(self.asRawMut(), @ptrCast(key));
+        }
+
+        pub fn eql(self: *const Self, other: Self) bool {
+            return CubsSyncMap.cubs_sync_map_eql(self.asRaw(), other.asRaw());
+        }
+
+        pub fn hash(self: *const Self) usize {
+            return CubsSyncMap.cubs_sync_map_hash(self.asRaw());
+        }
+
+        pub fn asRaw(self: *const Self) *const CubsSyncMap {
+            return @ptrCast(self);
+        }
+
+        pub fn asRawMut(self: *Self) *CubsSyncMap {
+            return @ptrCast(self);
+        }
+    };
+}
+
+pub const CubsSyncMap = extern struct {
+    _inner: *anyopaque,
+    keyContext: *const TypeContext,
+    valueContext: *const TypeContext,
+
+    pub extern fn cubs_sync_map_init(keyContext: *const TypeContext, valueContext: *const TypeContext) callconv(.C) CubsSyncMap;
+    pub extern fn cubs_sync_map_deinit(self: *CubsSyncMap) callconv(.C) void;
+    pub extern fn cubs_sync_map_clone(self: *const CubsSyncMap) callconv(.C) CubsSyncMap;
+    pub extern fn cubs_sync_map_len(self: *const CubsSyncMap) callconv(.C) usize;
+    pub extern fn cubs_sync_map_find(self: *const CubsSyncMap, key: *const anyopaque, outValue: *anyopaque) callconv(.C) bool;
+    pub extern fn cubs_sync_map_contains(self: *const CubsSyncMap, key: *const anyopaque) callconv(.C) bool;
+    pub extern fn cubs_sync_map_insert(self: *CubsSyncMap, key: *anyopaque, value: *anyopaque) callconv(.C) void;
+    pub extern fn cubs_sync_map_erase(self: *CubsSyncMap, key: *const anyopaque) callconv(.C) bool;
+    pub extern fn cubs_sync_map_eql(self: *const CubsSyncMap, other: *const CubsSyncMap) callconv(.C) bool;
+    pub extern fn cubs_sync_map_hash(self: *const CubsSyncMap) callconv(.C) usize;
+};
+
+test "init" {
+    {
+        var map = SyncMap(i64, f64).init();
+        defer map.deinit();
+    }
+    {
+        var map = SyncMap(String, bool).init();
+        defer map.deinit();
+    }
+}
+
+test "insert find erase" {
+    var map = SyncMap(String, String).init();
+    defer map.deinit();
+
+    for (0..100) |i| {
+        map.insert(String.fromInt(@intCast(i)), String.initUnchecked("hello world!"));
+    }
+    try expect(map.len() == 100);
+
+    for (0..100) |i| {
+        var key = String.fromInt(@intCast(i));
+        defer key.deinit();
+
+        try expect(map.contains(&key));
+        if (map.find(&key)) |found| {
+            var value = found;
+            defer value.deinit();
+            try expect(value.eqlSlice("hello world!"));
+        } else {
+            try expect(false);
+        }
+
+        if (i % 2 == 0) {
+            try expect(map.erase(&key));
+            try expect(!map.erase(&key));
+            try expect(map.find(&key) == null);
+        }
+    }
+    try expect(map.len() == 50);
+}
+
+test "insert existing key" {
+    var map = SyncMap(i64, i64).init();
+    defer map.deinit();
+
+    map.insert(1, 10);
+    map.insert(1, 20);
+
+    try expect(map.len() == 1);
+    try expect(map.find(&@as(i64, 1)).? == 20);
+}
+
+test "clone eql" {
+    var map = SyncMap(i64, i64).init();
+    defer map.deinit();
+
+    var clone = map.clone();
+    defer clone.deinit();
+
+    try expect(map.eql(clone));
+    try expect(map.hash() == clone.hash());
+
+    clone.insert(5, 6);
+    try expect(map.find(&@as(i64, 5)).? == 6); // same pairs
+
+    var other = SyncMap(i64, i64).init();
+    defer other.deinit();
+    try expect(!map.eql(other));
+}
+
+const Thread = std.Thread;
+
+test "threads insert find erase" {
+    const Validate = struct {
+        fn run(map: *SyncMap(i64, i64), threadIndex: usize) void {
+            const start: i64 = @intCast(threadIndex * 10000);
+            for (0..10000) |i| {
+                const key = start + @as(i64, @intCast(i));
+                map.insert(key, key * 2);
+                expect(map.find(&key).? == key * 2) catch unreachable;
+                if (i % 2 == 1) {
+                    expect(map.erase(&key)) catch unreachable;
+                }
+            }
+        }
+    };
+
+    var map = SyncMap(i64, i64).init();
+    defer map.deinit();
+
+    const t1 = try Thread.spawn(.{}, Validate.run, .{ &map, 0 });
+    const t2 = try Thread.spawn(.{}, Validate.run, .{ &map, 1 });
+    const t3 = try Thread.spawn(.{}, Validate.run, .{ &map, 2 });
+    const t4 = try Thread.spawn(.{}, Validate.run, .{ &map, 3 });
+
+    t1.join();
+    t2.join();
+    t3.join();
+    t4.join();
+
+    try expect(map.len() == 20000);
+    for (0..40000) |i| {
+        const key: i64 = @intCast(i);
+        try expect(map.contains(&key) == (i % 2 == 0));
+    }
+}
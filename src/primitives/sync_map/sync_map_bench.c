@@ -0,0 +1,154 @@
+#include "../../bench.h"
+#include "sync_map.h"
+#include "../map/map.h"
+#include "../sync_ptr/sync_ptr.h"
+#include "../context.h"
+#include <assert.h>
+#include <stdio.h>
+#include <threads.h>
+
+#define PRELOAD_ENTRY_COUNT 100000
+#define KEY_RANGE (PRELOAD_ENTRY_COUNT * 2)
+#define OPS_PER_THREAD 400000
+#define MAX_THREADS 8
+
+/*
+Every thread runs the same mix of operations on one map shared between all of them,
+90% finds, 5% inserts and 5% erases, over keys of which roughly half are present.
+This compares `CubsSyncMap` against the existing way of sharing a map, a `CubsMap` within a `CubsShared`,
+which takes the one rwlock of the `CubsShared` for every operation.
+Per operation times are the wall clock time divided by the total operations of every thread, so on a machine
+with enough cores, a lower time with more threads means the map scales.
+*/
+
+typedef struct {
+    CubsSyncMap* syncMap;
+    CubsShared* sharedMap;
+    uint64_t seed;
+    int64_t found;
+} WorkerArgs;
+
+/// splitmix64, so each thread has its own deterministic key sequence.
+static uint64_t next_random(uint64_t* state) {
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+static int sync_map_worker(void* arg) {
+    WorkerArgs* args = (WorkerArgs*)arg;
+    uint64_t state = args->seed;
+    int64_t found = 0;
+    for(int i = 0; i < OPS_PER_THREAD; i++) {
+        const uint64_t r = next_random(&state);
+        int64_t key = (int64_t)((r >> 8) % KEY_RANGE);
+        const uint64_t op = r % 100;
+        if(op < 90) {
+            int64_t value;
+            found += cubs_sync_map_find(args->syncMap, (const void*)&key, (void*)&value);
+        } else if(op < 95) {
+            int64_t value = key;
+            cubs_sync_map_insert(args->syncMap, (void*)&key, (void*)&value);
+        } else {
+            (void)cubs_sync_map_erase(args->syncMap, (const void*)&key);
+        }
+    }
+    args->found = found;
+    return 0;
+}
+
+static int shared_map_worker(void* arg) {
+    WorkerArgs* args = (WorkerArgs*)arg;
+    uint64_t state = args->seed;
+    int64_t found = 0;
+    for(int i = 0; i < OPS_PER_THREAD; i++) {
+        const uint64_t r = next_random(&state);
+        int64_t key = (int64_t)((r >> 8) % KEY_RANGE);
+        const uint64_t op = r % 100;
+        if(op < 90) {
+            cubs_shared_lock_shared(args->sharedMap);
+            const CubsMap* map = (const CubsMap*)cubs_shared_get(args->sharedMap);
+            found += cubs_map_find(map, (const void*)&key) != NULL;
+            cubs_shared_unlock_shared(args->sharedMap);
+        } else if(op < 95) {
+            int64_t value = key;
+            cubs_shared_lock_exclusive(args->sharedMap);
+            cubs_map_insert((CubsMap*)cubs_shared_get_mut(args->sharedMap), (void*)&key, (void*)&value);
+            cubs_shared_unlock_exclusive(args->sharedMap);
+        } else {
+            cubs_shared_lock_exclusive(args->sharedMap);
+            (void)cubs_map_erase((CubsMap*)cubs_shared_get_mut(args->sharedMap), (const void*)&key);
+            cubs_shared_unlock_exclusive(args->sharedMap);
+        }
+    }
+    args->found = found;
+    return 0;
+}
+
+/// Runs `worker` on `threadCount` threads at once, and reports the combined throughput.
+static void run_workers(const char* name, thrd_start_t worker, CubsSyncMap* syncMap, CubsShared* sharedMap, int threadCount) {
+    thrd_t threads[MAX_THREADS];
+    WorkerArgs args[MAX_THREADS];
+    assert(threadCount <= MAX_THREADS);
+
+    const uint64_t start = cubs_bench_now_ns();
+    for(int i = 0; i < threadCount; i++) {
+        args[i].syncMap = syncMap;
+        args[i].sharedMap = sharedMap;
+        args[i].seed = (uint64_t)(i + 1);
+        args[i].found = 0;
+        const int result = thrd_create(&threads[i], worker, (void*)&args[i]);
+        assert(result == thrd_success);
+        (void)result;
+    }
+    int64_t found = 0;
+    for(int i = 0; i < threadCount; i++) {
+        (void)thrd_join(threads[i], NULL);
+        found += args[i].found;
+    }
+    const uint64_t elapsed = cubs_bench_now_ns() - start;
+
+    char fullName[64];
+    (void)snprintf(fullName, sizeof(fullName), "%s %d threads", name, threadCount);
+    cubs_bench_report(fullName, (uint64_t)OPS_PER_THREAD * (uint64_t)threadCount, elapsed);
+    // Keep `found` alive
+    if(found < 0) {
+        fprintf(stdout, "\n");
+    }
+}
+
+static void bench_sync_map(int threadCount) {
+    CubsSyncMap map = cubs_sync_map_init(&CUBS_INT_CONTEXT, &CUBS_INT_CONTEXT);
+    for(int64_t i = 0; i < PRELOAD_ENTRY_COUNT; i++) {
+        int64_t key = i * 2;
+        int64_t value = i;
+        cubs_sync_map_insert(&map, (void*)&key, (void*)&value);
+    }
+
+    run_workers("sync map int mixed", &sync_map_worker, &map, NULL, threadCount);
+
+    cubs_sync_map_deinit(&map);
+}
+
+static void bench_shared_map(int threadCount) {
+    CubsMap map = cubs_map_init(&CUBS_INT_CONTEXT, &CUBS_INT_CONTEXT);
+    for(int64_t i = 0; i < PRELOAD_ENTRY_COUNT; i++) {
+        int64_t key = i * 2;
+        int64_t value = i;
+        cubs_map_insert(&map, (void*)&key, (void*)&value);
+    }
+    CubsShared shared = cubs_shared_init((void*)&map, &CUBS_MAP_CONTEXT);
+
+    run_workers("shared map int mixed", &shared_map_worker, NULL, &shared, threadCount);
+
+    cubs_shared_deinit(&shared);
+}
+
+void cubs_bench_sync_map()
+{
+    for(int threadCount = 1; threadCount <= MAX_THREADS; threadCount *= 2) {
+        bench_shared_map(threadCount);
+        bench_sync_map(threadCount);
+    }
+}
@@ -126,6 +126,34 @@ int cubs_function_call(CubsFunctionCallArgs self, CubsFunctionReturn outReturn)
     }
 }
 
+int cubs_function_call_batch(
+    const CubsFunction* self,
+    const void* const* argArrays,
+    const size_t* argStrides,
+    size_t count,
+    void* outReturns,
+    size_t* optOutCompleted
+) {
+    if(self->funcType != cubsFunctionPtrTypeScript) {
+        cubs_panic("Only script functions can be called in batches");
+    }
+    const CubsScriptFunctionPtr* header = self->func.script;
+    // Checked once for the whole batch
+    #if _DEBUG
+    if(header->returnType != NULL && outReturns == NULL && count > 0) {
+        char buf[512];
+        #if defined(_WIN32) || defined(WIN32)
+        const int len = sprintf_s(buf, 512, "Script function [%s] expected return value destination", cubs_string_as_slice(&header->name).str);
+        #else
+        const int len = sprintf(buf, "Script function [%s] expected return value destination", cubs_string_as_slice(&header->name).str);
+        #endif
+        assert(len >= 0);
+        cubs_panic(buf);
+    }
+    #endif
+    return (int)cubs_interpreter_execute_function_batch(header, argArrays, argStrides, count, outReturns, optOutCompleted);
+}
+
 void cubs_function_return_set_value(CubsCFunctionHandler self, void* returnValue, const struct CubsTypeContext* returnContext)
 {
     assert(self.outReturn.value != NULL);
@@ -50,6 +50,14 @@ typedef struct CubsScriptFunctionPtr {
     size_t argsLen;
     size_t _stackSpaceRequired;
     size_t _bytecodeCount;
+    /// Bitmap of the stack slots that may ever hold an owned value that isn't a primitive,
+    /// meaning it could need a destructor. Unwinding skips all other slots.
+    /// `_destructorSlots[0]` is the number of bitmap words that follow.
+    const uint64_t* _destructorSlots;
+    /// Calls left until the JIT compiles the function, or 0 if it never will. See `jit.h`.
+    size_t _jitCallsUntilCompile;
+    /// Machine code the JIT compiled the function to, or NULL if it's interpreted. See `jit.h`.
+    const void* _jitCode;
 } CubsScriptFunctionPtr;
 
 #ifdef __cplusplus
@@ -69,6 +77,23 @@ void cubs_function_push_arg(CubsFunctionCallArgs* self, void* arg, const struct
 /// otherwise returns a user defined, non 0 error code. 
 int cubs_function_call(CubsFunctionCallArgs self, CubsFunctionReturn outReturn);
 
+/// Calls the script function `self` once for each of `count` entities, setting up each call's frame
+/// directly, rather than through `cubs_function_push_arg(...)`. Argument `j` of call `i` is moved from
+/// `(const char*)argArrays[j] + (i * argStrides[j])`, so arguments can come from separate arrays, or
+/// from fields of an array of structs. Each argument must be of the type the function declares.
+/// Return values are moved into `outReturns` one after another, or it may be NULL if the function
+/// doesn't return anything. Stops at the first error, returning it, and setting `optOutCompleted`
+/// to how many calls succeeded. The arguments of the calls after the failed one are left untouched.
+/// C functions can't be batched, as there are no declared argument types to stream them as.
+int cubs_function_call_batch(
+    const struct CubsFunction* self,
+    const void* const* argArrays,
+    const size_t* argStrides,
+    size_t count,
+    void* outReturns,
+    size_t* optOutCompleted
+);
+
 /// Defined in `interpreter.c`.
 /// Moves the argument at `argIndex` to the memory at `outArg`.
 /// `argIndex` is an array index, in which `0` is the first argument, `1` is the second argument, etc. 
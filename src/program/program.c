@@ -70,6 +70,11 @@ CubsProgram cubs_program_init(CubsProgramInitParams params)
         .contextMutex = CUBS_MUTEX_INITIALIZER,
         .functionMap = (FunctionMap){0},
         .typeMap = (TypeMap){0},
+        .images = NULL,
+        .inlineThreshold = 0,
+        .jitCallThreshold = params.jitCallThreshold,
+        .jitCode = NULL,
+        .jitMutex = CUBS_MUTEX_INITIALIZER,
     };
     *inner = innerData;
 
@@ -86,6 +91,17 @@ void cubs_program_deinit(CubsProgram *self)
     inner->context.vtable->deinit(inner->context.ptr);
     cubs_mutex_unlock(&inner->contextMutex);
 
+    for(ProgramImage* image = inner->images; image != NULL; image = image->next) {
+        _cubs_program_image_unmap(image);
+    }
+
+    JitCode* code = inner->jitCode;
+    while(code != NULL) {
+        JitCode* next = code->next;
+        _cubs_jit_code_free(code);
+        code = next;
+    }
+
     ProtectedArena arena = inner->arena;
     cubs_protected_arena_free(&arena, (void*)inner);
     cubs_protected_arena_deinit(&arena);
@@ -158,6 +174,11 @@ CubsScriptFunctionPtr* cubs_function_builder_build(FunctionBuilder* self, CubsPr
 
     ProgramInner* inner = as_inner_mut(program);
 
+    if(inner->inlineThreshold > 0) {
+        cubs_function_builder_inline_calls(self, inner->inlineThreshold);
+    }
+    cubs_function_builder_make_tail_calls(self);
+
     const CubsTypeContext** newArgsTypes = NULL;
     size_t newArgsLen = 0;
     if(self->args.len > 0) {
@@ -179,14 +200,23 @@ CubsScriptFunctionPtr* cubs_function_builder_build(FunctionBuilder* self, CubsPr
         .argsLen = newArgsLen,
         ._stackSpaceRequired = self->stackSpaceRequired,
         ._bytecodeCount = self->bytecodeLen,
+        ._jitCallsUntilCompile = inner->jitCallThreshold,
+        ._jitCode = NULL,
     };
+    // The destructor slots bitmap follows the bytecode, prefixed by it's word count
+    const size_t destructorSlotsWords = CUBS_DESTRUCTOR_SLOTS_WORDS(self->stackSpaceRequired);
     CubsScriptFunctionPtr* header = cubs_protected_arena_malloc(
         &inner->arena, 
-        sizeof(CubsScriptFunctionPtr) + (sizeof(Bytecode) * self->bytecodeLen), 
+        sizeof(CubsScriptFunctionPtr) + (sizeof(Bytecode) * self->bytecodeLen) + (sizeof(uint64_t) * (1 + destructorSlotsWords)), 
         _Alignof(Bytecode)
     );
     *header = headerData;
     memcpy((void*)cubs_function_bytecode_start(header), (const void*)self->bytecode, self->bytecodeLen * sizeof(Bytecode));
+    {
+        uint64_t* destructorSlots = (uint64_t*)&cubs_function_bytecode_start(header)[self->bytecodeLen];
+        destructorSlots[0] = (uint64_t)cubs_function_builder_find_destructor_slots(self, &destructorSlots[1]);
+        header->_destructorSlots = destructorSlots;
+    }
 
     { // deinitialize function builder
         // Explicitly DO NOT deinitialize the names, as their ownership is transferred above with `headerData`
@@ -39,6 +39,9 @@ typedef struct CubsProgramContext {
 typedef struct CubsProgramInitParams {
     /// Can be NULL
     CubsProgramContext* context;
+    /// Script functions are compiled to machine code once they've been called this many times,
+    /// where the JIT is supported. See `src/interpreter/jit.h`. If 0, every function is interpreted.
+    size_t jitCallThreshold;
 } CubsProgramInitParams;
 
 CubsProgram cubs_program_compile(CubsProgramInitParams params, const CubsBuildOptions* build);
@@ -35,6 +35,8 @@ pub const Program = extern struct {
 
     pub const InitParams = extern struct {
         context: ?*Context = null,
+        /// See `CubsProgramInitParams.jitCallThreshold`.
+        jitCallThreshold: usize = 0,
     };
 
     pub const RuntimeError = enum(c_int) {
@@ -57,6 +59,7 @@ pub const Program = extern struct {
         ArccosUndefined = 16,
         HyperbolicArccosUndefined = 17,
         HyperbolicArctanUndefined = 18,
+        YieldOutsideCoroutine = 20,
     };
 
     test init {
@@ -0,0 +1,690 @@
+#include "program_image.h"
+#include "program_internal.h"
+#include "../interpreter/function_definition.h"
+#include "../interpreter/bytecode.h"
+#include "../interpreter/operations.h"
+#include "../interpreter/verifier.h"
+#include "../interpreter/stack.h"
+#include "../primitives/context.h"
+#include "../platform/mem.h"
+#include "../util/unreachable.h"
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+static const char IMAGE_MAGIC[8] = {'C', 'U', 'B', 'S', 'I', 'M', 'G', '\0'};
+static const uint32_t IMAGE_BYTE_ORDER_MARK = 0x01020304;
+
+/// Opcodes known to this build. Images written with a different set of opcodes are rejected.
+#define IMAGE_OPCODE_COUNT ((uint32_t)OpCodeLoadImmediateAddInt + 1)
+
+/// Every offset within the image is relative to the start of it.
+typedef struct ImageHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrderMark;
+    uint32_t opcodeCount;
+    uint32_t functionHeaderSize;
+    uint64_t imageLen;
+    uint64_t functionCount;
+    /// Offset of `functionCount` `ImageFunction`.
+    uint64_t functionsOffset;
+    uint64_t fixupCount;
+    /// Offset of `fixupCount` `ImageFixup`.
+    uint64_t fixupsOffset;
+    uint64_t stringsOffset;
+    uint64_t stringsLen;
+    /// How many `FIXUP_STRING_CONSTANT` fixups there are.
+    uint64_t stringConstantCount;
+} ImageHeader;
+
+typedef struct ImageFunction {
+    /// Offset of the function's `CubsScriptFunctionPtr`, which is followed by it's bytecode and destructor
+    /// slots, as `cubs_function_builder_build(...)` lays them out. It's names are set on load.
+    uint64_t headerOffset;
+    /// Offsets into the string table.
+    uint64_t fullyQualifiedNameOffset;
+    uint64_t fullyQualifiedNameLen;
+    uint64_t nameOffset;
+    uint64_t nameLen;
+} ImageFunction;
+
+enum ImageFixupKind {
+    /// `value` is an index into `BUILTIN_CONTEXTS`.
+    FIXUP_BUILTIN_CONTEXT = 0,
+    /// `value` is the index of an `ImageFunction`, to point to it's header.
+    FIXUP_FUNCTION = 1,
+    /// `value` is an offset within the image to point to.
+    FIXUP_IMAGE_OFFSET = 2,
+    /// `value` and `len` are a string table range, to point to a `CubsString` of.
+    FIXUP_STRING_CONSTANT = 3,
+};
+
+/// Overwrites the pointer sized word at `offset` on load.
+typedef struct ImageFixup {
+    uint64_t offset;
+    uint64_t kind;
+    uint64_t value;
+    uint64_t len;
+} ImageFixup;
+
+/// The order is part of the image format. Only append to it.
+static const CubsTypeContext* const BUILTIN_CONTEXTS[] = {
+    &CUBS_BOOL_CONTEXT,
+    &CUBS_INT_CONTEXT,
+    &CUBS_FLOAT_CONTEXT,
+    &CUBS_CHAR_CONTEXT,
+    &CUBS_STRING_CONTEXT,
+    &CUBS_ORDERING_CONTEXT,
+    &CUBS_ARRAY_CONTEXT,
+    &CUBS_SET_CONTEXT,
+    &CUBS_MAP_CONTEXT,
+    &CUBS_OPTION_CONTEXT,
+    &CUBS_ERROR_CONTEXT,
+    &CUBS_RESULT_CONTEXT,
+    &CUBS_UNIQUE_CONTEXT,
+    &CUBS_SHARED_CONTEXT,
+    &CUBS_WEAK_CONTEXT,
+    &CUBS_FUNCTION_CONTEXT,
+    &CUBS_CONST_REF_CONTEXT,
+    &CUBS_MUT_REF_CONTEXT,
+    &CUBS_SYNC_MAP_CONTEXT,
+};
+#define BUILTIN_CONTEXT_COUNT (sizeof(BUILTIN_CONTEXTS) / sizeof(BUILTIN_CONTEXTS[0]))
+
+#pragma region Write
+
+typedef struct ByteBuffer {
+    uint8_t* bytes;
+    size_t len;
+    size_t capacity;
+} ByteBuffer;
+
+static void byte_buffer_deinit(ByteBuffer* self) {
+    if(self->bytes != NULL) {
+        cubs_free((void*)self->bytes, self->capacity, _Alignof(uint64_t));
+    }
+    const ByteBuffer zeroed = {0};
+    *self = zeroed;
+}
+
+/// Appends `len` zeroed bytes, padded to 8 byte alignment. Returns the offset of them.
+static size_t byte_buffer_append_zeroed(ByteBuffer* self, size_t len) {
+    const size_t offset = self->len;
+    const size_t newLen = offset + ((len + 7) & ~(size_t)7);
+    if(newLen > self->capacity) {
+        size_t newCapacity = self->capacity == 0 ? 4096 : self->capacity * 2;
+        while(newCapacity < newLen) {
+            newCapacity *= 2;
+        }
+        uint8_t* newBytes = (uint8_t*)cubs_malloc(newCapacity, _Alignof(uint64_t));
+        if(self->bytes != NULL) {
+            memcpy((void*)newBytes, (const void*)self->bytes, self->len);
+            cubs_free((void*)self->bytes, self->capacity, _Alignof(uint64_t));
+        }
+        self->bytes = newBytes;
+        self->capacity = newCapacity;
+    }
+    memset((void*)&self->bytes[offset], 0, newLen - offset);
+    self->len = newLen;
+    return offset;
+}
+
+static size_t byte_buffer_append(ByteBuffer* self, const void* data, size_t len) {
+    const size_t offset = byte_buffer_append_zeroed(self, len);
+    if(len > 0) {
+        memcpy((void*)&self->bytes[offset], data, len);
+    }
+    return offset;
+}
+
+/// Sorted by function pointer, to find the index of a call's callee.
+typedef struct FunctionIndex {
+    const CubsScriptFunctionPtr* function;
+    size_t index;
+} FunctionIndex;
+
+static int function_index_compare(const void* lhs, const void* rhs) {
+    const uintptr_t a = (uintptr_t)((const FunctionIndex*)lhs)->function;
+    const uintptr_t b = (uintptr_t)((const FunctionIndex*)rhs)->function;
+    return (a > b) - (a < b);
+}
+
+typedef struct ImageWriter {
+    /// The header, followed by each function.
+    ByteBuffer image;
+    ByteBuffer fixups;
+    ByteBuffer strings;
+    size_t fixupCount;
+    size_t stringConstantCount;
+    const FunctionIndex* sortedFunctions;
+    size_t functionCount;
+} ImageWriter;
+
+static void writer_add_fixup(ImageWriter* self, size_t offset, enum ImageFixupKind kind, uint64_t value, uint64_t len) {
+    const ImageFixup fixup = {.offset = offset, .kind = kind, .value = value, .len = len};
+    (void)byte_buffer_append(&self->fixups, (const void*)&fixup, sizeof(ImageFixup));
+    self->fixupCount += 1;
+}
+
+static bool writer_add_context_fixup(ImageWriter* self, size_t offset, const CubsTypeContext* context) {
+    for(size_t i = 0; i < BUILTIN_CONTEXT_COUNT; i++) {
+        if(BUILTIN_CONTEXTS[i] == context) {
+            writer_add_fixup(self, offset, FIXUP_BUILTIN_CONTEXT, i, 0);
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool writer_add_function_fixup(ImageWriter* self, size_t offset, const CubsScriptFunctionPtr* function) {
+    const FunctionIndex key = {.function = function, .index = 0};
+    const FunctionIndex* found = (const FunctionIndex*)bsearch(
+        (const void*)&key, (const void*)self->sortedFunctions, self->functionCount, sizeof(FunctionIndex), function_index_compare);
+    if(found == NULL) {
+        return false;
+    }
+    writer_add_fixup(self, offset, FIXUP_FUNCTION, found->index, 0);
+    return true;
+}
+
+/// Bytecode required for the argument sources following a call, 4 per bytecode.
+/// See `cubs_operands_make_call_immediate(...)` and `cubs_operands_make_call_src(...)`.
+static size_t call_args_bytecode_required(size_t argCount) {
+    if((argCount % 4) == 0) {
+        return argCount / 4;
+    }
+    return (argCount / 4) + 1;
+}
+
+/// Adds fixups for the pointers within the operation at `bytecodeOffset` in the image, clearing them
+/// in the image. Constants the operation clones are appended to the image.
+/// @return The number of bytecodes the operation occupies, or 0 if it can't be serialized.
+static size_t writer_relocate_operation(ImageWriter* self, size_t bytecodeOffset) {
+    // Appending constants may move the image, so only access it through `at(...)`
+    #define at(i) (&((Bytecode*)&self->image.bytes[bytecodeOffset])[i])
+    #define offset_of(i) (bytecodeOffset + ((i) * sizeof(Bytecode)))
+
+    const OpCode opcode = cubs_bytecode_get_opcode(*at(0));
+    switch(opcode) {
+        case OpCodeLoad: {
+            const OperandsLoadUnknown unknownOperands = *(const OperandsLoadUnknown*)at(0);
+            switch(unknownOperands.loadType) {
+                case LOAD_TYPE_IMMEDIATE: {
+                    return 1;
+                }
+                case LOAD_TYPE_IMMEDIATE_LONG: {
+                    return 2;
+                }
+                case LOAD_TYPE_DEFAULT: {
+                    const OperandsLoadDefault operands = *(const OperandsLoadDefault*)at(0);
+                    switch(operands.tag) {
+                        case cubsValueTagArray:
+                        case cubsValueTagSet:
+                        case cubsValueTagOption: {
+                            return writer_add_context_fixup(self, offset_of(1), (const CubsTypeContext*)at(1)->value) ? 2 : 0;
+                        }
+                        case cubsValueTagMap: {
+                            if(!writer_add_context_fixup(self, offset_of(1), (const CubsTypeContext*)at(1)->value)
+                                || !writer_add_context_fixup(self, offset_of(2), (const CubsTypeContext*)at(2)->value))
+                            {
+                                return 0;
+                            }
+                            return 3;
+                        }
+                        default: {
+                            return 1;
+                        }
+                    }
+                }
+                case LOAD_TYPE_CLONE_FROM_PTR: {
+                    const void* immediate = (const void*)at(1)->value;
+                    const CubsTypeContext* context = (const CubsTypeContext*)at(2)->value;
+                    if(!writer_add_context_fixup(self, offset_of(2), context)) {
+                        return 0;
+                    }
+                    if(context == &CUBS_STRING_CONTEXT) {
+                        const CubsStringSlice slice = cubs_string_as_slice((const CubsString*)immediate);
+                        const size_t stringOffset = byte_buffer_append(&self->strings, (const void*)slice.str, slice.len);
+                        writer_add_fixup(self, offset_of(1), FIXUP_STRING_CONSTANT, stringOffset, slice.len);
+                        self->stringConstantCount += 1;
+                    } else if(context == &CUBS_BOOL_CONTEXT || context == &CUBS_INT_CONTEXT
+                        || context == &CUBS_FLOAT_CONTEXT || context == &CUBS_CHAR_CONTEXT)
+                    {
+                        // Trivially copyable, so the value itself is stored in the image
+                        const size_t valueOffset = byte_buffer_append(&self->image, immediate, context->sizeOfType);
+                        writer_add_fixup(self, offset_of(1), FIXUP_IMAGE_OFFSET, valueOffset, 0);
+                    } else {
+                        return 0;
+                    }
+                    return 3;
+                }
+                default: {
+                    unreachable();
+                }
+            }
+        }
+        case OpCodeCall: {
+            const OperandsCallUnknown operands = *(const OperandsCallUnknown*)at(0);
+            if(operands.opType == CALL_TYPE_IMMEDIATE) {
+                const OperandsCallImmediate immediateOperands = *(const OperandsCallImmediate*)at(0);
+                if(immediateOperands.funcType != cubsFunctionPtrTypeScript
+                    || !writer_add_function_fixup(self, offset_of(1), (const CubsScriptFunctionPtr*)at(1)->value))
+                {
+                    return 0;
+                }
+            } else {
+                // The inline cache holds whatever function was last called
+                at(1)->value = 0;
+            }
+            return 2 + call_args_bytecode_required(operands.argCount);
+        }
+        case OpCodeSync: {
+            const OperandsSync operands = *(const OperandsSync*)at(0);
+            if(operands.opType == SYNC_TYPE_UNSYNC) {
+                return 1;
+            }
+            return cubs_operands_sync_bytecode_required(operands.num);
+        }
+        case OpCodeNop:
+        case OpCodeReturn:
+        case OpCodeJump:
+        case OpCodeDeinit:
+        case OpCodeMove:
+        case OpCodeClone:
+        case OpCodeDereference:
+        case OpCodeSetReference:
+        case OpCodeMakeReference:
+        case OpCodeGetMember:
+        case OpCodeSetMember:
+        case OpCodeCast:
+        case OpCodeEqual:
+        case OpCodeNotEqual:
+        case OpCodeLess:
+        case OpCodeGreater:
+        case OpCodeLessOrEqual:
+        case OpCodeGreaterOrEqual:
+        case OpCodeIncrement:
+        case OpCodeAdd:
+        case OpCodeIncrementInt:
+        case OpCodeAddInt:
+        case OpCodeAddFloat:
+        case OpCodeEqualInt:
+        case OpCodeNotEqualInt:
+        case OpCodeLessInt:
+        case OpCodeGreaterInt:
+        case OpCodeLessOrEqualInt:
+        case OpCodeGreaterOrEqualInt:
+        case OpCodeLessFloat:
+        case OpCodeGreaterFloat:
+        case OpCodeLessOrEqualFloat:
+        case OpCodeGreaterOrEqualFloat:
+        case OpCodeYield:
+        case OpCodeIncrementLessIntJump:
+        case OpCodeLoadImmediateAddInt: {
+            return 1;
+        }
+        default: {
+            unreachable();
+        }
+    }
+
+    #undef at
+    #undef offset_of
+}
+
+/// Appends `function`, it's bytecode, destructor slots, and argument types to the image.
+static bool writer_add_function(ImageWriter* self, const CubsScriptFunctionPtr* function, ImageFunction* outEntry) {
+    const size_t destructorSlotsLen = sizeof(uint64_t) * (1 + function->_destructorSlots[0]);
+    const size_t headerOffset = byte_buffer_append_zeroed(&self->image,
+        sizeof(CubsScriptFunctionPtr) + (sizeof(Bytecode) * function->_bytecodeCount) + destructorSlotsLen);
+    const size_t bytecodeOffset = headerOffset + sizeof(CubsScriptFunctionPtr);
+    const size_t destructorSlotsOffset = bytecodeOffset + (sizeof(Bytecode) * function->_bytecodeCount);
+    memcpy((void*)&self->image.bytes[bytecodeOffset], (const void*)cubs_function_bytecode_start(function), sizeof(Bytecode) * function->_bytecodeCount);
+    memcpy((void*)&self->image.bytes[destructorSlotsOffset], (const void*)function->_destructorSlots, destructorSlotsLen);
+
+    { // Pointers are left NULL, and the names are left zeroed, to be set on load
+        CubsScriptFunctionPtr header = {0};
+        header.argsLen = function->argsLen;
+        header._stackSpaceRequired = function->_stackSpaceRequired;
+        header._bytecodeCount = function->_bytecodeCount;
+        memcpy((void*)&self->image.bytes[headerOffset], (const void*)&header, sizeof(CubsScriptFunctionPtr));
+    }
+    writer_add_fixup(self, headerOffset + offsetof(CubsScriptFunctionPtr, _destructorSlots), FIXUP_IMAGE_OFFSET, destructorSlotsOffset, 0);
+    if(function->returnType != NULL) {
+        if(!writer_add_context_fixup(self, headerOffset + offsetof(CubsScriptFunctionPtr, returnType), function->returnType)) {
+            return false;
+        }
+    }
+    if(function->argsLen > 0) {
+        const size_t argsTypesOffset = byte_buffer_append_zeroed(&self->image, sizeof(const CubsTypeContext*) * function->argsLen);
+        writer_add_fixup(self, headerOffset + offsetof(CubsScriptFunctionPtr, argsTypes), FIXUP_IMAGE_OFFSET, argsTypesOffset, 0);
+        for(size_t i = 0; i < function->argsLen; i++) {
+            if(!writer_add_context_fixup(self, argsTypesOffset + (i * sizeof(const CubsTypeContext*)), function->argsTypes[i])) {
+                return false;
+            }
+        }
+    }
+
+    size_t i = 0;
+    while(i < function->_bytecodeCount) {
+        const size_t used = writer_relocate_operation(self, bytecodeOffset + (i * sizeof(Bytecode)));
+        if(used == 0) {
+            return false;
+        }
+        i += used;
+    }
+
+    const CubsStringSlice fullyQualifiedName = cubs_string_as_slice(&function->fullyQualifiedName);
+    const CubsStringSlice name = cubs_string_as_slice(&function->name);
+    const ImageFunction entry = {
+        .headerOffset = headerOffset,
+        .fullyQualifiedNameOffset = byte_buffer_append(&self->strings, (const void*)fullyQualifiedName.str, fullyQualifiedName.len),
+        .fullyQualifiedNameLen = fullyQualifiedName.len,
+        .nameOffset = byte_buffer_append(&self->strings, (const void*)name.str, name.len),
+        .nameLen = name.len,
+    };
+    *outEntry = entry;
+    return true;
+}
+
+static CubsProgramImageError write_image_file(const char* path, const ImageWriter* writer, const ImageFunction* functions) {
+    FILE* file = fopen(path, "wb");
+    if(file == NULL) {
+        return cubsProgramImageErrorFileAccess;
+    }
+    (void)fwrite((const void*)writer->image.bytes, 1, writer->image.len, file);
+    (void)fwrite((const void*)functions, sizeof(ImageFunction), writer->functionCount, file);
+    (void)fwrite((const void*)writer->fixups.bytes, 1, writer->fixups.len, file);
+    (void)fwrite((const void*)writer->strings.bytes, 1, writer->strings.len, file);
+    const bool failed = ferror(file) != 0;
+    if((fclose(file) != 0) || failed) {
+        (void)remove(path);
+        return cubsProgramImageErrorFileAccess;
+    }
+    return cubsProgramImageErrorNone;
+}
+
+CubsProgramImageError cubs_program_write_image(const CubsProgram *self, const char *path)
+{
+    const ProgramInner* inner = (const ProgramInner*)self->_inner;
+    const size_t functionCount = inner->functionMap.count;
+
+    FunctionIndex* sortedFunctions = NULL;
+    ImageFunction* functions = NULL;
+    if(functionCount > 0) {
+        sortedFunctions = MALLOC_TYPE_ARRAY(FunctionIndex, functionCount);
+        functions = MALLOC_TYPE_ARRAY(ImageFunction, functionCount);
+        for(size_t i = 0; i < functionCount; i++) {
+            const FunctionIndex index = {.function = inner->functionMap.allFunctions[i], .index = i};
+            sortedFunctions[i] = index;
+        }
+        qsort((void*)sortedFunctions, functionCount, sizeof(FunctionIndex), function_index_compare);
+    }
+
+    ImageWriter writer = {.sortedFunctions = sortedFunctions, .functionCount = functionCount};
+    (void)byte_buffer_append_zeroed(&writer.image, sizeof(ImageHeader));
+
+    CubsProgramImageError err = cubsProgramImageErrorNone;
+    for(size_t i = 0; i < functionCount; i++) {
+        if(!writer_add_function(&writer, inner->functionMap.allFunctions[i], &functions[i])) {
+            err = cubsProgramImageErrorUnsupported;
+            break;
+        }
+    }
+
+    if(err == cubsProgramImageErrorNone) {
+        const uint64_t functionsOffset = writer.image.len;
+        const uint64_t fixupsOffset = functionsOffset + (sizeof(ImageFunction) * functionCount);
+        const uint64_t stringsOffset = fixupsOffset + writer.fixups.len;
+        ImageHeader header = {
+            .version = CUBS_PROGRAM_IMAGE_VERSION,
+            .byteOrderMark = IMAGE_BYTE_ORDER_MARK,
+            .opcodeCount = IMAGE_OPCODE_COUNT,
+            .functionHeaderSize = (uint32_t)sizeof(CubsScriptFunctionPtr),
+            .imageLen = stringsOffset + writer.strings.len,
+            .functionCount = functionCount,
+            .functionsOffset = functionsOffset,
+            .fixupCount = writer.fixupCount,
+            .fixupsOffset = fixupsOffset,
+            .stringsOffset = stringsOffset,
+            .stringsLen = writer.strings.len,
+            .stringConstantCount = writer.stringConstantCount,
+        };
+        memcpy((void*)header.magic, (const void*)IMAGE_MAGIC, sizeof(IMAGE_MAGIC));
+        memcpy((void*)writer.image.bytes, (const void*)&header, sizeof(ImageHeader));
+        err = write_image_file(path, &writer, functions);
+    }
+
+    byte_buffer_deinit(&writer.image);
+    byte_buffer_deinit(&writer.fixups);
+    byte_buffer_deinit(&writer.strings);
+    if(functionCount > 0) {
+        FREE_TYPE_ARRAY(FunctionIndex, sortedFunctions, functionCount);
+        FREE_TYPE_ARRAY(ImageFunction, functions, functionCount);
+    }
+    return err;
+}
+
+#pragma endregion
+
+#pragma region Load
+
+/// `offset` and `len` are within an image of `imageLen` bytes.
+static bool image_range_valid(uint64_t imageLen, uint64_t offset, uint64_t len) {
+    return offset <= imageLen && len <= (imageLen - offset);
+}
+
+/// `count` elements of `elementSize` starting at `offset`, which must be 8 byte aligned, are within the image.
+static bool image_array_valid(uint64_t imageLen, uint64_t offset, uint64_t count, size_t elementSize) {
+    return (offset % 8) == 0 && count <= (imageLen / elementSize) && image_range_valid(imageLen, offset, count * elementSize);
+}
+
+static CubsProgramImageError validate_image(const uint8_t* image, size_t imageLen) {
+    if(imageLen < sizeof(ImageHeader)) {
+        return cubsProgramImageErrorInvalidFormat;
+    }
+    const ImageHeader* header = (const ImageHeader*)image;
+    if(memcmp((const void*)header->magic, (const void*)IMAGE_MAGIC, sizeof(IMAGE_MAGIC)) != 0) {
+        return cubsProgramImageErrorInvalidFormat;
+    }
+    if(header->version != CUBS_PROGRAM_IMAGE_VERSION
+        || header->byteOrderMark != IMAGE_BYTE_ORDER_MARK
+        || header->opcodeCount != IMAGE_OPCODE_COUNT
+        || header->functionHeaderSize != sizeof(CubsScriptFunctionPtr))
+    {
+        return cubsProgramImageErrorVersionMismatch;
+    }
+    if(header->imageLen != imageLen
+        || !image_array_valid(imageLen, header->functionsOffset, header->functionCount, sizeof(ImageFunction))
+        || !image_array_valid(imageLen, header->fixupsOffset, header->fixupCount, sizeof(ImageFixup))
+        || !image_range_valid(imageLen, header->stringsOffset, header->stringsLen))
+    {
+        return cubsProgramImageErrorInvalidFormat;
+    }
+
+    const ImageFunction* functions = (const ImageFunction*)&image[header->functionsOffset];
+    for(uint64_t i = 0; i < header->functionCount; i++) {
+        if(!image_array_valid(imageLen, functions[i].headerOffset, 1, sizeof(CubsScriptFunctionPtr))
+            || !image_range_valid(header->stringsLen, functions[i].fullyQualifiedNameOffset, functions[i].fullyQualifiedNameLen)
+            || !image_range_valid(header->stringsLen, functions[i].nameOffset, functions[i].nameLen))
+        {
+            return cubsProgramImageErrorInvalidFormat;
+        }
+    }
+
+    uint64_t stringConstantCount = 0;
+    const ImageFixup* fixups = (const ImageFixup*)&image[header->fixupsOffset];
+    for(uint64_t i = 0; i < header->fixupCount; i++) {
+        const ImageFixup fixup = fixups[i];
+        if(!image_array_valid(imageLen, fixup.offset, 1, sizeof(uintptr_t))) {
+            return cubsProgramImageErrorInvalidFormat;
+        }
+        bool valid = false;
+        switch(fixup.kind) {
+            case FIXUP_BUILTIN_CONTEXT: valid = fixup.value < BUILTIN_CONTEXT_COUNT; break;
+            case FIXUP_FUNCTION: valid = fixup.value < header->functionCount; break;
+            case FIXUP_IMAGE_OFFSET: valid = fixup.value < imageLen; break;
+            case FIXUP_STRING_CONSTANT: {
+                valid = image_range_valid(header->stringsLen, fixup.value, fixup.len);
+                stringConstantCount += 1;
+            } break;
+            default: break;
+        }
+        if(!valid) {
+            return cubsProgramImageErrorInvalidFormat;
+        }
+    }
+    if(stringConstantCount != header->stringConstantCount) {
+        return cubsProgramImageErrorInvalidFormat;
+    }
+    return cubsProgramImageErrorNone;
+}
+
+/// Checks the function at `headerOffset` after the fixups are applied, as they may overwrite any of it's header.
+/// The bytecode, destructor slots, and argument types must all be within the image, as verifying, executing,
+/// and unwinding the function read them without any bounds.
+static bool image_function_layout_valid(const uint8_t* image, size_t imageLen, uint64_t headerOffset) {
+    const CubsScriptFunctionPtr* function = (const CubsScriptFunctionPtr*)&image[headerOffset];
+    const uint64_t bytecodeOffset = headerOffset + sizeof(CubsScriptFunctionPtr);
+    if(function->_stackSpaceRequired > MAX_FRAME_LENGTH
+        || function->argsLen > function->_stackSpaceRequired
+        || !image_array_valid(imageLen, bytecodeOffset, function->_bytecodeCount, sizeof(Bytecode)))
+    {
+        return false;
+    }
+
+    const uintptr_t imageStart = (uintptr_t)image;
+    const uintptr_t destructorSlots = (uintptr_t)function->_destructorSlots;
+    if(destructorSlots < imageStart
+        || !image_array_valid(imageLen, destructorSlots - imageStart, 1, sizeof(uint64_t)))
+    {
+        return false;
+    }
+    // Unwinding indexes the frame by every bit of every word
+    const uint64_t destructorSlotsWords = function->_destructorSlots[0];
+    if(destructorSlotsWords > CUBS_DESTRUCTOR_SLOTS_WORDS(function->_stackSpaceRequired)
+        || !image_array_valid(imageLen, destructorSlots - imageStart, 1 + destructorSlotsWords, sizeof(uint64_t)))
+    {
+        return false;
+    }
+
+    if(function->argsLen > 0) {
+        const uintptr_t argsTypes = (uintptr_t)function->argsTypes;
+        if(argsTypes < imageStart
+            || !image_array_valid(imageLen, argsTypes - imageStart, function->argsLen, sizeof(const CubsTypeContext*)))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static CubsStringSlice image_string(const uint8_t* image, const ImageHeader* header, uint64_t offset, uint64_t len) {
+    const CubsStringSlice slice = {.str = (const char*)&image[header->stringsOffset + offset], .len = (size_t)len};
+    return slice;
+}
+
+CubsProgramImageError cubs_program_load_image(CubsProgram *self, const char *path)
+{
+    size_t imageLen = 0;
+    uint8_t* image = (uint8_t*)_cubs_os_map_file_private(path, &imageLen);
+    if(image == NULL) {
+        return cubsProgramImageErrorFileAccess;
+    }
+    const CubsProgramImageError err = validate_image(image, imageLen);
+    if(err != cubsProgramImageErrorNone) {
+        _cubs_os_unmap_file((void*)image, imageLen);
+        return err;
+    }
+
+    ProgramInner* inner = (ProgramInner*)self->_inner;
+    const ImageHeader* header = (const ImageHeader*)image;
+    const ImageFunction* functions = (const ImageFunction*)&image[header->functionsOffset];
+    const ImageFixup* fixups = (const ImageFixup*)&image[header->fixupsOffset];
+
+    ProgramImage* programImage = (ProgramImage*)cubs_protected_arena_malloc(&inner->arena, sizeof(ProgramImage), _Alignof(ProgramImage));
+    const ProgramImage programImageData = {.mapping = (void*)image, .len = imageLen, .strings = NULL, .stringCount = 0, .next = inner->images};
+    *programImage = programImageData;
+    if(header->stringConstantCount > 0) {
+        programImage->strings = (CubsString*)cubs_protected_arena_malloc(
+            &inner->arena, sizeof(CubsString) * header->stringConstantCount, _Alignof(CubsString));
+    }
+
+    for(uint64_t i = 0; i < header->fixupCount; i++) {
+        const ImageFixup fixup = fixups[i];
+        uintptr_t* dst = (uintptr_t*)&image[fixup.offset];
+        switch(fixup.kind) {
+            case FIXUP_BUILTIN_CONTEXT: {
+                *dst = (uintptr_t)BUILTIN_CONTEXTS[fixup.value];
+            } break;
+            case FIXUP_FUNCTION: {
+                *dst = (uintptr_t)&image[functions[fixup.value].headerOffset];
+            } break;
+            case FIXUP_IMAGE_OFFSET: {
+                *dst = (uintptr_t)&image[fixup.value];
+            } break;
+            case FIXUP_STRING_CONSTANT: {
+                CubsString* string = &programImage->strings[programImage->stringCount];
+                *string = cubs_string_init_unchecked(image_string(image, header, fixup.value, fixup.len));
+                programImage->stringCount += 1;
+                *dst = (uintptr_t)string;
+            } break;
+            default: {
+                unreachable();
+            }
+        }
+    }
+
+    // None of the image is added unless all of it is valid
+    for(uint64_t i = 0; i < header->functionCount; i++) {
+        const CubsScriptFunctionPtr* function = (const CubsScriptFunctionPtr*)&image[functions[i].headerOffset];
+        CubsProgramImageError functionErr = cubsProgramImageErrorNone;
+        if(!image_function_layout_valid(image, imageLen, functions[i].headerOffset)) {
+            functionErr = cubsProgramImageErrorInvalidFormat;
+        } else if(cubs_function_verify(function, NULL) != cubsBytecodeVerifyErrorNone) {
+            functionErr = cubsProgramImageErrorInvalidBytecode;
+        }
+        if(functionErr != cubsProgramImageErrorNone) {
+            for(size_t j = 0; j < programImage->stringCount; j++) {
+                cubs_string_deinit(&programImage->strings[j]);
+            }
+            _cubs_os_unmap_file((void*)image, imageLen);
+            return functionErr;
+        }
+    }
+
+    for(uint64_t i = 0; i < header->functionCount; i++) {
+        CubsScriptFunctionPtr* function = (CubsScriptFunctionPtr*)&image[functions[i].headerOffset];
+        function->program = self;
+        function->_jitCallsUntilCompile = inner->jitCallThreshold;
+        function->_jitCode = NULL;
+        function->fullyQualifiedName = cubs_string_init_unchecked(
+            image_string(image, header, functions[i].fullyQualifiedNameOffset, functions[i].fullyQualifiedNameLen));
+        function->name = cubs_string_init_unchecked(image_string(image, header, functions[i].nameOffset, functions[i].nameLen));
+        cubs_function_map_insert(&inner->functionMap, &inner->arena, function);
+    }
+
+    inner->images = programImage;
+    return cubsProgramImageErrorNone;
+}
+
+void _cubs_program_image_unmap(ProgramImage *image)
+{
+    uint8_t* mapping = (uint8_t*)image->mapping;
+    const ImageHeader* header = (const ImageHeader*)mapping;
+    const ImageFunction* functions = (const ImageFunction*)&mapping[header->functionsOffset];
+    for(uint64_t i = 0; i < header->functionCount; i++) {
+        CubsScriptFunctionPtr* function = (CubsScriptFunctionPtr*)&mapping[functions[i].headerOffset];
+        cubs_string_deinit(&function->fullyQualifiedName);
+        cubs_string_deinit(&function->name);
+    }
+    for(size_t i = 0; i < image->stringCount; i++) {
+        cubs_string_deinit(&image->strings[i]);
+    }
+    _cubs_os_unmap_file(image->mapping, image->len);
+}
+
+#pragma endregion
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "program.h"
+
+/*
+Compiled program images. An image holds a program's script functions, with their headers, bytecode,
+and destructor slots laid out exactly as `cubs_function_builder_build(...)` lays them out in memory,
+along with the function names and string constants, and a table of fixups for every pointer within them.
+Loading an image memory maps it copy-on-write, and applies the fixups in place, so the functions execute
+directly from the mapping, without tokenizing or codegen. Only the pages containing pointers are copied.
+
+Pointers to type contexts can only be serialized for the built-in types, such as `CUBS_INT_CONTEXT`, and
+immediate calls only to script functions within the same program, not C functions. Script defined structs
+aren't serialized, as their contexts are created by the compiler rather than being static, so writing a
+program that uses any of them fails with `cubsProgramImageErrorUnsupported`, and it must be compiled instead.
+
+Loading checks that every function's bytecode, destructor slots, and argument types are within the image,
+and verifies it's bytecode, before any of it can execute, see `verifier.h`. Pointers within the image, such as
+to called functions and type contexts, are only as valid as it's fixups, so images must still come from a trusted writer.
+A typical host loads the image from a previous run, and compiles and writes it if that fails.
+*/
+
+/// Incremented whenever the image layout changes. Images are also rejected if they were written by a
+/// build with a different set of opcodes, or a different `CubsScriptFunctionPtr` layout.
+#define CUBS_PROGRAM_IMAGE_VERSION 2
+
+typedef enum CubsProgramImageError {
+    cubsProgramImageErrorNone = 0,
+    /// The file couldn't be opened, mapped, or written.
+    cubsProgramImageErrorFileAccess = 1,
+    /// The file isn't a program image, or is corrupt, such as a function's bytecode extending past the end of it.
+    cubsProgramImageErrorInvalidFormat = 2,
+    /// The image was written by an incompatible version, or build.
+    cubsProgramImageErrorVersionMismatch = 3,
+    /// The program references something that can't be serialized, such as a C function,
+    /// a type context that isn't built-in, or a constant of such a type.
+    cubsProgramImageErrorUnsupported = 4,
+    /// A function in the image failed bytecode verification. See `cubs_function_verify(...)`.
+    cubsProgramImageErrorInvalidBytecode = 5,
+
+    _CUBS_PROGRAM_IMAGE_ERROR_MAX_VALUE = 0x7FFFFFFF,
+} CubsProgramImageError;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Writes all of the script functions in `self` to a new image at `path`, replacing any existing file.
+CubsProgramImageError cubs_program_write_image(const CubsProgram* self, const char* path);
+
+/// Maps the image at `path`, and adds all of it's functions to `self`. The mapping is owned by
+/// `self`, and unmapped when it's deinitialized. On failure, `self` is unchanged.
+CubsProgramImageError cubs_program_load_image(CubsProgram* self, const char* path);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
@@ -0,0 +1,136 @@
+const std = @import("std");
+const expect = std.testing.expect;
+
+const c = @cImport({
+    @cInclude("interpreter/interpreter.h");
+    @cInclude("interpreter/function_definition.h");
+    @cInclude("interpreter/bytecode.h");
+    @cInclude("interpreter/operations.h");
+    @cInclude("primitives/context.h");
+    @cInclude("primitives/string/string.h");
+    @cInclude("program/program.h");
+    @cInclude("program/program_internal.h");
+    @cInclude("program/program_image.h");
+});
+
+fn stringOf(comptime s: []const u8) c.CubsString {
+    return c.cubs_string_init_unchecked(.{ .str = s.ptr, .len = s.len });
+}
+
+fn imagePath(tmp: *std.testing.TmpDir, buf: []u8) ![:0]const u8 {
+    const dirPath = try tmp.dir.realpath(".", buf);
+    return std.fmt.bufPrintZ(buf[dirPath.len..], "{s}/program.cubsimg", .{dirPath});
+}
+
+test "write and load image" {
+    var tmp = std.testing.tmpDir(.{});
+    defer tmp.cleanup();
+    var pathBuf: [std.fs.max_path_bytes * 2]u8 = undefined;
+    const path = try imagePath(&tmp, &pathBuf);
+
+    {
+        var program = c.cubs_program_init(.{});
+        defer c.cubs_program_deinit(&program);
+
+        // fn add(a: int, b: int) int { return a + b; }
+        var addBuilder = c.FunctionBuilder{ .stackSpaceRequired = 3, .optReturnType = &c.CUBS_INT_CONTEXT, .fullyQualifiedName = stringOf("example.add"), .name = stringOf("add") };
+        c.cubs_function_builder_add_arg(&addBuilder, &c.CUBS_INT_CONTEXT);
+        c.cubs_function_builder_add_arg(&addBuilder, &c.CUBS_INT_CONTEXT);
+        c.cubs_function_builder_push_bytecode(&addBuilder, c.operands_make_add_dst(false, 2, 0, 1));
+        c.cubs_function_builder_push_bytecode(&addBuilder, c.operands_make_return(true, 2));
+        const add = c.cubs_function_builder_build(&addBuilder, &program);
+
+        // fn addSeven(a: int) int { return add(a, 7); }
+        var builder = c.FunctionBuilder{ .stackSpaceRequired = 3, .optReturnType = &c.CUBS_INT_CONTEXT, .fullyQualifiedName = stringOf("example.addSeven"), .name = stringOf("addSeven") };
+        c.cubs_function_builder_add_arg(&builder, &c.CUBS_INT_CONTEXT);
+        var seven: i64 = 7;
+        var clone: [3]c.Bytecode = undefined;
+        c.operands_make_load_clone_from_ptr(&clone, 1, @ptrCast(&seven), &c.CUBS_INT_CONTEXT);
+        c.cubs_function_builder_push_bytecode_many(&builder, &clone, 3);
+        var call: [3]c.Bytecode = undefined;
+        const args = [_]u16{ 0, 1 };
+        c.cubs_operands_make_call_immediate(&call, 3, 2, &args, true, 2, .{ .func = .{ .script = add }, .funcType = c.cubsFunctionPtrTypeScript });
+        c.cubs_function_builder_push_bytecode_many(&builder, &call, 3);
+        c.cubs_function_builder_push_bytecode(&builder, c.operands_make_return(true, 2));
+        _ = c.cubs_function_builder_build(&builder, &program);
+
+        try expect(c.cubs_program_write_image(&program, path.ptr) == c.cubsProgramImageErrorNone);
+    }
+
+    var program = c.cubs_program_init(.{});
+    defer c.cubs_program_deinit(&program);
+    try expect(c.cubs_program_load_image(&program, path.ptr) == c.cubsProgramImageErrorNone);
+
+    var func: c.CubsFunction = undefined;
+    const name = "example.addSeven";
+    try expect(c.cubs_program_find_function(&program, &func, .{ .str = name.ptr, .len = name.len }));
+
+    var a: i64 = 5;
+    c.cubs_interpreter_push_script_function_arg(@ptrCast(&a), &c.CUBS_INT_CONTEXT, 0);
+    var result: i64 = undefined;
+    var retContext: *const c.CubsTypeContext = undefined;
+    try expect(c.cubs_interpreter_execute_function(func.func.script, @ptrCast(&result), @ptrCast(&retContext)) == 0);
+    try expect(result == 12);
+    try expect(retContext == &c.CUBS_INT_CONTEXT);
+}
+
+test "load invalid image" {
+    var tmp = std.testing.tmpDir(.{});
+    defer tmp.cleanup();
+    var pathBuf: [std.fs.max_path_bytes * 2]u8 = undefined;
+    const path = try imagePath(&tmp, &pathBuf);
+
+    var program = c.cubs_program_init(.{});
+    defer c.cubs_program_deinit(&program);
+
+    try expect(c.cubs_program_load_image(&program, path.ptr) == c.cubsProgramImageErrorFileAccess);
+
+    try tmp.dir.writeFile(.{ .sub_path = "program.cubsimg", .data = "not a program image, but long enough to hold a header" ** 2 });
+    try expect(c.cubs_program_load_image(&program, path.ptr) == c.cubsProgramImageErrorInvalidFormat);
+}
+
+test "load image with function outside of it" {
+    var tmp = std.testing.tmpDir(.{});
+    defer tmp.cleanup();
+    var pathBuf: [std.fs.max_path_bytes * 2]u8 = undefined;
+    const path = try imagePath(&tmp, &pathBuf);
+
+    {
+        var program = c.cubs_program_init(.{});
+        defer c.cubs_program_deinit(&program);
+
+        // fn five() int { return 5; }
+        var builder = c.FunctionBuilder{ .stackSpaceRequired = 5, .optReturnType = &c.CUBS_INT_CONTEXT, .fullyQualifiedName = stringOf("example.five"), .name = stringOf("five") };
+        c.cubs_function_builder_push_bytecode(&builder, c.operands_make_load_immediate(c.LOAD_IMMEDIATE_INT, 0, 5));
+        c.cubs_function_builder_push_bytecode(&builder, c.operands_make_return(true, 0));
+        _ = c.cubs_function_builder_build(&builder, &program);
+
+        try expect(c.cubs_program_write_image(&program, path.ptr) == c.cubsProgramImageErrorNone);
+    }
+
+    const bytes = try tmp.dir.readFileAlloc(std.testing.allocator, "program.cubsimg", 1 << 20);
+    defer std.testing.allocator.free(bytes);
+
+    { // Find the function header by it's argsLen, _stackSpaceRequired, and _bytecodeCount, and make the bytecode run past the image
+        var found = false;
+        var i: usize = 0;
+        while ((i + (3 * @sizeOf(usize))) <= bytes.len) : (i += @sizeOf(usize)) {
+            const words = std.mem.bytesAsSlice(usize, bytes[i..(i + (3 * @sizeOf(usize)))]);
+            if (words[0] == 0 and words[1] == 5 and words[2] == 2) {
+                words[2] = bytes.len;
+                found = true;
+                break;
+            }
+        }
+        try expect(found);
+    }
+    try tmp.dir.writeFile(.{ .sub_path = "program.cubsimg", .data = bytes });
+
+    var program = c.cubs_program_init(.{});
+    defer c.cubs_program_deinit(&program);
+    try expect(c.cubs_program_load_image(&program, path.ptr) == c.cubsProgramImageErrorInvalidFormat);
+
+    var func: c.CubsFunction = undefined;
+    const name = "example.five";
+    try expect(!c.cubs_program_find_function(&program, &func, .{ .str = name.ptr, .len = name.len }));
+}
@@ -7,12 +7,40 @@
 #include "type_map.h"
 #include "program_type_context.h"
 
+/// A program image mapped into a program. See `program_image.h`.
+typedef struct ProgramImage {
+    void* mapping;
+    size_t len;
+    /// String constants the image's bytecode points to, allocated in the program's arena.
+    CubsString* strings;
+    size_t stringCount;
+    struct ProgramImage* next;
+} ProgramImage;
+
+/// Machine code the JIT compiled for one of the program's functions. See `jit.h`.
+typedef struct JitCode {
+    void* pages;
+    size_t len;
+    struct JitCode* next;
+} JitCode;
+
 typedef struct {
     ProtectedArena arena;
     CubsProgramContext context;
     CubsMutex contextMutex;
     FunctionMap functionMap;
     TypeMap typeMap;
+    /// Linked list of the images loaded into the program.
+    ProgramImage* images;
+    /// Script functions with at most this many bytecodes are inlined into functions built
+    /// after them. See `cubs_function_builder_inline_calls(...)`. If 0, nothing is inlined.
+    size_t inlineThreshold;
+    /// Calls before a function is compiled by the JIT. See `CubsProgramInitParams.jitCallThreshold`.
+    size_t jitCallThreshold;
+    /// Linked list of the machine code the JIT compiled, freed with the program.
+    JitCode* jitCode;
+    /// Held while compiling, so a function is only compiled once.
+    CubsMutex jitMutex;
 } ProgramInner;
 
 /// If `params.context == NULL`, uses the default context. Otherwise, copies `params.context`, taking ownership of it, 
@@ -28,3 +56,10 @@ const CubsTypeContext* cubs_program_find_type_context(const CubsProgram* self, C
 CubsTypeContext* cubs_program_find_mut_script_type_context(CubsProgram* self, CubsStringSlice fullyQualifiedName);
 
 void cubs_program_context_insert(CubsProgram* self, ProgramTypeContext context);
+
+/// Deinitializes the names and string constants of the image's functions, and unmaps it.
+/// Defined in `program_image.c`.
+void _cubs_program_image_unmap(ProgramImage* image);
+
+/// Frees the machine code. Defined in `jit.c`.
+void _cubs_jit_code_free(JitCode* code);
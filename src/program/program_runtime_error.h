@@ -21,6 +21,8 @@ typedef enum CubsProgramRuntimeError {
     cubsProgramRuntimeErrorArccosUndefined = 17,
     cubsProgramRuntimeErrorHyperbolicArccosUndefined = 18,
     cubsProgramRuntimeErrorHyperbolicArctanUndefined = 19,
+    /// `OpCodeYield` executed by a script function that isn't running as a coroutine or budgeted execution.
+    cubsProgramRuntimeErrorYieldOutsideCoroutine = 20,
 
     _CUBS_PROGRAM_RUNTIME_ERROR_MAX_VALUE = 0x7FFFFFFF,
 } CubsProgramRuntimeError;
\ No newline at end of file
@@ -87,7 +87,10 @@ void cubs_mutex_init(CubsMutex* mutexToInit)
 
 void cubs_mutex_lock(CubsMutex* self)
 {
-	assert(pthread_mutex_lock((pthread_mutex_t*)self) == 0);
+	// Mustn't be inside the assert, otherwise it won't be called with NDEBUG defined.
+	const int result = pthread_mutex_lock((pthread_mutex_t*)self);
+	assert(result == 0);
+	(void)result;
 }
 
 bool cubs_mutex_try_lock(CubsMutex* self)
@@ -97,7 +100,10 @@ bool cubs_mutex_try_lock(CubsMutex* self)
 
 void cubs_mutex_unlock(CubsMutex* self)
 {
-	assert(pthread_mutex_unlock((pthread_mutex_t*)self) == 0);
+	// Mustn't be inside the assert, otherwise it won't be called with NDEBUG defined.
+	const int result = pthread_mutex_unlock((pthread_mutex_t*)self);
+	assert(result == 0);
+	(void)result;
 }
 
 _Static_assert(sizeof(CubsRwLock) == sizeof(pthread_rwlock_t), "The size of pthread_rwlock_t must be the same size as CubsRwLock");
@@ -105,7 +111,10 @@ _Static_assert(_Alignof(CubsRwLock) == _Alignof(pthread_rwlock_t), "The alignmen
 
 void cubs_rwlock_init(CubsRwLock* rwlockToInit)
 {
-	assert(pthread_rwlock_init((pthread_rwlock_t*)rwlockToInit, NULL) == 0);
+	// Mustn't be inside the assert, otherwise it won't be called with NDEBUG defined.
+	const int result = pthread_rwlock_init((pthread_rwlock_t*)rwlockToInit, NULL);
+	assert(result == 0);
+	(void)result;
 }
 
 void cubs_rwlock_lock_shared(const CubsRwLock* self)
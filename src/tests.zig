@@ -6,7 +6,14 @@ comptime {
     _ = @import("interpreter/interpreter.zig");
     _ = @import("interpreter/stack.zig");
     _ = @import("interpreter/function_definition.zig");
+    _ = @import("interpreter/profiler.zig");
+    _ = @import("interpreter/coroutine.zig");
+    _ = @import("interpreter/verifier.zig");
+    _ = @import("interpreter/jit.zig");
     _ = @import("program/protected_arena.zig");
+    _ = @import("program/program_image.zig");
+
+    _ = @import("util/hash.zig");
 
     _ = @import("compiler/tokenizer.zig");
     _ = @import("compiler/ast.zig");
@@ -28,6 +35,7 @@ comptime {
     _ = @import("primitives/error/error.zig");
     _ = @import("primitives/result/result.zig");
     _ = @import("primitives/sync_ptr/sync_ptr.zig");
+    _ = @import("primitives/sync_map/sync_map.zig");
     _ = @import("primitives/reference/reference.zig");
     _ = @import("primitives/vector/vector.zig").Vec2i;
     _ = @import("primitives/vector/vector.zig").Vec3i;
@@ -2,6 +2,8 @@
 
 #include <stddef.h>
 #include <stdint.h>
+#include <string.h>
+#include "simd.h"
 
 /// Instantiated once per program call 
 size_t cubs_hash_seed();
@@ -14,34 +16,131 @@ inline static size_t cubs_combine_hash(size_t a, size_t b) {
     return h;
 }
 
+/// Secrets for the hash functions below. Odd, with 32 bits set in each, so that multiplying
+/// by them keeps entropy in both halves.
+#define CUBS_HASH_SECRET0 0xa0761d6478bd642fULL
+#define CUBS_HASH_SECRET1 0xe7037ed1a0b428dbULL
+#define CUBS_HASH_SECRET2 0x8ebc6af09c88c6e3ULL
+#define CUBS_HASH_SECRET3 0x589965cc75374cc3ULL
+
+/// When built with AVX2, inputs of at least this many bytes are hashed by `_cubs_simd_bytes_hash_long(...)`,
+/// which is faster than the scalar loop for long inputs, but slower to set up. With gcc or clang, AVX2
+/// requires the `CUBS_AVX2` CMake option.
+#define CUBS_HASH_LONG_THRESHOLD 2048
+
+/// Multiplies `a` and `b` into a 128 bit result, storing the low 64 bits in `a` and the high 64 bits in `b`.
+inline static void cubs_hash_mum(uint64_t* a, uint64_t* b) {
+    #if defined(__SIZEOF_INT128__)
+    const __uint128_t r = (__uint128_t)(*a) * (__uint128_t)(*b);
+    *a = (uint64_t)r;
+    *b = (uint64_t)(r >> 64);
+    #else
+    const uint64_t ha = *a >> 32;
+    const uint64_t hb = *b >> 32;
+    const uint64_t la = (uint32_t)*a;
+    const uint64_t lb = (uint32_t)*b;
+    const uint64_t rh = ha * hb;
+    const uint64_t rm0 = ha * lb;
+    const uint64_t rm1 = hb * la;
+    const uint64_t rl = la * lb;
+    const uint64_t t = rl + (rm0 << 32);
+    uint64_t c = t < rl;
+    const uint64_t lo = t + (rm1 << 32);
+    c += lo < t;
+    *a = lo;
+    *b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+    #endif
+}
+
+/// Folds the full 128 bit product of `a` and `b` into 64 bits.
+inline static uint64_t cubs_hash_mix(uint64_t a, uint64_t b) {
+    cubs_hash_mum(&a, &b);
+    return a ^ b;
+}
+
+inline static uint64_t cubs_hash_read64(const uint8_t* p) {
+    uint64_t v;
+    memcpy((void*)&v, (const void*)p, 8);
+    return v;
+}
+
+inline static uint64_t cubs_hash_read32(const uint8_t* p) {
+    uint32_t v;
+    memcpy((void*)&v, (const void*)p, 4);
+    return v;
+}
+
+/// Reads 1 to 3 bytes. Every byte is used, as the first, middle, and last bytes overlap for short lengths.
+inline static uint64_t cubs_hash_read_small(const uint8_t* p, size_t len) {
+    return (((uint64_t)p[0]) << 16) | (((uint64_t)p[len >> 1]) << 8) | ((uint64_t)p[len - 1]);
+}
+
+/// Hashes a 64 bit integer with the per program seed. Every bit of `value` affects every bit of the result,
+/// so integer keys that only differ in their low or high bits still spread across `CubsMap` and `CubsSet` groups.
+inline static size_t cubs_hash_u64(uint64_t value) {
+    uint64_t a = value ^ CUBS_HASH_SECRET0;
+    uint64_t b = ((uint64_t)cubs_hash_seed()) ^ CUBS_HASH_SECRET1;
+    cubs_hash_mum(&a, &b);
+    return (size_t)cubs_hash_mix(a ^ CUBS_HASH_SECRET0, b ^ CUBS_HASH_SECRET1);
+}
+
+/// Hashes `len` bytes at `ptr`, which does not need to be aligned, using the per program seed.
+/// Based on [wyhash](https://github.com/wangyi-fudan/wyhash). When built with AVX2, inputs of
+/// `CUBS_HASH_LONG_THRESHOLD` bytes or more use a vectorized path. See `_cubs_simd_bytes_hash_long(...)`.
 inline static size_t bytes_hash(const void* ptr, size_t len) {
-    const size_t seed = cubs_hash_seed();
-    const uint64_t m = 0xc6a4a7935bd1e995LLU;
-    // const int r = 47;
-
-    uint64_t h = seed ^ (len * m);
-    
-    // TODO this sucks. improve
-    // Need to handle unaligned access for future implementation
-
-    const uint8_t* data = (const uint8_t*)ptr;
-    switch(len & 7)
-    {
-    case 7: h ^= (uint64_t)(data[6]) << 48;
-    case 6: h ^= (uint64_t)(data[5]) << 40;
-    case 5: h ^= (uint64_t)(data[4]) << 32;
-    case 4: h ^= (uint64_t)(data[3]) << 24;
-    case 3: h ^= (uint64_t)(data[2]) << 16;
-    case 2: h ^= (uint64_t)(data[1]) << 8;
-    case 1: h ^= (uint64_t)(data[0]);
-            h *= m;
-    };
-    
-    // h ^= h >> r;
-    // h *= m;
-    // h ^= h >> r;
+    const uint8_t* p = (const uint8_t*)ptr;
+    uint64_t seed = (uint64_t)cubs_hash_seed();
+    seed ^= cubs_hash_mix(seed ^ CUBS_HASH_SECRET0, CUBS_HASH_SECRET1);
 
-    return h;
+    #if __AVX2__
+    if(len >= CUBS_HASH_LONG_THRESHOLD) {
+        return _cubs_simd_bytes_hash_long(p, len, seed);
+    }
+    #endif
+
+    uint64_t a;
+    uint64_t b;
+    if(len <= 16) {
+        if(len >= 4) {
+            // Two overlapping reads from each end cover every byte
+            const size_t offset = (len >> 3) << 2;
+            a = (cubs_hash_read32(p) << 32) | cubs_hash_read32(&p[offset]);
+            b = (cubs_hash_read32(&p[len - 4]) << 32) | cubs_hash_read32(&p[len - 4 - offset]);
+        } else if(len > 0) {
+            a = cubs_hash_read_small(p, len);
+            b = 0;
+        } else {
+            a = 0;
+            b = 0;
+        }
+    } else {
+        size_t i = len;
+        if(i > 48) {
+            uint64_t see1 = seed;
+            uint64_t see2 = seed;
+            do {
+                seed = cubs_hash_mix(cubs_hash_read64(p) ^ CUBS_HASH_SECRET1, cubs_hash_read64(&p[8]) ^ seed);
+                see1 = cubs_hash_mix(cubs_hash_read64(&p[16]) ^ CUBS_HASH_SECRET2, cubs_hash_read64(&p[24]) ^ see1);
+                see2 = cubs_hash_mix(cubs_hash_read64(&p[32]) ^ CUBS_HASH_SECRET3, cubs_hash_read64(&p[40]) ^ see2);
+                p += 48;
+                i -= 48;
+            } while(i > 48);
+            seed ^= see1 ^ see2;
+        }
+        while(i > 16) {
+            seed = cubs_hash_mix(cubs_hash_read64(p) ^ CUBS_HASH_SECRET1, cubs_hash_read64(&p[8]) ^ seed);
+            p += 16;
+            i -= 16;
+        }
+        // The last 16 bytes, which may overlap with already hashed bytes
+        a = cubs_hash_read64(&p[i - 16]);
+        b = cubs_hash_read64(&p[i - 8]);
+    }
+
+    a ^= CUBS_HASH_SECRET1;
+    b ^= seed;
+    cubs_hash_mum(&a, &b);
+    return (size_t)cubs_hash_mix(a ^ CUBS_HASH_SECRET0 ^ (uint64_t)len, b ^ CUBS_HASH_SECRET1);
 }
 
 typedef struct CubsHashGroupBitmask {
@@ -0,0 +1,84 @@
+const std = @import("std");
+const expect = std.testing.expect;
+const String = @import("../primitives/string/string.zig").String;
+
+const c = @cImport({
+    @cInclude("util/hash.h");
+    @cInclude("util/simd.h");
+    @cInclude("primitives/context.h");
+    @cInclude("primitives/string/string_slice.h");
+});
+
+fn intHash(value: i64) usize {
+    return c.cubs_context_fast_hash(@ptrCast(&value), &c.CUBS_INT_CONTEXT);
+}
+
+fn floatHash(value: f64) usize {
+    return c.cubs_context_fast_hash(@ptrCast(&value), &c.CUBS_FLOAT_CONTEXT);
+}
+
+fn bytesHash(bytes: []const u8) usize {
+    return c.cubs_string_slice_hash(.{ .str = bytes.ptr, .len = bytes.len });
+}
+
+test "integers only differing in their high bits spread across groups" {
+    // Same as `cubs_hash_group_bitmask_init(...)` with 64 groups
+    const GROUP_COUNT = 64;
+    const KEYS = GROUP_COUNT * 16;
+
+    var groups = [_]usize{0} ** GROUP_COUNT;
+    var pairs = [_]usize{0} ** 128;
+    for (0..KEYS) |i| {
+        const hashCode = intHash(@bitCast(@as(u64, i) << 32));
+        groups[(hashCode >> 7) % GROUP_COUNT] += 1;
+        pairs[hashCode & 0x7F] += 1;
+    }
+    // With 16 expected per group, a hash ignoring the high bits would put them all in one
+    for (groups) |count| {
+        try expect(count > 0);
+        try expect(count < 48);
+    }
+    for (pairs) |count| {
+        try expect(count < 32);
+    }
+}
+
+test "positive and negative zero hash the same" {
+    try expect(floatHash(0.0) == floatHash(-0.0));
+    try expect(floatHash(0.0) != floatHash(1.0));
+}
+
+test "strings and slices with the same contents hash the same" {
+    const contents = [_][]const u8{ "", "a", "small string", "a string long enough to be stored on the heap" };
+    for (contents) |content| {
+        var string = String.initUnchecked(content);
+        defer string.deinit();
+
+        const sliceHash = bytesHash(content);
+        try expect(string.hash() == sliceHash);
+        try expect(c._cubs_simd_string_hash_sso(content.ptr, content.len) == sliceHash);
+        try expect(c._cubs_simd_string_hash_heap(content.ptr, content.len) == sliceHash);
+    }
+}
+
+test "every byte affects the hash around the long input threshold" {
+    const threshold: usize = c.CUBS_HASH_LONG_THRESHOLD;
+    var buf: [c.CUBS_HASH_LONG_THRESHOLD * 2 + 1]u8 = undefined;
+    for (&buf, 0..) |*byte, i| {
+        byte.* = @truncate(i *% 31);
+    }
+
+    const lens = [_]usize{ threshold - 1, threshold, threshold + 1, threshold + 63, threshold * 2 + 1 };
+    for (lens) |len| {
+        const bytes = buf[0..len];
+        const original = bytesHash(bytes);
+        try expect(original != bytesHash(buf[0..(len - 1)]));
+
+        for ([_]usize{ 0, 1, len / 2, len - 65, len - 64, len - 1 }) |index| {
+            bytes[index] ^= 1;
+            defer bytes[index] ^= 1;
+            try expect(bytesHash(bytes) != original);
+        }
+        try expect(bytesHash(bytes) == original);
+    }
+}
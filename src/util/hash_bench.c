@@ -0,0 +1,151 @@
+#include "../bench.h"
+#include "hash.h"
+#include "../primitives/context.h"
+#include "../primitives/string/string.h"
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DISTRIBUTION_KEY_COUNT 100000
+#define BYTES_HASH_ITERATIONS 2000000
+
+typedef enum {
+    KeyPatternSequential,
+    KeyPatternStride128,
+    KeyPatternHighBits,
+    KeyPatternRandom,
+} KeyPattern;
+
+static const char* KEY_PATTERN_NAMES[] = {"sequential", "stride 128", "high bits", "random"};
+
+/// Keys that real scripts commonly use, and keys that defeat weak hashes, such as ones
+/// that only differ in bits that a weak hash ignores.
+static int64_t key_for_pattern(KeyPattern pattern, int64_t i) {
+    switch(pattern) {
+        case KeyPatternSequential: return i;
+        case KeyPatternStride128: return i << 7;
+        case KeyPatternHighBits: return i << 32;
+        case KeyPatternRandom: {
+            // splitmix64, so the keys are the same every run
+            uint64_t z = (uint64_t)i * 0x9E3779B97F4A7C15ULL;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            return (int64_t)(z ^ (z >> 31));
+        }
+    }
+    return i;
+}
+
+/// Mirrors how `CubsMap` and `CubsSet` choose a group count, and place a hash code within a group.
+static void report_group_distribution(const char* name, const size_t* hashCodes, size_t count) {
+    size_t groupCount = 1;
+    while(((32 * groupCount * 4) / 5) < count) {
+        groupCount <<= 1;
+    }
+
+    size_t* groupLoads = (size_t*)calloc(groupCount, sizeof(size_t));
+    // How many keys in each group have each of the 128 possible pair bitmasks
+    size_t* tagCounts = (size_t*)calloc(groupCount * 128, sizeof(size_t));
+
+    for(size_t i = 0; i < count; i++) {
+        const size_t group = cubs_hash_group_bitmask_init(hashCodes[i]).value % groupCount;
+        const uint8_t tag = cubs_hash_pair_bitmask_init(hashCodes[i]).value & 0x7F;
+        groupLoads[group] += 1;
+        tagCounts[(group * 128) + tag] += 1;
+    }
+
+    size_t maxLoad = 0;
+    size_t emptyGroups = 0;
+    for(size_t i = 0; i < groupCount; i++) {
+        if(groupLoads[i] > maxLoad) {
+            maxLoad = groupLoads[i];
+        }
+        emptyGroups += groupLoads[i] == 0;
+    }
+
+    // Every other key in the same group with the same pair bitmask costs a call to the equality function.
+    size_t falseTagMatches = 0;
+    for(size_t i = 0; i < groupCount * 128; i++) {
+        if(tagCounts[i] > 1) {
+            falseTagMatches += tagCounts[i] * (tagCounts[i] - 1);
+        }
+    }
+
+    fprintf(stdout, "%-48s %6zu groups mean %6.2f max %6zu empty %6zu eql/find %8.3f\n",
+        name, groupCount, (double)count / (double)groupCount, maxLoad, emptyGroups,
+        (double)falseTagMatches / (double)count);
+    fflush(stdout);
+
+    free((void*)groupLoads);
+    free((void*)tagCounts);
+}
+
+static void bench_int_distribution() {
+    size_t* hashCodes = (size_t*)malloc(sizeof(size_t) * DISTRIBUTION_KEY_COUNT);
+    for(int pattern = KeyPatternSequential; pattern <= KeyPatternRandom; pattern++) {
+        for(int64_t i = 0; i < DISTRIBUTION_KEY_COUNT; i++) {
+            const int64_t key = key_for_pattern((KeyPattern)pattern, i);
+            hashCodes[i] = cubs_context_fast_hash((const void*)&key, &CUBS_INT_CONTEXT);
+        }
+        char name[64];
+        (void)snprintf(name, sizeof(name), "hash groups int %s", KEY_PATTERN_NAMES[pattern]);
+        report_group_distribution(name, hashCodes, DISTRIBUTION_KEY_COUNT);
+    }
+    free((void*)hashCodes);
+}
+
+static void bench_string_distribution() {
+    size_t* hashCodes = (size_t*)malloc(sizeof(size_t) * DISTRIBUTION_KEY_COUNT);
+    const char* formats[] = {"entity_identifier_%lld", "%lld", "a key long enough to be stored on the heap %lld"};
+    const char* names[] = {"hash groups string identifier", "hash groups string digits", "hash groups string heap"};
+    for(int f = 0; f < 3; f++) {
+        for(int64_t i = 0; i < DISTRIBUTION_KEY_COUNT; i++) {
+            char buf[64];
+            const int len = snprintf(buf, sizeof(buf), formats[f], (long long)i);
+            const CubsStringSlice slice = {.str = buf, .len = (size_t)len};
+            hashCodes[i] = cubs_string_slice_hash(slice);
+        }
+        report_group_distribution(names[f], hashCodes, DISTRIBUTION_KEY_COUNT);
+    }
+    free((void*)hashCodes);
+}
+
+static void bench_bytes_hash(size_t len) {
+    // Hashing from a different offset each iteration keeps the hash from being hoisted out of the loop.
+    const size_t offsets = 64;
+    char* bytes = (char*)malloc(len + offsets);
+    for(size_t i = 0; i < len + offsets; i++) {
+        bytes[i] = (char)('a' + (i % 26));
+    }
+
+    const size_t iterations = len >= 4096 ? BYTES_HASH_ITERATIONS / 32 : BYTES_HASH_ITERATIONS;
+    size_t h = 0;
+    const uint64_t start = cubs_bench_now_ns();
+    for(size_t i = 0; i < iterations; i++) {
+        // Summed rather than xor-ed, since every offset is hashed an even number of times
+        h += bytes_hash((const void*)&bytes[i % offsets], len);
+    }
+    const uint64_t elapsed = cubs_bench_now_ns() - start;
+
+    char name[64];
+    (void)snprintf(name, sizeof(name), "bytes_hash %zu bytes", len);
+    cubs_bench_report(name, iterations, elapsed);
+    // Keep `h` alive
+    if(h == 0) {
+        fprintf(stdout, "\n");
+    }
+
+    free((void*)bytes);
+}
+
+void cubs_bench_hash()
+{
+    bench_int_distribution();
+    bench_string_distribution();
+    bench_bytes_hash(8);
+    bench_bytes_hash(23);
+    bench_bytes_hash(64);
+    bench_bytes_hash(256);
+    bench_bytes_hash(4096);
+}
@@ -254,115 +254,104 @@ bool _cubs_simd_cmpeq_string_slice(const char *buffer, const char *slicePtr, siz
     #endif
 }
 
-#if __AVX2__
-static __m256i string_hash_iteration(const __m256i* vec, char num) {
-	// in the case of SSO, will ignore the 
-	const __m256i indices = _mm256_set_epi8(31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17, 16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
-	const __m256i numVec = _mm256_set1_epi8(num);
-
-	// Checks if num is greater than each value of indices.
-	// Mask is 0xFF if greater than, and 0x00 otherwise. 
-	const __m256i mask = _mm256_cmpgt_epi8(numVec, indices);
-	const __m256i partial = _mm256_and_si256(*vec, mask);
-	return _mm256_add_epi8(partial, numVec);
-}
-#else
-//_Static_assert(false, "string hash not implemented for target architecture");
-#endif
-
-
-#define HASH_INIT() \
-const size_t HASH_MODIFIER = cubs_hash_seed();\
-const size_t HASH_SHIFT = 47;\
-\
-size_t h = 0;\
-h = 0 ^ (len * HASH_MODIFIER)\
-
-#define HASH_MERGE() \
-do {\
-    for (size_t i = 0; i < 4; i++) {\
-        h ^= m256i_u64[i];\
-        h *= HASH_MODIFIER;\
-        h ^= h >> HASH_SHIFT;\
-    }\
-} while(false)
-
-#define HASH_END() \
-h ^= h >> HASH_SHIFT;\
-h *= HASH_MODIFIER;\
-h ^= h >> HASH_SHIFT
-
-#if __ARM_NEON__
-size_t _cubs_simd_string_hash_sso(const char *ssoBuffer, size_t len) {
-    return bytes_hash((const void*)ssoBuffer, len);
-}
-#else
 size_t _cubs_simd_string_hash_sso(const char *ssoBuffer, size_t len)
 {
-    
-    HASH_INIT();
-
-    #if __AVX2__
-
-    __m256i thisVec = {0};
-    memcpy((void*)&thisVec, (const void*)ssoBuffer, len);
-	const __m256i hashIter = string_hash_iteration(&thisVec, (char)len);
-    
-    const uint64_t* m256i_u64 = (const uint64_t*)&hashIter;
-
-    HASH_MERGE();
-
-    #else
-    // TODO actual hash
-    h = cubs_combine_hash(h, len);
-    for(size_t i = 0; i < len; i++) {
-        const size_t modify = (size_t)ssoBuffer[i];
-        h = cubs_combine_hash(modify << (8 * (i & 7)), h);
-    }
-    #endif
-	
-    HASH_END();
-
-    return h;
+    return bytes_hash((const void*)ssoBuffer, len);
 }
-#endif
 
-#if __ARM_NEON__
-size_t _cubs_simd_string_hash_heap(const char *heapBuffer, size_t len) {
-    return bytes_hash((const void*)heapBuffer, len);
-}
-#else
 size_t _cubs_simd_string_hash_heap(const char *heapBuffer, size_t len)
 {
-    assert_aligned(heapBuffer, 32);
+    // Doesn't require `heapBuffer` to be aligned or padded, so string slices can be hashed the same way.
+    return bytes_hash((const void*)heapBuffer, len);
+}
 
-    HASH_INIT();
+#if __AVX2__
+// Long inputs are hashed 64 bytes (a stripe) at a time into 8 independent 64 bit accumulators,
+// in the style of [XXH3](https://github.com/Cyan4973/xxHash). The accumulators don't depend on each
+// other, so each stripe is only a few vector instructions.
+
+#define LONG_HASH_LANES 8
+#define LONG_HASH_STRIPE_LEN 64
+/// Stripe `n` within a block uses secret lanes `n` through `n + 7`, and the scramble after each block
+/// uses lanes 8 through 15.
+#define LONG_HASH_SECRET_LANES 16
+#define LONG_HASH_STRIPES_PER_BLOCK 8
+#define LONG_HASH_BLOCK_LEN (LONG_HASH_STRIPE_LEN * LONG_HASH_STRIPES_PER_BLOCK)
+#define LONG_HASH_PRIME32_1 0x9E3779B1ULL
+
+static const uint64_t LONG_HASH_DEFAULT_SECRET[LONG_HASH_SECRET_LANES] = {
+    0xbe4ba423396cfeb8ULL, 0x1cad21f72c81017cULL, 0xdb979083e96dd4deULL, 0x1f67b3b7a4a44072ULL,
+    0x78e5c0cc4ee679cbULL, 0x2172ffcc7dd05a82ULL, 0x8e2443f7744608b8ULL, 0x4c263a81e69035e0ULL,
+    0xcb00c391bb52283cULL, 0xa32e531b8b65d088ULL, 0x4ef90da297486471ULL, 0xd8acdea946ef1938ULL,
+    0x3f349ce33f76faa8ULL, 0x1d4f0bc7c7bbdcf9ULL, 0x3159b4cd4be0518aULL, 0x647378d9c97e9fc8ULL,
+};
+
+static void long_hash_accumulate(uint64_t* acc, const uint8_t* data, const uint64_t* secret, size_t stripes) {
+    __m256i acc0 = _mm256_load_si256((const __m256i*)&acc[0]);
+    __m256i acc1 = _mm256_load_si256((const __m256i*)&acc[4]);
+    for(size_t n = 0; n < stripes; n++) {
+        const uint8_t* stripe = &data[n * LONG_HASH_STRIPE_LEN];
+        const __m256i data0 = _mm256_loadu_si256((const __m256i*)stripe);
+        const __m256i data1 = _mm256_loadu_si256((const __m256i*)&stripe[32]);
+        const __m256i dataKey0 = _mm256_xor_si256(data0, _mm256_loadu_si256((const __m256i*)&secret[n]));
+        const __m256i dataKey1 = _mm256_xor_si256(data1, _mm256_loadu_si256((const __m256i*)&secret[n + 4]));
+        // Low 32 bits of each lane multiplied by the high 32 bits
+        const __m256i product0 = _mm256_mul_epu32(dataKey0, _mm256_srli_epi64(dataKey0, 32));
+        const __m256i product1 = _mm256_mul_epu32(dataKey1, _mm256_srli_epi64(dataKey1, 32));
+        // Adds each lane's data to its neighbour, so no input bits are lost to the 32 bit multiply
+        acc0 = _mm256_add_epi64(acc0, _mm256_add_epi64(product0, _mm256_shuffle_epi32(data0, _MM_SHUFFLE(1, 0, 3, 2))));
+        acc1 = _mm256_add_epi64(acc1, _mm256_add_epi64(product1, _mm256_shuffle_epi32(data1, _MM_SHUFFLE(1, 0, 3, 2))));
+    }
+    _mm256_store_si256((__m256i*)&acc[0], acc0);
+    _mm256_store_si256((__m256i*)&acc[4], acc1);
+}
 
-    #if __AVX2__
+static void long_hash_scramble(uint64_t* acc, const uint64_t* secret) {
+    const __m256i prime = _mm256_set1_epi64x((long long)LONG_HASH_PRIME32_1);
+    for(size_t i = 0; i < LONG_HASH_LANES; i += 4) {
+        __m256i a = _mm256_load_si256((const __m256i*)&acc[i]);
+        a = _mm256_xor_si256(a, _mm256_srli_epi64(a, 47));
+        a = _mm256_xor_si256(a, _mm256_loadu_si256((const __m256i*)&secret[i]));
+        const __m256i productLow = _mm256_mul_epu32(a, prime);
+        const __m256i productHigh = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), prime);
+        _mm256_store_si256((__m256i*)&acc[i], _mm256_add_epi64(productLow, _mm256_slli_epi64(productHigh, 32)));
+    }
+}
 
-    const size_t iterationsToDo = ((len) % 32 == 0 ?
-		len :
-		len + (32 - (len % 32))) / 32;
+size_t _cubs_simd_bytes_hash_long(const void *ptr, size_t len, uint64_t seed)
+{
+    assert(len >= CUBS_HASH_LONG_THRESHOLD);
+    const uint8_t* p = (const uint8_t*)ptr;
 
-	for (size_t i = 0; i < iterationsToDo; i++) {
-		const __m256i* thisVec = (const __m256i*)(heapBuffer);
-		const char num = i != (iterationsToDo - 1) ? (char)(32) : (char)((iterationsToDo * i) - len);
-		const __m256i hashIter = string_hash_iteration(thisVec + i, num);
-        const uint64_t* m256i_u64 = (const uint64_t*)&hashIter;
+    uint64_t secret[LONG_HASH_SECRET_LANES];
+    for(size_t i = 0; i < LONG_HASH_SECRET_LANES; i += 2) {
+        secret[i] = LONG_HASH_DEFAULT_SECRET[i] + seed;
+        secret[i + 1] = LONG_HASH_DEFAULT_SECRET[i + 1] - seed;
+    }
 
-		HASH_MERGE();
-	}
+    _Alignas(32) uint64_t acc[LONG_HASH_LANES] = {
+        0xC2B2AE3DULL, 0x9E3779B185EBCA87ULL, 0xC2B2AE3D27D4EB4FULL, 0x165667B19E3779F9ULL,
+        0x85EBCA77C2B2AE63ULL, 0x85EBCA77ULL, 0x27D4EB2F165667C5ULL, 0x9E3779B1ULL,
+    };
 
-    #else
-    // TODO actual hash
-    h = cubs_combine_hash(h, len);
-    for(size_t i = 0; i < len; i++) {
-        const size_t modify = (size_t)heapBuffer[i];
-        h = cubs_combine_hash(modify << (8 * (i & 7)), h);
+    // The final stripe is always hashed separately below, so it's never part of a block.
+    const size_t blocks = (len - 1) / LONG_HASH_BLOCK_LEN;
+    for(size_t b = 0; b < blocks; b++) {
+        long_hash_accumulate(acc, &p[b * LONG_HASH_BLOCK_LEN], secret, LONG_HASH_STRIPES_PER_BLOCK);
+        long_hash_scramble(acc, &secret[LONG_HASH_SECRET_LANES - LONG_HASH_LANES]);
     }
-    #endif
-
-    HASH_END();
-    return h;
+    const size_t remainingStripes = ((len - 1) - (blocks * LONG_HASH_BLOCK_LEN)) / LONG_HASH_STRIPE_LEN;
+    long_hash_accumulate(acc, &p[blocks * LONG_HASH_BLOCK_LEN], secret, remainingStripes);
+    // The last 64 bytes, which may overlap with already hashed bytes
+    long_hash_accumulate(acc, &p[len - LONG_HASH_STRIPE_LEN], &secret[LONG_HASH_STRIPES_PER_BLOCK - 1], 1);
+
+    uint64_t h = (uint64_t)len * 0x9E3779B185EBCA87ULL;
+    for(size_t i = 0; i < LONG_HASH_LANES; i += 2) {
+        h += cubs_hash_mix(acc[i] ^ secret[i + 1], acc[i + 1] ^ secret[i + 2]);
+    }
+    h ^= h >> 37;
+    h *= 0x165667919E3779F9ULL;
+    h ^= h >> 32;
+    return (size_t)h;
 }
 #endif
@@ -18,4 +18,8 @@ bool _cubs_simd_cmpeq_string_slice(const char* buffer, const char* slicePtr, siz
 
 size_t _cubs_simd_string_hash_sso(const char* ssoBuffer, size_t len);
 
-size_t _cubs_simd_string_hash_heap(const char* heapBuffer, size_t len);
\ No newline at end of file
+size_t _cubs_simd_string_hash_heap(const char* heapBuffer, size_t len);
+
+/// Hashes inputs of at least `CUBS_HASH_LONG_THRESHOLD` bytes for `bytes_hash(...)`. `ptr` does not need to be aligned.
+/// Only defined when built with AVX2. Without it, the scalar loop in `bytes_hash(...)` is faster than 128 bit vectors.
+size_t _cubs_simd_bytes_hash_long(const void* ptr, size_t len, uint64_t seed);